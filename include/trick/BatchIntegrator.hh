@@ -0,0 +1,93 @@
+/*******************************************************************************
+Purpose:
+  (Define class BatchIntegrator.)
+*******************************************************************************/
+
+#ifndef BATCH_INTEGRATOR_HH
+#define BATCH_INTEGRATOR_HH
+
+#include "trick/Integrator.hh"
+
+namespace Trick {
+
+    /**
+     * Integrates the states of many bodies as one contiguous block.
+     *
+     * Each body reserves a slice of the block with add_states. Derivative
+     * jobs write straight into the slice returned by get_deriv, and read and
+     * write the body's state through the slice returned by get_state, so no
+     * state_in / deriv_in / state_out copies are made. A single integrate()
+     * call then applies the integration stage to the whole block in one pass.
+     * Those loops are compiled into libtrick in every build, vectorized and,
+     * with GCC on x86-64 Linux, for each of AVX-512, AVX2 and the baseline
+     * instruction set. The states are bit for bit those of integrating each
+     * body in a BatchIntegrator of its own.
+     *
+     * The supported techniques are Euler, Runge_Kutta_2, Runge_Kutta_4 and
+     * ABM_Method (fourth order Adams-Bashforth-Moulton, primed with RK4).
+     * The state_in / deriv_in / state_out family of the base class is not
+     * used with this integrator.
+     */
+    class BatchIntegrator : public Integrator {
+
+    public:
+        /** Default Constructor. This must remain public so the MM can create these. */
+        BatchIntegrator();
+
+        /**
+         * Create an empty batch; bodies are added with add_states.
+         * @param Alg  Integration technique.
+         * @param Dt   Integration time step.
+         */
+        BatchIntegrator( Integrator_type Alg, double Dt);
+
+        virtual ~BatchIntegrator();
+
+        /**
+         * Reserve State_size states, as though one body of that size was added.
+         */
+        void initialize( int State_size, double Dt);
+
+        /**
+         * Reserve a slice of the state block.
+         * Pointers returned by get_state and get_deriv are invalidated.
+         * @param num  Number of states in the slice.
+         * @return Offset of the slice in the block.
+         */
+        int add_states( int num);
+
+        /**
+         * @return The state slice at the given offset. Holds the state at which
+         *         the next derivatives are to be evaluated, and the integrated
+         *         state once integrate() returns 0.
+         */
+        double * get_state( int offset) { return state + offset; }
+
+        /**
+         * @return The derivative slice at the given offset for the current
+         *         intermediate step.
+         */
+        double * get_deriv( int offset) { return deriv[intermediate_step] + offset; }
+
+        int integrate();
+
+        /** Restart ABM priming, e.g. after states are changed discontinuously. */
+        void reset();
+
+        Integrator_type get_Integrator_type() { return(alg); };
+
+        /** The block is integrated in place, outside the C interface, so there is no dense output. */
+        bool has_dense_output() { return false; }
+
+        Integrator_type alg;    // -- integration technique
+        int capacity;           // -- allocated length of each state array
+        int num_stages;         // -- number of derivative arrays
+        int num_hist;           // -- number of ABM history entries filled
+        double **deriv_hist;    // -- ABM derivative history, oldest first
+
+    private:
+        void allocate( int new_capacity);
+    };
+}
+
+#endif
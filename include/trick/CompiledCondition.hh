@@ -0,0 +1,73 @@
+/*
+    PURPOSE:
+        (Native evaluation of simple event condition strings.)
+*/
+
+#ifndef COMPILEDCONDITION_HH
+#define COMPILEDCONDITION_HH
+
+#include <string>
+
+namespace Trick {
+
+/**
+  A CompiledCondition is an event condition string that has been translated into
+  an expression tree over resolved variable references, so it can be evaluated
+  without calling into the Python interpreter.
+
+  Only a subset of Python expression syntax is compiled: Trick variable references
+  with constant indices, numeric literals, True/False, trick.exec_get_sim_time(),
+  unary and binary + - *, comparison operators (including chained comparisons),
+  "and", "or", "not" and parentheses. Referenced variables must be fully indexed
+  numeric or boolean scalars of at most 32 bits, and integer arithmetic that could reach
+  2**53 is not compiled, so that every comparison is exact as it is in Python. Anything
+  else is left for Python to evaluate.
+
+  References are resolved again by name after a named allocation is deleted or resized.
+  A condition whose variable is gone, or now has another type, is false, as it is when
+  a referenced pointer is NULL.
+ */
+
+    class CompiledCondition {
+
+        public:
+
+            /**
+             Translate a condition string into a CompiledCondition.
+             @param str - the condition in Python syntax
+             @return a new CompiledCondition, or NULL if str must be evaluated by Python.
+             */
+            static CompiledCondition * compile( const std::string & str ) ;
+
+            ~CompiledCondition() ;
+
+            /**
+             Evaluate the condition with the current values of the referenced variables.
+             @return the Python truth value of the condition.
+             */
+            bool evaluate() ;
+
+            /**
+             Find a sim time before which the condition cannot be true, such as 100.0 for
+             "trick.exec_get_sim_time() >= 100.0 and x > 1".
+             @param time - set to the bound if one is found
+             @return true if the condition has a lower bound on sim time.
+             */
+            bool get_time_bound( double & time ) ;
+
+            class Node ;
+
+        private:
+
+            CompiledCondition( Node * in_root ) ;
+
+            Node * root ;       /**< ** root of the expression tree */
+
+            /** Not copyable. */
+            CompiledCondition( const CompiledCondition & ) ;
+            CompiledCondition & operator = ( const CompiledCondition & ) ;
+    } ;
+
+}
+
+#endif
@@ -129,6 +129,13 @@ GROUP "/" {
              */
             virtual int format_specific_shutdown() ;
 
+            /**
+             @brief An HDF5 file cannot be shared with a forked process, which would write the library's cached
+             metadata to it on exit.
+             @returns always -1
+            */
+            virtual int prepare_fork() ;
+
         protected:
 
 #ifdef HDF5
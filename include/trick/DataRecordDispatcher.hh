@@ -90,6 +90,12 @@ namespace Trick {
             /** @brief Stop data recording during simulation shutdown. */
             virtual int shutdown() ;
 
+            /** @brief Stop the writer thread and write out all groups before the process forks. */
+            int prepare_fork() ;
+
+            /** @brief Restart the writer thread and reopen all groups in the current output directory of a forked process. */
+            int reopen() ;
+
             /** @brief Enable a group or all groups */
             int enable( const char * in_name = NULL ) ;
 
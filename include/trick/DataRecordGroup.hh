@@ -8,6 +8,7 @@ PROGRAMMERS:
 #ifndef DATARECORDGROUP_HH
 #define DATARECORDGROUP_HH
 
+#include <stdio.h>
 #include <vector>
 #include <string>
 #include <fstream>
@@ -136,6 +137,12 @@ namespace Trick {
             /**  Yes = record all doubles as floats.\n */
             bool single_prec_only;      /**< trick_io(*io) trick_units(--) */
 
+            /**  Yes = write a time index beside the log file.\n */
+            bool time_index;            /**< trick_io(*io) trick_units(--) */
+
+            /**  Number of records between entries of the time index.\n */
+            unsigned int time_index_interval; /**< trick_io(*io) trick_units(--) */
+
             /**  Type of buffering.\n */
             DR_Buffering buffer_type ;  /**< trick_io(*io) trick_units(--) */
 
@@ -239,6 +246,26 @@ namespace Trick {
             */
             virtual int set_single_prec_only(bool in_single_prec_only) ;
 
+            /**
+             @brief @userdesc Command to write a time index, log_<group_name>.<ext>.idx, beside the log file.
+             The data products use it to start reading a log at a given time without reading
+             the records before it.
+             @par Python Usage:
+             @code <dr_group>.set_time_index(<in_time_index>) @endcode
+             @param in_time_index - boolean true indicates write the time index
+             @return always 0
+            */
+            virtual int set_time_index(bool in_time_index) ;
+
+            /**
+             @brief @userdesc Command to set the number of records between entries of the time index (default 1000).
+             @par Python Usage:
+             @code <dr_group>.set_time_index_interval(<num>) @endcode
+             @param num - number of records between entries
+             @return always 0
+            */
+            virtual int set_time_index_interval(unsigned int num) ;
+
             /**
              @brief @userdesc Command to set the thread of execution for this log group
              @par Python Usage:
@@ -380,6 +407,19 @@ namespace Trick {
             */
             virtual int shutdown() ;
 
+            /**
+             @brief Write out all recorded data before the process forks.
+             @returns 0 if the group can be reopened in a forked process, -1 otherwise
+            */
+            virtual int prepare_fork() ;
+
+            /**
+             @brief Close the log file inherited from the parent of a forked process and start a new one in the
+             current output directory.
+             @returns always 0
+            */
+            virtual int reopen() ;
+
             /**
              @brief The executive scheduler's interface to data_record job.
              @returns always 0
@@ -414,6 +454,28 @@ namespace Trick {
             /** Current time saved in Trick::DataRecordGroup::data_record.\n */
             double curr_time ;          /**< trick_io(*i) trick_units(--) */
 
+            /** The time index file, NULL when no index is written.  */
+            FILE * time_index_fp ;      /**< trick_io(**) */
+
+            /** Latest time of the records written so far, for the time index.\n */
+            double time_index_max ;     /**< trick_io(**) trick_units(s) */
+
+            /** Number of records written so far, for the time index.\n */
+            long long time_index_records ; /**< trick_io(**) trick_units(--) */
+
+            /**
+             @brief Open the time index of the log file just opened, or remove a stale one.
+             @returns always 0
+            */
+            int open_time_index() ;
+
+            /**
+             @brief Add the record about to be written to the time index.
+             @param writer_offset - the record's offset in the buffers
+             @param bytes - offset of the record in the log file, or -1 if it has none
+            */
+            void add_time_index(unsigned int writer_offset, long long bytes) ;
+
     } ;
 
 } ;
@@ -51,9 +51,9 @@ class Event {
         std::string get_name() { return name ; } ;
 
         /**
-         @brief set the event name
+         @brief set the event name.  The event manager looks up active events by their current name.
         */
-        void set_name(std::string in_name) { name = in_name ; } ;
+        void set_name(std::string in_name) ;
 
         /**
          @brief returns if the event is active or not.
@@ -158,6 +158,12 @@ class Event {
         /** process the event */
         virtual int process( long long curr_time ) = 0 ;
 
+        /**
+         @brief Gets the earliest time in tics at which processing the event could have any effect.
+         Cyclic event processing skips the cycles before this time.
+        */
+        virtual long long get_wake_tics() { return 0 ; } ;
+
         /** called when the event is added to the event manager */
         virtual void add() = 0 ;
 
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 #include "trick/Event.hh"
 #include "trick/EventInstrument.hh"
@@ -113,6 +114,22 @@ namespace Trick {
             */
             int remove_event(Trick::Event * in_event) ;
 
+            /**
+             @brief Move a cyclic event that is skipping cycles until its wake time back to its next cycle.
+             Called by events when a change may make them fire earlier than their wake time.
+             @param in_event - the event object
+             @return always 0
+            */
+            int wake_event(Trick::Event * in_event) ;
+
+            /**
+             @brief Update the name index after an active event is renamed.  Called by Event::set_name.
+             @param in_event - the event object
+             @param old_name - the name of the event before it was renamed
+             @return always 0
+            */
+            int rename_event(Trick::Event * in_event, std::string old_name) ;
+
             /**
              @brief Modifies the event firing times according to the time tic change
              @return always 0
@@ -155,6 +172,21 @@ namespace Trick {
             /** All of the events that have been attached to jobs */
             std::vector< Trick::EventInstrument * > events_instrumented ;  /**< trick_io(**) */
 
+            /** Active events indexed by name.  When several active events share a name, the first one
+                in active_events is indexed.  Rebuilt from active_events on restart. */
+            std::unordered_map< std::string, Trick::Event * > event_names ;  /**< trick_io(**) */
+
+            /**
+             @brief Index the named event unless an event of the same name is already indexed.
+            */
+            void index_event_name(Trick::Event * in_event) ;
+
+            /**
+             @brief Index the first active event with the given name, or remove the name from the index
+             if no active event has it.
+            */
+            void reindex_event_name(std::string event_name) ;
+
             /**
              @brief Add user's event to manager's list of events; don't add it if it's already in list.
             */
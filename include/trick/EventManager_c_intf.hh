@@ -17,4 +17,7 @@ int event_manager_add_event_after( Trick::Event * in_event, std::string target_n
 // Remove an event
 int event_manager_remove_event( Trick::Event * in_event ) ;
 
+// Move an event skipping cycles back to its next cycle
+int event_manager_wake_event( Trick::Event * in_event ) ;
+
 #endif
@@ -53,6 +53,13 @@ namespace Trick {
             */
             void remove_event(Trick::Event * in_event) ;
 
+            /**
+             @brief Request that an event skipping cycles until its wake time be moved back to its
+              next cycle.  Used when the event changes in a way that may make it fire earlier.
+              The event is moved at the next top of frame when add_pending_events is run.
+            */
+            void wake_event(Trick::Event * in_event) ;
+
             /**
              @brief top_of_frame job that moves pending events to the process_event queue.
              @return always 0
@@ -81,6 +88,14 @@ namespace Trick {
             /** Added events are put in the staging area called pending events.  The add_pending_events
                 job moves pending events to the event_set.\n */
             std::vector< Trick::Event * > pending_events ; // trick_io(**)
+            /** Events requesting to be moved back to their next cycle.\n */
+            std::vector< Trick::Event * > wake_events ; // trick_io(**)
+
+            /** Find an event in the event_set. */
+            std::multiset< Trick::Event *, CompareEventPtrs >::iterator find_event(Trick::Event * in_event) ;
+
+            /** Move a cyclic event's next time forward by whole cycles until it reaches the event's wake time. */
+            void skip_to_wake_tics(Trick::Event * in_event) ;
 
     } ;
 
@@ -17,11 +17,13 @@ namespace Trick {
 
     class IPPython ;
     class MTV ;
+    class CompiledCondition ;
 
     /** Data associated with each event condition.\n */
     struct condition_t {
 
         condition_t() ;
+        ~condition_t() ;
         /** True means condition is to be evaluated during event processing.\n */
         char enabled ;                          /**< trick_io(*io) trick_units(--) */
         /** True means that when fired, condition stays fired.\n */
@@ -42,6 +44,8 @@ namespace Trick {
         Trick::JobData * job ;                  /**< trick_io(**) trick_units(--) */
         /** Type of condition string: 0=python, 1=variable, 2=job.\n */
         int  cond_type ;                        /**< trick_io(*io) trick_units(--) */
+        /** Native form of a python condition string, NULL if python must evaluate it.\n */
+        Trick::CompiledCondition * compiled ;   /**< trick_io(**) trick_units(--) */
     } ;
 
     /** Data associated with each event action.\n */
@@ -298,6 +302,16 @@ namespace Trick {
             */
             std::string condition_string(int num) ;
 
+            /**
+             @brief @userdesc Accessor function to test if the condition string, indicated by num, is evaluated
+             without python. Simple comparisons of variables and constants are compiled when the condition is set.
+             @par Python Usage:
+             @code <my_bool> = <event_object>.condition_compiled(<num>) @endcode
+             @param num - number identifying the condition
+             @return true if the specified condition is evaluated in compiled form
+            */
+            bool condition_compiled(int num) ;
+
 
             /**
              @brief @userdesc Command to create a new action and set its input string (or reset an existing action string), num is index starting at 0.
@@ -393,6 +407,13 @@ namespace Trick {
 
             virtual int process( long long curr_time ) ;
 
+            /**
+             @brief When every enabled condition is compiled and false until some sim time, such as
+             "trick.exec_get_sim_time() > 100.0", returns the earliest of those times in tics.
+             Otherwise returns 0 so the event is processed every cycle.
+            */
+            virtual long long get_wake_tics() ;
+
             bool process_user_event( long long curr_time ) ;
 
             virtual void add() ;
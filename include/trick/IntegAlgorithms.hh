@@ -8,6 +8,7 @@
 #ifndef SWIG
 
 #include "trick/ABM_Integrator.hh"
+#include "trick/BatchIntegrator.hh"
 #include "trick/Euler_Cromer_Integrator.hh"
 #include "trick/Euler_Integrator.hh"
 #include "trick/MM4_Integrator.hh"
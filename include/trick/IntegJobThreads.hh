@@ -0,0 +1,181 @@
+/*
+PURPOSE:
+    ( Worker threads for parallel integration of independent sim objects )
+ICG: (No)
+*/
+
+#ifndef INTEGJOBTHREADS_HH
+#define INTEGJOBTHREADS_HH
+
+// Trick includes
+#include "trick/ThreadBase.hh"
+#include "trick/ScheduledJobQueue.hh"
+
+// System includes
+#include <pthread.h>
+#include <sys/types.h>
+#include <map>
+#include <vector>
+
+namespace Trick {
+
+    class IntegLoopScheduler;
+    class JobData;
+    class SimObject;
+
+    /**
+     * An IntegJobThreads object partitions the derivative and integration
+     * jobs of an IntegLoopScheduler by sim object and calls each partition
+     * on its own thread.
+     *
+     * Each call to call_deriv_jobs or call_integ_jobs is a barrier: it
+     * returns only after every partition has finished. The scheduler calls
+     * the derivative jobs and the integration jobs of each intermediate pass
+     * separately, so a derivative job sees the states of every sim object as
+     * they were at the end of the previous pass, just as it does when the
+     * jobs are called serially.
+     *
+     * The thread that calls the integration loop works on the first
+     * partition, so N threads use N-1 worker threads. The workers are
+     * started by the first call after the number of threads is set, and
+     * again in a child process forked after that, which does not inherit
+     * its parent's threads.
+     */
+    class IntegJobThreads {
+
+        public:
+
+            /**
+             * Constructor.
+             * @param scheduler  The scheduler whose jobs are called.
+             */
+            IntegJobThreads (Trick::IntegLoopScheduler * scheduler);
+
+            /**
+             * Destructor. Stops and joins the worker threads.
+             */
+            ~IntegJobThreads ();
+
+            /**
+             * Set the number of threads that call jobs, including the
+             * calling thread. Must not be called while jobs are running.
+             * @param num  Number of threads; values less than 1 mean 1.
+             */
+            void set_num_threads (unsigned int num);
+
+            /**
+             * Get the number of threads that call jobs.
+             * @return Number of threads, including the calling thread.
+             */
+            unsigned int get_num_threads () const {
+                return num_threads;
+            }
+
+            /**
+             * Forget the assignment of sim objects to threads.
+             * Called when the scheduler's job queues are rebuilt.
+             */
+            void clear_assignments ();
+
+            /**
+             * Split the enabled jobs of the queues among the threads.
+             * All of the jobs of a sim object go to the same thread, and jobs
+             * keep their queue order within a thread.
+             * @param deriv_queue  Derivative job queue.
+             * @param integ_queue  Integration job queue.
+             */
+            void distribute (
+                Trick::ScheduledJobQueue & deriv_queue,
+                Trick::ScheduledJobQueue & integ_queue);
+
+            /**
+             * Call the distributed derivative jobs.
+             */
+            void call_deriv_jobs ();
+
+            /**
+             * Call the distributed integration jobs for one pass.
+             * @param t_start  Time at the start of the integration interval.
+             * @param dt       Time span of the integration interval.
+             * @param ex_pass  Expected intermediate pass number.
+             * @param ipass    Set to the pass number returned by the last
+             *                 integration job in queue order.
+             * @return Zero on success, non-zero if any job failed.
+             */
+            int call_integ_jobs (
+                double t_start, double dt, int ex_pass, int & ipass);
+
+        private:
+
+            /**
+             * The jobs assigned to one thread, and the outcome of the most
+             * recent pass through them.
+             */
+            struct Partition {
+                Partition () : load (0), status (0), ipass (0), last_order (-1) {}
+                std::vector<Trick::JobData*> deriv_jobs;
+                std::vector<Trick::JobData*> integ_jobs;
+                std::vector<unsigned int> integ_order;
+                unsigned int load;
+                int status;
+                int ipass;
+                int last_order;
+            };
+
+            /**
+             * A worker thread; calls the jobs of one partition.
+             */
+            class Worker : public Trick::ThreadBase {
+                public:
+                    Worker (IntegJobThreads * in_owner, unsigned int in_index,
+                            unsigned long long in_generation);
+                    virtual void * thread_body ();
+                private:
+                    IntegJobThreads * owner;
+                    unsigned int index;
+                    unsigned long long generation;
+            };
+
+            /** Phases handed to the workers. */
+            enum Phase { DerivPhase, IntegPhase };
+
+            Trick::IntegLoopScheduler * scheduler;
+
+            unsigned int num_threads;
+
+            std::vector<Partition> partitions;
+
+            /** Thread that each sim object's jobs are assigned to. */
+            std::map<Trick::SimObject*, unsigned int> assignments;
+
+            std::vector<Worker*> workers;
+
+            /** Process that started the workers. */
+            pid_t workers_pid;
+
+            pthread_mutex_t mutex;
+            pthread_cond_t start_cv;
+            pthread_cond_t done_cv;
+            unsigned long long generation;
+            unsigned int num_running;
+            bool shutdown;
+
+            Phase phase;
+            double t_start;
+            double dt;
+            int ex_pass;
+
+            void run_phase (Phase in_phase);
+            void call_partition (unsigned int index);
+            void worker_loop (unsigned int index, unsigned long long seen);
+            void start_workers ();
+            void forget_forked_workers ();
+            void stop_workers ();
+
+            // Not copyable.
+            IntegJobThreads (const IntegJobThreads &);
+            IntegJobThreads & operator= (const IntegJobThreads &);
+    };
+}
+
+#endif
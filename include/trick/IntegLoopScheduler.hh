@@ -23,6 +23,7 @@ PROGRAMMERS:
 
 // System includes
 #include <vector>
+#include <deque>
 #include <string>
 #include <map>
 #include <cstdarg>
@@ -36,6 +37,7 @@ PROGRAMMERS:
 namespace Trick {
 
     class IntegrationManager;
+    class IntegJobThreads;
     class SimObject;
 
     /**
@@ -54,7 +56,8 @@ namespace Trick {
      *    intrinsically change the behaviors of the derivatives. Since such
      *    events change behavior, state is be integrated back to the point
      *    where the event occurs and then integrated forward to the desired
-     *    target time.
+     *    target time. With dense events enabled, the point where the event
+     *    occurs is instead found on an interpolant of the step just taken.
      *  - Post-integration jobs.\n
      *    The post-integration jobs are called after state is advanced to the
      *    target time.
@@ -131,7 +134,7 @@ namespace Trick {
             /**
              * Destructor.
              */
-            virtual ~IntegLoopScheduler () {}
+            virtual ~IntegLoopScheduler ();
 
 
             /**
@@ -246,6 +249,166 @@ namespace Trick {
             }
 
 
+            /**
+             * Set the number of threads used to call the derivative and
+             * integration jobs. With more than one thread, the jobs of the
+             * sim objects integrated by this loop are partitioned by sim
+             * object and each intermediate pass is called in parallel, with
+             * a barrier after the derivative jobs and after the integration
+             * jobs of each pass. The sim objects must be independent: a job
+             * must not modify the state of another sim object in the loop.
+             * @param num  Number of threads, including the thread that calls
+             *             the integ_loop job. The default, 1, calls the jobs
+             *             serially.
+             * @return Zero.
+             */
+            int set_num_threads (unsigned int num);
+
+            /**
+             * Get the number of threads used to call the derivative and
+             * integration jobs.
+             * @return Number of threads.
+             */
+            unsigned int get_num_threads () const {
+                return num_threads;
+            }
+
+
+            /**
+             * Locate dynamic events on the dense output of the integrators
+             * instead of integrating back and forth to each estimate of the
+             * event time. After a step in which an event occurs, the
+             * derivative jobs are called once more at the end of the step,
+             * and each search iteration sets the states of the sim objects
+             * to the cubic Hermite interpolant through the states and
+             * derivatives at both ends of the step, without calling the
+             * derivative jobs. The event is applied to the interpolated
+             * state; the loop then integrates once, from the event to the
+             * end of the step.
+             *
+             * Integration jobs must use the C interface integrate
+             * functions. The loop falls back to integrating to each estimate
+             * when an integrator cannot provide dense output or no step was
+             * captured, e.g. when a job calls its integrator directly.
+             * @param dense  True to locate events on the dense output.
+             */
+            void set_dense_events (bool dense) {
+                dense_events = dense;
+            }
+
+            /**
+             * Get whether dynamic events are located on the dense output.
+             * @return True if dense events are enabled.
+             */
+            bool get_dense_events () const {
+                return dense_events;
+            }
+
+
+            /**
+             * Take error controlled substeps within each integration cycle.
+             * Each substep is sized from the embedded error estimate of the
+             * integrators so that the error norm stays below one, where a
+             * state's error is scaled by abs_tol + rel_tol * |state|. A
+             * substep with too large an error is rejected, the states are
+             * set back to the start of the substep and a shorter substep is
+             * taken. The last substep of a cycle is shortened to end on the
+             * cycle boundary, so results are delivered at the cycle as usual,
+             * and the proposed substep carries over to the next cycle.
+             * Dynamic events are processed after each accepted substep.
+             *
+             * Every integrator of the loop must provide an error estimate,
+             * e.g. Runge_Kutta_Fehlberg_45, and the integration jobs must use
+             * the C interface integrate functions. Otherwise a warning is
+             * published and the loop steps at the integration cycle.
+             * @param adaptive  True to take error controlled substeps.
+             */
+            void set_adaptive_step (bool adaptive) {
+                adaptive_step = adaptive;
+            }
+
+            /**
+             * Get whether the loop takes error controlled substeps.
+             * @return True if adaptive stepping is enabled.
+             */
+            bool get_adaptive_step () const {
+                return adaptive_step;
+            }
+
+            /**
+             * Set the tolerances of adaptive stepping.
+             * @param abs_tol  Absolute error tolerance, in state units.
+             * @param rel_tol  Error tolerance relative to the state.
+             */
+            void set_adaptive_tolerance (double abs_tol, double rel_tol) {
+                adaptive_abs_tol = abs_tol;
+                adaptive_rel_tol = rel_tol;
+            }
+
+            /**
+             * Set the shortest substep of adaptive stepping. Substeps this
+             * short are accepted whatever their error.
+             * @param dt  Minimum substep, in seconds. Zero, the default,
+             *            uses a millionth of the integration cycle.
+             */
+            void set_min_substep (double dt) {
+                min_substep = dt;
+            }
+
+            /**
+             * Get the substep proposed for the next adaptive step.
+             * @return Substep, in seconds; zero before the first step.
+             */
+            double get_substep () const {
+                return substep;
+            }
+
+            /**
+             * Get the number of adaptive substeps accepted so far.
+             * @return Number of accepted substeps.
+             */
+            unsigned int get_accepted_substeps () const {
+                return accepted_substeps;
+            }
+
+            /**
+             * Get the number of adaptive substeps rejected so far.
+             * @return Number of rejected substeps.
+             */
+            unsigned int get_rejected_substeps () const {
+                return rejected_substeps;
+            }
+
+            /**
+             * Let the derivative jobs of this loop read a state integrated
+             * by another, usually faster, loop. The source loop records the
+             * variable at the end of each of its cycles. While this loop
+             * integrates, the variable is set before each pass of the
+             * derivative jobs to a cubic interpolant of that history at the
+             * time of the pass, and is given back its own value once the
+             * cycle is done. Times past the latest cycle of the source loop
+             * are extrapolated, so the source loop should run first within
+             * a frame. Both loops must run on the same thread.
+             *
+             * The time of a pass is taken from the integrators, which the
+             * integrators of the er7_utils library advance at each
+             * intermediate step. Integrators that only advance the time at
+             * the end of the step see the value at the start of the step.
+             * @return Zero on success, non-zero if the variable is already
+             *         an input or the source is this loop.
+             * @param var     Variable read by the derivative jobs.
+             * @param source  Loop that integrates the variable.
+             */
+            int add_rate_input (double * var, Trick::IntegLoopScheduler & source);
+
+            /**
+             * Stop interpolating a variable added with add_rate_input.
+             * @return Zero on success, non-zero if the variable is not an input.
+             * @param var  The variable.
+             */
+            int remove_rate_input (double * var);
+
+
             /**
              * Creates an integrator object for use by some integration class
              * job associated with this integration loop.
@@ -305,6 +468,8 @@ namespace Trick {
 
         protected:
 
+            friend class IntegJobThreads;
+
             // Types
 
             /**
@@ -312,6 +477,21 @@ namespace Trick {
              */
             typedef std::vector<Trick::Integrator*> IntegratorVector;
 
+            /**
+             * A variable this loop reads from another loop.
+             */
+            struct RateInput {
+                double * var;                 //!< trick_io(**) The variable.
+                IntegLoopScheduler * source;  //!< trick_io(**) Loop that records it.
+                unsigned int index;           //!< trick_io(**) Index in the source's rate_outputs.
+                double saved;                 //!< trick_io(**) Its own value during a cycle.
+            };
+
+            /**
+             * Vector of the variables read from other loops.
+             */
+            typedef std::vector<RateInput> RateInputVector;
+
 
             // Static member data
 
@@ -343,6 +523,82 @@ namespace Trick {
             SimObject * parent_sim_object; //!< trick_units(--)
 
 
+            /**
+             * Number of threads that call the derivative and integration jobs.
+             */
+            unsigned int num_threads; //!< trick_units(--)
+
+            /**
+             * Worker threads for parallel integration; created on demand.
+             */
+            Trick::IntegJobThreads * job_threads; //!< trick_io(**)
+
+            /**
+             * Locate dynamic events on the integrators' dense output.
+             */
+            bool dense_events; //!< trick_units(--)
+
+            /**
+             * Take error controlled substeps within each cycle.
+             */
+            bool adaptive_step; //!< trick_units(--)
+
+            /**
+             * Absolute error tolerance of adaptive stepping.
+             */
+            double adaptive_abs_tol; //!< trick_units(--)
+
+            /**
+             * Relative error tolerance of adaptive stepping.
+             */
+            double adaptive_rel_tol; //!< trick_units(--)
+
+            /**
+             * Shortest adaptive substep; zero for a millionth of the cycle.
+             */
+            double min_substep; //!< trick_units(s)
+
+            /**
+             * Substep proposed for the next adaptive step.
+             */
+            double substep; //!< trick_units(s)
+
+            /**
+             * Number of adaptive substeps accepted.
+             */
+            unsigned int accepted_substeps; //!< trick_units(--)
+
+            /**
+             * Number of adaptive substeps rejected.
+             */
+            unsigned int rejected_substeps; //!< trick_units(--)
+
+            /**
+             * Variables of this loop that other loops read.
+             */
+            std::vector<double *> rate_outputs; //!< trick_io(**)
+
+            /**
+             * Times at which the rate outputs were recorded, oldest first.
+             */
+            std::deque<double> rate_times; //!< trick_io(**)
+
+            /**
+             * Recorded rate outputs, one row per recorded time.
+             */
+            std::deque<double> rate_values; //!< trick_io(**)
+
+            /**
+             * How far back the readers of the rate outputs need the history.
+             */
+            double rate_history_span; //!< trick_units(s)
+
+            /**
+             * Variables this loop reads from other loops.
+             */
+            RateInputVector rate_inputs; //!< trick_io(**)
+
+
             /**
              * Pre-integration jobs managed by this loop.
              */
@@ -405,6 +661,21 @@ namespace Trick {
             virtual int integrate_dt (double beg_time, double del_time);
 
 
+            /**
+             * Call one integration job for one intermediate pass.
+             * This may be called concurrently for jobs of different sim objects.
+             *
+             * @return          Zero/non-zero success indicator.
+             * @param curr_job  The integration job.
+             * @param t_start   Time at the start of the integration interval.
+             * @param dt        Time span of the integration interval.
+             * @param ex_pass   Expected intermediate pass number.
+             * @param ipass     Set to the pass number returned by the job.
+             */
+            int call_integ_job (Trick::JobData * curr_job,
+                double t_start, double dt, int ex_pass, int & ipass);
+
+
             /**
              * Process dynamic events.
              *
@@ -415,6 +686,110 @@ namespace Trick {
              */
             int process_dynamic_events (double start_t, double end_t, unsigned int depth=0);
 
+
+            /**
+             * Collect the integrators used by the enabled integration jobs.
+             * @param integrators  Set to the distinct integrators.
+             */
+            void get_integrators (IntegratorVector & integrators);
+
+            /**
+             * Set the dense output mode of the integrators.
+             * @return  False, with the mode left unchanged, if a mode other
+             *          than Dense_Off was requested and some integrator
+             *          cannot provide dense output.
+             * @param mode  The new mode.
+             * @param time  Time at which Dense_Evaluate evaluates the output.
+             */
+            bool set_dense_mode (Dense_Output_Mode mode, double time = 0.0);
+
+            /**
+             * Determine whether every integrator captured the step that
+             * started at the given time.
+             * @return True if the step is captured.
+             * @param t_start     Time at the start of the step.
+             * @param end_derivs  Also require the derivatives at the end.
+             */
+            bool dense_step_captured (double t_start, bool end_derivs);
+
+            /**
+             * Call each integration job once with the integrators in the
+             * given dense output mode, then return them to Dense_Capture.
+             * @return Zero/non-zero success indicator.
+             * @param mode  Dense_End_Deriv, Dense_Evaluate or Dense_Restore.
+             * @param time  Time at which Dense_Evaluate evaluates the output.
+             */
+            int call_dense_pass (Dense_Output_Mode mode, double time);
+
+            /**
+             * Integrate from t_start to t_end in error controlled substeps,
+             * processing dynamic events after each accepted substep.
+             * The integrators must be capturing steps.
+             * @return Zero/non-zero success indicator.
+             * @param t_start  Time at the start of the cycle.
+             * @param t_end    Time at the end of the cycle.
+             */
+            int integrate_adaptive (double t_start, double t_end);
+
+            /**
+             * Determine whether every integrator provides an error estimate.
+             * @return True if adaptive stepping is possible.
+             */
+            bool have_error_estimates ();
+
+            /**
+             * Find or add a variable of this loop that another loop reads.
+             * Adding a variable discards the recorded history.
+             * @return Index of the variable in rate_outputs.
+             * @param var  The variable.
+             */
+            unsigned int add_rate_output (double * var);
+
+            /**
+             * Record the rate outputs, if any, at the given time.
+             * @param time  Time of the current values.
+             */
+            void record_rate_outputs (double time);
+
+            /**
+             * Interpolate a rate output from the recorded history.
+             * @return False, with value unchanged, if nothing is recorded.
+             * @param index  Index of the variable in rate_outputs.
+             * @param time   Time at which the variable is wanted.
+             * @param value  Set to the interpolated value.
+             */
+            bool get_rate_output (unsigned int index, double time, double & value);
+
+            /**
+             * Set the rate inputs to their values at the given time.
+             * @param time  Time of the coming derivative pass.
+             */
+            void set_rate_inputs (double time);
+
+            /**
+             * Save the values the rate inputs have before a cycle.
+             */
+            void save_rate_inputs ();
+
+            /**
+             * Give the rate inputs back the values saved before the cycle.
+             */
+            void restore_rate_inputs ();
+
+            /**
+             * Get the time at which the integrators evaluate the next
+             * derivatives, taken from the first integrator of the loop.
+             * @return The time, or t_default if the loop has no integrator.
+             * @param t_default  Time to use without an integrator.
+             */
+            double get_deriv_time (double t_default);
+
+        private:
+
+            // Not copyable; the copies would share, and both delete, job_threads.
+            IntegLoopScheduler (const IntegLoopScheduler &);
+            IntegLoopScheduler & operator= (const IntegLoopScheduler &);
+
     };
 }
 
@@ -422,8 +797,11 @@ namespace Trick {
 /**
  * The integrator currently being integrated.
  * This global is used by the C language interface to the integration functions.
+ * It is thread local so integration jobs can be called on several threads.
  */
-extern Trick::Integrator* trick_curr_integ; //!< trick_io(**)
+#ifndef SWIG
+extern __thread Trick::Integrator* trick_curr_integ; //!< trick_io(**)
+#endif
 
 #endif
 
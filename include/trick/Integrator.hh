@@ -38,6 +38,19 @@ typedef enum {
     User_Defined            = 10 /* User defined integrator */
 } Integrator_type;
 
+/**
+ *  What the C interface integrate functions do with an integrator while the
+ *  integration loop searches for dynamic events using dense output, or
+ *  takes adaptive substeps.
+ */
+typedef enum {
+    Dense_Off       = 0, /* Integrate */
+    Dense_Capture   = 1, /* Integrate, keeping the states and derivatives at both ends of the step */
+    Dense_End_Deriv = 2, /* Keep the derivatives at the end of the step; the state is unchanged */
+    Dense_Evaluate  = 3, /* Set the state to the dense output at dense_time */
+    Dense_Restore   = 4  /* Set the state back to the start of the captured step */
+} Dense_Output_Mode;
+
 namespace Trick {
 /**
  *  Contains the information shared by all of the Integrator Schemes.
@@ -53,7 +66,7 @@ namespace Trick {
     public:
 
         Integrator();
-        virtual ~Integrator() {};
+        virtual ~Integrator();
 
         virtual void initialize(int State_size, double Dt) = 0;
         virtual int integrate() = 0;
@@ -149,6 +162,75 @@ namespace Trick {
         virtual void reset() {}
         virtual Integrator_type get_Integrator_type() { return (User_Defined); };
 
+        /* Dense output over the last step, used to locate dynamic events
+           without integrating again. The integration loop sets dense_mode;
+           the C interface integrate functions call the dense_ versions
+           below whenever it is not Dense_Off. */
+
+        Dense_Output_Mode dense_mode; // -- set by IntegLoopScheduler
+        double dense_time;            // s  time at which Dense_Evaluate evaluates
+        double dense_t0;              // s  start time of the captured step
+        double dense_t1;              // s  end time of the captured step
+        bool dense_captured;          // -- the last step was captured from start to end
+        bool dense_valid;             // -- dense_f1 has also been captured
+
+        /**
+         * Whether this integrator can provide dense output. The default
+         * interpolant needs the whole first derivative of the state in
+         * deriv, so integrators that use deriv2 cannot.
+         */
+        virtual bool has_dense_output();
+
+        /**
+         * Evaluate the dense output over the captured step.
+         * The default is the cubic Hermite interpolant through the states
+         * and derivatives at both ends of the step. Integrators with a
+         * continuous extension of their own may override this.
+         * @param t  Time within the captured step.
+         * @param y  num_state interpolated states.
+         */
+        virtual void dense_output(double t, double * y);
+
+        /**
+         * Weights of the stage derivatives in the difference between the
+         * solutions of an embedded pair. Integrators that compute such a
+         * pair override this; the default has none.
+         * @param order  Set to the order of the lower order solution.
+         * @return One weight per intermediate step, or NULL.
+         */
+        virtual const double * get_error_weights(int & order);
+
+        /**
+         * Whether the captured step carries an embedded error estimate.
+         */
+        bool has_error_estimate();
+
+        /**
+         * The largest ratio of the error estimate of the captured step to
+         * the tolerance abs_tol + rel_tol * |state|.
+         * @return The error norm; a step with a norm above one is too long.
+         */
+        double get_error_norm(double abs_tol, double rel_tol);
+
+        void set_dense_mode(Dense_Output_Mode mode);
+        int dense_integrate();
+        int dense_integrate_1st_order_ode (
+           double const* derivs_in, double* state_in_out);
+        int dense_integrate_2nd_order_ode (
+           double const* accel, double* velocity, double* position);
+
+    protected:
+        double *dense_y0;   // ** state at the start of the captured step
+        double *dense_f0;   // ** derivatives at the start of the captured step
+        double *dense_y1;   // ** state at the end of the captured step
+        double *dense_f1;   // ** derivatives at the end of the captured step
+        double *dense_err;  // ** embedded error estimate of the captured step
+        int dense_size;     // ** allocated length of the dense arrays
+
+        void dense_capture_start(double const * y, double const * f);
+        void dense_capture_end(double const * y);
+        void dense_capture_stage(double const * f, double const * f2);
+
     };
 
     Integrator* getIntegrator( Integrator_type Alg, unsigned int State_size, double Dt = 0.0 );
@@ -7,6 +7,7 @@
 #define MEMORYMANAGEMENT_HH
 
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <vector>
 #include <list>
@@ -31,11 +32,15 @@ struct ut_system ;
 
 namespace Trick {
 
+    class MemoryPool ;
+    class UnitsConversion ;
+
     typedef std::map<void*, ALLOC_INFO*, std::greater<void*> > ALLOC_INFO_MAP;
     typedef std::map<void*, ALLOC_INFO*, std::greater<void*> >::const_iterator ALLOC_INFO_MAP_ITER ;
-    typedef std::map<std::string, ALLOC_INFO*> VARIABLE_MAP;
-    typedef std::map<std::string, ALLOC_INFO*>::const_iterator VARIABLE_MAP_ITER ;
+    typedef std::unordered_map<std::string, ALLOC_INFO*> VARIABLE_MAP;
+    typedef std::unordered_map<std::string, ALLOC_INFO*>::const_iterator VARIABLE_MAP_ITER ;
     typedef std::map<std::string, ENUM_ATTR*> ENUMERATION_MAP;
+    typedef std::unordered_map<std::string, REF2*> REF_CACHE_MAP;
 
 /**
   The Memory Manager provides memory-resource administration services.
@@ -280,6 +285,16 @@ namespace Trick {
              */
              void set_hexfloat_checkpoint( bool flag);
 
+            /**
+             Indicate whether small allocations of C types (intrinsics, pointers and C structs) made
+             by declare_var should come from size-class memory pools instead of calloc. Pooled
+             allocations are faster to create and delete, but must only be released with delete_var.
+             Checkpointing and address lookup are the same for pooled and calloc'ed allocations.
+             @param flag - true: Allocations up to 512 bytes are taken from the memory pools.
+                           false: (default) All allocations are made with calloc.
+             */
+             void set_pool_allocation( bool flag);
+
             /**
              Set the value(s) of the variable at the given address to 0, 0.0, NULL, false or "", as appropriate for the type.
              @param address - The address of the variable to be cleared.
@@ -466,11 +481,34 @@ namespace Trick {
             /**
              Generate and return a REF2 reference object for the named variable.
              Caller is responsible for freeing the returned REF2 object (using free() from stdlib.h ).
+             Plain dotted/indexed names are resolved without the reference parser, and references
+             that do not pass through a pointer are cached until the named allocations change.
              @param name - fully qualified variable name.
              @return pointer to REF2 object, or NULL on failure.
              */
             REF2 *ref_attributes( const char* name);
 
+            /**
+             Enable or disable the cache of resolved references used by ref_attributes.
+             Disabling the cache also empties it.
+             @param on - true = cache resolved references (default). false = always resolve.
+             */
+            void set_ref_cache_enabled( bool on ) ;
+
+            /**
+             Set the number of resolved references the cache may hold. When a new reference
+             would exceed it, the cache is emptied and starts over.
+             @param num - maximum number of cached references (default 4096).
+             */
+            void set_ref_cache_max_size( size_t num ) ;
+
+            /**
+             A count that changes whenever a named allocation is deleted, resized or unregistered,
+             which may invalidate the address of any reference resolved before.
+             @return the current generation of the named allocations.
+             */
+            unsigned int get_ref_cache_generation() { return ref_cache_generation ; }
+
             /**
              @param address - Address for which a name reference is needed.
              @return a name reference for the given address.
@@ -683,6 +721,59 @@ namespace Trick {
             ENUMERATION_MAP enumeration_map; /**< ** Enumeration map. */
             pthread_mutex_t mm_mutex;        /**< ** Mutex to control access to memory manager maps */
 
+            bool pool_allocation;            /**< ** true = small C allocations are taken from data_pools. */
+            MemoryPool * alloc_info_pool;    /**< ** Slab from which ALLOC_INFO records are allocated. */
+            std::vector<MemoryPool*> data_pools; /**< ** Size-class pools for small allocations, smallest first. Fixed at construction. */
+
+            /**
+             Create the data_pools. Called once by the constructor.
+             */
+            void create_data_pools() ;
+
+            /**
+             Allocate a zero-filled ALLOC_INFO record from the alloc_info_pool.
+             */
+            ALLOC_INFO * new_alloc_info() ;
+
+            /**
+             Return an ALLOC_INFO record obtained from new_alloc_info().
+             */
+            void free_alloc_info( ALLOC_INFO * alloc_info ) ;
+
+            /**
+             Allocate zero-filled memory from the smallest size-class pool that fits.
+             @return address of the memory, or NULL if no pool is large enough.
+             */
+            void * pool_allocate( size_t num_bytes ) ;
+
+            /**
+             Return memory obtained from pool_allocate().
+             */
+            void pool_deallocate( void * address, size_t num_bytes ) ;
+
+            REF_CACHE_MAP   ref_cache;       /**< ** Map of <reference string, REF2*> for resolved references with fixed addresses. */
+            bool ref_cache_enabled;          /**< ** true = ref_attributes caches resolved references. */
+            size_t ref_cache_max_size;       /**< ** Maximum number of references held in the ref_cache. */
+            unsigned int ref_cache_generation; /**< ** Incremented each time the ref_cache is invalidated. */
+
+            /**
+             Resolve a plain dotted/indexed reference without the reference parser.
+             @param name - reference string.
+             @param handled - set to false if the name requires the full reference parser.
+             @return pointer to REF2 object, or NULL on failure.
+             */
+            REF2 * ref_attributes_fast( const char* name, bool & handled ) ;
+
+            /**
+             Empty the ref_cache because named allocations changed. The caller must hold mm_mutex.
+             */
+            void invalidate_ref_cache() ;
+
+            /**
+             Empty the ref_cache without marking it invalid. The caller must hold mm_mutex.
+             */
+            void clear_ref_cache() ;
+
             int alloc_info_map_counter ;     /**< ** counter to assign unique ids to allocations as they are added to map */
             int extern_alloc_info_map_counter ; /**< ** counter to assign unique ids to allocations as they are added to map */
 
@@ -749,9 +840,9 @@ namespace Trick {
              @param curr_dim - The dimension of interest in the variable.
              @param offset - Offset to one of the elements in the dimension of interest.
              @param v_tree - RHS data to be assigned.
-             @param cf - units conversion function.
+             @param cf - units conversion, NULL if no conversion is needed.
              */
-            int assign_recursive(void* base_addr, ATTRIBUTES* attr, int curr_dim, int offset, V_TREE* v_tree, cv_converter * cf);
+            int assign_recursive(void* base_addr, ATTRIBUTES* attr, int curr_dim, int offset, V_TREE* v_tree, const Trick::UnitsConversion * cf);
 
             /**
              Copy the common elements from one array to another. The arrays must be of the same dimension,
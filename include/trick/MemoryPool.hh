@@ -0,0 +1,78 @@
+/*
+    PURPOSE:
+        (Fixed size block pool used by the Memory Manager.)
+*/
+
+#ifndef MEMORYPOOL_HH
+#define MEMORYPOOL_HH
+
+#include <stddef.h>
+#include <vector>
+#include <pthread.h>
+
+namespace Trick {
+
+/**
+ A MemoryPool hands out zero-filled blocks of a single fixed size. Blocks are
+ carved out of large slabs obtained from malloc and are recycled through a free
+ list, so allocating and freeing a block is a handful of pointer operations.
+ Slabs are only returned to the system when the pool is destroyed.
+ */
+    class MemoryPool {
+
+        public:
+
+            /**
+             @param block_size - size in bytes of each block. Rounded up to a multiple of 16.
+             @param blocks_per_slab - number of blocks obtained from the system at a time.
+             */
+            MemoryPool( size_t block_size, size_t blocks_per_slab ) ;
+
+            ~MemoryPool() ;
+
+            /**
+             Return a zero-filled block, or NULL if a new slab could not be allocated.
+             */
+            void * allocate() ;
+
+            /**
+             Return a block obtained from allocate() to the pool.
+             */
+            void deallocate( void * block ) ;
+
+            size_t get_block_size() const { return block_size ; } ;
+
+            /**
+             @return number of blocks currently handed out.
+             */
+            size_t get_num_blocks_in_use() const { return num_in_use ; } ;
+
+            /**
+             @return number of slabs obtained from the system.
+             */
+            size_t get_num_slabs() const { return slabs.size() ; } ;
+
+        private:
+
+            struct FreeBlock {
+                FreeBlock * next ;
+            } ;
+
+            size_t block_size ;             /**< ** size of each block */
+            size_t blocks_per_slab ;        /**< ** number of blocks in each slab */
+            std::vector<char *> slabs ;     /**< ** slabs obtained from malloc */
+            FreeBlock * free_list ;         /**< ** blocks available for reuse */
+            size_t num_in_use ;             /**< ** blocks currently handed out */
+            pthread_mutex_t pool_mutex ;    /**< ** protects free_list and slabs */
+
+            /** Add a slab's worth of blocks to the free list. */
+            int add_slab() ;
+
+            /** Not copyable. */
+            MemoryPool( const MemoryPool & ) ;
+            MemoryPool & operator = ( const MemoryPool & ) ;
+    } ;
+
+}
+
+#endif
@@ -61,6 +61,12 @@ namespace Trick {
              */
             virtual int init() ;
 
+            /**
+             @brief Closes the file, if it is open, and opens it again in the current output directory.
+             @return always 0
+             */
+            virtual int reopen() ;
+
         protected:
             /** The output file stream. \n */
             std::fstream out_stream ;    /**< trick_io(**) */
@@ -68,6 +68,12 @@ namespace Trick {
              */
             int publish(int level, std::string message) ;
 
+            /**
+             @brief Restarts the output of every subscriber in the current output directory.
+             @return always 0
+             */
+            int reopen() ;
+
             /**
              @brief gets the subscriber from the list
              @param sub_name - name of the subscriber to get.
@@ -50,6 +50,11 @@ namespace Trick {
              */
             virtual int init() { return 0 ; } ;
 
+            /**
+             @brief Restarts the subscriber's output in the current output directory, as in a forked Monte Carlo run
+             */
+            virtual int reopen() { return 0 ; } ;
+
             /**
              @brief Get a message and send to output. This gets called every time when the message publisher
              that this subscriber subscribes to publishes a message. Actual output done in the derived class.
@@ -10,8 +10,11 @@
 #include <climits>
 
 #include "trick/MonteVar.hh"
+#include "trick/MonteResult.hh"
 #include "trick/Executive.hh"
 #include "trick/RemoteShell.hh"
+#include "trick/UnitsConversion.hh"
+#include "trick/reference.h"
 #include "trick/tc.h"
 
 #ifdef SWIG
@@ -35,6 +38,22 @@ static const char* MC_exit_status_string[] = {
 
 namespace Trick {
 
+    /**
+     * A Monte Carlo variable's address and the conversion from its units to those of the simulation variable,
+     * resolved once by a slave so that numeric values can be assigned without the input processor.
+     */
+    class MonteVarReference {
+
+        public:
+        /** Reference to the simulation variable, or <code>NULL</code> if it is assigned by the input processor. */
+        REF2 *ref2;                       /**< \n trick_io(**) */
+
+        /** Conversion from the Monte Carlo variable's units to the simulation variable's. */
+        UnitsConversion conversion;       /**< \n trick_io(**) */
+
+        MonteVarReference() : ref2(NULL) {}
+    };
+
     /**
      * Represents a particular iteration in a Monte Carlo simulation. In addition to some bookkeeping information, a run
      * contains the variable values specific to this iteration.
@@ -78,6 +97,9 @@ namespace Trick {
         /** Variable values specific to this Monte Carlo iteration. */
         std::vector <std::string> variables; /**< \n trick_units(--) */
 
+        /** The value alone of each of the #variables, as it was generated. */
+        std::vector <std::string> values; /**< \n trick_units(--) */
+
         /** Manner in which this run exited. */
         ExitStatus exit_status;    /**< \n trick_units(--) */
 
@@ -141,10 +163,16 @@ namespace Trick {
         /** Name of the machine on which this slave is running. */
         std::string machine_name;             /**< \n trick_units(--) */
 
-        /** Port over which this slave is listening for dispatches. */
-        unsigned int port;               /**< \n trick_units(--) */
+        /**
+         * Connection the slave made to the master when it started. It stays open: runs are dispatched and their
+         * results returned over it.
+         */
+        TCDevice connection;             /**< \n trick_io(**) */
 
-        /** Run most recently dispatched to this slave. */
+        /** Runs dispatched to this slave whose results have not been returned, in the order they were dispatched. */
+        std::deque <MonteRun *> pending_runs; /**< \n trick_io(**) trick_units(--) */
+
+        /** Run this slave is processing, or most recently processed. */
         MonteRun *current_run;           /**< \n trick_units(--) */
 
         /** Number of runs dispatched to this slave. */
@@ -187,13 +215,14 @@ namespace Trick {
         MonteSlave(std::string name = "localhost") :
             id(0),
             state(MC_UNINITIALIZED),
-            port(0),
+            connection(),
             current_run(NULL),
             num_dispatches(0),
             num_results(0),
             cpu_time(0),
             remote_shell(Trick::TRICK_SSH),
             multiplier(1) {
+            connection.socket = TRICKCOMM_INVALID_SOCKET;
             if (name.empty()) {
                 machine_name = "localhost";
             }
@@ -335,6 +364,19 @@ namespace Trick {
         /** Maximum number of times that a run may be dispatched. Defaults to two. Specify zero for no limit. */
         unsigned int max_tries;                         /**< \n trick_units(--) */
 
+        /**
+         * Maximum number of runs dispatched to a slave at once: the one it is processing and those queued behind it,
+         * which it starts as soon as it finishes, without waiting on the master. Defaults to two.
+         */
+        unsigned int max_pending_runs;                  /**< \n trick_units(--) */
+
+        /**
+         * Simulation time at which slaves fork their runs. Defaults to zero, in which case runs are forked at the end
+         * of the slave's Phase 0 initialization. Otherwise each slave simulates up to this time once, and every run
+         * continues from that state with its values assigned.
+         */
+        double branch_time;                             /**< \n trick_units(s) */
+
         /** Options to be passed to the remote shell when spawning new slaves. */
         std::string user_cmd_string;                         /**< \n trick_units(--) */
 
@@ -350,7 +392,10 @@ namespace Trick {
         /** Device over which connections are accepted. */
         TCDevice listen_device;                         /**< \n trick_units(--) */
 
-        /** Device over which data is sent and received. */
+        /**
+         * For the master, device over which a newly started slave's connection is accepted. For a slave, its
+         * connection to the master.
+         */
         TCDevice connection_device;                     /**< \n trick_units(--) */
 
         /** Runs to be dispatched. */
@@ -368,6 +413,12 @@ namespace Trick {
         /** Variables. */
         std::vector <Trick::MonteVar *> variables;           /**< \n trick_io(**) trick_units(--) */
 
+        /** For a slave, a reference to each of the #variables, resolved at initialization and again at #branch_time. */
+        std::vector <Trick::MonteVarReference> variable_references; /**< \n trick_io(**) */
+
+        /** Results, whose values are returned by every run and reduced to statistics by the master. */
+        std::vector <Trick::MonteResult *> results;          /**< \n trick_io(**) trick_units(--) */
+
         /** Slaves. */
         std::vector <Trick::MonteSlave *> slaves;            /**< \n trick_io(**) trick_units(--) */
 
@@ -413,8 +464,23 @@ namespace Trick {
         /** Run directory. */
         std::string run_directory;                      /**, \n trick_units(--) */
 
+        /**
+         * Data written by #write in a slave's post run jobs. It is returned to the master with the run's exit status,
+         * where #read gives it to the master's post run jobs.
+         */
+        std::string post_run_data;                      /**< trick_io(**) */
+
+        /** Number of bytes of #post_run_data already read by the master. */
+        std::string::size_type post_run_data_read;      /**< trick_io(**) */
+
         Trick::JobData * curr_job ;                     /**< trick_io(**) */
 
+        /** The #branch job, which schedules itself for #branch_time. */
+        Trick::JobData * branch_job ;                   /**< trick_io(**) */
+
+        /** The #sample_results job, which schedules itself for the next sample of the #results. */
+        Trick::JobData * sample_job ;                   /**< trick_io(**) */
+
         /** Return code to be returned by Executive:init(), Executive::loop(), and Executive::shutdown() \n */
         int except_return ;                       /**< trick_io(**) */
 
@@ -461,6 +527,32 @@ namespace Trick {
          */
         int execute_monte();
 
+        /**
+         * S_define level automatic job. When #branch_time is reached in a slave, connects to the master and forks
+         * every run dispatched to the slave from the current state.
+         *
+         * @return 0 on success
+         */
+        int branch();
+
+        /**
+         * Sets #branch_job.
+         */
+        void set_branch_job(Trick::JobData * branch_job);
+
+        /**
+         * S_define level automatic job. In a slave, samples the #results that are sampled periodically when they are
+         * due.
+         *
+         * @return 0 on success
+         */
+        int sample_results();
+
+        /**
+         * Sets #sample_job.
+         */
+        void set_sample_job(Trick::JobData * sample_job);
+
         /**
          * Sets #enabled.
          *
@@ -541,6 +633,26 @@ namespace Trick {
          */
         unsigned int get_max_tries();
 
+        /**
+         * Sets #max_pending_runs. Values less than one are treated as one.
+         */
+        void set_max_pending_runs(unsigned int max_pending_runs);
+
+        /**
+         * Gets #max_pending_runs.
+         */
+        unsigned int get_max_pending_runs();
+
+        /**
+         * Sets #branch_time. Negative values are treated as zero.
+         */
+        void set_branch_time(double branch_time);
+
+        /**
+         * Gets #branch_time.
+         */
+        double get_branch_time();
+
         /**
          * Sets #user_cmd_string.
          */
@@ -673,6 +785,21 @@ namespace Trick {
          */
         const std::vector<Trick::MonteVar*>& get_variables();
 
+        /**
+         * Adds the specified result. Every run returns its values to the master, which writes their statistics to the
+         * monte_results file.
+         *
+         * @param result the result to add
+         */
+        void add_result(Trick::MonteResult *result);
+
+        /**
+         * Gets the list of added results.
+         *
+         * @return the current list of results
+         */
+        const std::vector<Trick::MonteResult*>& get_results();
+
         /**
          * Adds a new slave with the specified machine name.
          *
@@ -774,7 +901,18 @@ namespace Trick {
          */
         int  get_connection_device_port() ;
 
+        /**
+         * In a slave's post run jobs, adds data to be returned to the master with the run's exit status.
+         *
+         * @return the number of bytes written, or -1 if called by the master
+         */
         int write(char* data, int size);
+
+        /**
+         * In the master's post run jobs, reads data written by the slave's post run jobs for the run.
+         *
+         * @return the number of bytes read, or -1 if called by a slave
+         */
         int read(char* data, int size);
 
 #if 0
@@ -813,6 +951,14 @@ namespace Trick {
         void handle_run_data(MonteSlave& slave);
         void set_disconnected_state(MonteSlave& slave);
 
+        /**
+         * Queues the unresolved runs dispatched to the specified slave to be dispatched again, for when the slave may
+         * never return their results.
+         *
+         * @param slave the slave the runs were dispatched to
+         */
+        void requeue_pending_runs(MonteSlave& slave);
+
         /**
          * Handles the retrying of the current run of the specified slave with the specified exit status.
          *
@@ -835,7 +981,9 @@ namespace Trick {
         void check_timeouts();
 
         /**
-         * Gets a slave that is ready for a new dispatch.
+         * Gets a slave that is ready for a new dispatch: one that is ready or running with fewer than
+         * #max_pending_runs pending runs. Of those, the one with the fewest is chosen, so that every slave has a run
+         * before any has one queued.
          *
          * @return a ready slave, or <code>NULL</code> if there is none
          */
@@ -877,9 +1025,34 @@ namespace Trick {
          */
         int  prepare_run(MonteRun *run);
 
+        /**
+         * Forms the input processor assignment of the specified value to the specified variable, as the variables'
+         * get_next_value does.
+         *
+         * @param variable the variable
+         * @param value the value
+         *
+         * @return the assignment
+         */
+        static std::string assignment_text(const MonteVar &variable, const std::string &value);
+
+        /**
+         * Parses a value that is a plain decimal number, which the input processor would read as the same number.
+         *
+         * @param value the value
+         * @param type set to TRICK_LONG_LONG for an integer, or TRICK_DOUBLE
+         * @param bits set to the bits of the integer or double
+         *
+         * @return whether the value is a plain decimal number
+         */
+        static bool parse_number(const std::string &value, int &type, unsigned long long &bits);
+
         /** Removes the specified run, if present, from #runs. */
         void dequeue_run(MonteRun *run);
 
+        /** Determines if the specified run is in #runs. */
+        bool is_queued(MonteRun *run);
+
         /**
          * Dispatches the specified run to the specified slave.
          *
@@ -904,6 +1077,13 @@ namespace Trick {
          */
         int slave_init();
 
+        /**
+         * Connects the slave to the master and writes the name of its machine.
+         *
+         * @return 0 on success
+         */
+        int slave_connect();
+
         /**
          * Begins Monte Carlo simulation as a slave.
          *
@@ -914,6 +1094,47 @@ namespace Trick {
         /** Processes an incoming run. */
         int slave_process_run();
 
+        /**
+         * Resolves #variable_references. Variables that are not numeric scalars, or whose units cannot be converted,
+         * are left to the input processor.
+         */
+        void resolve_variable_references();
+
+        /** Resolves the variable of each of the #results. */
+        void resolve_results();
+
+        /**
+         * Adds the values of the #results returned by a completed run to their statistics.
+         *
+         * @param data the values, as written by #slave_send_result
+         *
+         * @return 0 on success, or -1 if the data is malformed
+         */
+        int reduce_results(const std::string &data);
+
+        /** Writes the statistics of the #results to the monte_results file. */
+        void write_results();
+
+        /**
+         * Assigns a value sent by the master to the specified variable.
+         *
+         * @param index the index of the variable within #variables
+         * @param type the type of the value, TRICK_LONG_LONG or TRICK_DOUBLE
+         * @param bits the value's bits
+         * @param assignment set to the input processor assignment of the value
+         *
+         * @return 0 if the value was assigned, 1 if the assignment must be parsed by the input processor, or -1 if
+         * there is no such variable
+         */
+        int assign_variable(unsigned int index, int type, unsigned long long bits, std::string &assignment);
+
+        /**
+         * Returns the specified run's exit status and any #post_run_data to the master.
+         *
+         * @return 0 on success
+         */
+        int slave_send_result(unsigned int run_id, MonteRun::ExitStatus exit_status);
+
         /** Shuts down the slave. */
         void slave_shutdown();
 
@@ -0,0 +1,192 @@
+/*
+  PURPOSE:                     (Monte carlo result reduction)
+  REFERENCE:                   (Trick Users Guide)
+  ASSUMPTIONS AND LIMITATIONS: (None)
+*/
+
+#ifndef MONTERESULT_HH
+#define MONTERESULT_HH
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "trick/reference.h"
+
+// This block of code disowns the pointer on the python side so you can reassign
+// python variables without freeing the C++ class underneath
+#ifdef SWIG
+%feature("compactdefaultargs","0") ;
+%feature("shadow") Trick::MonteResult::MonteResult(std::string name, double interval) %{
+    def __init__(self, *args):
+        this = $action(*args)
+        try: self.this.append(this)
+        except: self.this = this
+        this.own(0)
+        self.this.own(0)
+%}
+#endif
+
+namespace Trick {
+
+    /**
+     * Estimates a quantile of a stream of values by the P-squared algorithm of Jain and Chlamtac, which keeps five
+     * markers instead of the values.
+     */
+    class MonteQuantile {
+
+        public:
+        /**
+         * Constructs a MonteQuantile.
+         *
+         * @param probability the probability of the quantile, between zero and one
+         */
+        MonteQuantile(double probability = 0.5);
+
+        /** Adds a value to the stream. */
+        void add(double value);
+
+        /**
+         * Gets the estimate of the quantile.
+         *
+         * @return the estimate, or zero if no values were added
+         */
+        double get_value() const;
+
+        /** Probability of the quantile. */
+        double probability;     /**< \n trick_units(--) */
+
+        /** Number of values added. */
+        unsigned int count;     /**< \n trick_units(--) */
+
+        protected:
+        /** Heights of the markers. Until five values are added, the values, in order. */
+        double heights[5];      /**< \n trick_units(--) */
+
+        /** Positions of the markers. */
+        double positions[5];    /**< \n trick_units(--) */
+
+        /** Desired positions of the markers. */
+        double desired[5];      /**< \n trick_units(--) */
+    };
+
+    class MonteResult;
+
+    /** Statistics of the values that a MonteResult took at one time over every run. */
+    class MonteResultBin {
+
+        public:
+        /** Constructs a MonteResultBin for the specified result. */
+        MonteResultBin(const MonteResult &result);
+
+        /** Adds a run's value. */
+        void add(double value, const MonteResult &result);
+
+        /**
+         * Gets the sample variance of the values.
+         *
+         * @return the variance, or zero for fewer than two values
+         */
+        double get_variance() const;
+
+        /** Number of values. */
+        unsigned int count;     /**< \n trick_units(--) */
+
+        /** Mean of the values. */
+        double mean;            /**< \n trick_units(--) */
+
+        /** Sum of the squared differences of the values from #mean, kept by Welford's method. */
+        double m2;              /**< \n trick_units(--) */
+
+        /** Least value. */
+        double min;             /**< \n trick_units(--) */
+
+        /** Greatest value. */
+        double max;             /**< \n trick_units(--) */
+
+        /** The 5th, 50th and 95th percentiles. */
+        std::vector<MonteQuantile> quantiles; /**< \n trick_io(**) */
+
+        /**
+         * Number of values in each bin of the result's histogram, preceded by those below it and followed by those
+         * above it. Empty if the result has no histogram.
+         */
+        std::vector<unsigned int> histogram;  /**< \n trick_io(**) */
+    };
+
+    /**
+     * A simulation variable whose values are returned to the master from every run and reduced to statistics there,
+     * in place of reading them back from each run's data recording. The statistics are written to the monte_results
+     * file.
+     */
+    class MonteResult {
+
+        public:
+        /**
+         * Constructs a MonteResult.
+         *
+         * @param name the fully qualified name of the simulation variable, which must be a single number
+         * @param interval the period, in seconds of simulation time, at which the variable is sampled, starting at
+         * zero. Zero samples only the variable's final value.
+         */
+        MonteResult(std::string name, double interval = 0);
+
+        /** Destructor. */
+        virtual ~MonteResult();
+
+        /**
+         * Counts the values of this result in a histogram of equal bins.
+         *
+         * @param min the lower bound of the histogram
+         * @param max the upper bound of the histogram
+         * @param num_bins the number of bins. Zero removes the histogram.
+         */
+        void set_histogram(double min, double max, unsigned int num_bins);
+
+        /** Name of the simulation variable. */
+        std::string name;                /**< \n trick_units(--) */
+
+        /** Period at which the variable is sampled, or zero to sample only its final value. */
+        double interval;                 /**< \n trick_units(s) */
+
+        /** Lower bound of the histogram. */
+        double histogram_min;            /**< \n trick_units(--) */
+
+        /** Upper bound of the histogram. */
+        double histogram_max;            /**< \n trick_units(--) */
+
+        /** Number of bins in the histogram, zero for none. */
+        unsigned int num_histogram_bins; /**< \n trick_units(--) */
+
+        /** Class MonteCarlo is a friend so it can sample and reduce this result. */
+        friend class MonteCarlo ;
+
+        protected:
+        /** For a slave, the variable, resolved at initialization. */
+        REF2 *ref2;                      /**< trick_io(**) */
+
+        /** For a slave, the values sampled in the current run. */
+        std::vector<double> samples;     /**< trick_io(**) */
+
+        /** For the master, the statistics at each sample time. */
+        std::vector<MonteResultBin> bins; /**< trick_io(**) */
+
+        /**
+         * Resolves #ref2.
+         *
+         * @return true if the variable is a single number
+         */
+        bool resolve();
+
+        /** Appends the variable's current value to #samples. */
+        void sample();
+
+        /** Adds a run's #samples to the statistics in #bins. */
+        void add_run(const std::vector<double> &run_samples);
+
+        /** Writes the statistics in #bins. */
+        void write(FILE *fp);
+    };
+
+};
+#endif
@@ -70,6 +70,16 @@ public:
    virtual ~RKF45_Integrator() {}
 
    virtual Integrator_type get_Integrator_type() { return Runge_Kutta_Fehlberg_45; }
+
+   /** Weights of the stage derivatives in the difference between the
+       fifth and fourth order solutions. */
+   virtual const double * get_error_weights (int & order)
+   {
+      static const double weights[6] = {
+         1.0/360.0, 0.0, -128.0/4275.0, -2197.0/75240.0, 1.0/50.0, 2.0/55.0};
+      order = 4;
+      return weights;
+   }
 };
 
 }
@@ -99,6 +109,8 @@ namespace Trick {
         void set_first_step_deriv(bool first_step);
 
         Integrator_type get_Integrator_type() { return(Runge_Kutta_Fehlberg_45); } ;
+
+        const double * get_error_weights( int & order);
     };
 }
 #endif
@@ -0,0 +1,83 @@
+/*
+    PURPOSE:
+        (Cached udunits conversions reduced to a scale and offset.)
+*/
+
+#ifndef UNITSCONVERSION_HH
+#define UNITSCONVERSION_HH
+
+#include <stddef.h>
+#include <string>
+
+union cv_converter ;
+struct ut_system ;
+
+namespace Trick {
+
+/**
+  A UnitsConversion converts values between two units. Almost every conversion udunits
+  produces is linear or affine, and those are stored as a scale and offset so converting
+  a value is a multiply and an add rather than a dispatch through a udunits converter.
+  The scale and offset are used only if they match udunits to within a few ulps at
+  several sample points. Other conversions, e.g. logarithmic units, keep the udunits
+  converter.
+
+  Conversions are created once per (from, to) pair and kept in a process wide cache, so
+  looking one up does not parse either unit string again.
+ */
+
+    class UnitsConversion {
+
+        public:
+
+            /** Creates the trivial conversion. */
+            UnitsConversion() ;
+
+            /**
+             Look up the conversion between two units, creating and caching it on first use.
+             @param u_system - unit system used to parse the unit strings
+             @param from - units of the values to be converted
+             @param to - units to convert the values to
+             @param conversion - set to the conversion if it exists
+             @return 0 on success, -1 if from cannot be parsed, -2 if to cannot be parsed,
+                     -3 if the units are not convertible.
+             */
+            static int get( ut_system * u_system, const std::string & from, const std::string & to,
+             UnitsConversion & conversion ) ;
+
+            /** @return true if converting leaves values unchanged. */
+            bool is_trivial() const { return ( converter == NULL && scale == 1.0 && offset == 0.0 ) ; }
+
+            /** @return true if the conversion is value * scale + offset. */
+            bool is_affine() const { return ( converter == NULL ) ; }
+
+            double get_scale() const { return scale ; }
+            double get_offset() const { return offset ; }
+
+            double convert( double value ) const {
+                return ( converter == NULL ) ? value * scale + offset : convert_nonaffine(value) ;
+            }
+
+            float convert_float( float value ) const {
+                return ( converter == NULL ) ? (float)(value * scale + offset) : (float)convert_nonaffine(value) ;
+            }
+
+            /**
+             Convert an array of values in place.
+             @param values - values to convert
+             @param num - number of values
+             */
+            void convert( double * values, size_t num ) const ;
+
+        private:
+
+            double scale ;                  /**< ** multiplier of an affine conversion */
+            double offset ;                 /**< ** offset of an affine conversion */
+            cv_converter * converter ;      /**< ** udunits converter if the conversion is not affine */
+
+            double convert_nonaffine( double value ) const ;
+    } ;
+
+}
+
+#endif
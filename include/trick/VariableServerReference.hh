@@ -8,8 +8,7 @@
 
 #include <iostream>
 #include "trick/reference.h"
-
-union cv_converter ;
+#include "trick/UnitsConversion.hh"
 
 #define MAX_ARRAY_LENGTH 4096
 
@@ -29,7 +28,7 @@ namespace Trick {
 
             /** Pointer to trick variable reference structure.\n */
             REF2 * ref ;
-            cv_converter * conversion_factor ; // ** udunits conversion factor
+            Trick::UnitsConversion conversion_factor ; // ** units conversion to the requested units
             void * buffer_in ;
             void * buffer_out ;
             void * address ;          // -- address of data copied to buffer
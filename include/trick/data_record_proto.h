@@ -17,6 +17,8 @@ int dr_record_now_group( const char * in_name ) ;
 int dr_set_max_file_size ( uint64_t bytes ) ;
 void remove_all_data_record_groups(void) ;
 int set_max_size_record_group (const char * in_name, uint64_t bytes ) ;
+int dr_prepare_fork(void) ;
+int dr_reopen(void) ;
 
 
 #ifdef __cplusplus
@@ -51,6 +51,7 @@
 #include "trick/IntegLoopManager.hh"
 #include "trick/IntegLoopSimObject.hh"
 #include "trick/ABM_Integrator.hh"
+#include "trick/BatchIntegrator.hh"
 #include "trick/Euler_Cromer_Integrator.hh"
 #include "trick/Euler_Integrator.hh"
 #include "trick/MM4_Integrator.hh"
@@ -16,6 +16,7 @@ typedef enum {
    TRICK_ALLOC_MALLOC = 0,
    TRICK_ALLOC_NEW = 1,
    TRICK_ALLOC_OTHER = 2,
+   TRICK_ALLOC_POOL = 3,
 } TRICK_ALLOC_TYPE;
 
 #ifdef __cplusplus
@@ -39,6 +39,7 @@ int   TMM_is_alloced(char *addr) ;
 void  TMM_set_debug_level(int level);
 void  TMM_reduced_checkpoint(int flag);
 void  TMM_hexfloat_checkpoint(int flag);
+void  TMM_pool_allocation(int flag);
 
 void  TMM_clear_var_a( void* address);
 void  TMM_clear_var_n( const char* var_name );
@@ -60,6 +61,7 @@ int   TMM_add_shared_library_symbols( const char* filename);
 int   TMM_set_stl_restore (int on_off);
 
 REF2* ref_attributes(const char* name);
+unsigned int TMM_ref_cache_generation(void);
 int   ref_var(REF2* R, char* name);
 int   get_size(void *addr) ;
 
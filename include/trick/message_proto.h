@@ -12,6 +12,7 @@ extern "C" {
 int message_publish(int level, const char *format_msg, ...) ;
 int message_publish_standalone(int level, const char *format_msg, ...) ;
 int send_hs(FILE * fp, const char *format_msg, ...) ;
+int message_reopen(void) ;
 
 #ifndef SWIG
 int vmessage_publish(int level, const char *format_msg, va_list args) ;
@@ -89,6 +89,30 @@ void mc_set_max_tries(unsigned int max_tries);
  */
 unsigned int mc_get_max_tries(void);
 
+/**
+ * @relates Trick::MonteCarlo
+ * @copydoc set_max_pending_runs
+ */
+void mc_set_max_pending_runs(unsigned int max_pending_runs);
+
+/**
+ * @relates Trick::MonteCarlo
+ * @copydoc get_max_pending_runs
+ */
+unsigned int mc_get_max_pending_runs(void);
+
+/**
+ * @relates Trick::MonteCarlo
+ * @copydoc set_branch_time
+ */
+void mc_set_branch_time(double branch_time);
+
+/**
+ * @relates Trick::MonteCarlo
+ * @copydoc get_branch_time
+ */
+double mc_get_branch_time(void);
+
 /**
  * @relates Trick::MonteCarlo
  * @copydoc set_user_cmd_string
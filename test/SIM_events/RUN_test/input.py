@@ -198,6 +198,41 @@ trick.add_read(3.5, """manual12.manual_fire()""")
 expected.append(3.5)
 result.append(0)
 
+# TEST 13: conditions that compile fire exactly when Python finds them true
+agree_tests = [
+ # (condition, compiled)
+ ("ev.cond_int + 2 * 3 == 9", True),
+ ("(ev.cond_int + 2) * 3 == 15", True),
+ ("not ev.cond_int == 4 and ev.cond_var_true", True),
+ ("ev.cond_int == 3 or ev.cond_int == 1 and False", True),
+ ("1 < ev.cond_int < 5", True),
+ ("ev.cond_int > 2 == True", True),
+ ("ev.cond_var_false or ev.cond_var_true", True),
+ ("ev.cond_var_true + ev.cond_var_true == 2", True),
+ ("ev.cond_dbl[1] * 2 == 3.0", True),
+ ("-ev.cond_dbl[2] > 1", True),
+ ("ev.cond_ptr[1] == 1.5 or True", False),
+ ("ev.cond_ll == 9007199254740993", False),
+ ("ev.cond_int == '3'", False),
+ ("str(ev.cond_int) == '3'", False),
+]
+agree_expected = []
+agree_fired = []
+agree_events = []
+for ii, (cond, compiled) in enumerate(agree_tests):
+    try:
+        agree_expected.append(1 if eval(cond) else 0)
+    except:
+        agree_expected.append(0)
+    agree_fired.append(0)
+    agree_event = trick.new_event("agree" + str(ii))
+    agree_event.condition(0, cond)
+    agree_event.action(0, "agree_fired[" + str(ii) + "] = 1")
+    agree_event.activate()
+    trick.add_event(agree_event)
+    TRICK_EXPECT_EQ(agree_event.condition_compiled(0), compiled, test_suite, "compiled " + cond)
+    agree_events.append(agree_event)
+
 ##########################################################
 # TEST RESULTS AT SHUTDOWN
 result_event = trick.new_event("result_event")
@@ -219,6 +254,8 @@ TRICK_EXPECT_EQ(result[9], expected[9], test_suite, "event9")
 TRICK_EXPECT_EQ(result[10], expected[10], test_suite, "manual10")
 TRICK_EXPECT_EQ(result[11], expected[11], test_suite, "manual11")
 TRICK_EXPECT_EQ(result[12], expected[12], test_suite, "manual12")
+for ii, (cond, compiled) in enumerate(agree_tests):
+    TRICK_EXPECT_EQ(agree_fired[ii], agree_expected[ii], test_suite, "agree " + cond)
 """)
 result_event.activate() 
 trick.add_event_after(result_event, "ev.shutdown")
@@ -0,0 +1,155 @@
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "format_double.hh"
+
+/* Powers of ten that are exact doubles. */
+static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+ * Round value * 10^scale, which is below 2^54, to the nearest integer, ties
+ * to even, as printf does. The product or quotient is rounded to a double,
+ * hi, and what that leaves out is found exactly with fma, so only its sign
+ * and how it compares with one half are needed.
+ */
+static uint64_t round_scaled( double value, int scale, double hi) {
+
+    double p, lo, f;
+    int lo_sign, lo_half;
+    uint64_t m;
+
+    if (scale >= 0) {
+        p = powers_of_ten[scale];
+        lo = fma( value, p, -hi);
+        lo_sign = (lo > 0.0) - (lo < 0.0);
+        lo_half = (fabs(lo) > 0.5) - (fabs(lo) < 0.5);
+    } else {
+        // The remainder of a rounded quotient is exact; what is left out is lo / p.
+        p = powers_of_ten[-scale];
+        lo = fma( -hi, p, value);
+        lo_sign = (lo > 0.0) - (lo < 0.0);
+        lo_half = (fabs(lo) > 0.5 * p) - (fabs(lo) < 0.5 * p);
+    }
+
+    if (hi < 4503599627370496.0) {
+        // Below 2^52, hi has a fraction, a multiple of a step no more than
+        // 1/2, and what is left out is within half a step.
+        m = (uint64_t)hi;
+        f = hi - (double)m;
+        if (f > 0.5 || (f == 0.5 && (lo_sign > 0 || (lo_sign == 0 && (m & 1))))) {
+            m++;
+        }
+    } else {
+        // From 2^52, hi is a whole number, and what is left out no more than 1.
+        m = (uint64_t)hi;
+        if (lo_half > 0 || (lo_half == 0 && (m & 1))) {
+            m += (int64_t)lo_sign;
+        }
+    }
+    return m;
+}
+
+int format_double( char *buf, double value, int precision, bool upper) {
+
+    char digits[20];
+    char *cp = buf;
+    double original = value;
+    double hi;
+    uint64_t m, lower, upper_bound;
+    int exponent, scale, last, ii, tries;
+
+    if (value == 0.0) {
+        return sprintf( buf, signbit(value) ? "-0" : "0");
+    }
+    if (precision < 1 || precision > 16 || !isfinite(value)) {
+        return snprintf( buf, 32, upper ? "%.*G" : "%.*g", precision, value);
+    }
+
+    if (value < 0.0) {
+        *cp++ = '-';
+        value = -value;
+    }
+
+    // Find the power of ten that brings the value to precision digits. The
+    // estimate from the binary exponent is at most one too small. A value
+    // just short of the next power of ten may round up to it; that is left
+    // to the rounding below, which moves to the next exponent if need be.
+    lower = (uint64_t)powers_of_ten[precision - 1];
+    upper_bound = lower * 10;
+    exponent = (ilogb( value) * 78913) >> 18;
+    hi = 0.0;
+    for (tries = 0; tries < 3; tries++) {
+        scale = precision - 1 - exponent;
+        if (scale > 22 || scale < -22) {
+            return snprintf( buf, 32, upper ? "%.*G" : "%.*g", precision, original);
+        }
+        hi = (scale >= 0) ? value * powers_of_ten[scale] : value / powers_of_ten[-scale];
+        if (hi > (double)upper_bound) {
+            exponent++;
+        } else if (hi < (double)lower) {
+            exponent--;
+        } else {
+            break;
+        }
+    }
+
+    m = round_scaled( value, scale, hi);
+    if (m >= upper_bound) {
+        m /= 10;
+        exponent++;
+    }
+
+    for (ii = precision - 1; ii >= 0; ii--) {
+        digits[ii] = (char)('0' + m % 10);
+        m /= 10;
+    }
+    for (last = precision - 1; last > 0 && digits[last] == '0'; last--) {
+    }
+
+    if (exponent < precision && exponent >= -4) {
+        if (exponent >= 0) {
+            memcpy( cp, digits, exponent + 1);
+            cp += exponent + 1;
+            if (last > exponent) {
+                *cp++ = '.';
+                memcpy( cp, digits + exponent + 1, last - exponent);
+                cp += last - exponent;
+            }
+        } else {
+            *cp++ = '0';
+            *cp++ = '.';
+            for (ii = exponent + 1; ii < 0; ii++) {
+                *cp++ = '0';
+            }
+            memcpy( cp, digits, last + 1);
+            cp += last + 1;
+        }
+    } else {
+        *cp++ = digits[0];
+        if (last > 0) {
+            *cp++ = '.';
+            memcpy( cp, digits + 1, last);
+            cp += last;
+        }
+        *cp++ = upper ? 'E' : 'e';
+        if (exponent < 0) {
+            *cp++ = '-';
+            exponent = -exponent;
+        } else {
+            *cp++ = '+';
+        }
+        if (exponent >= 100) {
+            *cp++ = (char)('0' + exponent / 100);
+        }
+        *cp++ = (char)('0' + exponent / 10 % 10);
+        *cp++ = (char)('0' + exponent % 10);
+    }
+
+    *cp = '\0';
+    return (int)(cp - buf);
+}
@@ -0,0 +1,18 @@
+
+#ifndef FORMAT_DOUBLE_HH
+#define FORMAT_DOUBLE_HH
+
+/**
+ * Format a double as printf's "%.<precision>G" does, or "%.<precision>g" if
+ * upper is false, with the same digits, but several times faster.
+ *
+ * Values of precision 16 or less between about 1e-8 and 1e36 are rounded
+ * with exact arithmetic on the double itself; anything else is handed to
+ * snprintf.
+ *
+ * @param buf Holds at least 32 characters.
+ * @return The length of the text, which is null terminated.
+ */
+int format_double( char *buf, double value, int precision, bool upper);
+
+#endif
@@ -2,8 +2,12 @@
 #include <vector>
 #include <iostream>
 #include "Log/TrickBinary.hh"
+#include "Log/TrickBinaryFile.hh"
+#include "format_double.hh"
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
 
 static const char *usage_doc[] = {
 "----------------------------------------------------------------------------",
@@ -24,6 +28,12 @@ static const char *usage_doc[] = {
 "                          Change the default delimiter used in 'csv' & 'fix'",
 "                          ascii formats from comma separated \",\" to another ",
 "                          string (Note: do not use spaces before quotes).   ",
+"     params=\"<name>[,<name>...]\"                                            ",
+"                          Convert only these parameters, in this order.     ",
+"                          Only their values are read from the file.         ",
+"                                                                            ",
+" Records are formatted on one thread per processor. Set the environment     ",
+" variable TRICK_DP_THREADS to use another number of threads.                ",
 "                                                                            ",
 "----------------------------------------------------------------------------"};
 #define N_USAGE_LINES (sizeof(usage_doc)/sizeof(usage_doc[0]))
@@ -40,9 +50,183 @@ void usage() {
     print_doc((char **)usage_doc,N_USAGE_LINES);
 }
 
+enum {CSV, FIX, XML};
+
+// The conversion, shared by the threads that format records and the one
+// that writes them.
+struct Trk2AsciiConverter {
+    TrickBinaryFile *trk_file;
+    vector <int> columns;
+    int format;
+    string delimiter;
+    int num_records;
+    int chunk_records;
+    int num_chunks;
+
+    // Chunks of records are formatted into a ring of slots, and written out
+    // of them in order.
+    int next_chunk;
+    int next_write;
+    vector <string> slots;
+    vector <bool> ready;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+// Decode and format the records of one chunk.
+static void format_chunk( Trk2AsciiConverter *conv, int chunk, string &text) {
+
+    char buf[64];
+    int len;
+    int first = chunk * conv->chunk_records;
+    int count = conv->num_records - first;
+    size_t num_columns = conv->columns.size();
+    size_t ii, jj;
+
+    if (count > conv->chunk_records) {
+        count = conv->chunk_records;
+    }
+    vector <double> rows(count * num_columns);
+    conv->trk_file->decodeRows( conv->columns, first, count, &rows[0]);
+
+    text.clear();
+    for ( ii = 0; ii < (size_t)count; ii++ ) {
+        const double *row = &rows[ii * num_columns];
+        if ( conv->format == XML ) {
+            text.append("        <Row>");
+            for ( jj = 0; jj < num_columns; jj++ ) {
+                len = format_double(buf, row[jj], 15, true);
+                text.append("<Col>");
+                text.append(buf, len);
+                text.append("</Col>");
+            }
+            text.append("</Row>");
+        } else {
+            for ( jj = 0; jj < num_columns; jj++ ) {
+                if ( jj != 0) {
+                    text.append(conv->delimiter);
+                }
+                if ( conv->format == FIX ) {
+                    // %20.16g
+                    len = format_double(buf, row[jj], 16, false);
+                    if ( len < 20 ) {
+                        text.append(20 - len, ' ');
+                    }
+                } else {
+                    // %.15G
+                    len = format_double(buf, row[jj], 15, true);
+                }
+                text.append(buf, len);
+            }
+        }
+        text.push_back('\n');
+    }
+}
+
+static void *format_chunks_thread( void *arg ) {
+
+    Trk2AsciiConverter *conv = (Trk2AsciiConverter *)arg;
+    int chunk;
+    size_t slot;
+
+    pthread_mutex_lock( &conv->mutex);
+    for (;;) {
+        chunk = conv->next_chunk++;
+        if (chunk >= conv->num_chunks) {
+            break;
+        }
+        // Wait for the chunk last in this slot to be written.
+        while (chunk - conv->next_write >= (int)conv->slots.size()) {
+            pthread_cond_wait( &conv->cond, &conv->mutex);
+        }
+        pthread_mutex_unlock( &conv->mutex);
+
+        slot = chunk % conv->slots.size();
+        format_chunk( conv, chunk, conv->slots[slot]);
+
+        pthread_mutex_lock( &conv->mutex);
+        conv->ready[slot] = true;
+        pthread_cond_broadcast( &conv->cond);
+    }
+    pthread_mutex_unlock( &conv->mutex);
+    return NULL;
+}
+
+// Format the records on several threads and write them in order, a chunk at a time.
+static void convert_records( Trk2AsciiConverter *conv, FILE *fp ) {
+
+    vector <pthread_t> threads;
+    const char *env_threads;
+    long n_threads;
+    int chunk;
+    size_t slot;
+
+    // About a megabyte of decoded values per chunk.
+    conv->chunk_records = (1 << 17) / (conv->columns.size() > 0 ? conv->columns.size() : 1);
+    if (conv->chunk_records < 16) {
+        conv->chunk_records = 16;
+    }
+    conv->num_chunks = (conv->num_records + conv->chunk_records - 1) / conv->chunk_records;
+
+    // One thread per processor, unless TRICK_DP_THREADS says otherwise.
+    if ((env_threads = getenv("TRICK_DP_THREADS")) != NULL) {
+        n_threads = atol( env_threads);
+    } else {
+        n_threads = sysconf( _SC_NPROCESSORS_ONLN);
+    }
+    if (n_threads > conv->num_chunks) {
+        n_threads = conv->num_chunks;
+    }
+    if (n_threads < 1) {
+        n_threads = 1;
+    }
+
+    conv->next_chunk = 0;
+    conv->next_write = 0;
+    conv->slots.resize( 2 * n_threads);
+    conv->ready.assign( 2 * n_threads, false);
+    pthread_mutex_init( &conv->mutex, NULL);
+    pthread_cond_init( &conv->cond, NULL);
+
+    // This thread writes.
+    threads.resize( n_threads);
+    for (slot = 0; slot < threads.size(); slot++) {
+        if (pthread_create( &threads[slot], NULL, format_chunks_thread, conv) != 0) {
+            threads.resize( slot);
+            break;
+        }
+    }
+
+    for (chunk = 0; chunk < conv->num_chunks; chunk++) {
+        slot = chunk % conv->slots.size();
+        if (threads.empty()) {
+            format_chunk( conv, chunk, conv->slots[slot]);
+        } else {
+            pthread_mutex_lock( &conv->mutex);
+            while (!conv->ready[slot]) {
+                pthread_cond_wait( &conv->cond, &conv->mutex);
+            }
+            pthread_mutex_unlock( &conv->mutex);
+        }
+
+        fwrite( conv->slots[slot].data(), 1, conv->slots[slot].size(), fp);
+
+        pthread_mutex_lock( &conv->mutex);
+        conv->ready[slot] = false;
+        conv->next_write++;
+        pthread_cond_broadcast( &conv->cond);
+        pthread_mutex_unlock( &conv->mutex);
+    }
+
+    for (slot = 0; slot < threads.size(); slot++) {
+        pthread_join( threads[slot], NULL);
+    }
+    pthread_cond_destroy( &conv->cond);
+    pthread_mutex_destroy( &conv->mutex);
+}
+
 int main(int argc, char* argv[])
 {
-    double t, y ;
     char *trk_file_name = NULL;
     char *ascii_file_name = NULL;
     FILE *fp;
@@ -50,17 +234,18 @@ int main(int argc, char* argv[])
     int number_of_parameters;
     char ** param_names;
     char ** param_units;
-    enum {CSV, FIX, XML};
     int Format=0;  /* default to csv */
     string delimiter(",");  /* default delimter */
 
-    int i, done;
+    int i;
     char *prog_name = argv[0];
 
-    DataStream* each_ds;
-    vector <DataStream*> ds_list;
-    // idx is used when comparing with the size() of the vector
-    vector <DataStream*>::size_type idx;
+    // Records are read straight from the mapped log file, only the columns converted.
+    TrickBinaryFile* trk_file;
+    Trk2AsciiConverter conv;
+    vector <string> subset;
+    // header names and units of the columns converted
+    vector <int> headers;
 
     if (argc <= 1 ) {
         cerr << prog_name << ": No arguments were supplied.\n";
@@ -95,6 +280,18 @@ int main(int argc, char* argv[])
                 }
             } else if (option.find(".trk") != string::npos) {
                 trk_file_name = strdup( option.c_str() );
+            } else if (option.compare(0, 7, "params=") == 0) {
+                string::size_type start = 7, comma;
+                while (start <= option.length()) {
+                    comma = option.find(',', start);
+                    if (comma == string::npos) {
+                        comma = option.length();
+                    }
+                    if (comma > start) {
+                        subset.push_back(option.substr(start, comma - start));
+                    }
+                    start = comma + 1;
+                }
             } else if (option.find("delim") != string::npos) {
                 found_it = option.find_first_of("=");
                 if (found_it>=0) {
@@ -146,6 +343,35 @@ int main(int argc, char* argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (( trk_file = TrickBinaryFile::open(trk_file_name)) == NULL ) {
+        cerr << "Unable to read the Trk data log file.\n";
+        cerr.flush();
+        exit(EXIT_FAILURE);
+    }
+
+    // Every parameter, or those asked for, by the index the readers have always used.
+    if (subset.empty()) {
+        for ( i=0; i<number_of_parameters; i++ ) {
+            headers.push_back(i);
+            conv.columns.push_back(trk_file->findParam(param_names[i]));
+        }
+    } else {
+        for ( i=0; i<(int)subset.size(); i++ ) {
+            int index = trk_file->findParam(subset[i].c_str());
+            if (index < 0) {
+                cerr << "\"" << subset[i] << "\" is not in the Trk data log file.\n";
+                cerr.flush();
+                exit(EXIT_FAILURE);
+            }
+            headers.push_back(index);
+            conv.columns.push_back(index);
+        }
+    }
+    conv.trk_file = trk_file;
+    conv.format = Format;
+    conv.delimiter = delimiter;
+    conv.num_records = trk_file->getNumRecords();
+
     string ascii_title("Results");
     if (ascii_file_name != NULL) {
         ascii_title = ascii_file_name;
@@ -157,43 +383,17 @@ int main(int argc, char* argv[])
     /* Strip off log_ prefix extension */
     ascii_title.erase(ascii_title.find_first_of("log_"), (ascii_title.find_first_of("log_")+4));
 
-    char buf[64] ;
-    string current_line;
     switch ( Format ) {
         case XML:
             fprintf(fp,"<DataTable name=\"%s\">\n", ascii_title.c_str());
             fprintf(fp,"%4s<Columns>\n", "");
-            for ( i=0; i<number_of_parameters; i++ ) {
-                fprintf(fp, "%8s<Column name=\"%s\" units=\"%s\" />\n", "", param_names[i], param_units[i]);
-                if (( each_ds = new TrickBinary(trk_file_name, param_names[i] )) == NULL) {
-                    cerr << ".\n";
-                    cerr.flush();
-                    exit(EXIT_FAILURE);
-                } else {
-                    ds_list.push_back(each_ds);
-                }
+            for ( i=0; i<(int)headers.size(); i++ ) {
+                fprintf(fp, "%8s<Column name=\"%s\" units=\"%s\" />\n", "", param_names[headers[i]], param_units[headers[i]]);
             }
             fprintf(fp,"%4s</Columns>\n", "");
 
             fprintf(fp,"%4s<Data>\n", "");
-            done = 0;
-            while ( !done ) {
-                current_line.clear();
-                snprintf(buf, sizeof(buf), "%8s<Row>", "");
-                current_line.append(buf);
-                for ( idx = 0; idx < ds_list.size(); idx++ ) {
-                    if ( ds_list[idx]->get( &t, &y) == 0 ) {
-                        done = 1;
-                        break;
-                    }
-                    snprintf(buf, sizeof(buf), "<Col>%.15G</Col>", y);
-                    current_line.append(buf);
-                }
-                current_line.append("</Row>");
-                if ( !done ) {
-                    fprintf(fp, "%s\n", current_line.c_str());
-                }
-            }
+            convert_records(&conv, fp);
             fprintf(fp,"%4s</Data>\n", "");
             fprintf(fp,"</DataTable>\n");
             break;
@@ -201,57 +401,26 @@ int main(int argc, char* argv[])
         case CSV:
         case FIX:
         default:
-            for ( i=0; i<number_of_parameters; i++ ) {
+            for ( i=0; i<(int)headers.size(); i++ ) {
                 if (i == 0) {
-                    fprintf(fp,"%s {%s}",param_names[0], param_units[i]);
+                    fprintf(fp,"%s {%s}",param_names[headers[i]], param_units[headers[i]]);
                 } else {
-                    fprintf(fp,"%s%s {%s}", delimiter.c_str(), param_names[i], param_units[i]);
-                }
-
-                if (( each_ds = new TrickBinary(trk_file_name, param_names[i] )) == NULL) {
-                    cerr << ".\n";
-                    cerr.flush();
-                    exit(EXIT_FAILURE);
-                } else {
-                    ds_list.push_back(each_ds);
+                    fprintf(fp,"%s%s {%s}", delimiter.c_str(), param_names[headers[i]], param_units[headers[i]]);
                 }
             }
 
             fprintf(fp,"\n");
 
-            done = 0;
-            while ( !done ) {
-                current_line.clear();
-                for ( idx = 0; idx < ds_list.size(); idx++ ) {
-                    if ( ds_list[idx]->get( &t, &y) == 0 ) {
-                        done = 1;
-                        break;
-                    }
-                    if ( idx != 0) {
-                        snprintf(buf, sizeof(buf), "%s", delimiter.c_str());
-                        current_line.append(buf);
-                    }
-                    if ( Format == FIX ) {
-                        snprintf(buf, sizeof(buf), "%20.16g", y);
-                        current_line.append(buf);
-                    } else {
-                        snprintf(buf, sizeof(buf), "%.15G", y);
-                        current_line.append(buf);
-                    }
-                }
-                if ( !done ) {
-                    fprintf(fp, "%s\n", current_line.c_str());
-                }
-            }
+            convert_records(&conv, fp);
             break;
     }
 
-    // release memory for the DataStream list
-    // vector clear function won't delete objects created by new
-    for ( idx = 0; idx < ds_list.size(); idx++) {
-        delete ds_list[idx];
+    if (fp != stdout) {
+        fclose(fp);
     }
-    ds_list.clear();
+
+    // release the log file
+    TrickBinaryFile::close(trk_file);
 
     // relese memory for the name list
     for (i = 0; i < number_of_parameters; i ++) {
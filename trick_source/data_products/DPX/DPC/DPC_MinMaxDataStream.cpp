@@ -0,0 +1,194 @@
+
+#include <math.h>
+#include <algorithm>
+#include "DPC/DPC_MinMaxDataStream.hh"
+
+// CONSTRUCTOR
+DPC_MinMaxDataStream::DPC_MinMaxDataStream(DataStream* in_ds, int buckets) {
+
+  this->ds = in_ds;
+  this->max_buckets = (buckets > 0) ? buckets : 1;
+  this->reduced = false;
+  this->next_point = 0;
+  this->time0 = 0.0;
+  this->width = 0.0;
+  this->bucket_start = 0.0;
+}
+
+// DESTRUCTOR
+DPC_MinMaxDataStream::~DPC_MinMaxDataStream() {
+  if (ds) delete ds;
+}
+
+// MEMBER FUNCTION
+bool DPC_MinMaxDataStream::earlier(const Point &a, const Point &b) {
+  return (a.index < b.index);
+}
+
+// MEMBER FUNCTION
+void DPC_MinMaxDataStream::reduce() {
+
+  double t, v;
+  Point p;
+  Point kept[4];
+  long long count = 0;
+  size_t ii;
+  int jj, n_kept;
+
+  buckets.clear();
+  ds->begin();
+
+  while (ds->get(&t, &v)) {
+    p.time = t;
+    p.value = v;
+    p.index = count++;
+
+    // Does the point fall in the current bucket?
+    if (!buckets.empty() &&
+        ((width > 0.0 && t >= bucket_start && t < bucket_start + width) ||
+         (width == 0.0 && t == bucket_start))) {
+      Bucket &b = buckets.back();
+      if (v < b.min.value) b.min = p;
+      if (v > b.max.value) b.max = p;
+      b.last = p;
+      continue;
+    }
+
+    if (buckets.empty()) {
+      time0 = t;
+    } else if (width == 0.0 && buckets.size() == 1 && t > time0) {
+      // Start one sample period wide.
+      width = t - time0;
+    }
+
+    if (width > 0.0) {
+      bucket_start = time0 + floor((t - time0) / width) * width;
+    } else {
+      bucket_start = t;
+    }
+    Bucket b = { p, p, p, p };
+    buckets.push_back(b);
+
+    if ((int)buckets.size() >= 2 * max_buckets) {
+      merge_buckets();
+    }
+  }
+
+  // Supply the kept points of each bucket in their original order.
+  points.clear();
+  for (ii = 0; ii < buckets.size(); ii++) {
+    kept[0] = buckets[ii].first;
+    kept[1] = buckets[ii].min;
+    kept[2] = buckets[ii].max;
+    kept[3] = buckets[ii].last;
+    std::sort(kept, kept + 4, earlier);
+    n_kept = 0;
+    for (jj = 0; jj < 4; jj++) {
+      if (n_kept == 0 || kept[jj].index != kept[n_kept - 1].index) {
+        kept[n_kept++] = kept[jj];
+      }
+    }
+    points.insert(points.end(), kept, kept + n_kept);
+  }
+  buckets.clear();
+
+  reduced = true;
+  next_point = 0;
+}
+
+// MEMBER FUNCTION
+// Merge each pair of neighbouring buckets and double the width of those to come.
+void DPC_MinMaxDataStream::merge_buckets() {
+
+  size_t ii, n_merged;
+
+  n_merged = 0;
+  for (ii = 0; ii < buckets.size(); ii += 2) {
+    Bucket b = buckets[ii];
+    if (ii + 1 < buckets.size()) {
+      const Bucket &next = buckets[ii + 1];
+      if (next.min.value < b.min.value) b.min = next.min;
+      if (next.max.value > b.max.value) b.max = next.max;
+      b.last = next.last;
+    }
+    buckets[n_merged++] = b;
+  }
+  buckets.resize(n_merged);
+
+  // Times need not increase; if the source has gone back in time, the
+  // buckets are still merged, which bounds their number regardless.
+  width = std::max(2.0 * width,
+                   (buckets.back().last.time - time0) / max_buckets);
+  if (width > 0.0) {
+    bucket_start = time0 + floor((buckets.back().last.time - time0) / width) * width;
+  }
+}
+
+// MEMBER FUNCTION
+int DPC_MinMaxDataStream::get(double* timestamp, double* paramValue) {
+
+  if (!reduced) reduce();
+  if (next_point < points.size()) {
+    *timestamp = points[next_point].time;
+    *paramValue = points[next_point].value;
+    next_point++;
+    return(1);
+  }
+  // Like the other streams, leave the last point at the end.
+  if (!points.empty()) {
+    *timestamp = points.back().time;
+    *paramValue = points.back().value;
+  }
+  return(0);
+}
+
+// MEMBER FUNCTION
+int DPC_MinMaxDataStream::peek(double* timestamp, double* paramValue) {
+
+  if (!reduced) reduce();
+  if (next_point < points.size()) {
+    *timestamp = points[next_point].time;
+    *paramValue = points[next_point].value;
+    return(1);
+  }
+  return(0);
+}
+
+// MEMBER FUNCTION
+std::string DPC_MinMaxDataStream::getFileName() {
+  return ds->getFileName();
+}
+
+// MEMBER FUNCTION
+std::string DPC_MinMaxDataStream::getUnit() {
+  return ds->getUnit();
+}
+
+// MEMBER FUNCTION
+std::string DPC_MinMaxDataStream::getTimeUnit() {
+  return ds->getTimeUnit();
+}
+
+// MEMBER FUNCTION
+// The source is not read until a point is wanted, so a curve can be
+// reduced on whichever thread loads it.
+void DPC_MinMaxDataStream::begin() {
+  next_point = 0;
+}
+
+// MEMBER FUNCTION
+int DPC_MinMaxDataStream::end() {
+  if (!reduced) reduce();
+  if (next_point >= points.size()) return (1);
+  return(0);
+}
+
+// MEMBER FUNCTION
+int DPC_MinMaxDataStream::step() {
+  if (!reduced) reduce();
+  if (next_point < points.size()) {
+    next_point++;
+    return (1);
+  }
+  return(0);
+}
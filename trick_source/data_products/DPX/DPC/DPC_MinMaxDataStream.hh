@@ -0,0 +1,123 @@
+
+#ifndef DPC_MINMAXDATASTREAM_HH
+#define DPC_MINMAXDATASTREAM_HH
+
+#include <string>
+#include <vector>
+#include "../../Log/DataStream.hh"
+
+/**
+ * DPC_MinMaxDataStream is a DataStream that reduces another to about as many
+ * points as a plot of it can show, without changing how the plot looks.
+ *
+ * Time is divided into buckets, and of the points of each bucket only the
+ * first, the last, the one with the smallest value and the one with the
+ * largest value are supplied, in their original order. Drawn with lines at
+ * one or more buckets per pixel, these trace the same envelope as all of the
+ * points (the M4 method).
+ *
+ * The source is read once, when the first point is wanted, and the time it
+ * spans need not be known beforehand: buckets start one sample period wide,
+ * and whenever there are twice as many as asked for, neighbouring buckets
+ * are merged and the width doubled. Memory therefore stays within a few
+ * points per bucket however long the source.
+ */
+class DPC_MinMaxDataStream : public DataStream {
+
+public:
+  /**
+   * Constructor.
+   * @param ds A pointer to the DataStream object to be reduced.
+   * @param buckets The number of buckets, at least, the points are reduced to;
+   * the width of the plot in pixels.
+   */
+  DPC_MinMaxDataStream(DataStream* ds, int buckets);
+
+  /**
+   * Destructor.
+   */
+  ~DPC_MinMaxDataStream();
+
+  /**
+   * Get the timestamp/value pair at the current position in the DataStream
+   * and move to the next position.
+   * @param timestamp the timestamp value returned from the DataStream.
+   * @param paramValue the parameter value returned from the DataStream.
+   * @return 1 if a time/value pair was returned, 0 otherwise.
+   */
+  int get(double* timestamp, double* paramValue);
+
+  /**
+   * Get the timestamp/value pair at the current position in the DataStream
+   * but do not move to the next position.
+   * @param timestamp the timestamp value returned from the DataStream.
+   * @param paramValue the parameter value returned from the DataStream.
+   * @return 1 if a time/value pair was returned, 0 otherwise.
+   */
+  int peek(double* timestamp, double* paramValue);
+
+  /**
+   * Return the name of the file from which the data is being streamed.
+   */
+  std::string getFileName();
+
+  /**
+   * Return the data's units of measure.
+   */
+  std::string getUnit();
+
+  /**
+   * Return the units of measure for timestamps.
+   */
+  std::string getTimeUnit();
+
+  /**
+   * Set the DataStream to read from the beginning.
+   */
+  void begin();
+
+  /**
+   * Test for the end of the DataStream.
+   * @return 1 if the end of the DataStream has been reached, 0 otherwise.
+   */
+  int end();
+
+  /**
+   * Progress forward one position in the DataStream.
+   * @return 1 if we progressed, 0 otherwise.
+   */
+  int step();
+
+private:
+
+  struct Point {
+    double time;
+    double value;
+    long long index;
+  };
+
+  struct Bucket {
+    Point first;
+    Point min;
+    Point max;
+    Point last;
+  };
+
+  static bool earlier(const Point &a, const Point &b);
+  void reduce();
+  void merge_buckets();
+
+  DataStream *ds;
+  int max_buckets;
+  bool reduced;
+  size_t next_point;
+  std::vector<Point> points;
+
+  // State of the reduction.
+  std::vector<Bucket> buckets;
+  double time0;
+  double width;
+  double bucket_start;
+};
+
+#endif
@@ -152,3 +152,8 @@ int DPC_UnitConvDataStream::end() {
 int DPC_UnitConvDataStream::step() {
     return( source_ds->step());
 }
+
+// MEMBER FUNCTION
+int DPC_UnitConvDataStream::seek(double time) {
+    return( source_ds->seek(time));
+}
@@ -87,6 +87,12 @@ public:
      */
     int step();
 
+    /**
+     * Move to the first record at or after the given time.
+     * @return 1 if there is such a record, 0 otherwise.
+     */
+    int seek(double time);
+
 private:
 
     cv_converter * cf ;
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 #include "DPM/DPM_var.hh"
 #include "DPV/DPV_view.hh"
 
@@ -22,6 +23,10 @@ public:
         x_var = NULL;
         y_var = NULL;
         view_data = NULL;
+        loaded = false;
+        next_point = 0;
+        x_final = 0.0;
+        y_final = 0.0;
     }
 
     /**
@@ -91,18 +96,48 @@ public:
     }
 
     /**
-     * Get the next (X, Y) pair for the curve.
+     * Get the next (X, Y) pair for the curve, from memory once the curve is loaded.
      * @return 1 if data was returned in x_value and y_value, 0 if there is no more data.
      */
-    virtual int getXY(double *, double *) {
-        return 0;
+    int getXY(double *x_value, double *y_value) {
+        if (!loaded) {
+            return( readXY( x_value, y_value));
+        }
+        if (next_point < x_points.size()) {
+            *x_value = x_points[next_point];
+            *y_value = y_points[next_point];
+            next_point++;
+            return(1);
+        }
+        // The values the source left on its last, unsuccessful read.
+        *x_value = x_final;
+        *y_value = y_final;
+        return(0);
+    }
+
+    /**
+     * Reset a loaded curve, so getXY() will get points from the beginning.
+     */
+    void begin() {
+        next_point = 0;
     }
 
     /**
-     * Reset the source DataStreams for this curve to their beginnings, so
-     * getXY() will get points from the beginning.
+     * Read all of the (X, Y) pairs of the curve into memory. DPC_product
+     * loads the curves of a product this way, several at once.
      */
-    void begin() {}
+    void load() {
+        double x = 0.0;
+        double y = 0.0;
+        while ( readXY( &x, &y)) {
+            x_points.push_back(x);
+            y_points.push_back(y);
+        }
+        x_final = x;
+        y_final = y;
+        next_point = 0;
+        loaded = true;
+    }
 
     /**
      * Tell the view to create an external representation of this DPC_curve object.
@@ -126,11 +161,27 @@ public:
     void emphasize( DPV_view *view, DPV_message msg );
 
 protected:
+    /**
+     * Read the next (X, Y) pair of the curve from its DataStreams.
+     * @return 1 if data was returned in x_value and y_value, 0 if there is no more data.
+     */
+    virtual int readXY(double *, double *) {
+        return 0;
+    }
+
     DPM_var* x_var;
     DPM_var* y_var;
 
 private:
     DPV_pointer view_data;
 
+    // The points of a loaded curve.
+    bool loaded;
+    size_t next_point;
+    std::vector<double> x_points;
+    std::vector<double> y_points;
+    double x_final;
+    double y_final;
+
 };
 #endif
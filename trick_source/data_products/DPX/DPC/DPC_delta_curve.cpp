@@ -10,7 +10,7 @@ DPC_delta_curve::DPC_delta_curve( DPM_curve*               Curve_spec,
                                   DPM_run*                 RUN2,
                                   DPC_datastream_supplier *ds_supplier,
                                   DPM_time_constraints    *Time_constraints )
-    : DPC_curve()
+    : DPC_curve(), delta_align(T_TOLERANCE, DeltaAlign::MATCH)
 {
 
     char work[255];
@@ -30,6 +30,8 @@ DPC_delta_curve::DPC_delta_curve( DPM_curve*               Curve_spec,
     DPM_var * run2_y_var;
 
     time_conversion = NULL;
+    aligned = false;
+    next_delta = 0;
 
     run_dir1 = strdup( RUN1->getDir());
     run_dir2 = strdup( RUN2->getDir());
@@ -197,27 +199,36 @@ const char *DPC_delta_curve::getDataSrcLbl() {
 }
 
 // MEMBER FUNCTION
-int DPC_delta_curve::getXY(double *X_value, double *Y_value) {
-
-    double t1,t2,v1,v2;
-    int eos;
-    int e0, e1;
-
+// Read both runs and take their difference, a column at a time. A point is
+// made wherever the runs have the same time; the earlier of two times that
+// differ is skipped.
+void DPC_delta_curve::align() {
+
+    std::vector<double> t1, v1;
+    std::vector<double> t2, v2;
+
+    DeltaAlign::read( ds[0], t1, v1);
+    DeltaAlign::read( ds[1], t2, v2);
+    delta_align.align( t1, t2);
+    delta_align.difference( v1, v2, y_deltas);
+
+    x_deltas = delta_align.getTimes();
+    if (!x_deltas.empty()) {
+        cv_convert_doubles( time_conversion, &x_deltas[0], x_deltas.size(), &x_deltas[0]);
+    }
+    aligned = true;
+}
 
-    e0 = ds[0]->get( &t1, &v1);
-    e1 = ds[1]->get( &t2, &v2);
-    eos = !(e0 && e1);
+// MEMBER FUNCTION
+int DPC_delta_curve::readXY(double *X_value, double *Y_value) {
 
-    while (!eos && ( fabs( t1 - t2) > T_TOLERANCE )) {
-        if (t1 < t2) {
-            eos = ! ds[0]->get( &t1, &v1);
-        } else {
-            eos = ! ds[1]->get( &t2, &v2);
-        }
+    if (!aligned) {
+        align();
     }
-    if (!eos) {
-        *X_value = cv_convert_double(time_conversion,t1);
-        *Y_value = v1 - v2;
+    if (next_delta < x_deltas.size()) {
+        *X_value = x_deltas[next_delta];
+        *Y_value = y_deltas[next_delta];
+        next_delta++;
         return(1);
     }
 
@@ -226,7 +237,6 @@ int DPC_delta_curve::getXY(double *X_value, double *Y_value) {
 
 // MEMBER FUNCTION
 void DPC_delta_curve::begin() {
-    if (ds[0]) ds[0]->begin();
-    if (ds[1]) ds[1]->begin();
+    next_delta = 0;
 }
 
@@ -5,8 +5,10 @@
 #include "DPC/DPC_curve.hh"
 #include "DPC/DPC_datastream_supplier.hh"
 #include "DPM/DPM_run.hh"
+#include "../../Log/DeltaAlign.hh"
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <udunits2.h>
 
 /**
@@ -47,21 +49,30 @@ public:
      */
     const char *getDataSrcLbl();
 
-    /**
-     * Get the next (X, Y) pair for the curve.
-     * @return 1 if data was returned in x_value and y_value, 0 if there is no more data.
-     */
-    int getXY(double *x_value, double *y_value);
-
     /**
      * Reset the source DataStreams for this curve to their beginnings, so
      * getXY() will get points from the beginning.
      */
     void begin();
 
+protected:
+
+    /**
+     * Read the next (X, Y) pair for the curve from its DataStreams.
+     * @return 1 if data was returned in x_value and y_value, 0 if there is no more data.
+     */
+    int readXY(double *x_value, double *y_value);
+
 private:
 
+    void align();
+
     DataStream *ds[2];
+    DeltaAlign delta_align;
+    bool aligned;
+    size_t next_delta;
+    std::vector<double> x_deltas;
+    std::vector<double> y_deltas;
     DPM_var * delta_x_var;
     DPM_var * delta_y_var;
     char * x_actual_units;
@@ -46,6 +46,21 @@ public:
      */
     void notify( DPV_view *view, DPV_message msg);
 
+    /**
+     * Returns the number of DPC_plot objects contained by this DPC_page.
+     */
+    int NumberOfPlots() {
+        return( (int)plot_list.size());
+    }
+
+    /**
+     * Return a pointer to the i'th DPC_plot object contained in the DPC_page,
+     * or NULL if the index is invalid.
+     */
+    DPC_plot *getPlot( unsigned int index) {
+        return( (index < plot_list.size()) ? plot_list[index] : NULL);
+    }
+
 // ============================
 // DPV_VIEW INTERFACE FUNCTIONS
 // ============================
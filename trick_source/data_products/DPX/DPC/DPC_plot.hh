@@ -51,6 +51,13 @@ public:
         return( (int)curve_list.size());
     }
 
+    /**
+     * Return a pointer to the i'th curve of the plot, or NULL if the index is invalid.
+     */
+    DPC_curve *getCurve( unsigned int index) {
+        return( (index < curve_list.size()) ? curve_list[index] : NULL);
+    }
+
     /**
      * Set the title of the plot.
      */
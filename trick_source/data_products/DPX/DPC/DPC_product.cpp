@@ -6,9 +6,10 @@
 #include <libxml/tree.h>
 
 #include <fcntl.h>  // for open()
-#include <unistd.h> // for link()
+#include <unistd.h> // for link(), sysconf()
 #include <stdlib.h> // for getenv()
 #include <string.h> // for strlen()
+#include <pthread.h>
 
 DPC_product::DPC_product( DPM_session          *Session,
                           const char           *ProductFileName
@@ -86,6 +87,8 @@ DPC_product::DPC_product( DPM_session          *Session,
             }
 
         }
+
+        load_curves();
     }
 
     if ((session_mode == NULL) || (strcasecmp( session_mode, "table") == 0)) {
@@ -139,6 +142,83 @@ DPC_product::~DPC_product() {
     }
 }
 
+// The curves left to load, shared by the loading threads.
+struct DPC_curve_loader {
+    std::vector <DPC_curve *> curves;
+    size_t next;
+    pthread_mutex_t mutex;
+};
+
+static void *load_curves_thread( void *arg ) {
+
+    DPC_curve_loader *loader = (DPC_curve_loader *)arg;
+    size_t curvix;
+
+    for (;;) {
+        pthread_mutex_lock( &loader->mutex);
+        curvix = loader->next++;
+        pthread_mutex_unlock( &loader->mutex);
+        if (curvix >= loader->curves.size()) {
+            break;
+        }
+        loader->curves[curvix]->load();
+    }
+    return NULL;
+}
+
+// MEMBER FUNCTION
+void DPC_product::load_curves() {
+
+    DPC_curve_loader loader;
+    std::vector <pthread_t> threads;
+    const char *env_threads;
+    long n_threads;
+    int pagix, plotix, curvix;
+
+    for (pagix = 0 ; pagix < (int)page_list.size() ; pagix++) {
+        DPC_page *page = page_list[pagix];
+        for (plotix = 0 ; plotix < page->NumberOfPlots() ; plotix++) {
+            DPC_plot *plot = page->getPlot( plotix);
+            for (curvix = 0 ; curvix < plot->getNumCurves() ; curvix++) {
+                loader.curves.push_back( plot->getCurve( curvix));
+            }
+        }
+    }
+
+    // One thread per processor, unless TRICK_DP_THREADS says otherwise.
+    if ((env_threads = getenv("TRICK_DP_THREADS")) != NULL) {
+        n_threads = atol( env_threads);
+    } else {
+        n_threads = sysconf( _SC_NPROCESSORS_ONLN);
+    }
+    if (n_threads > (long)loader.curves.size()) {
+        n_threads = (long)loader.curves.size();
+    }
+
+    // With one thread the curves are read as they are rendered, as always.
+    if (n_threads <= 1) {
+        return;
+    }
+
+    loader.next = 0;
+    pthread_mutex_init( &loader.mutex, NULL);
+
+    // This thread loads curves too.
+    threads.resize( n_threads - 1);
+    for (curvix = 0 ; curvix < (int)threads.size() ; curvix++) {
+        if (pthread_create( &threads[curvix], NULL, load_curves_thread, &loader) != 0) {
+            threads.resize( curvix);
+            break;
+        }
+    }
+    load_curves_thread( &loader);
+    for (curvix = 0 ; curvix < (int)threads.size() ; curvix++) {
+        pthread_join( threads[curvix], NULL);
+    }
+
+    pthread_mutex_destroy( &loader.mutex);
+}
+
 // MEMBER FUNCTION
 const char *DPC_product::getTitle() {
     return ( product_spec->getTitle());
@@ -84,6 +84,12 @@ public:
 
 private:
 
+    /**
+     * Load the curves of every page, several at once, so rendering them,
+     * which stays in order, reads them from memory.
+     */
+    void load_curves();
+
     DPM_product *product_spec;
     DPC_datastream_supplier *datastream_supplier;
     std::vector <DPC_page *> page_list;
@@ -2,6 +2,7 @@
 #include <udunits2.h>
 
 #include "DPC/DPC_std_curve.hh"
+#include "DPC/DPC_MinMaxDataStream.hh"
 #include "math.h"
 
 extern ut_system * u_system ;
@@ -106,6 +107,15 @@ DPC_std_curve::DPC_std_curve(
                                                 Time_constraints );
             if (ds[0] != NULL) {
 
+                // If TRICK_DP_PLOT_WIDTH gives the width of the plots in pixels,
+                // keep only the points of A(t) that change how it looks at that
+                // width. Only <t,A(t)> curves are reduced, as the points of the
+                // two DataStreams of other curves must stay paired by time.
+                const char* env_width = getenv("TRICK_DP_PLOT_WIDTH");
+                if ((env_width != NULL) && (atoi( env_width) > 0)) {
+                    ds[0] = new DPC_MinMaxDataStream( ds[0], atoi( env_width));
+                }
+
                 const char* ds_units = ds[0]->getUnit().c_str();
 
                 y_actual_units = strdup(ds_units);
@@ -231,7 +241,7 @@ const char *DPC_std_curve::getDataSrcLbl() {
 }
 
 // MEMBER FUNCTION
-int DPC_std_curve::getXY(double *X_value, double *Y_value) {
+int DPC_std_curve::readXY(double *X_value, double *Y_value) {
 
     double t1,t2,v1,v2;
     int eos;
@@ -47,18 +47,20 @@ public:
      */
     const char *getDataSrcLbl();
 
-    /**
-     * Get the next (X, Y) pair for the curve.
-     * @return 1 if data was returned in x_value and y_value, 0 if there is no more data.
-     */
-    int getXY(double *x_value, double *y_value);
-
     /**
      * Reset the source DataStreams for this curve to their beginnings, so
      * getXY() will get points from the beginning.
      */
     void begin();
 
+protected:
+
+    /**
+     * Read the next (X, Y) pair for the curve from its DataStreams.
+     * @return 1 if data was returned in x_value and y_value, 0 if there is no more data.
+     */
+    int readXY(double *x_value, double *y_value);
+
 private:
 
     DataStream *ds[2];
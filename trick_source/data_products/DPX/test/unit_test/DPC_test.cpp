@@ -685,6 +685,19 @@ TEST_F(DPCTest, ComparisonCurves) {
     EXPECT_EQ(result, 0);
 }
 
+// Session 9_1, curves loaded on several threads
+TEST_F(DPCTest, ComparisonCurves_Threads) {
+
+    setenv("TRICK_DP_THREADS", "1", 1);
+    std::string serial = parseDPCData(testxml[10].c_str());
+    setenv("TRICK_DP_THREADS", "4", 1);
+    std::string threaded = parseDPCData(testxml[10].c_str());
+    unsetenv("TRICK_DP_THREADS");
+
+    EXPECT_FALSE(serial.empty());
+    EXPECT_EQ(serial, threaded);
+}
+
 // Session 9_2
 TEST_F(DPCTest, DeltaCurves) {
 	//req.add_requirement("2904854297");
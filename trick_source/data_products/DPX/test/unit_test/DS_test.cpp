@@ -4,8 +4,10 @@
 #include <string.h>
 #include "Log/DataStream.hh"
 #include "Log/DataStreamFactory.hh"
+#include "Log/DeltaAlign.hh"
 #include "DPC/DPC_UnitConvDataStream.hh"
 #include "DPC/DPC_TimeCstrDataStream.hh"
+#include "DPC/DPC_MinMaxDataStream.hh"
 #include "DPM/DPM_time_constraints.hh"
 
 #include "gtest/gtest.h"
@@ -191,6 +193,93 @@ TEST_F(DSTest, DataStream_Ascii) {
 	delete data_stream_factory;
 }
 
+// ASCII (CSV) DATASTREAMS SHARING ONE FILE
+TEST_F(DSTest, DataStream_Ascii_Shared) {
+
+	double time, value;
+	DataStream *azimuth, *clock;
+	CsvFile *file1, *file2;
+
+	RUN_dir = "../TEST_DATA/RUN_ASCII";
+
+    data_stream_factory = new DataStreamFactory();
+    azimuth = data_stream_factory->create(RUN_dir, "sun_predictor.sun.solar_azimuth", NULL);
+    clock = data_stream_factory->create(RUN_dir, "sys.exec.out.time", NULL);
+    ASSERT_TRUE(azimuth != NULL);
+    ASSERT_TRUE(clock != NULL);
+
+	// BOTH STREAMS READ THE SAME SHARED FILE
+    file1 = CsvFile::open("../TEST_DATA/RUN_ASCII/log_helios.csv");
+    file2 = CsvFile::open("../TEST_DATA/RUN_ASCII/log_helios.csv");
+    ASSERT_TRUE(file1 != NULL);
+    EXPECT_EQ(file1, file2);
+
+	// INTERLEAVED READS ARE INDEPENDENT
+    EXPECT_EQ(azimuth->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 0.0);
+    EXPECT_NEAR(value, 351.283, 1.0e-3);
+    EXPECT_EQ(clock->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 0.0);
+    EXPECT_DOUBLE_EQ(value, 0.0);
+    EXPECT_EQ(azimuth->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 1.0);
+    EXPECT_NEAR(value, 351.289, 1.0e-3);
+    EXPECT_EQ(clock->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(value, 1.0);
+
+	// SEEK BETWEEN LINES
+    EXPECT_EQ(azimuth->seek(2.5), 1);
+    EXPECT_EQ(azimuth->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 3.0);
+    EXPECT_NEAR(value, 351.301, 1.0e-3);
+
+	// EVERY LINE IS READ
+    while (clock->get(&time, &value)) {
+        EXPECT_DOUBLE_EQ(time, value);
+    }
+    EXPECT_EQ(clock->end(), 1);
+
+    CsvFile::close(file1);
+    CsvFile::close(file2);
+    delete azimuth;
+    delete clock;
+	delete data_stream_factory;
+}
+
+// CSV FIELDS
+TEST_F(DSTest, DataStream_Ascii_Fields) {
+
+	const char * field ;
+	double value ;
+
+    field = "1.5" ;
+    EXPECT_TRUE(CsvParseField(field, field + strlen(field), &value));
+    EXPECT_DOUBLE_EQ(value, 1.5);
+    field = " (2.25e2) " ;
+    EXPECT_TRUE(CsvParseField(field, field + strlen(field), &value));
+    EXPECT_DOUBLE_EQ(value, -225.0);
+    field = "0.1" ;
+    EXPECT_TRUE(CsvParseField(field, field + strlen(field), &value));
+    EXPECT_EQ(value, 0.1);
+    field = "-123456789012345678901234567890" ;
+    EXPECT_TRUE(CsvParseField(field, field + strlen(field), &value));
+    EXPECT_EQ(value, -123456789012345678901234567890.0);
+    field = "4.9e-324" ;
+    EXPECT_TRUE(CsvParseField(field, field + strlen(field), &value));
+    EXPECT_EQ(value, 4.9e-324);
+    field = "1e" ;
+    EXPECT_TRUE(CsvParseField(field, field + strlen(field), &value));
+    EXPECT_DOUBLE_EQ(value, 1.0);
+    // Only the field is read, not what follows it
+    field = "7,8" ;
+    EXPECT_TRUE(CsvParseField(field, field + 1, &value));
+    EXPECT_DOUBLE_EQ(value, 7.0);
+    field = "abc" ;
+    EXPECT_FALSE(CsvParseField(field, field + strlen(field), &value));
+    field = "" ;
+    EXPECT_FALSE(CsvParseField(field, field, &value));
+}
+
 // TRICK BINARY DATASTREAM
 TEST_F(DSTest, DataStream_Binary) {
 	//req.add_requirement("3201880761");
@@ -262,6 +351,86 @@ TEST_F(DSTest, DataStream_Binary) {
 	delete data_stream_factory;
 }
 
+// BINARY DATASTREAMS SHARING ONE FILE
+TEST_F(DSTest, DataStream_Binary_Shared) {
+
+	double time, value;
+	DataStream *elevation, *azimuth;
+	TrickBinaryFile *file1, *file2;
+
+	RUN_dir = "../TEST_DATA/RUN_BINARY";
+
+    data_stream_factory = new DataStreamFactory();
+    elevation = data_stream_factory->create(RUN_dir, "sun_predictor.sun.solar_elevation", NULL);
+    azimuth = data_stream_factory->create(RUN_dir, "sun_predictor.sun.solar_azimuth", NULL);
+    ASSERT_TRUE(elevation != NULL);
+    ASSERT_TRUE(azimuth != NULL);
+
+	// BOTH STREAMS READ THE SAME SHARED FILE
+    file1 = TrickBinaryFile::open("../TEST_DATA/RUN_BINARY/log_helios.trk");
+    file2 = TrickBinaryFile::open("../TEST_DATA/RUN_BINARY/log_helios.trk");
+    ASSERT_TRUE(file1 != NULL);
+    EXPECT_EQ(file1, file2);
+    EXPECT_EQ(file1->getNumRecords(), 1201);
+
+	// INTERLEAVED READS ARE INDEPENDENT
+    EXPECT_EQ(elevation->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 0.0);
+    EXPECT_NEAR(value, -36.7426, 1.0e-4);
+    EXPECT_EQ(azimuth->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 0.0);
+    EXPECT_NEAR(value, 353.673, 1.0e-3);
+    EXPECT_EQ(elevation->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 1.0);
+    EXPECT_NEAR(value, -36.743, 1.0e-4);
+    EXPECT_EQ(azimuth->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 1.0);
+    EXPECT_NEAR(value, 353.678, 1.0e-3);
+
+	// EVERY RECORD IS READ
+    int count = 2;
+    while (elevation->get(&time, &value)) { count++; }
+    EXPECT_EQ(count, 1201);
+    EXPECT_EQ(elevation->end(), 1);
+
+    TrickBinaryFile::close(file1);
+    TrickBinaryFile::close(file2);
+    delete elevation;
+    delete azimuth;
+	delete data_stream_factory;
+}
+
+// BINARY DATASTREAM SEEK
+TEST_F(DSTest, DataStream_Binary_Seek) {
+
+	double time, value;
+
+	RUN_dir = "../TEST_DATA/RUN_BINARY";
+    VarName = "sun_predictor.sun.solar_elevation";
+
+    data_stream_factory = new DataStreamFactory();
+    testds = data_stream_factory->create(RUN_dir, VarName, NULL);
+
+	// SEEK BETWEEN RECORDS
+    EXPECT_EQ(testds->seek(600.5), 1);
+    EXPECT_EQ(testds->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 601.0);
+    EXPECT_NEAR(value, -36.9285, 1.0e-4);
+
+	// SEEK BACK TO A RECORD
+    EXPECT_EQ(testds->seek(1.0), 1);
+    EXPECT_EQ(testds->get(&time, &value), 1);
+    EXPECT_DOUBLE_EQ(time, 1.0);
+    EXPECT_NEAR(value, -36.743, 1.0e-4);
+
+	// SEEK PAST THE END
+    EXPECT_EQ(testds->seek(1200.5), 0);
+    EXPECT_EQ(testds->end(), 1);
+
+	delete testds;
+	delete data_stream_factory;
+}
+
 // MATLAB DATASTREAM
 TEST_F(DSTest, DataStream_MatLab) {
 	//req.add_requirement("2533684432 1366633954");
@@ -353,6 +522,61 @@ TEST_F(DSTest, DataStream_Delta) {
 	delete data_stream_factory;
 }
 
+// DELTA ALIGNMENT
+TEST_F(DSTest, DataStream_DeltaAlign) {
+
+	double time, value;
+	double t1[] = { 0.0, 1.0, 2.0, 3.0, 4.0 };
+	double v1[] = { 10.0, 11.0, 12.0, 13.0, 14.0 };
+	double t2[] = { 0.0, 1.5, 2.0, 4.0 };
+	double v2[] = { 1.0, 2.5, 3.0, 5.0 };
+	std::vector<double> times1(t1, t1 + 5), values1(v1, v1 + 5);
+	std::vector<double> times2(t2, t2 + 4), values2(v2, v2 + 4);
+	std::vector<double> delta;
+
+	// MATCHING TIMES ONLY
+	DeltaAlign match;
+	match.align(times1, times2);
+	match.difference(values1, values2, delta);
+	ASSERT_EQ(match.size(), 3u);
+	EXPECT_DOUBLE_EQ(match.getTimes()[1], 2.0);
+	EXPECT_DOUBLE_EQ(delta[0], 9.0);
+	EXPECT_DOUBLE_EQ(delta[1], 9.0);
+	EXPECT_DOUBLE_EQ(delta[2], 9.0);
+
+	// THE SECOND RUN INTERPOLATED AT EACH TIME OF THE FIRST
+	DeltaAlign interpolate(1.0e-9, DeltaAlign::INTERPOLATE);
+	interpolate.align(times1, times2);
+	interpolate.difference(values1, values2, delta);
+	ASSERT_EQ(interpolate.size(), 5u);
+	EXPECT_DOUBLE_EQ(delta[1], 11.0 - 2.0);
+	EXPECT_DOUBLE_EQ(delta[3], 13.0 - 4.0);
+
+	// A RUN LESS ITSELF
+	RUN_dir = "../TEST_DATA/RUN_BINARY";
+	VarName = "sun_predictor.sun.solar_elevation";
+	data_stream_factory = new DataStreamFactory();
+	srcds = data_stream_factory->create(RUN_dir, VarName, NULL);
+	testds = data_stream_factory->create(NULL,
+	 "delta(sun_predictor.sun.solar_elevation:../TEST_DATA/RUN_BINARY,"
+	 "sun_predictor.sun.solar_elevation:../TEST_DATA/RUN_BINARY)", NULL);
+
+	testds->begin();
+	EXPECT_EQ(testds->peek(&time, &value), 1);
+	EXPECT_DOUBLE_EQ(time, 0.0);
+	while (srcds->get(&time, &value)) {
+		double delta_time, delta_value;
+		ASSERT_EQ(testds->get(&delta_time, &delta_value), 1);
+		EXPECT_DOUBLE_EQ(delta_time, time);
+		EXPECT_DOUBLE_EQ(delta_value, 0.0);
+	}
+	EXPECT_EQ(testds->end(), 1);
+
+	delete data_stream_factory;
+	delete srcds;
+	delete testds;
+}
+
 // DPC UNIT CONVERSION DATASTREAM
 TEST_F(DSTest, DataStream_DPCUnitConv) {
 	//req.add_requirement("2269871888");
@@ -425,5 +649,61 @@ TEST_F(DSTest, DataStream_DPCTimeCstr) {
 	delete testds;
 }
 
+
+// DPC MIN/MAX DATASTREAM
+TEST_F(DSTest, DataStream_DPCMinMax) {
+
+	double time, value;
+	double min_value, max_value, last_time;
+	int count;
+
+	RUN_dir = "../TEST_DATA/RUN_BINARY";
+	VarName = "sun_predictor.sun.solar_elevation";
+
+	data_stream_factory = new DataStreamFactory();
+
+	// THE EXTREMES OF ALL THE POINTS
+	srcds = data_stream_factory->create(RUN_dir, VarName, NULL);
+	min_value = 1.0e30;
+	max_value = -1.0e30;
+	while (srcds->get(&time, &value)) {
+		if (value < min_value) min_value = value;
+		if (value > max_value) max_value = value;
+	}
+	delete srcds;
+
+	srcds = data_stream_factory->create(RUN_dir, VarName, NULL);
+	testds = new DPC_MinMaxDataStream(srcds, 10);
+	testds->begin();
+
+	// AT MOST FOUR POINTS IN EACH OF AT MOST TWICE AS MANY BUCKETS,
+	// IN ORDER, KEEPING THE FIRST, LAST AND EXTREME POINTS
+	count = 0;
+	last_time = -1.0;
+	EXPECT_EQ(testds->peek(&time, &value), 1);
+	EXPECT_DOUBLE_EQ(time, 0.0);
+	while (testds->get(&time, &value)) {
+		EXPECT_GT(time, last_time);
+		last_time = time;
+		if (value == min_value) min_value = 1.0e30;
+		if (value == max_value) max_value = -1.0e30;
+		count++;
+	}
+	EXPECT_LE(count, 80);
+	EXPECT_GE(count, 10);
+	EXPECT_DOUBLE_EQ(last_time, 1200.0);
+	EXPECT_EQ(min_value, 1.0e30);
+	EXPECT_EQ(max_value, -1.0e30);
+	EXPECT_EQ(testds->end(), 1);
+
+	// BEGIN AGAIN WITHOUT READING THE SOURCE AGAIN
+	testds->begin();
+	EXPECT_EQ(testds->get(&time, &value), 1);
+	EXPECT_DOUBLE_EQ(time, 0.0);
+
+	delete data_stream_factory;
+	delete testds;
+}
+
 }
 
@@ -0,0 +1,280 @@
+/*
+ * Desc    : Compile an equation once into a program, then evaluate it
+ *           over whole columns of values.
+ *
+ *           equationparse() parses the equation again for every value.
+ *           equationcompile() runs the same parser once, folds the
+ *           operations on constants, and keeps the postfix form as a
+ *           list of instructions.  equationevaluate() runs each
+ *           instruction over a batch of values at a time, so the cost
+ *           per value is a few tight loops rather than a parse.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "eqparse_protos.h"
+
+/* Global error number */
+extern int eqp_errno;
+
+/* Values evaluated at a time */
+#define EQP_BATCH 256
+
+/*
+ * Compile an equation of the variable x.  The equation is not changed.
+ * Returns NULL on error, with eqp_errno set as equationparse() sets it.
+ * Free the program with equationfree().
+ */
+eqp_program *equationcompile(char *str)
+{
+
+#define EQP_COMPILE_FREE \
+	 makenull(input) ;\
+	 makenull1(numbers)
+
+        char *equation;
+        stack input = NULL;
+        stack1 numbers = NULL;
+        stack temp;
+        eqp_program *prog;
+        eqp_instr *instrs;
+        char ch;
+        double x, y, z;
+        int len, depth, arity, err;
+
+        if (str[0] == '\0') {
+                eqp_errno = 22;
+                return (NULL);
+        }
+
+        /* Always reset error to no error */
+        eqp_errno = 0;
+
+        /*
+         * The parser rewrites the equation in place, and substituting
+         * functions lengthens it.  The variable is parsed as NaN, which no
+         * constant can be, to tell the two apart below.
+         */
+        equation = (char *) malloc(4 * strlen(str) + 64);
+        strcpy(equation, str);
+        input = takeinput(input, equation, NAN);
+        free(equation);
+        if (eqp_errno) {
+                EQP_COMPILE_FREE;
+                return (NULL);
+        }
+        if (input) {
+                input = revers_stk(input);
+                input = fillno(&numbers, input, NAN);
+                if (chkvalid(&input)) {
+                        input = postfix(input);
+                } else {
+                        EQP_COMPILE_FREE;
+                        return (NULL);
+                }
+        }
+
+        len = 0;
+        for (temp = input; temp != NULL; temp = temp->next) {
+                len++;
+        }
+
+        prog = (eqp_program *) calloc(1, sizeof(eqp_program));
+        prog->instrs = instrs = (eqp_instr *) calloc(len + 1, sizeof(eqp_instr));
+
+        depth = 0;
+        while (!empty(input) && !eqp_errno) {
+                input = pop(input, &ch);
+                if (ch == 'N') {
+                        numbers = pop1(numbers, &x);
+                        if (isnan(x)) {
+                                instrs[prog->num_instrs].op = EQP_VARIABLE;
+                        } else {
+                                instrs[prog->num_instrs].op = EQP_CONSTANT;
+                                instrs[prog->num_instrs].value = x;
+                        }
+                        prog->num_instrs++;
+                        if (++depth > prog->max_depth) {
+                                prog->max_depth = depth;
+                        }
+                } else if (ch == (char)0xD8) {
+                } else {
+                        arity = eqp_unary(ch) ? 1 : 2;
+                        if (depth < arity) {
+                                /* Stack is empty */
+                                eqp_errno = 13;
+                                break;
+                        }
+                        depth -= arity - 1;
+
+                        /*
+                         * The last instructions are the arguments.  If they
+                         * are constants, so is the result, unless evaluating
+                         * it fails or it is rand().
+                         */
+                        len = prog->num_instrs;
+                        if (ch != (char)0xC2 &&
+                            instrs[len - 1].op == EQP_CONSTANT &&
+                            (arity == 1 || instrs[len - 2].op == EQP_CONSTANT)) {
+                                y = instrs[len - 1].value;
+                                x = (arity == 1) ? 0 : instrs[len - 2].value;
+                                z = eqp_operate(ch, x, y, &err);
+                                if (!err) {
+                                        prog->num_instrs -= arity;
+                                        instrs[prog->num_instrs].op = EQP_CONSTANT;
+                                        instrs[prog->num_instrs].value = z;
+                                        prog->num_instrs++;
+                                        continue;
+                                }
+                        }
+                        instrs[prog->num_instrs].op = ch;
+                        prog->num_instrs++;
+                }
+        }
+
+        if (!eqp_errno && depth < 1) {
+                /* Stack is empty */
+                eqp_errno = 13;
+        }
+
+        EQP_COMPILE_FREE;
+
+        if (eqp_errno) {
+                equationfree(prog);
+                return (NULL);
+        }
+
+        return (prog);
+}
+
+/*
+ * Evaluate a compiled equation for num values of in, into out, which may
+ * be in.  A value whose evaluation fails is passed through, as with
+ * equationparse().  Returns the error of the first value that failed, or 0.
+ */
+int equationevaluate(eqp_program * prog, double *in, double *out, int num)
+{
+        double *slots;
+        double *x, *y;
+        char errs[EQP_BATCH];
+        eqp_instr *instr;
+        double value;
+        int start, count, depth, ii, kk, err, first_err;
+
+        slots = (double *) malloc(prog->max_depth * EQP_BATCH * sizeof(double));
+        first_err = 0;
+
+        for (start = 0; start < num; start += EQP_BATCH) {
+                count = (num - start < EQP_BATCH) ? num - start : EQP_BATCH;
+                memset(errs, 0, count);
+                depth = 0;
+
+                for (ii = 0; ii < prog->num_instrs; ii++) {
+                        instr = &prog->instrs[ii];
+                        if (instr->op == EQP_CONSTANT) {
+                                y = slots + depth++ * EQP_BATCH;
+                                value = instr->value;
+                                for (kk = 0; kk < count; kk++) {
+                                        y[kk] = value;
+                                }
+                                continue;
+                        } else if (instr->op == EQP_VARIABLE) {
+                                y = slots + depth++ * EQP_BATCH;
+                                memcpy(y, in + start, count * sizeof(double));
+                                continue;
+                        }
+
+                        /* The result replaces the first argument */
+                        y = slots + (depth - 1) * EQP_BATCH;
+                        if (eqp_unary(instr->op)) {
+                                x = NULL;
+                        } else {
+                                x = slots + (depth - 2) * EQP_BATCH;
+                                depth--;
+                        }
+
+                        switch (instr->op) {
+                        case '+':
+                                for (kk = 0; kk < count; kk++) {
+                                        x[kk] += y[kk];
+                                }
+                                break;
+                        case '-':
+                                for (kk = 0; kk < count; kk++) {
+                                        x[kk] -= y[kk];
+                                }
+                                break;
+                        case '*':
+                                for (kk = 0; kk < count; kk++) {
+                                        x[kk] *= y[kk];
+                                }
+                                break;
+                        case '/':
+                                for (kk = 0; kk < count; kk++) {
+                                        if (y[kk] == 0.0) {
+                                                /* Division by zero */
+                                                if (!errs[kk]) {
+                                                        errs[kk] = 6;
+                                                }
+                                                x[kk] = 0.0;
+                                        } else {
+                                                x[kk] /= y[kk];
+                                        }
+                                }
+                                break;
+                        case (char)0xA2:      /* abs(x) */
+                                for (kk = 0; kk < count; kk++) {
+                                        y[kk] = fabs(y[kk]);
+                                }
+                                break;
+                        case (char)0xC7:      /* sqrt(x) */
+                                for (kk = 0; kk < count; kk++) {
+                                        y[kk] = sqrt(y[kk]);
+                                }
+                                break;
+                        default:
+                                for (kk = 0; kk < count; kk++) {
+                                        value = eqp_operate(instr->op,
+                                                            x ? x[kk] : 0, y[kk], &err);
+                                        if (err && !errs[kk]) {
+                                                errs[kk] = err;
+                                        }
+                                        if (x) {
+                                                x[kk] = value;
+                                        } else {
+                                                y[kk] = value;
+                                        }
+                                }
+                                break;
+                        }
+                }
+
+                for (kk = 0; kk < count; kk++) {
+                        if (errs[kk]) {
+                                /* If there is an error, just return value passed in */
+                                out[start + kk] = in[start + kk];
+                                if (!first_err) {
+                                        first_err = errs[kk];
+                                }
+                        } else {
+                                out[start + kk] = slots[kk];
+                        }
+                }
+        }
+
+        free(slots);
+
+        eqp_errno = first_err;
+        return (first_err);
+}
+
+void equationfree(eqp_program * prog)
+{
+        if (prog != NULL) {
+                free(prog->instrs);
+                free(prog);
+        }
+}
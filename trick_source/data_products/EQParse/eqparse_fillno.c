@@ -14,7 +14,7 @@
 
 stack fillno(stack1 * no, stack stk, double value)
 {
-        int i, j;
+        int i, j, len;
         double x;
         char ch;
         char *num;
@@ -57,7 +57,13 @@ stack fillno(stack1 * no, stack stk, double value)
                         tmp_no = revers_stk(tmp_no);
                         for (j = 0; j < i; j++) {
                                 tmp_no = pop(tmp_no, &ch);
-                                snprintf(num, sizeof(numstr), "%s%c", num, ch);
+                                /* Append in place; snprintf may not read from
+                                 * its own destination */
+                                len = strlen(num);
+                                if (len < (int) sizeof(numstr) - 1) {
+                                        num[len] = ch;
+                                        num[len + 1] = '\0';
+                                }
                         }
                         x = atof(num);
 #ifdef DEBUG
@@ -7,11 +7,32 @@
 extern "C" {
 #endif
 
+/* Compiled equation, see eqparse_compile.c */
+        typedef struct _eqp_instr {
+                char op;        /* EQP_CONSTANT, EQP_VARIABLE or an operator */
+                double value;   /* Value of an EQP_CONSTANT */
+        } eqp_instr;
+
+        typedef struct _eqp_program {
+                int num_instrs;
+                eqp_instr *instrs;
+                int max_depth;  /* Deepest the evaluation stack gets */
+        } eqp_program;
+
+#define EQP_CONSTANT 'N'
+#define EQP_VARIABLE 'x'
+
         void operatorcheck(char *equation);
         int equationparse(char *str, double value, double *out);
         char *eqperror(int code);
         stack takeinput(stack stk, char *equation, double value);
         double eval(stack * stk, stack1 * no);
+        int eqp_unary(char ch);
+        double eqp_operate(char ch, double x, double y, int *err);
+        eqp_program *equationcompile(char *str);
+        int equationevaluate(eqp_program * prog, double *in, double *out,
+                             int num);
+        void equationfree(eqp_program * prog);
         double inverf(double p);
         double add(double x, double y);
         double dif(double x, double y);
@@ -13,6 +13,10 @@ int main()
         double y;
         int ret;
         div_t divt;
+        eqp_program *prog;
+        double column[1000];
+        double result[1000];
+        int ii;
 
 
        /*-------------------------------------------------------
@@ -1213,5 +1217,67 @@ int main()
                 printf("[32m[PASS][00m %s\n", equation2);
         }
 
+       /*-------------------------------------------------------
+        * Compiled equations
+        */
+        fprintf(stderr, "\n[36mTesting compiled equations.[00m\n");
+
+        for (ii = 0; ii < 1000; ii++) {
+                column[ii] = (ii - 500) * 0.0137;
+        }
+
+        // Same values as equationparse(), over more than one batch
+        strcpy(equation1, "sqrt(x*x + 4) - atan2(x,2.5)^2");
+        prog = equationcompile(equation1);
+        ret = (prog == NULL) ? -1 : equationevaluate(prog, column, result, 1000);
+        for (ii = 0; ii < 1000 && ret == 0; ii++) {
+                strcpy(equation2, equation1);
+                equationparse(equation2, column[ii], &y);
+                if (y != result[ii]) {
+                        ret = -1;
+                }
+        }
+        equationfree(prog);
+        if (ret != 0) {
+                printf("[31m[FAIL][00m compiled %s %d\n", equation1, ret);
+                return (-1);
+        } else {
+                printf("[32m[PASS][00m compiled %s\n", equation1);
+        }
+
+        // Constants fold into one
+        strcpy(equation1, "2*sin(PI/2)*x");
+        prog = equationcompile(equation1);
+        if (prog == NULL || prog->num_instrs != 3 ||
+            prog->instrs[0].value != 2.0) {
+                printf("[31m[FAIL][00m compiled %s\n", equation1);
+                return (-1);
+        } else {
+                printf("[32m[PASS][00m compiled %s\n", equation1);
+        }
+        equationfree(prog);
+
+        // A value that fails is passed through
+        strcpy(equation1, "1/x");
+        prog = equationcompile(equation1);
+        ret = (prog == NULL) ? -1 : equationevaluate(prog, column, result, 1000);
+        equationfree(prog);
+        if (ret != 6 || result[500] != 0.0 || result[0] != 1 / column[0]) {
+                printf("[31m[FAIL][00m compiled %s %d\n", equation1, ret);
+                return (-1);
+        } else {
+                printf("[32m[PASS][00m compiled %s\n", equation1);
+        }
+
+        // Syntax errors are found once
+        strcpy(equation1, "x++");
+        prog = equationcompile(equation1);
+        if (prog != NULL || eqp_errno != 5) {
+                printf("[31m[FAIL][00m compiled %s %d\n", equation1, eqp_errno);
+                return (-1);
+        } else {
+                printf("[32m[PASS][00m compiled %s\n", equation1);
+        }
+
         return 0 ;
 }
@@ -8,139 +8,133 @@
 #include "Csv.hh"
 #include "trick/map_trick_units_to_udunits.hh"
 
-Csv::Csv(char * file_name , char * param_name ) {
+Csv::Csv(char * file_name , char * param_name ) :
+ field_num_(0), column_(NULL), record_(0), index_built_(false) {
 
-        char * header ;
-        char * next_field ;
+        int num_fields ;
         int len ;
+        std::string::size_type start_unit , end_unit ;
+        std::string units ;
 
         fileName_ = file_name ;
         len = strlen(param_name) ;
 
-        if ((fp_ = fopen(file_name , "r")) == 0 ) {
-           std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+        if ((file_ = CsvFile::open(file_name)) == NULL ) {
            exit(-1) ;
         }
 
-        line_ = new char[20480] ;
-        header = new char[20480] ;
-        fgets( header , 20480 , fp_ );
-
-        // remove trailing newline
-        header[strlen(header)-1] = '\0' ;
-
-        field_num_ = 0 ;
-        next_field = strtok( header , "," ) ;
-
-        if ( strncmp(next_field , param_name, len) ) {
-                field_num_++ ;
-                while ((next_field = strtok( NULL , "," ))) {
-                        char *space_loc = strchr(next_field, ' ');
-                        int actual_name_len = space_loc - next_field;
+        num_fields = file_->getNumFields() ;
+        if ( num_fields > 0 && strncmp(file_->getField(0).c_str() , param_name, len) ) {
+                for ( field_num_ = 1 ; field_num_ < num_fields ; field_num_++ ) {
+                        const std::string & field = file_->getField(field_num_) ;
                         // need to make sure if the length of the parameter and the length
-                        // of the parameter found in the next_field are actually the same,
+                        // of the parameter found in the field are actually the same,
                         // since strncmp(a.b.c_more, a.b.c, 5) results a.b.c_more equals a.b.c.
-                        if ( strncmp(next_field , param_name, len) || actual_name_len != len) {
-                                field_num_++ ;
+                        if ( strncmp(field.c_str() , param_name, len) || field.find(' ') != (std::string::size_type)len ) {
+                                continue ;
                         }
-                        else {
-                                /* found the parameter, get the units if there are any */
-                                char * start_unit ,  * end_unit ;
-                                if ((start_unit = index( next_field , '{' ))) {
-                                        end_unit = index( next_field , '}' ) ;
-                                        end_unit[0] = '\0' ;
-                                        if ( ! strcmp( param_name , "sys.exec.out.time" )) {
-                                                unitTimeStr_ = start_unit + 1 ;
-                                        }
-                                        else {
-                                                if ( !strcmp(start_unit + 1,"--") ) {
-                                                    unitStr_ = start_unit + 1;
-                                                } else {
-                                                    unitStr_ = map_trick_units_to_udunits(start_unit + 1) ;
-                                                }
+                        /* found the parameter, get the units if there are any */
+                        if ((start_unit = field.find('{')) != std::string::npos ) {
+                                end_unit = field.find('}' , start_unit) ;
+                                units = field.substr(start_unit + 1 ,
+                                 end_unit == std::string::npos ? end_unit : end_unit - start_unit - 1) ;
+                                if ( ! strcmp( param_name , "sys.exec.out.time" )) {
+                                        unitTimeStr_ = units ;
+                                }
+                                else {
+                                        if ( units == "--" ) {
+                                            unitStr_ = units ;
+                                        } else {
+                                            unitStr_ = map_trick_units_to_udunits(units) ;
                                         }
                                 }
-                                break ;
                         }
+                        break ;
                 }
         }
 
-        data_offset_ = ftell(fp_) ;
-
-        delete[]header ;
-
+        // Request the column now, so it is parsed in the same pass as those
+        // of the other streams of this file.
+        file_->request(field_num_) ;
 }
 
-int Csv::get( double * time , double * value ) {
-
-        int ii ;
-        char * field ;
-        int ret ;
-
-        /* loop until we get a good line or we finish the file */
-        while ( fgets( line_ , 20480 , fp_ ) ) {
+Csv::~Csv() {
+        CsvFile::close(file_) ;
+}
 
-                field = strtok( line_ , "," ) ;
-                /* handle numbers in parenthesis as negative numbers */
-                if ( (ret = sscanf( field , "%*[ \t](%lf)" , time )) == 1 || (ret = sscanf( field , "(%lf)" , time )) == 1  ) {
-                        *time = -(*time) ;
-                }
-                else {
-                        ret = sscanf( field , "%lf" , time ) ;
-                }
+int Csv::ready() {
 
-                if ( ret == 1 ) {
+        if ( column_ == NULL ) {
+                column_ = file_->load(field_num_) ;
+        }
+        return( record_ < (int)column_->times.size() ) ;
+}
 
-                        for ( ii = 0 ; ii < field_num_ ; ii++ ) {
-                                field = strtok(NULL , ",") ;
-                        }
+int Csv::get( double * time , double * value ) {
 
-                        if ( field != NULL ) {
-                                /* handle numbers in parenthesis as negative numbers */
-                                if ( sscanf( field , "%*[ \t](%lf)" , value ) == 1 || sscanf( field , "(%lf)" , value ) == 1 ) {
-                                        *value = -(*value) ;
-                                        /* successfully read both time and value */
-                                        return( 1 ) ;
-                                }
-                                else {
-                                        ret = sscanf( field , "%lf" ,  value ) ;
-                                        if ( ret == 1 ) {
-                                                /* successfully read both time and value */
-                                                return( 1 ) ;
-                                        }
-                                }
-                        }
-                }
+        if ( ready() ) {
+                *time = column_->times[record_] ;
+                *value = column_->values[record_] ;
+                record_++ ;
+                return(1) ;
         }
 
-        return ( 0 ) ;
-
+        return(0) ;
 }
 
 int Csv::peek( double * time , double * value ) {
 
-        long offset ;
-        int ret ;
-
-        offset = ftell(fp_) ;
-        ret = get( time , value ) ;
-        fseek(fp_ , offset , SEEK_SET ) ;
+        if ( ready() ) {
+                *time = column_->times[record_] ;
+                *value = column_->values[record_] ;
+                return(1) ;
+        }
 
-        return(ret) ;
+        return(0) ;
 }
 
 void Csv::begin() {
-        fseek(fp_ , data_offset_ , SEEK_SET ) ;
+        record_ = 0 ;
         return ;
 }
 
 int Csv::end() {
-        return(feof(fp_)) ;
+
+        if ( ! ready() ) {
+                // Sitting past the last data point
+                return(1) ;
+        }
+
+        return(0) ;
+}
+
+/* The whole column is in memory, so the index is built over it rather than
+   read from the sidecar the recorder may have written. */
+int Csv::seek( double time ) {
+
+        const TimeIndex::Entry * entry ;
+        unsigned int ii ;
+
+        ready() ;
+        if ( ! index_built_ ) {
+                index_built_ = true ;
+                for ( ii = 0 ; ii < column_->times.size() ; ii++ ) {
+                        index_.add(column_->times[ii] , -1) ;
+                }
+        }
+
+        begin() ;
+        if ((entry = index_.find(time)) != NULL ) {
+                record_ = (int)entry->record ;
+        }
+
+        return(skipUntil(time)) ;
 }
 
 int Csv::step() {
 
-        if ( fgets( line_ , 20480 , fp_ ) ) {
+        if ( ready() ) {
+                record_++ ;
                 return(1) ;
         }
 
@@ -148,37 +142,22 @@ int Csv::step() {
 }
 
 int CsvLocateParam( char * file_name , char * param_name ) {
-        char * header ;
-        char * next_field ;
-        FILE * fp ;
+
+        CsvFile * file ;
         int len ;
+        int ii ;
+        int found = 0 ;
 
         len = strlen(param_name) ;
 
-        if ((fp = fopen(file_name , "r")) != 0 ) {
-                header = new char[20480] ;
-                fgets( header , 20480 , fp );
-
-                // remove trailing newline
-                header[strlen(header)-1] = '\0' ;
-                next_field = strtok( header , "," ) ;
-                do {
-                        if ( ! strncmp(next_field , param_name, len) ) {
-                                fclose(fp) ;
-                                delete[]header ;
-                                return(1) ;
+        if ((file = CsvFile::open(file_name)) != NULL ) {
+                for ( ii = 0 ; ii < file->getNumFields() && ! found ; ii++ ) {
+                        if ( ! strncmp(file->getField(ii).c_str() , param_name, len) ) {
+                                found = 1 ;
                         }
-                } while ((next_field = strtok( NULL , "," ))) ;
-
-                delete[]header ;
-                fclose(fp) ;
-
-        }
-        else {
-           std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                }
+                CsvFile::close(file) ;
         }
 
-        return(0) ;
+        return(found) ;
 }
-
-
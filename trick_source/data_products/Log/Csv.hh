@@ -4,11 +4,18 @@
 
 #include <stdio.h>
 #include "DataStream.hh"
+#include "TimeIndex.hh"
+#include "CsvFile.hh"
 
+/**
+ * One variable of a comma separated data log. The log is parsed through the
+ * CsvFile shared by every Csv of the same file.
+ */
 class Csv : public DataStream {
 
        public:
                Csv(char * file, char * param ) ;
+               ~Csv() ;
 
                int get(double * time , double * value ) ;
                int peek(double * time , double * value ) ;
@@ -16,12 +23,19 @@ class Csv : public DataStream {
                void begin() ;
                int end() ;
                int step() ;
+               int seek(double time) ;
 
        private:
-               FILE *fp_ ;
+               CsvFile * file_ ;
                int field_num_ ;
-               int data_offset_ ;
-               char * line_ ;
+               /** The lines holding the variable, parsed on first use. */
+               const CsvFile::Column * column_ ;
+               int record_ ;
+               bool index_built_ ;
+               TimeIndex index_ ;
+
+               /** Make sure the column is parsed. @return 0 past its last line. */
+               int ready() ;
 
 } ;
 
@@ -0,0 +1,380 @@
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "CsvFile.hh"
+
+pthread_mutex_t CsvFile::files_mutex_ = PTHREAD_MUTEX_INITIALIZER ;
+std::map<std::string, CsvFile *> CsvFile::files_ ;
+
+CsvFile * CsvFile::open( const char * file_name ) {
+
+        struct stat st ;
+        CsvFile * file = NULL ;
+        std::map<std::string, CsvFile *>::iterator it ;
+
+        if ( stat(file_name , &st) != 0 ) {
+                std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return NULL ;
+        }
+
+        pthread_mutex_lock(&files_mutex_) ;
+
+        it = files_.find(file_name) ;
+        if ( it != files_.end() ) {
+                if ( it->second->file_size_ == (long long)st.st_size &&
+                     it->second->file_mtime_ == (long long)st.st_mtime ) {
+                        file = it->second ;
+                } else {
+                        // The file has changed. Its current readers keep the old copy.
+                        files_.erase(it) ;
+                }
+        }
+
+        if ( file == NULL ) {
+                file = new CsvFile(file_name) ;
+                if ( file->file_size_ < 0 ) {
+                        delete file ;
+                        file = NULL ;
+                } else {
+                        files_[file_name] = file ;
+                }
+        }
+
+        if ( file != NULL ) {
+                file->ref_count_++ ;
+        }
+
+        pthread_mutex_unlock(&files_mutex_) ;
+        return file ;
+}
+
+void CsvFile::close( CsvFile * file ) {
+
+        std::map<std::string, CsvFile *>::iterator it ;
+
+        if ( file == NULL ) {
+                return ;
+        }
+
+        pthread_mutex_lock(&files_mutex_) ;
+        if ( --file->ref_count_ == 0 ) {
+                it = files_.find(file->file_name_) ;
+                if ( it != files_.end() && it->second == file ) {
+                        files_.erase(it) ;
+                }
+                delete file ;
+        }
+        pthread_mutex_unlock(&files_mutex_) ;
+}
+
+/* An empty file is a log without fields; file_size_ is left -1 if the file
+   can't be read at all. */
+CsvFile::CsvFile( const char * file_name ) :
+ ref_count_(0), file_name_(file_name), file_size_(-1), file_mtime_(0), map_(NULL), data_offset_(0) {
+
+        struct stat st ;
+        int fd ;
+        void * map ;
+        const char * eol ;
+        std::string header ;
+        std::string::size_type start , stop ;
+
+        pthread_mutex_init(&mutex_, NULL) ;
+
+        if ((fd = ::open(file_name , O_RDONLY)) < 0 ) {
+                std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return ;
+        }
+
+        if ( fstat(fd , &st) != 0 ) {
+                ::close(fd) ;
+                return ;
+        }
+        file_mtime_ = st.st_mtime ;
+
+        if ( st.st_size == 0 ) {
+                ::close(fd) ;
+                file_size_ = 0 ;
+                return ;
+        }
+
+        map = mmap(NULL , st.st_size , PROT_READ , MAP_PRIVATE , fd , 0) ;
+        ::close(fd) ;
+        if ( map == MAP_FAILED ) {
+                std::cerr << "ERROR:  Couldn't map \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return ;
+        }
+        map_ = (char *)map ;
+        file_size_ = st.st_size ;
+        madvise(map_ , file_size_ , MADV_SEQUENTIAL) ;
+
+        // The header is the first line, less its last character, the newline.
+        if ((eol = (const char *)memchr(map_ , '\n' , file_size_)) != NULL ) {
+                data_offset_ = eol + 1 - map_ ;
+        } else {
+                data_offset_ = file_size_ ;
+        }
+        header.assign(map_ , data_offset_ - 1) ;
+
+        start = header.find_first_not_of(',') ;
+        while ( start != std::string::npos ) {
+                stop = header.find(',' , start) ;
+                fields_.push_back(header.substr(start , stop == std::string::npos ? stop : stop - start)) ;
+                start = header.find_first_not_of(',' , stop) ;
+        }
+}
+
+CsvFile::~CsvFile() {
+
+        std::map<int, Column *>::iterator it ;
+
+        for ( it = columns_.begin() ; it != columns_.end() ; it++ ) {
+                delete it->second ;
+        }
+        if ( map_ ) {
+                munmap(map_ , file_size_) ;
+        }
+        pthread_mutex_destroy(&mutex_) ;
+}
+
+void CsvFile::request( int index ) {
+
+        pthread_mutex_lock(&mutex_) ;
+        if ( columns_.find(index) == columns_.end() ) {
+                columns_[index] = new Column ;
+                pending_.push_back(index) ;
+        }
+        pthread_mutex_unlock(&mutex_) ;
+}
+
+const CsvFile::Column * CsvFile::load( int index ) {
+
+        const char * cp ;
+        const char * end ;
+        const char * eol ;
+        const char * fp ;
+        double time ;
+        double value ;
+        int max_index ;
+        int num_fields ;
+        unsigned int ii ;
+        Column * column ;
+
+        request(index) ;
+
+        pthread_mutex_lock(&mutex_) ;
+
+        if ( ! pending_.empty() && map_ != NULL ) {
+
+                max_index = 0 ;
+                for ( ii = 0 ; ii < pending_.size() ; ii++ ) {
+                        if ( pending_[ii] > max_index ) {
+                                max_index = pending_[ii] ;
+                        }
+                }
+                std::vector<const char *> starts(max_index + 1) ;
+                std::vector<const char *> stops(max_index + 1) ;
+
+                cp = map_ + data_offset_ ;
+                end = map_ + file_size_ ;
+                while ( cp < end ) {
+                        if ((eol = (const char *)memchr(cp , '\n' , end - cp)) == NULL ) {
+                                eol = end ;
+                        }
+
+                        // Split the fields up to the last one wanted.
+                        num_fields = 0 ;
+                        fp = cp ;
+                        while ( num_fields <= max_index ) {
+                                while ( fp < eol && *fp == ',' ) {
+                                        fp++ ;
+                                }
+                                if ( fp == eol ) {
+                                        break ;
+                                }
+                                starts[num_fields] = fp ;
+                                while ( fp < eol && *fp != ',' ) {
+                                        fp++ ;
+                                }
+                                stops[num_fields++] = fp ;
+                        }
+
+                        // A line counts for a column if both its time and value read.
+                        if ( num_fields > 0 && CsvParseField(starts[0] , stops[0] , &time) ) {
+                                for ( ii = 0 ; ii < pending_.size() ; ii++ ) {
+                                        if ( pending_[ii] < num_fields &&
+                                             CsvParseField(starts[pending_[ii]] , stops[pending_[ii]] , &value) ) {
+                                                column = columns_[pending_[ii]] ;
+                                                column->times.push_back(time) ;
+                                                column->values.push_back(value) ;
+                                        }
+                                }
+                        }
+
+                        cp = eol + 1 ;
+                }
+        }
+        pending_.clear() ;
+        column = columns_[index] ;
+
+        pthread_mutex_unlock(&mutex_) ;
+        return column ;
+}
+
+/* Powers of ten that are exact doubles. */
+static const double exact_powers_of_ten[] = {
+        1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10 ,
+        1e11 , 1e12 , 1e13 , 1e14 , 1e15 , 1e16 , 1e17 , 1e18 , 1e19 , 1e20 ,
+        1e21 , 1e22
+} ;
+
+/* Read a number with strtod, which needs it null terminated. */
+static bool parse_number_strtod( const char * cp , const char * end , double * value ) {
+
+        char buffer[64] ;
+        std::string copy ;
+        const char * str ;
+        char * str_end ;
+
+        if ( end - cp < (long)sizeof(buffer) ) {
+                memcpy(buffer , cp , end - cp) ;
+                buffer[end - cp] = '\0' ;
+                str = buffer ;
+        } else {
+                copy.assign(cp , end - cp) ;
+                str = copy.c_str() ;
+        }
+
+        *value = strtod(str , &str_end) ;
+        return ( str_end != str ) ;
+}
+
+/* Read a number as sscanf's %lf would. Plain decimal numbers of up to 19
+   digits, with a mantissa and power of ten that are both exact doubles, are
+   read with one multiply or divide, which rounds correctly; anything else goes
+   to strtod. */
+static bool parse_number( const char * cp , const char * end , double * value ) {
+
+        const char * start ;
+        uint64_t mantissa = 0 ;
+        int num_digits = 0 ;
+        int num_read = 0 ;
+        int exponent = 0 ;
+        int exp_value = 0 ;
+        int exp_sign = 1 ;
+        bool negative = false ;
+        bool truncated = false ;
+        const char * ep ;
+        double result ;
+
+        while ( cp < end && isspace((unsigned char)*cp) ) {
+                cp++ ;
+        }
+        start = cp ;
+
+        if ( cp < end && ( *cp == '-' || *cp == '+' )) {
+                negative = ( *cp == '-' ) ;
+                cp++ ;
+        }
+
+        while ( cp < end && isdigit((unsigned char)*cp) ) {
+                if ( mantissa != 0 || *cp != '0' ) {
+                        if ( num_digits < 19 ) {
+                                mantissa = mantissa * 10 + (*cp - '0') ;
+                                num_digits++ ;
+                        } else {
+                                truncated = true ;
+                        }
+                }
+                cp++ ;
+                num_read++ ;
+        }
+        // A leading 0 may be the start of a hexadecimal number.
+        if ( cp < end && ( *cp == 'x' || *cp == 'X' )) {
+                return parse_number_strtod(start , end , value) ;
+        }
+
+        if ( cp < end && *cp == '.' ) {
+                cp++ ;
+                while ( cp < end && isdigit((unsigned char)*cp) ) {
+                        if ( mantissa != 0 || *cp != '0' ) {
+                                if ( num_digits < 19 ) {
+                                        mantissa = mantissa * 10 + (*cp - '0') ;
+                                        num_digits++ ;
+                                } else {
+                                        truncated = true ;
+                                }
+                        }
+                        if ( ! truncated ) {
+                                exponent-- ;
+                        }
+                        cp++ ;
+                        num_read++ ;
+                }
+        }
+
+        if ( num_read == 0 ) {
+                // Not a decimal number; inf, nan, or nothing at all.
+                return parse_number_strtod(start , end , value) ;
+        }
+
+        // The exponent counts only if it has digits.
+        if ( cp < end && ( *cp == 'e' || *cp == 'E' )) {
+                ep = cp + 1 ;
+                if ( ep < end && ( *ep == '-' || *ep == '+' )) {
+                        exp_sign = ( *ep == '-' ) ? -1 : 1 ;
+                        ep++ ;
+                }
+                if ( ep < end && isdigit((unsigned char)*ep) ) {
+                        while ( ep < end && isdigit((unsigned char)*ep) ) {
+                                if ( exp_value < 100000 ) {
+                                        exp_value = exp_value * 10 + (*ep - '0') ;
+                                }
+                                ep++ ;
+                        }
+                        exponent += exp_sign * exp_value ;
+                }
+        }
+
+        if ( truncated || mantissa > ((uint64_t)1 << 53) || exponent < -22 || exponent > 22 ) {
+                return parse_number_strtod(start , end , value) ;
+        }
+
+        result = (double)mantissa ;
+        if ( exponent < 0 ) {
+                result /= exact_powers_of_ten[-exponent] ;
+        } else {
+                result *= exact_powers_of_ten[exponent] ;
+        }
+        *value = negative ? -result : result ;
+        return true ;
+}
+
+bool CsvParseField( const char * field , const char * end , double * value ) {
+
+        const char * cp = field ;
+
+        /* handle numbers in parenthesis as negative numbers */
+        while ( cp < end && ( *cp == ' ' || *cp == '\t' )) {
+                cp++ ;
+        }
+        if ( cp < end && *cp == '(' ) {
+                if ( ! parse_number(cp + 1 , end , value) ) {
+                        return false ;
+                }
+                *value = -(*value) ;
+                return true ;
+        }
+
+        return parse_number(field , end , value) ;
+}
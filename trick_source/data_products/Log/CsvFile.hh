@@ -0,0 +1,90 @@
+
+#ifndef CSVFILE_HH
+#define CSVFILE_HH
+
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+/**
+ * A comma separated data log shared by every reader of the file.
+ *
+ * The file is mapped into memory once. Each reader requests the column it
+ * needs; the first reader to load its column then parses every requested
+ * column in one pass over the lines, into arrays of the times and values of
+ * the lines where both could be read. A product that plots many variables
+ * from one log therefore parses the file once, not once per variable.
+ *
+ * Lines may be of any length. Fields are separated by one or more commas, as
+ * strtok separated them. A number in parentheses is negative.
+ *
+ * Files are shared by name through open and close. A file that has changed
+ * since it was opened is opened afresh.
+ */
+class CsvFile {
+
+       public:
+               /** The times and values of the lines of the file holding a column. */
+               struct Column {
+                       std::vector<double> times ;
+                       std::vector<double> values ;
+               } ;
+
+               /**
+                * Get the shared reader of a file, opening it if need be.
+                * @return The reader, or NULL if the file can't be read.
+                *         Release it with close.
+                */
+               static CsvFile * open( const char * file_name ) ;
+
+               /** Release a reader returned by open. NULL is ignored. */
+               static void close( CsvFile * file ) ;
+
+               /** Fields of the header line, the first being time. */
+               int getNumFields() const { return (int)fields_.size() ; }
+               const std::string & getField( int index ) const { return fields_[index] ; }
+               const std::string & getFileName() const { return file_name_ ; }
+
+               /** Request a column, to be parsed by the next load. */
+               void request( int index ) ;
+
+               /**
+                * Parse every requested column not parsed yet, in one pass.
+                * @return The column, which is not changed after.
+                */
+               const Column * load( int index ) ;
+
+       private:
+               CsvFile( const char * file_name ) ;
+               ~CsvFile() ;
+
+               static pthread_mutex_t files_mutex_ ;
+               static std::map<std::string, CsvFile *> files_ ;
+
+               pthread_mutex_t mutex_ ;
+               int ref_count_ ;
+
+               std::string file_name_ ;
+               long long file_size_ ;
+               long long file_mtime_ ;
+               char * map_ ;
+               long long data_offset_ ;
+
+               std::vector<std::string> fields_ ;
+
+               /** Requested columns, and those not parsed yet. */
+               std::map<int, Column *> columns_ ;
+               std::vector<int> pending_ ;
+
+} ;
+
+/**
+ * Read a number of a field the way the Csv reader always has: leading blanks,
+ * then a number as strtod reads it, negated if in parentheses. The rest of the
+ * field is ignored.
+ * @return false if the field doesn't start with a number.
+ */
+bool CsvParseField( const char * field , const char * end , double * value ) ;
+
+#endif
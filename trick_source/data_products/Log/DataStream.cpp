@@ -17,7 +17,7 @@ int DataStream::getValueAtTime(double time , double * value ) {
         double value_time ;
         int ret = 0 ;
 
-        begin() ;
+        seek( time - 1e-9 ) ;
         while ( (ret = get( &value_time , value )) &&
                 (fabs( value_time - time ) > 1e-9 )) ;
 
@@ -25,6 +25,26 @@ int DataStream::getValueAtTime(double time , double * value ) {
 
 }
 
+int DataStream::seek(double time) {
+        begin() ;
+        return(skipUntil(time)) ;
+}
+
+int DataStream::skipUntil(double time) {
+
+        double value_time ;
+        double value ;
+
+        while ( peek( &value_time , &value ) ) {
+                if ( value_time >= time ) {
+                        return(1) ;
+                }
+                step() ;
+        }
+
+        return(0) ;
+}
+
 string DataStream::getFileName() {
         return(fileName_) ;
 }
@@ -25,7 +25,18 @@ class DataStream {
                virtual int end() = 0 ;
                virtual int step() = 0 ;
 
+               /**
+                * Move to the first record at or after time, skipping only
+                * records earlier than time. Streams with a time index skip
+                * them without reading them.
+                * @return 1 if there is such a record, 0 otherwise.
+                */
+               virtual int seek(double time) ;
+
        protected:
+               /** Step forward to the first record at or after time. @return as seek. */
+               int skipUntil(double time) ;
+
                string fileName_ ;
                string unitStr_ ;
                string unitTimeStr_ ;
@@ -83,12 +83,16 @@ DataStream* DataStreamFactory::create( const char* iRunDir,
             size_t full_path_len = runDir.length() + strlen(dp->d_name) + 2;
             full_path = (char*) malloc( full_path_len) ;
             snprintf(full_path, full_path_len, "%s/%s", runDir.c_str(), dp->d_name);
-            if ( TrickBinaryLocateParam((const char*)full_path , paramName.c_str()) ) {
+            // The header is parsed once per file while streams of it are open.
+            TrickBinaryFile * trk = TrickBinaryFile::open(full_path) ;
+            if ( trk != NULL && trk->findParam(paramName.c_str()) >= 0 ) {
             	closedir(dirp) ;
                 stream = new TrickBinary(full_path , (char *)paramName.c_str()) ;
+                TrickBinaryFile::close(trk) ;
                 free( full_path ) ;
                 return(stream) ;
             }
+            TrickBinaryFile::close(trk) ;
             free( full_path ) ;
         }
     }
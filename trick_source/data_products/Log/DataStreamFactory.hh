@@ -15,6 +15,7 @@
 //#include "OctaveAscii.hh"
 //#include "OctaveBinary.hh"
 #include "TrickBinary.hh"
+#include "TrickBinaryFile.hh"
 //#include "TrickBinary04.hh"
 #include "MatLab.hh"
 #include "MatLab4.hh"
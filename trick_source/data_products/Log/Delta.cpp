@@ -9,7 +9,8 @@ using namespace std ;
 #include "Delta.hh"
 #include "DataStreamFactory.hh"
 
-Delta::Delta(const char * deltaStatement, const char* timeName)
+Delta::Delta(const char * deltaStatement, const char* timeName) :
+ loaded_(false), record_(0)
 {
         int ret ;
         char vr1[1024];
@@ -30,9 +31,6 @@ Delta::Delta(const char * deltaStatement, const char* timeName)
 
         dataStream1_ = dsf.create(NULL, vr1, timeName);
         dataStream2_ = dsf.create(NULL, vr2, timeName);
-
-        dsg_.add(dataStream1_);
-        dsg_.add(dataStream2_);
 }
 
 Delta::~Delta()
@@ -42,51 +40,62 @@ Delta::~Delta()
 }
 
 
-int Delta::get( double * time , double * value )
+int Delta::ready()
 {
-        int ret ;
-        double val1, val2 ;
-
-        ret = dsg_.matchTimeStamps();
-        if ( ! ret ) {
-                // At end of input streams
-                return ret ;
+        vector < double > times1, values1 ;
+        vector < double > times2, values2 ;
+
+        if ( ! loaded_ ) {
+                loaded_ = true ;
+                DeltaAlign::read(dataStream1_, times1, values1);
+                DeltaAlign::read(dataStream2_, times2, values2);
+                align_.align(times1, times2);
+                align_.difference(values1, values2, delta_);
         }
+        return( record_ < align_.size() ) ;
+}
 
-        dsg_.getLastRead(dataStream1_, time, &val1);
-        ret = dsg_.getLastRead(dataStream2_, time, &val2);
-
-        *value = val1 - val2 ;
+int Delta::get( double * time , double * value )
+{
+        if ( ready() ) {
+                *time = align_.getTimes()[record_] ;
+                *value = delta_[record_] ;
+                record_++ ;
+                return(1) ;
+        }
 
-        return(ret) ;
+        // At end of input streams
+        return(0) ;
 }
 
 int Delta::peek( double * time , double * value )
 {
-        int ret ;
-        double val1, val2 ;
-
-        dsg_.getLastRead(dataStream1_, time, &val1);
-        ret = dsg_.getLastRead(dataStream2_, time, &val2);
-
-        *value = val1 - val2 ;
+        if ( ready() ) {
+                *time = align_.getTimes()[record_] ;
+                *value = delta_[record_] ;
+                return(1) ;
+        }
 
-        return(ret) ;
+        return(0) ;
 }
 
 void Delta::begin()
 {
-        dsg_.begin();
+        record_ = 0 ;
         return ;
 }
 
 int Delta::end()
 {
-        return (dsg_.end()) ;
+        return ( ! ready() ) ;
 }
 
 int Delta::step()
 {
-        dsg_.step();
+        if ( ready() ) {
+                record_++ ;
+                return(1) ;
+        }
+
         return(0) ;
 }
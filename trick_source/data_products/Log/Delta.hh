@@ -5,8 +5,9 @@
 #define DELTA_HH
 
 #include <stdio.h>
+#include <vector>
 #include "DataStream.hh"
-#include "DataStreamGroup.hh"
+#include "DeltaAlign.hh"
 
 class Delta : public DataStream {
 
@@ -26,7 +27,14 @@ class Delta : public DataStream {
 
        DataStream* dataStream1_ ;
        DataStream* dataStream2_ ;
-       DataStreamGroup dsg_ ;
+
+       // Both streams are read and their difference taken when the first
+       // point is wanted.
+       int ready() ;
+       bool loaded_ ;
+       DeltaAlign align_ ;
+       std::vector<double> delta_ ;
+       unsigned int record_ ;
 } ;
 
 #endif
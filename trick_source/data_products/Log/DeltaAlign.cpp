@@ -0,0 +1,133 @@
+
+#include <math.h>
+#include "DeltaAlign.hh"
+
+DeltaAlign::DeltaAlign( double tolerance , Join join ) :
+ tolerance_(tolerance), join_(join), identity_(true) {
+}
+
+void DeltaAlign::read( DataStream * ds , std::vector<double> & times ,
+                       std::vector<double> & values ) {
+
+        double time , value ;
+
+        times.clear() ;
+        values.clear() ;
+        ds->begin() ;
+        while ( ds->get(&time , &value) ) {
+                times.push_back(time) ;
+                values.push_back(value) ;
+        }
+}
+
+void DeltaAlign::align( const std::vector<double> & times1 ,
+                        const std::vector<double> & times2 ) {
+
+        unsigned int ii , jj ;
+        unsigned int n1 = times1.size() ;
+        unsigned int n2 = times2.size() ;
+        double time , weight ;
+
+        times_.clear() ;
+        index1_.clear() ;
+        index2_.clear() ;
+        weight_.clear() ;
+        identity_ = true ;
+
+        if ( join_ == MATCH ) {
+                // Runs logged at the same times match point for point.
+                for ( ii = 0 ; ii < n1 && ii < n2 ; ii++ ) {
+                        if ( fabs(times1[ii] - times2[ii]) > tolerance_ ) {
+                                break ;
+                        }
+                }
+                if ( ii == n1 || ii == n2 ) {
+                        times_.assign(times1.begin() , times1.begin() + ii) ;
+                        return ;
+                }
+
+                ii = jj = 0 ;
+                while ( ii < n1 && jj < n2 ) {
+                        if ( ! ( fabs(times1[ii] - times2[jj]) > tolerance_ )) {
+                                if ( ii != times_.size() || jj != times_.size() ) {
+                                        identity_ = false ;
+                                }
+                                times_.push_back(times1[ii]) ;
+                                index1_.push_back(ii++) ;
+                                index2_.push_back(jj++) ;
+                        } else if ( times1[ii] < times2[jj] ) {
+                                ii++ ;
+                        } else {
+                                jj++ ;
+                        }
+                }
+        } else if ( n2 > 0 ) {
+                jj = 0 ;
+                for ( ii = 0 ; ii < n1 ; ii++ ) {
+                        time = times1[ii] ;
+                        while ( jj + 1 < n2 && times2[jj + 1] <= time ) {
+                                jj++ ;
+                        }
+                        if ( fabs(time - times2[jj]) <= tolerance_ ) {
+                                weight = 0.0 ;
+                        } else if ( jj + 1 < n2 && times2[jj + 1] - time <= tolerance_ ) {
+                                jj++ ;
+                                weight = 0.0 ;
+                        } else if ( jj + 1 < n2 && time > times2[jj] ) {
+                                weight = (time - times2[jj]) / (times2[jj + 1] - times2[jj]) ;
+                        } else {
+                                // Outside the times of the second run.
+                                continue ;
+                        }
+                        if ( ii != times_.size() || jj != times_.size() || weight != 0.0 ) {
+                                identity_ = false ;
+                        }
+                        times_.push_back(time) ;
+                        index1_.push_back(ii) ;
+                        index2_.push_back(jj) ;
+                        weight_.push_back(weight) ;
+                }
+        }
+
+        if ( identity_ ) {
+                index1_.clear() ;
+                index2_.clear() ;
+                weight_.clear() ;
+        }
+}
+
+void DeltaAlign::difference( const std::vector<double> & values1 ,
+                             const std::vector<double> & values2 ,
+                             std::vector<double> & delta ) const {
+
+        unsigned int kk ;
+        unsigned int num = times_.size() ;
+        const double * v1 = values1.empty() ? NULL : &values1[0] ;
+        const double * v2 = values2.empty() ? NULL : &values2[0] ;
+        double * out ;
+        double value2 ;
+
+        delta.resize(num) ;
+        if ( num == 0 ) {
+                return ;
+        }
+        out = &delta[0] ;
+
+        if ( identity_ ) {
+                for ( kk = 0 ; kk < num ; kk++ ) {
+                        out[kk] = v1[kk] - v2[kk] ;
+                }
+        } else if ( join_ == MATCH ) {
+                for ( kk = 0 ; kk < num ; kk++ ) {
+                        out[kk] = v1[index1_[kk]] - v2[index2_[kk]] ;
+                }
+        } else {
+                for ( kk = 0 ; kk < num ; kk++ ) {
+                        value2 = v2[index2_[kk]] ;
+                        if ( weight_[kk] != 0.0 ) {
+                                value2 += weight_[kk] * (v2[index2_[kk] + 1] - value2) ;
+                        }
+                        out[kk] = v1[index1_[kk]] - value2 ;
+                }
+        }
+}
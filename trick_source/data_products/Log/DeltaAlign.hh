@@ -0,0 +1,64 @@
+
+#ifndef DELTAALIGN_HH
+#define DELTAALIGN_HH
+
+#include <vector>
+#include "DataStream.hh"
+
+/**
+ * Aligns the points of two runs by time and takes the difference of their
+ * values, a column at a time rather than a point at a time.
+ *
+ * Both streams are read into memory once. align() then walks the two time
+ * columns together in one pass, recording for each point of the result which
+ * points of the runs it comes from, and difference() applies those to the
+ * value columns in plain loops over arrays. When the runs were logged at the
+ * same times, as they usually are, the difference is one subtraction of the
+ * columns.
+ *
+ * Points are joined one of two ways:
+ *    MATCH        A point wherever the runs have times within the tolerance of
+ *                 each other, at the time of the first run. The earlier of two
+ *                 times that don't match is skipped.
+ *    INTERPOLATE  A point at each time of the first run within the times of
+ *                 the second, whose value there is interpolated linearly.
+ */
+class DeltaAlign {
+
+       public:
+               enum Join { MATCH , INTERPOLATE } ;
+
+               DeltaAlign( double tolerance = 1.0e-9 , Join join = MATCH ) ;
+
+               /** Read a stream from its beginning into time and value columns. */
+               static void read( DataStream * ds , std::vector<double> & times ,
+                                 std::vector<double> & values ) ;
+
+               /** Join the time columns of the two runs. */
+               void align( const std::vector<double> & times1 ,
+                           const std::vector<double> & times2 ) ;
+
+               /**
+                * Take the difference of the value columns of the runs,
+                * values1 - values2, at the points found by align().
+                */
+               void difference( const std::vector<double> & values1 ,
+                                const std::vector<double> & values2 ,
+                                std::vector<double> & delta ) const ;
+
+               /** The times of the points found by align(). */
+               const std::vector<double> & getTimes() const { return times_ ; }
+               unsigned int size() const { return times_.size() ; }
+
+       private:
+               double tolerance_ ;
+               Join join_ ;
+
+               std::vector<double> times_ ;
+               bool identity_ ;                    // Each point is the same of both runs
+               std::vector<unsigned int> index1_ ;
+               std::vector<unsigned int> index2_ ;
+               std::vector<double> weight_ ;       // INTERPOLATE: toward index2_ + 1
+} ;
+
+#endif
@@ -1,9 +1,15 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <pthread.h>
+
 #include "log.h"
 #include "ExternalProgram.hh"
 
+/* External programs are written by users and need not be reentrant, so curves
+   loaded on several threads call them one at a time. */
+static pthread_mutex_t external_program_mutex = PTHREAD_MUTEX_INITIALIZER ;
+
 ExternalProgram::ExternalProgram( const char* sharedLibName,
                                    int nInputStreams, DataStream** istreams,
                                    int nOutputs, int outputIdx )
@@ -111,7 +117,9 @@ int ExternalProgram::getOutputValue( double* timeStamp, double* outputValue )
                 dsg_.getLastRead(istreams_[ii], timeStamp, &input_[ii] ) ;
         }
 
+        pthread_mutex_lock(&external_program_mutex) ;
         ret = external_program(input_, nInputs_, output_, nOutputs_);
+        pthread_mutex_unlock(&external_program_mutex) ;
         if (ret < 0) {
                 fprintf(stderr, "ERROR: External program \"%s\" "
                         " aborted with an error status of %d \n",
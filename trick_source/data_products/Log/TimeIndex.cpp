@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <algorithm>
+#include "TimeIndex.hh"
+#include "trick_byte_order.h"
+
+TimeIndex::TimeIndex( int interval ) :
+ interval_(interval > 0 ? interval : 1), num_records_(0), max_time_(-DBL_MAX) {
+}
+
+bool TimeIndex::load( const std::string & log_name ) {
+
+        const int tag_len = 10 ;
+        char tag[tag_len] ;
+        int my_byte_order ;
+        FILE * fp ;
+        Entry entry ;
+        std::vector<Entry> entries ;
+        bool ok ;
+
+        if ((fp = fopen((log_name + ".idx").c_str() , "r")) == NULL ) {
+                return false ;
+        }
+
+        TRICK_GET_BYTE_ORDER(my_byte_order) ;
+        ok = ( fread(tag , tag_len , 1 , fp) == 1 &&
+               !strncmp(tag , "Trick-IX-" , 9) &&
+               tag[9] == (my_byte_order == TRICK_LITTLE_ENDIAN ? 'L' : 'B') ) ;
+
+        while ( ok &&
+                fread(&entry.max_time , sizeof(double) , 1 , fp) == 1 &&
+                fread(&entry.record , sizeof(long long) , 1 , fp) == 1 &&
+                fread(&entry.offset , sizeof(long long) , 1 , fp) == 1 ) {
+                // Records must increase, and the latest time must not decrease.
+                if ( !entries.empty() &&
+                     ( entry.record <= entries.back().record ||
+                       entry.max_time < entries.back().max_time ) ) {
+                        ok = false ;
+                }
+                entries.push_back(entry) ;
+        }
+        fclose(fp) ;
+
+        if ( !ok || entries.empty() ) {
+                return false ;
+        }
+
+        entries_.swap(entries) ;
+        return true ;
+}
+
+void TimeIndex::add( double time , long long offset ) {
+
+        if ( num_records_ % interval_ == 0 ) {
+                Entry entry ;
+                entry.max_time = max_time_ ;
+                entry.record = num_records_ ;
+                entry.offset = offset ;
+                entries_.push_back(entry) ;
+        }
+        num_records_++ ;
+
+        if ( time > max_time_ ) {
+                max_time_ = time ;
+        }
+}
+
+static bool earlier( const TimeIndex::Entry & entry , double time ) {
+        return entry.max_time < time ;
+}
+
+const TimeIndex::Entry * TimeIndex::find( double time ) const {
+
+        std::vector<Entry>::const_iterator it ;
+
+        if ( entries_.empty() ) {
+                return NULL ;
+        }
+
+        // The first entry with a record at or after time before it; the one
+        // before that is the last with every record before it earlier.
+        it = std::lower_bound(entries_.begin() , entries_.end() , time , earlier) ;
+        if ( it != entries_.begin() ) {
+                --it ;
+        }
+        return &(*it) ;
+}
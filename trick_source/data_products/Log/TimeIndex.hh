@@ -0,0 +1,60 @@
+
+#ifndef TIMEINDEX_HH
+#define TIMEINDEX_HH
+
+#include <string>
+#include <vector>
+
+/**
+ * Index from time to record of a data log, so a reader can start at a given
+ * time without reading the records before it.
+ *
+ * The index is read from the sidecar the data recorders write beside the log
+ * when asked to (see Trick::DataRecordGroup::set_time_index), or built by a
+ * reader in one pass over the time of each record.
+ *
+ * Times need not increase through a log; a restart can go back in time. Each
+ * entry therefore holds the latest time of all records before it, which never
+ * decreases, so find is a binary search and no record before the entry it
+ * returns is at or after the time sought.
+ */
+class TimeIndex {
+
+       public:
+               struct Entry {
+                       double max_time ;   /**< Latest time of the records before this one. */
+                       long long record ;  /**< Number of the record, the first is 0. */
+                       long long offset ;  /**< Byte offset of the record in the log, -1 if none. */
+               } ;
+
+               /** @param interval Records between entries of a built index. */
+               TimeIndex( int interval = 1024 ) ;
+
+               /**
+                * Read the sidecar of a log, log_name + ".idx".
+                * @return false if there is none or it is not a time index
+                *         in this machine's byte order.
+                */
+               bool load( const std::string & log_name ) ;
+
+               /** Add the next record of the log to a built index. */
+               void add( double time , long long offset ) ;
+
+               /**
+                * @return The last entry before which every record is earlier
+                *         than time, or NULL if the index is empty.
+                */
+               const Entry * find( double time ) const ;
+
+               bool empty() const { return entries_.empty() ; }
+               const std::vector<Entry> & getEntries() const { return entries_ ; }
+
+       private:
+               int interval_ ;
+               long long num_records_ ;
+               double max_time_ ;
+               std::vector<Entry> entries_ ;
+
+} ;
+
+#endif
@@ -5,6 +5,12 @@
 #include <stdio.h>
 #include "DataStream.hh"
 
+class TrickBinaryFile ;
+
+/**
+ * One variable of a Trick binary data log. The log is read through the
+ * TrickBinaryFile shared by every TrickBinary of the same file.
+ */
 class TrickBinary : public DataStream {
 
        public:
@@ -17,19 +23,21 @@ class TrickBinary : public DataStream {
                void begin() ;
                int end() ;
                int step() ;
+               int seek(double time) ;
 
        private:
-               FILE *fp_ ;
-               int swap_ ;
-               int time_size_ ;
-               int num_params_ ;
-               int record_offset_ ;
-               int record_size_ ;
-               char * record_ ;
-               int type_ ;
-               int size_ ;
-
-               int data_offset_ ;
+               TrickBinaryFile * file_ ;
+               int param_ ;
+               int num_records_ ;
+               int record_ ;
+               /** The block of records decoded last, first_ up to decoded_. */
+               int first_ ;
+               int decoded_ ;
+               const double * times_ ;
+               const double * values_ ;
+
+               /** Make sure record_ is decoded. @return 0 past the last record. */
+               int ready() ;
 
 } ;
 
@@ -0,0 +1,560 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "TrickBinaryFile.hh"
+#include "trick/parameter_types.h"
+#include "trick_byte_order.h"
+#include "trick_byteswap.h"
+#include "trick/units_conv.h"
+
+/* Records are decoded a block at a time, so readers created after the first
+   read still join the pass over the rest of the file. */
+const int TrickBinaryFile::block_records ;
+
+pthread_mutex_t TrickBinaryFile::files_mutex_ = PTHREAD_MUTEX_INITIALIZER ;
+std::map<std::string, TrickBinaryFile *> TrickBinaryFile::files_ ;
+
+TrickBinaryFile * TrickBinaryFile::open( const char * file_name ) {
+
+        struct stat st ;
+        TrickBinaryFile * file = NULL ;
+        std::map<std::string, TrickBinaryFile *>::iterator it ;
+
+        if ( stat(file_name , &st) != 0 ) {
+                std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return NULL ;
+        }
+
+        pthread_mutex_lock(&files_mutex_) ;
+
+        it = files_.find(file_name) ;
+        if ( it != files_.end() ) {
+                if ( it->second->file_size_ == (long long)st.st_size &&
+                     it->second->file_mtime_ == (long long)st.st_mtime ) {
+                        file = it->second ;
+                } else {
+                        // The file has changed. Its current readers keep the old copy.
+                        files_.erase(it) ;
+                }
+        }
+
+        if ( file == NULL ) {
+                file = new TrickBinaryFile(file_name) ;
+                if ( file->map_ == NULL ) {
+                        delete file ;
+                        file = NULL ;
+                } else {
+                        files_[file_name] = file ;
+                }
+        }
+
+        if ( file != NULL ) {
+                file->ref_count_++ ;
+        }
+
+        pthread_mutex_unlock(&files_mutex_) ;
+        return file ;
+}
+
+void TrickBinaryFile::close( TrickBinaryFile * file ) {
+
+        std::map<std::string, TrickBinaryFile *>::iterator it ;
+
+        if ( file == NULL ) {
+                return ;
+        }
+
+        pthread_mutex_lock(&files_mutex_) ;
+        if ( --file->ref_count_ == 0 ) {
+                it = files_.find(file->file_name_) ;
+                if ( it != files_.end() && it->second == file ) {
+                        files_.erase(it) ;
+                }
+                delete file ;
+        }
+        pthread_mutex_unlock(&files_mutex_) ;
+}
+
+TrickBinaryFile::TrickBinaryFile( const char * file_name ) :
+ ref_count_(0), file_name_(file_name), file_size_(0), file_mtime_(0), map_(NULL),
+ swap_(0), record_size_(0), data_offset_(0), num_records_(0), time_index_(0), index_loaded_(false) {
+
+        struct stat st ;
+        int fd ;
+        void * map ;
+
+        pthread_mutex_init(&mutex_, NULL) ;
+
+        if ((fd = ::open(file_name , O_RDONLY)) < 0 ) {
+                std::cerr << "ERROR:  Couldn't open \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return ;
+        }
+
+        if ( fstat(fd , &st) != 0 || st.st_size == 0 ) {
+                ::close(fd) ;
+                return ;
+        }
+        file_size_ = st.st_size ;
+        file_mtime_ = st.st_mtime ;
+
+        map = mmap(NULL , file_size_ , PROT_READ , MAP_PRIVATE , fd , 0) ;
+        ::close(fd) ;
+        if ( map == MAP_FAILED ) {
+                std::cerr << "ERROR:  Couldn't map \"" << file_name << "\": " << std::strerror(errno) << std::endl;
+                return ;
+        }
+        map_ = (char *)map ;
+        madvise(map_ , file_size_ , MADV_SEQUENTIAL) ;
+
+        if ( ! parse_header(map_ + file_size_) ) {
+                munmap(map_ , file_size_) ;
+                map_ = NULL ;
+                return ;
+        }
+
+        if ( record_size_ > 0 ) {
+                num_records_ = (int)((file_size_ - data_offset_) / record_size_) ;
+        }
+}
+
+TrickBinaryFile::~TrickBinaryFile() {
+
+        unsigned int ii ;
+
+        for ( ii = 0 ; ii < data_.size() ; ii++ ) {
+                delete[] data_[ii] ;
+        }
+        if ( map_ ) {
+                munmap(map_ , file_size_) ;
+        }
+        pthread_mutex_destroy(&mutex_) ;
+}
+
+/* Read a 4 byte integer of the header, swapping it if need be. */
+static bool read_header_int( const char *& cp , const char * end , int swap , int * value ) {
+        if ( end - cp < 4 ) {
+                return false ;
+        }
+        memcpy(value , cp , 4) ;
+        cp += 4 ;
+        if ( swap ) { *value = trick_byteswap_int(*value) ; }
+        return true ;
+}
+
+/* Read a length prefixed string of the header. */
+static bool read_header_string( const char *& cp , const char * end , int swap , std::string & str ) {
+        int len ;
+        if ( ! read_header_int(cp , end , swap , &len) || len < 0 || end - cp < len ) {
+                return false ;
+        }
+        str.assign(cp , len) ;
+        cp += len ;
+        return true ;
+}
+
+bool TrickBinaryFile::parse_header( const char * end ) {
+
+        const int file_type_len = 10 ;
+        const char * file_type = map_ ;
+        const char * cp = map_ ;
+        int my_byte_order ;
+        int num_params ;
+        int ii ;
+        int type ;
+        int size ;
+        std::string name ;
+        std::string units ;
+        std::map<int, TRICK_TYPE> seven_to_ten_params  ;
+
+        if ( end - cp < file_type_len ||
+             ( strncmp( file_type , "Trick-05" , 8 ) &&
+               strncmp( file_type , "Trick-07" , 8 ) &&
+               strncmp( file_type , "Trick-10" , 8 ) ) ) {
+                return false ;
+        }
+        cp += file_type_len ;
+
+        seven_to_ten_params[0] = TRICK_CHARACTER ;
+        seven_to_ten_params[1] = TRICK_UNSIGNED_CHARACTER ;
+        seven_to_ten_params[2] = TRICK_STRING ;
+        seven_to_ten_params[3] = TRICK_SHORT ;
+        seven_to_ten_params[4] = TRICK_UNSIGNED_SHORT ;
+        seven_to_ten_params[5] = TRICK_INTEGER ;
+        seven_to_ten_params[6] = TRICK_UNSIGNED_INTEGER ;
+        seven_to_ten_params[7] = TRICK_LONG ;
+        seven_to_ten_params[8] = TRICK_UNSIGNED_LONG ;
+        seven_to_ten_params[9] = TRICK_FLOAT ;
+        seven_to_ten_params[10] = TRICK_DOUBLE ;
+        seven_to_ten_params[11] = TRICK_BITFIELD ;
+        seven_to_ten_params[12] = TRICK_UNSIGNED_BITFIELD ;
+        seven_to_ten_params[13] = TRICK_LONG_LONG ;
+        seven_to_ten_params[14] = TRICK_UNSIGNED_LONG_LONG ;
+        seven_to_ten_params[15] = TRICK_FILE_PTR ;
+        seven_to_ten_params[16] = TRICK_VOID ;
+        seven_to_ten_params[17] = TRICK_BOOLEAN ;
+        // 18 = TRICK_COMPLX , 19 = TRICK_DBL_COMPLX , 20 = TRICK_REF. These don't exist in 10
+        seven_to_ten_params[21] =  TRICK_WCHAR ;
+        seven_to_ten_params[22] =  TRICK_WSTRING ;
+        seven_to_ten_params[99] = TRICK_VOID_PTR ;
+        seven_to_ten_params[102] = TRICK_ENUMERATED ;
+        seven_to_ten_params[103] = TRICK_STRUCTURED ;
+
+        TRICK_GET_BYTE_ORDER(my_byte_order) ;
+        switch ( file_type[file_type_len - 1] ) {
+            case 'L':
+                    swap_ = ( my_byte_order == TRICK_LITTLE_ENDIAN ) ? 0 : 1 ;
+                    break ;
+            case 'B':
+                    swap_ = ( my_byte_order == TRICK_BIG_ENDIAN ) ? 0 : 1 ;
+                    break ;
+        }
+
+        if ( ! read_header_int(cp , end , swap_ , &num_params) || num_params < 0 ) {
+                return false ;
+        }
+
+        record_size_ = 0 ;
+        for ( ii = 0  ; ii < num_params ; ii++ ) {
+
+                if ( ! read_header_string(cp , end , swap_ , name) ||
+                     ! read_header_string(cp , end , swap_ , units) ) {
+                        return false ;
+                }
+
+                // If this is an 05 log file, we need to convert the units to 07 units
+                // ( where explicit asterisk for multiplication is required. )
+                if ( !strncmp( file_type , "Trick-05" , 8 ) )  {
+                        char new_units_spec[100];
+                        new_units_spec[0] = 0;
+                        if ( convert_units_spec (units.c_str(), new_units_spec) != 0 ) {
+                                printf (" ERROR: Attempt to convert Trick-05 units spec \"%s\" failed.\n\n",units.c_str());
+                        }
+                        units = new_units_spec ;
+                }
+
+                // type of param
+                if ( ! read_header_int(cp , end , swap_ , &type) ) {
+                        return false ;
+                }
+                // adjust the recorded types for 05 & 07 because they are 1 less than Trick10 types (because of Penn!)
+                if ( strncmp( file_type , "Trick-10" , 8 ) )  {
+                    type = (int)seven_to_ten_params[type] ;
+                }
+
+                // size of param
+                if ( ! read_header_int(cp , end , swap_ , &size) ) {
+                        return false ;
+                }
+
+                // correct they "type" according to the size recorded
+                switch ( type ) {
+                    case TRICK_LONG:
+                        switch  ( size ) {
+                            case 4:
+                                type = TRICK_INTEGER ;
+                                break ;
+                            case 8:
+                                type = TRICK_LONG_LONG ;
+                                break ;
+                            default:
+                                break ;
+                        }
+                    case TRICK_UNSIGNED_LONG:
+                        switch  ( size ) {
+                            case 4:
+                                type = TRICK_UNSIGNED_INTEGER ;
+                                break ;
+                            case 8:
+                                type = TRICK_UNSIGNED_LONG_LONG ;
+                                break ;
+                            default:
+                                break ;
+                        }
+                    default:
+                        break ;
+                }
+
+                if ( name == "sys.exec.out.time" ) {
+                        time_index_ = ii ;
+                }
+
+                names_.push_back(name) ;
+                units_.push_back(units) ;
+                types_.push_back(type) ;
+                sizes_.push_back(size) ;
+                offsets_.push_back(record_size_) ;
+
+                record_size_ += size ;
+        }
+
+        data_offset_ = (int)(cp - map_) ;
+        return true ;
+}
+
+int TrickBinaryFile::findParam( const char * param_name ) const {
+
+        int ii ;
+
+        for ( ii = (int)names_.size() - 1 ; ii >= 0 ; ii-- ) {
+                if ( names_[ii] == param_name ) {
+                        return ii ;
+                }
+        }
+        return -1 ;
+}
+
+const double * TrickBinaryFile::request( int index ) {
+
+        double * data ;
+        std::map<int, int>::iterator it ;
+
+        pthread_mutex_lock(&mutex_) ;
+        it = column_of_.find(index) ;
+        if ( it != column_of_.end() ) {
+                data = data_[it->second] ;
+        } else {
+                data = new double[num_records_ > 0 ? num_records_ : 1] ;
+                column_of_[index] = (int)columns_.size() ;
+                columns_.push_back(index) ;
+                decoded_.push_back(std::vector<bool>((num_records_ + block_records - 1) / block_records , false)) ;
+                data_.push_back(data) ;
+        }
+        pthread_mutex_unlock(&mutex_) ;
+
+        return data ;
+}
+
+int TrickBinaryFile::decode( int index , int record ) {
+
+        int column ;
+        int block = record / block_records ;
+        int last ;
+
+        if ( record < 0 || record >= num_records_ ) {
+                return 0 ;
+        }
+
+        pthread_mutex_lock(&mutex_) ;
+        column = column_of_[index] ;
+        if ( ! decoded_[column][block] ) {
+                decode_block(block) ;
+        }
+        pthread_mutex_unlock(&mutex_) ;
+
+        last = (block + 1) * block_records ;
+        return last < num_records_ ? last : num_records_ ;
+}
+
+/* Decode one value of a record, as TrickBinary::get always has. */
+static double decode_value( const char * cp , int type , int size , int swap ) {
+
+        char c ;
+        unsigned char uc ;
+        short s ;
+        unsigned short us ;
+        int i ;
+        unsigned int ui ;
+        long l ;
+        unsigned long ul ;
+        float f ;
+        double d ;
+        long long ll ;
+        unsigned long long ull ;
+
+        switch ( type ) {
+                case TRICK_CHARACTER:
+                        memcpy(&c , cp , sizeof(c)) ;
+                        return (double)c ;
+                case TRICK_UNSIGNED_CHARACTER:
+                        memcpy(&uc , cp , sizeof(uc)) ;
+                        return (double)uc ;
+                case TRICK_SHORT:
+                        memcpy(&s , cp , sizeof(s)) ;
+                        return (double)(swap ? trick_byteswap_short(s) : s) ;
+                case TRICK_UNSIGNED_SHORT:
+                        memcpy(&us , cp , sizeof(us)) ;
+                        return (double)(swap ? trick_byteswap_short(us) : us) ;
+                case TRICK_ENUMERATED:
+                case TRICK_INTEGER:
+                        memcpy(&i , cp , sizeof(i)) ;
+                        return (double)(swap ? trick_byteswap_int(i) : i) ;
+                case TRICK_UNSIGNED_INTEGER:
+                        memcpy(&ui , cp , sizeof(ui)) ;
+                        return (double)(swap ? (unsigned int)trick_byteswap_int(ui) : ui) ;
+                case TRICK_LONG:
+                        memcpy(&l , cp , sizeof(l)) ;
+                        return (double)(swap ? trick_byteswap_long(l) : l) ;
+                case TRICK_UNSIGNED_LONG:
+                        memcpy(&ul , cp , sizeof(ul)) ;
+                        return (double)(swap ? (unsigned long)trick_byteswap_long(ul) : ul) ;
+                case TRICK_FLOAT:
+                        memcpy(&f , cp , sizeof(f)) ;
+                        return (double)(swap ? trick_byteswap_float(f) : f) ;
+                case TRICK_DOUBLE:
+                        memcpy(&d , cp , sizeof(d)) ;
+                        return swap ? trick_byteswap_double(d) : d ;
+                case TRICK_BITFIELD:
+                        switch ( size ) {
+                                case 1 :
+                                        return decode_value(cp , TRICK_CHARACTER , size , swap) ;
+                                case 2 :
+                                        return decode_value(cp , TRICK_SHORT , size , swap) ;
+                                case 4 :
+                                        return decode_value(cp , TRICK_INTEGER , size , swap) ;
+                        }
+                        break ;
+                case TRICK_UNSIGNED_BITFIELD:
+                        switch ( size ) {
+                                case 1 :
+                                        return decode_value(cp , TRICK_UNSIGNED_CHARACTER , size , swap) ;
+                                case 2 :
+                                        memcpy(&us , cp , sizeof(us)) ;
+                                        return (double)(swap ? (unsigned short)trick_byteswap_short(us) : us) ;
+                                case 4 :
+                                        return decode_value(cp , TRICK_UNSIGNED_INTEGER , size , swap) ;
+                        }
+                        break ;
+                case TRICK_LONG_LONG:
+                        memcpy(&ll , cp , sizeof(ll)) ;
+                        return (double)(swap ? trick_byteswap_long_long(ll) : ll) ;
+                case TRICK_UNSIGNED_LONG_LONG:
+                        memcpy(&ull , cp , sizeof(ull)) ;
+                        return (double)(swap ? (unsigned long long)trick_byteswap_long_long(ull) : ull) ;
+                case TRICK_BOOLEAN:
+                        switch ( size ) {
+                                case 1 :
+                                        return decode_value(cp , TRICK_UNSIGNED_CHARACTER , size , swap) ;
+                                case 4 :
+                                        return decode_value(cp , TRICK_INTEGER , size , swap) ;
+                        }
+                        break ;
+        }
+        return 0.0 ;
+}
+
+/* The time is recorded as a double or a float, whatever its recorded type. */
+int TrickBinaryFile::decode_type( int index ) const {
+        if ( index == time_index_ ) {
+                return sizes_[time_index_] == 8 ? TRICK_DOUBLE : TRICK_FLOAT ;
+        }
+        return types_[index] ;
+}
+
+/* Decode a block of records for every requested column that has not decoded
+   it yet, in one pass over the records. */
+void TrickBinaryFile::decode_block( int block ) {
+
+        unsigned int jj ;
+        int ii ;
+        int first = block * block_records ;
+        int last = first + block_records ;
+        std::vector<unsigned int> columns ;
+        std::vector<int> types ;
+
+        if ( last > num_records_ ) {
+                last = num_records_ ;
+        }
+
+        for ( jj = 0 ; jj < columns_.size() ; jj++ ) {
+                if ( ! decoded_[jj][block] ) {
+                        columns.push_back(jj) ;
+                        types.push_back( decode_type(columns_[jj]) ) ;
+                        decoded_[jj][block] = true ;
+                }
+        }
+
+        for ( ii = first ; ii < last ; ii++ ) {
+                const char * record = map_ + data_offset_ + (long long)ii * record_size_ ;
+                for ( jj = 0 ; jj < columns.size() ; jj++ ) {
+                        int index = columns_[columns[jj]] ;
+                        data_[columns[jj]][ii] = decode_value(record + offsets_[index] , types[jj] ,
+                                                              sizes_[index] , swap_) ;
+                }
+        }
+}
+
+/* Nothing shared is written, so no lock is needed. */
+void TrickBinaryFile::decodeRows( const std::vector<int> & indices , int first , int count , double * rows ) const {
+
+        unsigned int jj ;
+        int ii ;
+        unsigned int num_columns = indices.size() ;
+        std::vector<int> types(num_columns) ;
+        std::vector<int> sizes(num_columns) ;
+        std::vector<int> offsets(num_columns) ;
+
+        for ( jj = 0 ; jj < num_columns ; jj++ ) {
+                types[jj] = decode_type(indices[jj]) ;
+                sizes[jj] = sizes_[indices[jj]] ;
+                offsets[jj] = offsets_[indices[jj]] ;
+        }
+
+        for ( ii = 0 ; ii < count ; ii++ ) {
+                const char * record = map_ + data_offset_ + (long long)(first + ii) * record_size_ ;
+                for ( jj = 0 ; jj < num_columns ; jj++ ) {
+                        *rows++ = decode_value(record + offsets[jj] , types[jj] , sizes[jj] , swap_) ;
+                }
+        }
+}
+
+double TrickBinaryFile::get_time( int record ) const {
+        return decode_value(map_ + data_offset_ + (long long)record * record_size_ + offsets_[time_index_] ,
+                            decode_type(time_index_) , sizes_[time_index_] , swap_) ;
+}
+
+/* Use the time index the recorder wrote if it indexes this file, else build
+   one from the time of each record. */
+void TrickBinaryFile::load_index() {
+
+        unsigned int ii ;
+        int record ;
+        bool ok ;
+
+        index_loaded_ = true ;
+
+        if ( index_.load(file_name_) ) {
+                const std::vector<TimeIndex::Entry> & entries = index_.getEntries() ;
+                ok = true ;
+                for ( ii = 0 ; ii < entries.size() && ok ; ii++ ) {
+                        ok = ( entries[ii].record < num_records_ &&
+                               entries[ii].offset == data_offset_ + entries[ii].record * record_size_ ) ;
+                }
+                if ( ok ) {
+                        return ;
+                }
+                index_ = TimeIndex() ;
+        }
+
+        for ( record = 0 ; record < num_records_ ; record++ ) {
+                index_.add(get_time(record) , data_offset_ + (long long)record * record_size_) ;
+        }
+}
+
+int TrickBinaryFile::seek( double time ) {
+
+        const TimeIndex::Entry * entry ;
+        int record = 0 ;
+
+        pthread_mutex_lock(&mutex_) ;
+        if ( ! index_loaded_ ) {
+                load_index() ;
+        }
+        if ((entry = index_.find(time)) != NULL ) {
+                record = (int)entry->record ;
+        }
+        pthread_mutex_unlock(&mutex_) ;
+
+        // The entry after this one is at or after time, so this runs to at
+        // most the next entry.
+        while ( record < num_records_ && get_time(record) < time ) {
+                record++ ;
+        }
+        return record ;
+}
@@ -0,0 +1,129 @@
+
+#ifndef TRICKBINARYFILE_HH
+#define TRICKBINARYFILE_HH
+
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "TimeIndex.hh"
+
+/**
+ * A Trick binary data log shared by every reader of the file.
+ *
+ * The file is mapped into memory once. Each reader requests the columns it
+ * needs; the records are then decoded a block at a time, every requested
+ * column in the same pass, into one contiguous array of doubles per column.
+ * A product that plots many variables from one log therefore reads and
+ * decodes the file once, not once per variable.
+ *
+ * Files are shared by name through open and close. A file that has changed
+ * since it was opened is opened afresh.
+ *
+ * seek finds the record to start reading from at a given time through the
+ * time index the recorder wrote beside the log, or one built from the time
+ * of each record on first use. Only the blocks read from there are decoded.
+ */
+class TrickBinaryFile {
+
+       public:
+               /** Records are decoded this many at a time. */
+               static const int block_records = 65536 ;
+
+               /**
+                * Get the shared reader of a file, opening it if need be.
+                * @return The reader, or NULL if the file is not a Trick
+                *         binary log. Release it with close.
+                */
+               static TrickBinaryFile * open( const char * file_name ) ;
+
+               /** Release a reader returned by open. NULL is ignored. */
+               static void close( TrickBinaryFile * file ) ;
+
+               int getNumParams() const { return (int)names_.size() ; }
+               int getNumRecords() const { return num_records_ ; }
+               const std::string & getFileName() const { return file_name_ ; }
+               const std::string & getName( int index ) const { return names_[index] ; }
+               /** Units as recorded, converted to Trick-07 syntax for Trick-05 logs. */
+               const std::string & getUnits( int index ) const { return units_[index] ; }
+               int getTimeIndex() const { return time_index_ ; }
+
+               /**
+                * @return Index of the last parameter of that name, as the
+                *         readers have always used, or -1 if there is none.
+                */
+               int findParam( const char * param_name ) const ;
+
+               /**
+                * Request a column. Records are decoded into it by decode.
+                * @return The column, num_records long.
+                */
+               const double * request( int index ) ;
+
+               /**
+                * Decode the block of records holding the given record for
+                * every requested column that still lacks it.
+                * @return End of the block, which starts at
+                *         record - record % block_records.
+                */
+               int decode( int index , int record ) ;
+
+               /**
+                * Decode count records from first, of the given parameters,
+                * into rows of indices.size() values, without keeping them.
+                * Unlike decode, any number of threads may do so at once.
+                */
+               void decodeRows( const std::vector<int> & indices , int first , int count ,
+                                double * rows ) const ;
+
+               /**
+                * @return The first record at or after time, with every record
+                *         before it earlier, or num_records if there is none.
+                */
+               int seek( double time ) ;
+
+       private:
+               TrickBinaryFile( const char * file_name ) ;
+               ~TrickBinaryFile() ;
+
+               bool parse_header( const char * end ) ;
+               int decode_type( int index ) const ;
+               void decode_block( int block ) ;
+               double get_time( int record ) const ;
+               void load_index() ;
+
+               static pthread_mutex_t files_mutex_ ;
+               static std::map<std::string, TrickBinaryFile *> files_ ;
+
+               pthread_mutex_t mutex_ ;
+               int ref_count_ ;
+
+               std::string file_name_ ;
+               long long file_size_ ;
+               long long file_mtime_ ;
+               char * map_ ;
+
+               int swap_ ;
+               int record_size_ ;
+               int data_offset_ ;
+               int num_records_ ;
+               int time_index_ ;
+
+               std::vector<std::string> names_ ;
+               std::vector<std::string> units_ ;
+               std::vector<int> types_ ;
+               std::vector<int> sizes_ ;
+               std::vector<int> offsets_ ;
+
+               /** Requested columns, the blocks decoded into each, and their data. */
+               std::vector<int> columns_ ;
+               std::vector< std::vector<bool> > decoded_ ;
+               std::vector<double *> data_ ;
+               std::map<int, int> column_of_ ;
+
+               bool index_loaded_ ;
+               TimeIndex index_ ;
+
+} ;
+
+#endif
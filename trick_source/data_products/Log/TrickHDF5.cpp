@@ -3,12 +3,18 @@
 #include <string.h>
 #include <strings.h>
 #include <math.h>
+#include <pthread.h>
 #include "TrickHDF5.hh"
 #include "trick/map_trick_units_to_udunits.hh"
 
+/*! The HDF5 library is not built thread safe by default, so the streams of
+ *  curves loaded on several threads read their packet tables one at a time. */
+static pthread_mutex_t hdf5_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 TrickHDF5::TrickHDF5(char *file_name , char *parameter_name , char *time_name) {
 
     packet_index = 0;
+    index_loaded = false;
 
     hid_t header_group, parameter_names, parameter_units;
     hsize_t header_packet_index;
@@ -107,8 +113,10 @@ int TrickHDF5::get(double *time, double *value) {
     if ( packet_index < num_packets ) {
         /*! Retrieve a param value (plus corresponding time)
          *  from the current packet index position. */
+        pthread_mutex_lock(&hdf5_mutex);
         H5PTget_next(parameter_dataset, 1, value);
         H5PTget_next(time_dataset,      1, time);
+        pthread_mutex_unlock(&hdf5_mutex);
 
         //! Advance the packet index.
         ret = this->step();
@@ -136,6 +144,8 @@ void TrickHDF5::begin() {
     //! Reset the dataset if another data pass is needed.
     packet_index = 0;
 
+    pthread_mutex_lock(&hdf5_mutex);
+
     /*! See how many packets were logged for this parameter.
      *  Each recorded value is represented by one packet. */
     H5PTget_num_packets( parameter_dataset, &num_packets );
@@ -147,14 +157,18 @@ void TrickHDF5::begin() {
     H5PTcreate_index( time_dataset );
     H5PTcreate_index( parameter_dataset );
 
+    pthread_mutex_unlock(&hdf5_mutex);
+
     return ;
 }
 
 int TrickHDF5::end() {
 
     //! Move packet index to the end of the packet table.
+    pthread_mutex_lock(&hdf5_mutex);
     H5PTset_index( time_dataset, num_packets );
     H5PTset_index( parameter_dataset, num_packets );
+    pthread_mutex_unlock(&hdf5_mutex);
     packet_index = num_packets;
 
     return (1);
@@ -168,8 +182,10 @@ int TrickHDF5::step() {
         /*! Set the packet table's index.  Each packet table keeps an index
          *  of its "current" packet so that get_next can iterate through
          *  the packets in order. */
+        pthread_mutex_lock(&hdf5_mutex);
         H5PTset_index( time_dataset, packet_index );
         H5PTset_index( parameter_dataset, packet_index );
+        pthread_mutex_unlock(&hdf5_mutex);
 
         return (1);
 
@@ -179,6 +195,47 @@ int TrickHDF5::step() {
     }
 }
 
+int TrickHDF5::seek( double time ) {
+
+    const TimeIndex::Entry * entry;
+    double packet_time;
+
+    begin();
+
+    pthread_mutex_lock(&hdf5_mutex);
+
+    if ( ! index_loaded ) {
+        index_loaded = true;
+        /*! Without the index the recorder wrote, build one from the time
+         *  packets alone, which is far less to read than the values. */
+        if ( ! index.load(fileName_) && num_packets > 0 ) {
+            std::vector<double> times(num_packets);
+            if ( H5PTread_packets( time_dataset, 0, num_packets, &times[0] ) >= 0 ) {
+                for ( hsize_t ii = 0; ii < num_packets; ii++ ) {
+                    index.add( times[ii], -1 );
+                }
+            }
+        }
+    }
+
+    if ( (entry = index.find(time)) != NULL && (hsize_t)entry->record < num_packets ) {
+        packet_index = entry->record;
+    }
+
+    //! Read the times from there until one is at or after the time sought.
+    while ( packet_index < num_packets &&
+            H5PTread_packets( time_dataset, packet_index, 1, &packet_time ) >= 0 &&
+            packet_time < time ) {
+        packet_index++;
+    }
+    H5PTset_index( time_dataset, packet_index );
+    H5PTset_index( parameter_dataset, packet_index );
+
+    pthread_mutex_unlock(&hdf5_mutex);
+
+    return ( packet_index < num_packets );
+}
+
 
 int HDF5LocateParam( const char * file_name, const char * parameter_name ) {
 
@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <vector>
 #include "DataStream.hh"
+#include "TimeIndex.hh"
 #include "hdf5.h"
 #include "H5PTpublic.h"
 
@@ -20,6 +21,7 @@ class TrickHDF5 : public DataStream {
         void begin() ;
         int end() ;
         int step() ;
+        int seek(double time) ;
 
     private:
         hid_t           file;
@@ -31,6 +33,8 @@ class TrickHDF5 : public DataStream {
         size_t          parameter_size;
         hsize_t         num_packets;
         hsize_t         packet_index;
+        bool            index_loaded;
+        TimeIndex       index;
 
 } ;
 
@@ -0,0 +1,157 @@
+/**
+ * @if Er7UtilsUseGroups
+ * @addtogroup Er7Utils
+ * @{
+ * @addtogroup Integration
+ * @{
+ * @endif
+ */
+
+/**
+ * @file
+ * Declares the out-of-line, vectorized versions of the integ_utils
+ * step primitives.
+ */
+
+/*
+Purpose: ()
+*/
+
+
+#ifndef ER7_UTILS_INTEG_SIMD_HH
+#define ER7_UTILS_INTEG_SIMD_HH
+
+// Interface includes
+#include "er7_utils/interface/include/config.hh"
+
+
+namespace er7_utils {
+
+/**
+ * Vectorized step primitives.
+ *
+ * The inline primitives in integ_utils forward to these functions when the
+ * state size is at least integ_simd::min_size. On x86-64 Linux builds with
+ * GCC each function is compiled for AVX-512, AVX2 and the baseline
+ * instruction set, and the dynamic loader picks the widest version the
+ * processor supports. Elsewhere the functions are plain loops.
+ *
+ * The vector versions perform the same multiplications and additions, in
+ * the same order, as the inline scalar loops, and never fuse a multiply
+ * and an add. Results are bit for bit identical to the scalar results.
+ */
+namespace integ_simd {
+
+   /**
+    * Smallest state size handed to the vectorized functions.
+    * Smaller states stay on the inline loops, where a call would cost more
+    * than it saves. Set to a very large value to force the scalar loops.
+    */
+   extern int min_size;
+
+
+   /**
+    * Vectorized integ_utils::inplace_euler_step.
+    */
+   void inplace_euler_step (
+      double const * ER7_UTILS_RESTRICT deriv,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT state);
+
+   /**
+    * Vectorized integ_utils::inplace_euler_step_save_state.
+    */
+   void inplace_euler_step_save_state (
+      double const * ER7_UTILS_RESTRICT deriv,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT init_state,
+      double * ER7_UTILS_RESTRICT state);
+
+   /**
+    * Vectorized integ_utils::inplace_euler_step_save_both.
+    */
+   void inplace_euler_step_save_both (
+      double const * ER7_UTILS_RESTRICT deriv,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT init_state,
+      double * ER7_UTILS_RESTRICT init_deriv,
+      double * ER7_UTILS_RESTRICT state);
+
+   /**
+    * Vectorized integ_utils::euler_step.
+    */
+   void euler_step (
+      double const * ER7_UTILS_RESTRICT old_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT new_state);
+
+   /**
+    * Vectorized integ_utils::euler_step_save_deriv.
+    */
+   void euler_step_save_deriv (
+      double const * ER7_UTILS_RESTRICT old_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT saved_deriv,
+      double * ER7_UTILS_RESTRICT new_state);
+
+   /**
+    * Vectorized integ_utils::weighted_sum.
+    * When deriv is null the newest derivatives are the last entry in
+    * deriv_hist, otherwise they are deriv.
+    */
+   void weighted_sum (
+      double const * ER7_UTILS_RESTRICT deriv,
+      double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+      double const * ER7_UTILS_RESTRICT weights,
+      int nweights,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT delta_pos);
+
+   /**
+    * Vectorized integ_utils::weighted_step.
+    * When deriv is null the newest derivatives are the last entry in
+    * deriv_hist, otherwise they are deriv.
+    */
+   void weighted_step (
+      double const * ER7_UTILS_RESTRICT init_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+      double const * ER7_UTILS_RESTRICT weights,
+      int nweights,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT new_state);
+
+   /**
+    * Vectorized integ_utils::weighted_step_save_deriv.
+    */
+   void weighted_step_save_deriv (
+      double const * ER7_UTILS_RESTRICT init_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double const * ER7_UTILS_RESTRICT weights,
+      int nweights,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT * ER7_UTILS_RESTRICT deriv_hist,
+      double * ER7_UTILS_RESTRICT new_state);
+
+}
+
+}
+
+
+#endif
+/**
+ * @if Er7UtilsUseGroups
+ * @}
+ * @}
+ * @endif
+ */
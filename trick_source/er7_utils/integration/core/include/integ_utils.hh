@@ -26,6 +26,13 @@ Purpose: ()
 // Interface includes
 #include "er7_utils/interface/include/er7_class.hh"
 
+// Integration includes
+// Define ER7_UTILS_NO_VECTOR_STEPS to keep every step on the inline loops,
+// e.g. in code that is not linked with the er7_utils library.
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+#include "integ_simd.hh"
+#endif
+
 
 namespace er7_utils {
 
@@ -146,6 +153,12 @@ namespace integ_utils {
       int size,
       double * ER7_UTILS_RESTRICT state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::inplace_euler_step (deriv, deltat, size, state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          state[ii] += deriv[ii] * deltat;
       }
@@ -168,6 +181,13 @@ namespace integ_utils {
       double * ER7_UTILS_RESTRICT init_state,
       double * ER7_UTILS_RESTRICT state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::inplace_euler_step_save_state (
+            deriv, deltat, size, init_state, state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          init_state[ii] = state[ii];
          state[ii] += deriv[ii] * deltat;
@@ -216,6 +236,13 @@ namespace integ_utils {
       double * ER7_UTILS_RESTRICT init_deriv,
       double * ER7_UTILS_RESTRICT state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::inplace_euler_step_save_both (
+            deriv, deltat, size, init_state, init_deriv, state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          init_state[ii] = state[ii];
          init_deriv[ii] = deriv[ii];
@@ -240,6 +267,12 @@ namespace integ_utils {
       int size,
       double * ER7_UTILS_RESTRICT new_state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::euler_step (old_state, deriv, deltat, size, new_state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          new_state[ii] = old_state[ii] + deriv[ii] * deltat;
       }
@@ -264,6 +297,13 @@ namespace integ_utils {
       double * ER7_UTILS_RESTRICT saved_deriv,
       double * ER7_UTILS_RESTRICT new_state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::euler_step_save_deriv (
+            old_state, deriv, deltat, size, saved_deriv, new_state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          saved_deriv[ii] = deriv[ii];
          new_state[ii] = old_state[ii] + deriv[ii] * deltat;
@@ -644,6 +684,13 @@ namespace integ_utils {
       int size,
       double * ER7_UTILS_RESTRICT delta_pos)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::weighted_sum (
+            0, deriv_hist, weights, nweights, deltat, size, delta_pos);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          double sum = weights[0] * deriv_hist[0][ii];
          for (int jj = 1; jj < nweights; ++jj) {
@@ -677,6 +724,13 @@ namespace integ_utils {
       int size,
       double * ER7_UTILS_RESTRICT delta_pos)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::weighted_sum (
+            deriv, deriv_hist, weights, nweights, deltat, size, delta_pos);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          double sum = weights[nweights-1] * deriv[ii];
          for (int jj = 0; jj < nweights-1; ++jj) {
@@ -743,6 +797,14 @@ namespace integ_utils {
       int size,
       double * ER7_UTILS_RESTRICT new_state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::weighted_step (
+            init_state, deriv, deriv_hist, weights, nweights, deltat, size,
+            new_state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          double weighted_deriv = weights[nweights-1] * deriv[ii];
          for (int jj = 0; jj < nweights-1; ++jj) {
@@ -773,6 +835,14 @@ namespace integ_utils {
       int size,
       double * ER7_UTILS_RESTRICT new_state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::weighted_step (
+            init_state, 0, deriv_hist, weights, nweights, deltat, size,
+            new_state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          double weighted_deriv = weights[0] * deriv_hist[0][ii];
          for (int jj = 1; jj < nweights; ++jj) {
@@ -804,6 +874,14 @@ namespace integ_utils {
       double * ER7_UTILS_RESTRICT * ER7_UTILS_RESTRICT deriv_hist,
       double * ER7_UTILS_RESTRICT new_state)
    {
+#ifndef ER7_UTILS_NO_VECTOR_STEPS
+      if (size >= integ_simd::min_size) {
+         integ_simd::weighted_step_save_deriv (
+            init_state, deriv, weights, nweights, deltat, size, deriv_hist,
+            new_state);
+         return;
+      }
+#endif
       for (int ii = 0; ii < size; ++ii) {
          double weighted_deriv = weights[nweights-1] * deriv[ii];
          for (int jj = 0; jj < nweights-1; ++jj) {
@@ -0,0 +1,361 @@
+/**
+ * @if Er7UtilsUseGroups
+ * @addtogroup Er7Utils
+ * @{
+ * @addtogroup Integration
+ * @{
+ * @endif
+ */
+
+/**
+ * @file
+ * Implements the vectorized integ_utils step primitives.
+ */
+
+/*
+Purpose: ()
+*/
+
+
+// Vectorize the loops whatever the optimization level, and never contract a
+// multiply and an add into a fused multiply-add: the AVX-512 versions would
+// otherwise round differently than the scalar loops.
+#if (defined __GNUC__) && !(defined __clang__)
+#pragma GCC optimize ("tree-vectorize", "fp-contract=off")
+#elif (defined __clang__)
+#pragma clang fp contract(off)
+#endif
+
+
+// Local includes
+#include "../include/integ_simd.hh"
+
+
+/**
+ * @def ER7_UTILS_SIMD_CLONES
+ * Compile a function for each of the listed instruction sets and select one
+ * when the program is loaded.
+ */
+#if (defined __GNUC__) && !(defined __clang__) && (__GNUC__ >= 6) && \
+    (defined __x86_64__) && (defined __linux__)
+#define ER7_UTILS_SIMD_CLONES \
+   __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#define ER7_UTILS_SIMD_CLONES
+#endif
+
+
+namespace er7_utils {
+
+namespace integ_simd {
+
+int min_size = 16;
+
+
+namespace {
+
+   /**
+    * Weighted sum of nweights derivatives, using the same operation order as
+    * the integ_utils loops. When deriv is non-null the sum starts with the
+    * newest derivatives, deriv, and continues with the nweights-1 history
+    * entries. Otherwise the sum runs over the nweights history entries,
+    * oldest first. The step adds init_state to the scaled sum when add_init
+    * is true; the sum alone is computed otherwise.
+    * Every ii is independent, so the loops vectorize across the states.
+    */
+   template <int nweights, bool add_init>
+   inline void ER7_UTILS_ALWAYS_INLINE
+   weighted_step_n (
+      double const * ER7_UTILS_RESTRICT init_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+      double const * ER7_UTILS_RESTRICT weights,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT new_state)
+   {
+      double const * hist[nweights];
+      double wts[nweights];
+      int nhist = (deriv != 0) ? nweights-1 : nweights;
+      for (int jj = 0; jj < nhist; ++jj) {
+         hist[jj] = deriv_hist[jj];
+      }
+      for (int jj = 0; jj < nweights; ++jj) {
+         wts[jj] = weights[jj];
+      }
+
+      if (deriv != 0) {
+         for (int ii = 0; ii < size; ++ii) {
+            double weighted_deriv = wts[nweights-1] * deriv[ii];
+            for (int jj = 0; jj < nweights-1; ++jj) {
+               weighted_deriv += wts[jj] * hist[jj][ii];
+            }
+            new_state[ii] = add_init ?
+                            init_state[ii] + weighted_deriv * deltat :
+                            weighted_deriv * deltat;
+         }
+      }
+      else {
+         for (int ii = 0; ii < size; ++ii) {
+            double weighted_deriv = wts[0] * hist[0][ii];
+            for (int jj = 1; jj < nweights; ++jj) {
+               weighted_deriv += wts[jj] * hist[jj][ii];
+            }
+            new_state[ii] = add_init ?
+                            init_state[ii] + weighted_deriv * deltat :
+                            weighted_deriv * deltat;
+         }
+      }
+   }
+
+
+   /**
+    * The same sums, computed a block of states at a time with one pass over
+    * the block per derivative. Each state still sees its terms in the same
+    * order, while every pass is a simple loop with only two input streams.
+    * This beats weighted_step_n once the weight count is large enough that
+    * the unrolled loop runs out of registers and input streams.
+    */
+   template <bool add_init>
+   inline void ER7_UTILS_ALWAYS_INLINE
+   weighted_step_blocked (
+      double const * ER7_UTILS_RESTRICT init_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+      double const * ER7_UTILS_RESTRICT weights,
+      int nweights,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT new_state)
+   {
+      const int block_size = 256;
+      double sum[block_size];
+
+      for (int start = 0; start < size; start += block_size) {
+         int count = (size - start < block_size) ? size - start : block_size;
+         int first = 0;
+
+         if (deriv != 0) {
+            double const * ER7_UTILS_RESTRICT newest = deriv + start;
+            double weight = weights[nweights-1];
+            for (int ii = 0; ii < count; ++ii) {
+               sum[ii] = weight * newest[ii];
+            }
+         }
+         else {
+            double const * ER7_UTILS_RESTRICT oldest = deriv_hist[0] + start;
+            double weight = weights[0];
+            for (int ii = 0; ii < count; ++ii) {
+               sum[ii] = weight * oldest[ii];
+            }
+            first = 1;
+         }
+
+         int last = (deriv != 0) ? nweights-1 : nweights;
+         for (int jj = first; jj < last; ++jj) {
+            double const * ER7_UTILS_RESTRICT hist = deriv_hist[jj] + start;
+            double weight = weights[jj];
+            for (int ii = 0; ii < count; ++ii) {
+               sum[ii] += weight * hist[ii];
+            }
+         }
+
+         double * ER7_UTILS_RESTRICT out = new_state + start;
+         if (add_init) {
+            double const * ER7_UTILS_RESTRICT init = init_state + start;
+            for (int ii = 0; ii < count; ++ii) {
+               out[ii] = init[ii] + sum[ii] * deltat;
+            }
+         }
+         else {
+            for (int ii = 0; ii < count; ++ii) {
+               out[ii] = sum[ii] * deltat;
+            }
+         }
+      }
+   }
+
+
+   /**
+    * Dispatch on the weight count. Up to four weights, as in the Runge
+    * Kutta 4 and ABM4 updates, the unrolled loop wins; the longer sums of
+    * the higher order methods, up to the 13 stages of RKF7(8), use blocks.
+    */
+   template <bool add_init>
+   inline void ER7_UTILS_ALWAYS_INLINE
+   weighted_step_dispatch (
+      double const * ER7_UTILS_RESTRICT init_state,
+      double const * ER7_UTILS_RESTRICT deriv,
+      double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+      double const * ER7_UTILS_RESTRICT weights,
+      int nweights,
+      double deltat,
+      int size,
+      double * ER7_UTILS_RESTRICT new_state)
+   {
+#define ER7_UTILS_WEIGHTED_CASE(n) \
+      case n: \
+         weighted_step_n<n, add_init> ( \
+            init_state, deriv, deriv_hist, weights, deltat, size, new_state); \
+         break
+
+      switch (nweights) {
+      ER7_UTILS_WEIGHTED_CASE(1);
+      ER7_UTILS_WEIGHTED_CASE(2);
+      ER7_UTILS_WEIGHTED_CASE(3);
+      ER7_UTILS_WEIGHTED_CASE(4);
+      default:
+         weighted_step_blocked<add_init> (
+            init_state, deriv, deriv_hist, weights, nweights, deltat, size,
+            new_state);
+         break;
+      }
+
+#undef ER7_UTILS_WEIGHTED_CASE
+   }
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+inplace_euler_step (
+   double const * ER7_UTILS_RESTRICT deriv,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT state)
+{
+   for (int ii = 0; ii < size; ++ii) {
+      state[ii] += deriv[ii] * deltat;
+   }
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+inplace_euler_step_save_state (
+   double const * ER7_UTILS_RESTRICT deriv,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT init_state,
+   double * ER7_UTILS_RESTRICT state)
+{
+   for (int ii = 0; ii < size; ++ii) {
+      init_state[ii] = state[ii];
+      state[ii] += deriv[ii] * deltat;
+   }
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+inplace_euler_step_save_both (
+   double const * ER7_UTILS_RESTRICT deriv,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT init_state,
+   double * ER7_UTILS_RESTRICT init_deriv,
+   double * ER7_UTILS_RESTRICT state)
+{
+   for (int ii = 0; ii < size; ++ii) {
+      init_state[ii] = state[ii];
+      init_deriv[ii] = deriv[ii];
+      state[ii] += deriv[ii] * deltat;
+   }
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+euler_step (
+   double const * ER7_UTILS_RESTRICT old_state,
+   double const * ER7_UTILS_RESTRICT deriv,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT new_state)
+{
+   for (int ii = 0; ii < size; ++ii) {
+      new_state[ii] = old_state[ii] + deriv[ii] * deltat;
+   }
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+euler_step_save_deriv (
+   double const * ER7_UTILS_RESTRICT old_state,
+   double const * ER7_UTILS_RESTRICT deriv,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT saved_deriv,
+   double * ER7_UTILS_RESTRICT new_state)
+{
+   for (int ii = 0; ii < size; ++ii) {
+      saved_deriv[ii] = deriv[ii];
+      new_state[ii] = old_state[ii] + deriv[ii] * deltat;
+   }
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+weighted_sum (
+   double const * ER7_UTILS_RESTRICT deriv,
+   double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+   double const * ER7_UTILS_RESTRICT weights,
+   int nweights,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT delta_pos)
+{
+   weighted_step_dispatch<false> (
+      0, deriv, deriv_hist, weights, nweights, deltat, size, delta_pos);
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+weighted_step (
+   double const * ER7_UTILS_RESTRICT init_state,
+   double const * ER7_UTILS_RESTRICT deriv,
+   double const * ER7_UTILS_RESTRICT const * ER7_UTILS_RESTRICT deriv_hist,
+   double const * ER7_UTILS_RESTRICT weights,
+   int nweights,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT new_state)
+{
+   weighted_step_dispatch<true> (
+      init_state, deriv, deriv_hist, weights, nweights, deltat, size,
+      new_state);
+}
+
+
+ER7_UTILS_SIMD_CLONES
+void
+weighted_step_save_deriv (
+   double const * ER7_UTILS_RESTRICT init_state,
+   double const * ER7_UTILS_RESTRICT deriv,
+   double const * ER7_UTILS_RESTRICT weights,
+   int nweights,
+   double deltat,
+   int size,
+   double * ER7_UTILS_RESTRICT * ER7_UTILS_RESTRICT deriv_hist,
+   double * ER7_UTILS_RESTRICT new_state)
+{
+   weighted_step_dispatch<true> (
+      init_state, deriv, deriv_hist, weights, nweights, deltat, size,
+      new_state);
+   for (int ii = 0; ii < size; ++ii) {
+      deriv_hist[nweights-1][ii] = deriv[ii];
+   }
+}
+
+}
+
+}
+/**
+ * @if Er7UtilsUseGroups
+ * @}
+ * @}
+ * @endif
+ */
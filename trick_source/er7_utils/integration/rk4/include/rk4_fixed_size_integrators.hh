@@ -0,0 +1,501 @@
+/**
+ * @if Er7UtilsUseGroups
+ * @addtogroup Er7Utils
+ * @{
+ * @addtogroup Integration
+ * @{
+ * @endif
+ */
+
+/**
+ * @file
+ * Defines RK4 state integrators whose state size is a compile-time constant.
+ */
+
+/*
+Purpose: ()
+*/
+
+
+#ifndef ER7_UTILS_RK4_FIXED_SIZE_INTEGRATORS_HH
+#define ER7_UTILS_RK4_FIXED_SIZE_INTEGRATORS_HH
+
+// System includes
+#include <algorithm>
+
+// Interface includes
+#include "er7_utils/interface/include/alloc.hh"
+#include "er7_utils/interface/include/er7_class.hh"
+
+// Integration includes
+#include "er7_utils/integration/core/include/first_order_ode_integrator.hh"
+#include "er7_utils/integration/core/include/second_order_ode_integrator.hh"
+
+
+namespace er7_utils {
+
+/**
+ * Propagate a state of N elements using the standard 4th order Runge-Kutta
+ * method.
+ *
+ * This is RK4FirstOrderODEIntegrator with the workspace held in the object
+ * and every loop bounded by N. The compiler fully unrolls the loops for the
+ * small states of a typical body, and the results are bit for bit those
+ * of RK4FirstOrderODEIntegrator.
+ *
+ * The class is abstract; each supported size has a concrete, named class
+ * below so the integrators can be allocated and checkpointed by name.
+ * @tparam N  State size
+ */
+template <unsigned int N>
+class RK4FirstOrderODEIntegratorN : public FirstOrderODEIntegrator {
+ER7_UTILS_MAKE_SIM_INTERFACES(RK4FirstOrderODEIntegratorN)
+
+public:
+
+   /**
+    * RK4FirstOrderODEIntegratorN destructor.
+    */
+   virtual ~RK4FirstOrderODEIntegratorN (void) {}
+
+   /**
+    * Propagate state via the standard RK4 integration scheme.
+    * @param[in]     dyn_dt        Integration interval, in dynamic time units.
+    * @param[in]     target_stage  The stage of the integration process
+    *                              that the integrator should try to attain.
+    * @param[in]     velocity      Time derivative of the state vector.
+    * @param[in,out] position      State vector.
+    * @return The status (time advance, pass/fail status) of the integration.
+    */
+   virtual IntegratorResult integrate (
+      double dyn_dt,
+      unsigned int target_stage,
+      const double * ER7_UTILS_RESTRICT velocity,
+      double * ER7_UTILS_RESTRICT position)
+   {
+      static const double one_sixth = 1.0 / 6.0;
+      double step_factor;
+
+      switch (target_stage) {
+      case 1: {
+         double hdt = 0.5*dyn_dt;
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            init_state[ii] = position[ii];
+            deriv_hist[0][ii] = velocity[ii];
+            position[ii] += velocity[ii] * hdt;
+         }
+         step_factor = 0.5;
+         break;
+      }
+
+      case 2: {
+         double hdt = 0.5*dyn_dt;
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            deriv_hist[1][ii] = velocity[ii];
+            position[ii] = init_state[ii] + velocity[ii] * hdt;
+         }
+         step_factor = 0.5;
+         break;
+      }
+
+      case 3:
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            deriv_hist[2][ii] = velocity[ii];
+            position[ii] = init_state[ii] + velocity[ii] * dyn_dt;
+         }
+         step_factor = 1.0;
+         break;
+
+      case 4: {
+         double dto6 = dyn_dt * one_sixth;
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            position[ii] = init_state[ii] +
+                           (deriv_hist[0][ii] +
+                            2.0*(deriv_hist[1][ii] + deriv_hist[2][ii]) +
+                            velocity[ii]) * dto6;
+         }
+         step_factor = 1.0;
+         break;
+      }
+
+      default:
+         step_factor = 1.0;
+         break;
+      }
+
+      return step_factor;
+   }
+
+
+protected:
+
+   // Constructors.
+
+   /**
+    * RK4FirstOrderODEIntegratorN default constructor.
+    */
+   RK4FirstOrderODEIntegratorN (void)
+   :
+      Er7UtilsDeletable (),
+      FirstOrderODEIntegrator ()
+   {
+      clear ();
+   }
+
+   /**
+    * RK4FirstOrderODEIntegratorN copy constructor.
+    * @param[in] src  Item to be copied.
+    */
+   RK4FirstOrderODEIntegratorN (const RK4FirstOrderODEIntegratorN & src)
+   :
+      Er7UtilsDeletable (),
+      FirstOrderODEIntegrator (src)
+   {
+      std::copy (src.init_state, src.init_state + N, init_state);
+      std::copy (&src.deriv_hist[0][0], &src.deriv_hist[0][0] + 4*N,
+                 &deriv_hist[0][0]);
+   }
+
+   /**
+    * RK4FirstOrderODEIntegratorN non-default constructor.
+    * @param[in]     size      State size, which must be N
+    * @param[in,out] controls  Integration controls
+    */
+   RK4FirstOrderODEIntegratorN (
+      unsigned int size ER7_UTILS_UNUSED,
+      IntegrationControls & controls)
+   :
+      Er7UtilsDeletable (),
+      FirstOrderODEIntegrator (N, controls)
+   {
+      clear ();
+   }
+
+
+   // Member functions.
+
+   /**
+    * Non-throwing swap.
+    * @param other  Item with which contents are to be swapped.
+    */
+   void swap (RK4FirstOrderODEIntegratorN & other)
+   {
+      FirstOrderODEIntegrator::swap (other);
+      std::swap_ranges (init_state, init_state + N, other.init_state);
+      std::swap_ranges (&deriv_hist[0][0], &deriv_hist[0][0] + 4*N,
+                        &other.deriv_hist[0][0]);
+   }
+
+   using FirstOrderODEIntegrator::swap;
+
+
+   // Member data.
+
+   double init_state[N]; /**< trick_units(--) @n
+      State at the start of an integration cycle. */
+
+   double deriv_hist[4][N]; /**< trick_units(--) @n
+      State derivatives at each step in the integration cycle. */
+
+
+private:
+
+   /**
+    * Zero the workspace.
+    */
+   void clear (void)
+   {
+      std::fill (init_state, init_state + N, 0.0);
+      std::fill (&deriv_hist[0][0], &deriv_hist[0][0] + 4*N, 0.0);
+   }
+
+   /**
+    * Not implemented.
+    */
+   RK4FirstOrderODEIntegratorN & operator= (const RK4FirstOrderODEIntegratorN &);
+};
+
+
+/**
+ * Propagate a simple second order ODE with N position and N velocity
+ * elements using the standard 4th order Runge-Kutta method.
+ *
+ * This is RK4SimpleSecondOrderODEIntegrator with the workspace held in the
+ * object and every loop bounded by N, with bit for bit identical results.
+ * @tparam N  Position and velocity size
+ */
+template <unsigned int N>
+class RK4SimpleSecondOrderODEIntegratorN : public SecondOrderODEIntegrator {
+ER7_UTILS_MAKE_SIM_INTERFACES(RK4SimpleSecondOrderODEIntegratorN)
+
+public:
+
+   /**
+    * RK4SimpleSecondOrderODEIntegratorN destructor.
+    */
+   virtual ~RK4SimpleSecondOrderODEIntegratorN (void) {}
+
+   /**
+    * Propagate state via the standard RK4 integration scheme.
+    * @param[in]     dyn_dt        Integration interval, in dynamic time units.
+    * @param[in]     target_stage  The stage of the integration process
+    *                              that the integrator should try to attain.
+    * @param[in]     accel         Time derivative of the velocity vector.
+    * @param[in,out] velocity      Velocity vector.
+    * @param[in,out] position      Position vector.
+    * @return The status (time advance, pass/fail status) of the integration.
+    */
+   virtual IntegratorResult integrate (
+      double dyn_dt,
+      unsigned int target_stage,
+      double const * ER7_UTILS_RESTRICT accel,
+      double * ER7_UTILS_RESTRICT velocity,
+      double * ER7_UTILS_RESTRICT position)
+   {
+      static const double one_sixth = 1.0 / 6.0;
+      double step_factor;
+
+      switch (target_stage) {
+      case 1: {
+         double hdt = 0.5*dyn_dt;
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            init_pos[ii]        = position[ii];
+            posdot_hist[0][ii]  = velocity[ii];
+            position[ii]       += velocity[ii]*hdt;
+            init_vel[ii]        = velocity[ii];
+            veldot_hist[0][ii]  = accel[ii];
+            velocity[ii]       += accel[ii]*hdt;
+         }
+         step_factor = 0.5;
+         break;
+      }
+
+      case 2:
+      case 3: {
+         double sdt = (target_stage == 2) ? 0.5*dyn_dt : dyn_dt;
+         unsigned int hist = target_stage - 1;
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            posdot_hist[hist][ii] = velocity[ii];
+            veldot_hist[hist][ii] = accel[ii];
+            position[ii] = init_pos[ii] + velocity[ii]*sdt;
+            velocity[ii] = init_vel[ii] + accel[ii]*sdt;
+         }
+         step_factor = (target_stage == 2) ? 0.5 : 1.0;
+         break;
+      }
+
+      case 4: {
+         double dto6 = dyn_dt * one_sixth;
+         ER7_UTILS_UNROLL
+         for (unsigned int ii = 0; ii < N; ++ii) {
+            position[ii] = init_pos[ii] +
+                           (posdot_hist[0][ii] +
+                            2.0*(posdot_hist[1][ii] + posdot_hist[2][ii]) +
+                            velocity[ii]) * dto6;
+            velocity[ii] = init_vel[ii] +
+                           (veldot_hist[0][ii] +
+                            2.0*(veldot_hist[1][ii] + veldot_hist[2][ii]) +
+                            accel[ii]) * dto6;
+         }
+         step_factor = 1.0;
+         break;
+      }
+
+      default:
+         step_factor = 1.0;
+         break;
+      }
+
+      return step_factor;
+   }
+
+
+protected:
+
+   // Constructors.
+
+   /**
+    * RK4SimpleSecondOrderODEIntegratorN default constructor.
+    */
+   RK4SimpleSecondOrderODEIntegratorN (void)
+   :
+      Er7UtilsDeletable (),
+      SecondOrderODEIntegrator ()
+   {
+      clear ();
+   }
+
+   /**
+    * RK4SimpleSecondOrderODEIntegratorN copy constructor.
+    * @param[in] src  Item to be copied.
+    */
+   RK4SimpleSecondOrderODEIntegratorN (
+      const RK4SimpleSecondOrderODEIntegratorN & src)
+   :
+      Er7UtilsDeletable (),
+      SecondOrderODEIntegrator (src)
+   {
+      std::copy (src.init_pos, src.init_pos + N, init_pos);
+      std::copy (src.init_vel, src.init_vel + N, init_vel);
+      std::copy (&src.posdot_hist[0][0], &src.posdot_hist[0][0] + 3*N,
+                 &posdot_hist[0][0]);
+      std::copy (&src.veldot_hist[0][0], &src.veldot_hist[0][0] + 3*N,
+                 &veldot_hist[0][0]);
+   }
+
+   /**
+    * RK4SimpleSecondOrderODEIntegratorN non-default constructor.
+    * @param[in]     size      State size, which must be N
+    * @param[in,out] controls  Integration controls
+    */
+   RK4SimpleSecondOrderODEIntegratorN (
+      unsigned int size ER7_UTILS_UNUSED,
+      IntegrationControls & controls)
+   :
+      Er7UtilsDeletable (),
+      SecondOrderODEIntegrator (N, controls)
+   {
+      clear ();
+   }
+
+
+   // Member functions.
+
+   /**
+    * Non-throwing swap.
+    * @param other  Item with which contents are to be swapped.
+    */
+   void swap (RK4SimpleSecondOrderODEIntegratorN & other)
+   {
+      SecondOrderODEIntegrator::swap (other);
+      std::swap_ranges (init_pos, init_pos + N, other.init_pos);
+      std::swap_ranges (init_vel, init_vel + N, other.init_vel);
+      std::swap_ranges (&posdot_hist[0][0], &posdot_hist[0][0] + 3*N,
+                        &other.posdot_hist[0][0]);
+      std::swap_ranges (&veldot_hist[0][0], &veldot_hist[0][0] + 3*N,
+                        &other.veldot_hist[0][0]);
+   }
+
+   using SecondOrderODEIntegrator::swap;
+
+
+   // Member data.
+
+   double init_pos[N]; /**< trick_units(--) @n
+      Position at the start of an integration cycle. */
+
+   double init_vel[N]; /**< trick_units(--) @n
+      Velocity at the start of an integration cycle. */
+
+   double posdot_hist[3][N]; /**< trick_units(--) @n
+      Velocities at the first three steps in the integration cycle. */
+
+   double veldot_hist[3][N]; /**< trick_units(--) @n
+      Accelerations at the first three steps in the integration cycle. */
+
+
+private:
+
+   /**
+    * Zero the workspace.
+    */
+   void clear (void)
+   {
+      std::fill (init_pos, init_pos + N, 0.0);
+      std::fill (init_vel, init_vel + N, 0.0);
+      std::fill (&posdot_hist[0][0], &posdot_hist[0][0] + 3*N, 0.0);
+      std::fill (&veldot_hist[0][0], &veldot_hist[0][0] + 3*N, 0.0);
+   }
+
+   /**
+    * Not implemented.
+    */
+   RK4SimpleSecondOrderODEIntegratorN & operator= (
+      const RK4SimpleSecondOrderODEIntegratorN &);
+};
+
+
+/**
+ * @def ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR
+ * Define a concrete fixed-size RK4 integrator class.
+ * @param class_name  Name of the class being defined.
+ * @param base_name   Fixed-size template base class.
+ * @param size        State size.
+ */
+#define ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(class_name, base_name, size) \
+class class_name : public base_name<size> { \
+ER7_UTILS_MAKE_SIM_INTERFACES(class_name) \
+public: \
+   class_name (void) \
+   : \
+      Er7UtilsDeletable (), \
+      base_name<size> () \
+   {} \
+   class_name (const class_name & src) \
+   : \
+      Er7UtilsDeletable (), \
+      base_name<size> (src) \
+   {} \
+   class_name (unsigned int state_size, IntegrationControls & controls) \
+   : \
+      Er7UtilsDeletable (), \
+      base_name<size> (state_size, controls) \
+   {} \
+   virtual ~class_name (void) {} \
+   class_name & operator= (class_name src) \
+   { \
+      swap (src); \
+      return *this; \
+   } \
+   virtual class_name * create_copy () const \
+   { \
+      return alloc::replicate_object (*this); \
+   } \
+};
+
+/** Fixed-size RK4 integrator for a three element state. */
+ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(
+   RK4FirstOrderODEIntegrator3, RK4FirstOrderODEIntegratorN, 3)
+
+/** Fixed-size RK4 integrator for a four element state, e.g. a quaternion. */
+ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(
+   RK4FirstOrderODEIntegrator4, RK4FirstOrderODEIntegratorN, 4)
+
+/** Fixed-size RK4 integrator for a six element state, e.g. position and
+ *  velocity. */
+ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(
+   RK4FirstOrderODEIntegrator6, RK4FirstOrderODEIntegratorN, 6)
+
+/** Fixed-size RK4 integrator for a seven element state, e.g. a quaternion
+ *  and angular rate. */
+ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(
+   RK4FirstOrderODEIntegrator7, RK4FirstOrderODEIntegratorN, 7)
+
+/** Fixed-size RK4 integrator for a thirteen element state, e.g. position,
+ *  velocity, quaternion and angular rate. */
+ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(
+   RK4FirstOrderODEIntegrator13, RK4FirstOrderODEIntegratorN, 13)
+
+/** Fixed-size RK4 integrator for a three dimensional simple second order
+ *  ODE, e.g. translation. */
+ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR(
+   RK4SimpleSecondOrderODEIntegrator3, RK4SimpleSecondOrderODEIntegratorN, 3)
+
+#undef ER7_UTILS_RK4_FIXED_SIZE_INTEGRATOR
+
+}
+
+
+#endif
+/**
+ * @if Er7UtilsUseGroups
+ * @}
+ * @}
+ * @endif
+ */
@@ -149,6 +149,7 @@ public:
 #include "er7_utils/integration/core/include/single_cycle_integration_controls.hh"
 #include "rk4_first_order_ode_integrator.hh"
 #include "rk4_second_order_ode_integrator.hh"
+#include "rk4_fixed_size_integrators.hh"
 #endif
 
 
@@ -28,6 +28,7 @@ Purpose: ()
 // Model includes
 #include "../include/rk4_integrator_constructor.hh"
 #include "../include/rk4_first_order_ode_integrator.hh"
+#include "../include/rk4_fixed_size_integrators.hh"
 #include "../include/rk4_second_order_ode_integrator.hh"
 
 
@@ -63,14 +64,34 @@ const
 
 
 // Create an RK4 state integrator for a first order ODE.
+// The common small state sizes get an integrator whose size is fixed at
+// compile time.
 FirstOrderODEIntegrator *
 RK4IntegratorConstructor::create_first_order_ode_integrator (
    unsigned int size,
    IntegrationControls & controls)
 const
 {
-   return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator> (
-             size, controls);
+   switch (size) {
+   case 3:
+      return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator3> (
+                size, controls);
+   case 4:
+      return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator4> (
+                size, controls);
+   case 6:
+      return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator6> (
+                size, controls);
+   case 7:
+      return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator7> (
+                size, controls);
+   case 13:
+      return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator13> (
+                size, controls);
+   default:
+      return integ_utils::allocate_integrator<RK4FirstOrderODEIntegrator> (
+                size, controls);
+   }
 }
 
 
@@ -81,6 +102,11 @@ RK4IntegratorConstructor::create_second_order_ode_integrator (
    IntegrationControls & controls)
 const
 {
+   if (size == 3) {
+      return integ_utils::allocate_integrator<
+                   RK4SimpleSecondOrderODEIntegrator3> (
+                size, controls);
+   }
    return integ_utils::allocate_integrator<RK4SimpleSecondOrderODEIntegrator> (
              size, controls);
 }
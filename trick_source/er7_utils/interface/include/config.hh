@@ -86,6 +86,21 @@ Purpose: ()
 #endif
 
 
+/**
+ * @def ER7_UTILS_UNROLL
+ * Fully unroll the loop that follows, up to 16 iterations. Intended for
+ * loops with a small compile-time trip count, where the compiler would
+ * otherwise replace a copy loop with a call to memmove.
+ */
+#if (! defined SWIG) && (defined __clang__)
+#define ER7_UTILS_UNROLL _Pragma("unroll 16")
+#elif (! defined SWIG) && (defined __GNUC__) && (__GNUC__ >= 8)
+#define ER7_UTILS_UNROLL _Pragma("GCC unroll 16")
+#else
+#define ER7_UTILS_UNROLL
+#endif
+
+
 /**
  * @def ER7_UTILS_HAVE_ABI
  * Defined if the header file <cxxabi.h> is available.
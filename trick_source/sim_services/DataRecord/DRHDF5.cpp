@@ -237,6 +237,14 @@ int Trick::DRHDF5::write_data(bool must_write) {
         }
         writer_num = local_buffer_num - num_to_write ;
 
+        if ( time_index_fp ) {
+            // Packets have no byte offset, readers find them by record number.
+            for ( ii = writer_num ; ii != local_buffer_num ; ii++ ) {
+                add_time_index(ii % max_num, -1) ;
+            }
+            fflush(time_index_fp) ;
+        }
+
         if ( writer_num != local_buffer_num ) {
             // Test if the writer pointer to the right of the buffer pointer in the ring
             if ( (writer_num % max_num) > (local_buffer_num % max_num) ) {
@@ -332,3 +340,7 @@ int Trick::DRHDF5::format_specific_shutdown() {
     return(0);
 }
 
+int Trick::DRHDF5::prepare_fork() {
+    message_publish(MSG_ERROR, "Data Record HDF5 group %s cannot be recorded in a forked process.\n", group_name.c_str()) ;
+    return(-1) ;
+}
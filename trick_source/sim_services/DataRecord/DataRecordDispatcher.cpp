@@ -254,6 +254,47 @@ int Trick::DataRecordDispatcher::shutdown() {
     return(0) ;
 }
 
+/**
+@details
+-# If the thread is running
+   -# Stop it and wait for it to finish, so that it holds no lock when the process forks
+-# Call every group's prepare_fork
+-# Return -1 if any group cannot be recorded in the forked process
+*/
+int Trick::DataRecordDispatcher::prepare_fork() {
+
+    unsigned int ii ;
+    int ret = 0 ;
+
+    if ( drd_writer_thread.get_pthread_id() != 0 and ! drd_mutexes.cancelled ) {
+        shutdown() ;
+        pthread_join( drd_writer_thread.get_pthread_id(), NULL) ;
+    }
+    for ( ii = 0 ; ii < groups.size() ; ii++ ) {
+        if ( groups[ii]->prepare_fork() != 0 ) {
+            ret = -1 ;
+        }
+    }
+    return ret ;
+}
+
+/**
+@details
+-# Create a new writer thread, the parent's thread not being part of the forked process
+-# Call every group's reopen to start its log in the current output directory
+*/
+int Trick::DataRecordDispatcher::reopen() {
+
+    unsigned int ii ;
+
+    drd_mutexes.cancelled = false ;
+    init() ;
+    for ( ii = 0 ; ii < groups.size() ; ii++ ) {
+        groups[ii]->reopen() ;
+    }
+    return 0 ;
+}
+
 int Trick::DataRecordDispatcher::enable( const char * in_name ) {
     unsigned int ii ;
     for ( ii = 0 ; ii < groups.size() ; ii++ ) {
@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <iomanip>
+#include <float.h>
 
 #ifdef __GNUC__
 #include <cxxabi.h>
@@ -76,9 +77,14 @@ Trick::DataRecordGroup::DataRecordGroup( std::string in_name ) :
  max_size_warning(false),
  writer_buff(NULL),
  single_prec_only(false),
+ time_index(false),
+ time_index_interval(1000),
  buffer_type(DR_Buffer),
  job_class("data_record"),
- curr_time(0.0)
+ curr_time(0.0),
+ time_index_fp(NULL),
+ time_index_max(-DBL_MAX),
+ time_index_records(0)
 {
 
     union {
@@ -207,6 +213,16 @@ int Trick::DataRecordGroup::set_single_prec_only( bool in_single_prec_only ) {
     return(0) ;
 }
 
+int Trick::DataRecordGroup::set_time_index( bool in_time_index ) {
+    time_index = in_time_index ;
+    return(0) ;
+}
+
+int Trick::DataRecordGroup::set_time_index_interval( unsigned int num ) {
+    time_index_interval = ( num > 0 ) ? num : 1 ;
+    return(0) ;
+}
+
 int Trick::DataRecordGroup::set_thread( unsigned int in_thread_id ) {
 
     unsigned int jj ;
@@ -398,6 +414,7 @@ int Trick::DataRecordGroup::init() {
 
     // set the inited flag to true when all initialization is done
     if ( ret == 0 ) {
+        open_time_index() ;
         inited = true ;
     }
 
@@ -703,12 +720,17 @@ int Trick::DataRecordGroup::write_data(bool must_write) {
         while ( writer_num != local_buffer_num ) {
 
             writer_offset = writer_num % max_num ;
+            add_time_index(writer_offset, (long long)total_bytes_written) ;
             //! keep record of bytes written to file. Default max is 1GB
             total_bytes_written += format_specific_write_data(writer_offset) ;
             writer_num++ ;
 
         }
 
+        if ( time_index_fp ) {
+            fflush(time_index_fp) ;
+        }
+
         if(!max_size_warning && (total_bytes_written > max_file_size)) {
             std::cerr << "WARNING: Data record max file size " << (static_cast<double>(max_file_size))/(1<<20) << "MB reached.\n"
             "https://nasa.github.io/trick/documentation/simulation_capabilities/Data-Record#changing-the-max-file-size-of-a-data-record-group-ascii-and-binary-only" 
@@ -740,6 +762,11 @@ int Trick::DataRecordGroup::shutdown() {
     write_data(true) ;
     format_specific_shutdown() ;
 
+    if ( time_index_fp ) {
+        fclose(time_index_fp) ;
+        time_index_fp = NULL ;
+    }
+
     remove_all_variables();
 
     // remove_all_variables does not remove sim time
@@ -756,6 +783,114 @@ int Trick::DataRecordGroup::shutdown() {
     return 0 ;
 }
 
+/**
+@details
+-# Force write out all data, so that the log is complete when the process forks
+*/
+int Trick::DataRecordGroup::prepare_fork() {
+    write_data(true) ;
+    return 0 ;
+}
+
+/**
+@details
+-# If the log file is open
+   -# Close it, leaving the parent's data to the parent
+   -# Free the recording buffers
+   -# Call init to start a new log in the current output directory
+*/
+int Trick::DataRecordGroup::reopen() {
+
+    unsigned int jj ;
+
+    if ( inited ) {
+        format_specific_shutdown() ;
+        inited = false ;
+
+        for (jj = 0; jj < rec_buffer.size() ; jj++) {
+            free(rec_buffer[jj]->buffer) ;
+            free(rec_buffer[jj]->last_value) ;
+            rec_buffer[jj]->buffer = rec_buffer[jj]->last_value = NULL ;
+        }
+        if ( writer_buff ) {
+            free(writer_buff) ;
+            writer_buff = NULL ;
+        }
+
+        init() ;
+    }
+
+    return 0 ;
+}
+
+/**
+@details
+The time index lets the data products start reading a log at a given time.  It holds the
+10 character tag "Trick-IX-L" or "Trick-IX-B", L for little endian, B for big, followed by
+an entry every #time_index_interval records:
+<center>
+<table>
+<tr><th>Value</th><th>Description</th><th>Type</th><th>Bytes</th></tr>
+<tr><td>\<max_time\></td><td>latest time of all records before this one</td><td>double</td><td>8</td></tr>
+<tr><td>\<record\></td><td>number of the record, the first is 0</td><td>long long</td><td>8</td></tr>
+<tr><td>\<offset\></td><td>byte offset of the record in the log file, -1 if it has none</td><td>long long</td><td>8</td></tr>
+</table>
+</center>
+Times need not increase through a log, but max_time never decreases, so a reader can binary
+search it.
+
+-# Close the time index of a previous recording
+-# If a time index is requested create log_<group_name>.<ext>.idx and write its tag
+-# Else remove the index an earlier run left beside the log file, as it does not index this one
+*/
+int Trick::DataRecordGroup::open_time_index() {
+
+    std::string index_name = file_name + ".idx" ;
+
+    if ( time_index_fp ) {
+        fclose(time_index_fp) ;
+        time_index_fp = NULL ;
+    }
+    time_index_max = -DBL_MAX ;
+    time_index_records = 0 ;
+
+    if ( time_index ) {
+        if ((time_index_fp = fopen(index_name.c_str(), "w")) == NULL ) {
+            message_publish(MSG_WARNING, "Could not create Data Record time index %s.\n", index_name.c_str()) ;
+        } else if ( byte_order == "little_endian" ) {
+            fwrite("Trick-IX-L", 10, 1, time_index_fp) ;
+        } else {
+            fwrite("Trick-IX-B", 10, 1, time_index_fp) ;
+        }
+    } else {
+        remove(index_name.c_str()) ;
+    }
+
+    return 0 ;
+}
+
+void Trick::DataRecordGroup::add_time_index( unsigned int writer_offset , long long bytes ) {
+
+    double time ;
+
+    if ( time_index_fp == NULL ) {
+        return ;
+    }
+
+    if ( time_index_records % time_index_interval == 0 ) {
+        fwrite(&time_index_max, sizeof(double), 1, time_index_fp) ;
+        fwrite(&time_index_records, sizeof(long long), 1, time_index_fp) ;
+        fwrite(&bytes, sizeof(long long), 1, time_index_fp) ;
+    }
+    time_index_records++ ;
+
+    // The first recorded variable is always the time, as a double.
+    memcpy(&time, rec_buffer[0]->buffer + (writer_offset * sizeof(double)), sizeof(double)) ;
+    if ( time > time_index_max ) {
+        time_index_max = time ;
+    }
+}
+
 std::string Trick::DataRecordGroup::type_string( int item_type, int item_size ) {
     switch (item_type) {
         case TRICK_CHARACTER:
@@ -54,6 +54,20 @@ extern "C" int dr_record_now_group( const char * in_name ) {
     return -1 ;
 }
 
+extern "C" int dr_prepare_fork(void) {
+    if ( the_drd != NULL ) {
+        return the_drd->prepare_fork() ;
+    }
+    return 0 ;
+}
+
+extern "C" int dr_reopen(void) {
+    if ( the_drd != NULL ) {
+        return the_drd->reopen() ;
+    }
+    return 0 ;
+}
+
 extern "C" int add_data_record_group( Trick::DataRecordGroup * in_group, Trick::DR_Buffering buffering ) {
     if ( the_drd != NULL ) {
         return the_drd->add_group(in_group, buffering) ;
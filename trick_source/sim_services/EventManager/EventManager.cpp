@@ -31,28 +31,55 @@ Trick::EventManager::EventManager() :
 
 //Command to get the event object given the event's name
 Trick::Event * Trick::EventManager::get_event(std::string event_name) {
-    unsigned int ii ;
-    Trick::Event* ret = NULL;
+    std::unordered_map< std::string, Trick::Event * >::iterator it ;
 
-    /* Find the event name in the active event list and return the pointer to that event */
-    for ( ii = 0 ; ii < num_active_events ; ii++ ) {
+    /* Look up the event name in the index.  Active events are indexed by their current name. */
+    it = event_names.find(event_name) ;
+    if ( it != event_names.end() ) {
+        return it->second ;
+    }
+    return NULL ;
+}
+
+void Trick::EventManager::index_event_name(Trick::Event * in_event) {
+    event_names.insert(std::pair< std::string, Trick::Event * >(in_event->get_name(), in_event)) ;
+}
+
+void Trick::EventManager::reindex_event_name(std::string event_name) {
+    event_names.erase(event_name) ;
+    for ( unsigned int ii = 0 ; ii < num_active_events ; ii++ ) {
         if ( ! active_events[ii]->get_name().compare(event_name) ) {
-            ret = active_events[ii];
+            index_event_name(active_events[ii]) ;
             break ;
         }
     }
+}
 
-    return(ret) ;
-
+//Rename an event.  An active event is indexed by its new name.
+void Trick::Event::set_name(std::string in_name) {
+    std::string old_name = name ;
+    name = in_name ;
+    if ( the_em != NULL ) {
+        the_em->rename_event(this, old_name) ;
+    }
 }
 
 //Add user's event to the active event list.
 int Trick::EventManager::add_to_active_events(Trick::Event * in_event) {
 
-    for ( unsigned int ii = 0 ; ii < num_active_events ; ii++ ) {
-        if (in_event == active_events[ii]) {
+    std::unordered_map< std::string, Trick::Event * >::iterator it ;
+
+    /* Events are usually found by name.  Search the list only if another event shares the name. */
+    it = event_names.find(in_event->get_name()) ;
+    if ( it != event_names.end() ) {
+        if ( it->second == in_event ) {
             return (0) ;
         }
+        for ( unsigned int ii = 0 ; ii < num_active_events ; ii++ ) {
+            if (in_event == active_events[ii]) {
+                return (0) ;
+            }
+        }
     }
     num_active_events++;
     if (num_active_events == 1) {
@@ -66,6 +93,7 @@ int Trick::EventManager::add_to_active_events(Trick::Event * in_event) {
         }
     }
     active_events[num_active_events-1] = in_event ;
+    index_event_name(in_event) ;
     return (0) ;
 }
 
@@ -229,6 +257,11 @@ int Trick::EventManager::remove_event(Trick::Event * in_event) {
             break ;
         }
     }
+    /* Index the next active event sharing the removed event's name. */
+    std::unordered_map< std::string, Trick::Event * >::iterator it = event_names.find(in_event->get_name()) ;
+    if ( it != event_names.end() and it->second == in_event ) {
+        reindex_event_name(in_event->get_name()) ;
+    }
 
     if ( in_event->get_free_on_removal() ) {
         TMM_delete_var_a(in_event) ;
@@ -237,6 +270,35 @@ int Trick::EventManager::remove_event(Trick::Event * in_event) {
     return 0 ;
 }
 
+//Update the name index after an active event is renamed.
+int Trick::EventManager::rename_event(Trick::Event * in_event, std::string old_name) {
+
+    std::unordered_map< std::string, Trick::Event * >::iterator it = event_names.find(old_name) ;
+    if ( it == event_names.end() ) {
+        /* No active event had the old name, so this event is not active. */
+        return 0 ;
+    }
+    if ( it->second == in_event ) {
+        reindex_event_name(old_name) ;
+    }
+    /* Another event of the new name may be earlier in the active list, or the event may not be active. */
+    it = event_names.find(in_event->get_name()) ;
+    if ( it == event_names.end() or it->second != in_event ) {
+        reindex_event_name(in_event->get_name()) ;
+    }
+    return 0 ;
+}
+
+//Move an event skipping cycles back to its next cycle.
+int Trick::EventManager::wake_event(Trick::Event * in_event) {
+
+    if ( in_event != NULL and in_event->get_before_after() == Trick::EVENT_NOTARGET and
+         in_event->get_thread() < event_processors.size() ) {
+        event_processors[in_event->get_thread()]->wake_event(in_event) ;
+    }
+    return 0 ;
+}
+
 /**
 @details
 This is called from the S_define file.  There will be one event processor assigned to each thread.
@@ -279,6 +341,12 @@ int Trick::EventManager::preload_checkpoint() {
 int Trick::EventManager::restart() {
     unsigned int ii ;
 
+    // rebuild the name index of the reloaded active events
+    event_names.clear() ;
+    for ( ii = 0 ; ii < num_active_events ; ii++ ) {
+        index_event_name(active_events[ii]) ;
+    }
+
     for ( ii = 0 ; ii < num_active_events ; ii++ ) {
         // rebuild the event_list of all events that were "added"
 
@@ -47,3 +47,11 @@ int event_manager_remove_event( Trick::Event * in_event ) {
     return -1 ;
 }
 
+/* Move an event skipping cycles back to its next cycle */
+int event_manager_wake_event( Trick::Event * in_event ) {
+    if ( the_em != NULL ) {
+        return the_em->wake_event(in_event) ;
+    }
+    return -1 ;
+}
+
@@ -8,6 +8,7 @@
 */
 
 #include <iostream>
+#include <algorithm>
 
 #include "trick/EventProcessor.hh"
 #include "trick/TrickConstant.hh"
@@ -22,20 +23,51 @@ void Trick::EventProcessor::add_event(Trick::Event * in_event) {
     pending_events.push_back(in_event) ;
 }
 
+/**
+@details
+-# Search only the events sharing the incoming event's next time.
+*/
+std::multiset< Trick::Event *, Trick::CompareEventPtrs >::iterator Trick::EventProcessor::find_event(Trick::Event * in_event) {
+    std::pair< std::multiset< Trick::Event *, CompareEventPtrs >::iterator,
+               std::multiset< Trick::Event *, CompareEventPtrs >::iterator > range = event_set.equal_range(in_event) ;
+    std::multiset< Trick::Event *, CompareEventPtrs >::iterator sit ;
+    for (sit=range.first; sit!=range.second; sit++) {
+        if ((*sit) == in_event) {
+            return sit ;
+        }
+    }
+    return event_set.end() ;
+}
+
+/**
+@details
+-# If the event's wake time is past its next time, advance the next time by the number of
+   whole cycles needed to reach the wake time.  The event stays on its cycle boundaries.
+*/
+void Trick::EventProcessor::skip_to_wake_tics(Trick::Event * in_event) {
+    long long cycle_tics = in_event->get_cycle_tics() ;
+    long long next_tics = in_event->get_next_tics() ;
+    long long wake_tics = in_event->get_wake_tics() ;
+    if ( cycle_tics > 0 and wake_tics > next_tics ) {
+        in_event->set_next_tics( next_tics + ((wake_tics - next_tics + cycle_tics - 1) / cycle_tics) * cycle_tics ) ;
+    }
+}
+
 /**
 @details
 -# Remove the incoming event from the set of events being processed
+-# Remove the incoming event from the events waiting to be added or woken at the next top of frame
 -# If the event set is not empty set the process_event job to the first event's next job call time.
 -# Else set the process_event job to maximum time
 */
 void Trick::EventProcessor::remove_event(Trick::Event * in_event) {
-    std::multiset< Trick::Event *, CompareEventPtrs >::iterator sit = event_set.begin() ;
-    for (sit=event_set.begin(); sit!=event_set.end(); sit++) {
-        if ((*sit) == in_event) {
-            event_set.erase(sit) ;
-            break;
-        }
+    std::multiset< Trick::Event *, CompareEventPtrs >::iterator sit = find_event(in_event) ;
+    if ( sit != event_set.end() ) {
+        event_set.erase(sit) ;
     }
+    // The event may be freed once it is removed, so it must not be left waiting for the next top of frame.
+    pending_events.erase(std::remove(pending_events.begin(), pending_events.end(), in_event), pending_events.end()) ;
+    wake_events.erase(std::remove(wake_events.begin(), wake_events.end(), in_event), wake_events.end()) ;
     if ( !event_set.empty() ) {
         process_event_job->next_tics = (*(event_set.begin()))->get_next_tics() ;
     } else {
@@ -44,9 +76,34 @@ void Trick::EventProcessor::remove_event(Trick::Event * in_event) {
     }
 }
 
+/**
+@details
+-# Add the incoming event to the list of events to be moved back to their next cycle.
+*/
+void Trick::EventProcessor::wake_event(Trick::Event * in_event) {
+    wake_events.push_back(in_event) ;
+}
+
 //Top of frame job to add new events to processing set.
 void Trick::EventProcessor::add_pending_events( long long curr_tics , bool is_restart ) {
     std::vector< Trick::Event * >::iterator it ;
+
+    // Move events that were skipping cycles back to their first cycle at or after the current time.
+    for ( it = wake_events.begin() ; it != wake_events.end() ; it++ ) {
+        std::multiset< Trick::Event *, CompareEventPtrs >::iterator sit = find_event(*it) ;
+        long long cycle_tics = (*it)->get_cycle_tics() ;
+        if ( sit != event_set.end() and cycle_tics > 0 and (*it)->get_next_tics() > curr_tics + cycle_tics ) {
+            event_set.erase(sit) ;
+            (*it)->set_next_tics( (*it)->get_next_tics() - (((*it)->get_next_tics() - curr_tics) / cycle_tics) * cycle_tics ) ;
+            skip_to_wake_tics(*it) ;
+            event_set.insert(*it) ;
+        }
+    }
+    wake_events.clear() ;
+    if ( !event_set.empty() ) {
+        process_event_job->next_tics = (*(event_set.begin()))->get_next_tics() ;
+    }
+
     for ( it = pending_events.begin() ; it != pending_events.end() ; ) {
         if ( (*it)->get_cycle_tics() != 0 ) {
             // this is a cyclic event
@@ -54,6 +111,7 @@ void Trick::EventProcessor::add_pending_events( long long curr_tics , bool is_re
             if ( ! is_restart ) {
                 // Set the next time to the current time
                 (*it)->set_next_tics( curr_tics ) ;
+                skip_to_wake_tics(*it) ;
             }
         } else {
             // this is a one time event, test to see if the event time has past.
@@ -87,9 +145,11 @@ int Trick::EventProcessor::process_event( long long curr_tics ) {
             curr_event->process(curr_tics) ;
         }
 
-        // if the event has a cycle time, update the time and put the item back in the set
+        // if the event has a cycle time, update the time and put the item back in the set.
+        // Cycles before the event could next fire are skipped.
         if ( curr_event->get_cycle_tics() != 0 ) {
             curr_event->advance_next_tics() ;
+            skip_to_wake_tics(curr_event) ;
             event_set.insert(curr_event) ;
         }
 
@@ -0,0 +1,240 @@
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "trick/EventManager.hh"
+#include "trick/EventProcessor.hh"
+#include "trick/Executive.hh"
+#include "trick/MemoryManager.hh"
+#include "trick/TrickConstant.hh"
+#include "trick/exec_proto.h"
+
+namespace Trick {
+
+/* An event whose condition becomes true at fire_tics.  It records the times it is processed
+   and fires, and may report fire_tics as its wake time so the processor skips cycles. */
+class TestEvent : public Trick::Event {
+
+    public:
+        long long fire_tics ;
+        bool report_wake ;
+        std::vector< long long > processed ;
+        std::vector< long long > fired ;
+
+        TestEvent(std::string in_name, double in_cycle = 1.0) :
+         Trick::Event(in_name, in_cycle) ,
+         fire_tics(0) ,
+         report_wake(false) {
+            activate() ;
+        }
+
+        virtual int process( long long curr_time ) {
+            processed.push_back(curr_time) ;
+            if ( curr_time >= fire_tics ) {
+                fired.push_back(curr_time) ;
+            }
+            return 0 ;
+        }
+
+        virtual long long get_wake_tics() {
+            return report_wake ? fire_tics : 0 ;
+        }
+
+        virtual void add() {}
+        virtual void remove() {}
+        virtual void restart() {}
+} ;
+
+class EventManagerTest : public ::testing::Test {
+
+    protected:
+        Trick::Executive exec ;
+        Trick::MemoryManager mm ;
+        Trick::EventManager em ;
+        Trick::EventProcessor ep ;
+        Trick::JobData process_event_job ;
+
+        EventManagerTest() {
+            ep.set_process_event_job(&process_event_job) ;
+            em.add_event_processor(&ep) ;
+        }
+
+        /* Run the event processor the way the scheduler does until end_tics. */
+        void run( Trick::EventProcessor & processor , Trick::JobData & job , long long end_tics ) {
+            long long curr_tics = 0 ;
+            processor.add_pending_events(curr_tics) ;
+            while ( job.next_tics <= end_tics ) {
+                curr_tics = job.next_tics ;
+                processor.add_pending_events(curr_tics) ;
+                processor.process_event(curr_tics) ;
+            }
+        }
+
+        long long tics( double seconds ) {
+            return (long long)(seconds * exec_get_time_tic_value()) ;
+        }
+} ;
+
+TEST_F(EventManagerTest, GetEventAfterAddAndRemove) {
+    TestEvent a("a") ;
+    TestEvent b("b") ;
+    TestEvent c("c") ;
+
+    EXPECT_TRUE(em.get_event("a") == NULL) ;
+    em.add_event(&a) ;
+    em.add_event(&b) ;
+    em.add_event(&c) ;
+    EXPECT_EQ(em.get_event("a"), &a) ;
+    EXPECT_EQ(em.get_event("b"), &b) ;
+    EXPECT_EQ(em.get_event("c"), &c) ;
+
+    // Adding an event twice does not add it to the active list twice.
+    em.add_event(&b) ;
+    em.remove_event(&b) ;
+    EXPECT_TRUE(em.get_event("b") == NULL) ;
+    EXPECT_EQ(em.get_event("a"), &a) ;
+    EXPECT_EQ(em.get_event("c"), &c) ;
+
+    em.add_event(&b) ;
+    EXPECT_EQ(em.get_event("b"), &b) ;
+    em.remove_event(&a) ;
+    em.remove_event(&b) ;
+    em.remove_event(&c) ;
+    EXPECT_TRUE(em.get_event("a") == NULL) ;
+    EXPECT_TRUE(em.get_event("b") == NULL) ;
+    EXPECT_TRUE(em.get_event("c") == NULL) ;
+}
+
+TEST_F(EventManagerTest, GetEventSharedName) {
+    TestEvent first("same") ;
+    TestEvent second("same") ;
+    TestEvent third("same") ;
+
+    // The first active event of a name is found, as it was when the active list was searched.
+    em.add_event(&first) ;
+    em.add_event(&second) ;
+    em.add_event(&third) ;
+    EXPECT_EQ(em.get_event("same"), &first) ;
+    em.remove_event(&second) ;
+    EXPECT_EQ(em.get_event("same"), &first) ;
+    em.remove_event(&first) ;
+    EXPECT_EQ(em.get_event("same"), &third) ;
+    em.remove_event(&third) ;
+    EXPECT_TRUE(em.get_event("same") == NULL) ;
+}
+
+TEST_F(EventManagerTest, GetEventAfterRename) {
+    TestEvent a("a") ;
+    TestEvent b("b") ;
+    TestEvent idle("idle") ;
+
+    em.add_event(&a) ;
+    em.add_event(&b) ;
+    a.set_name("renamed") ;
+    EXPECT_TRUE(em.get_event("a") == NULL) ;
+    EXPECT_EQ(em.get_event("renamed"), &a) ;
+
+    // Renaming an event to the name of an earlier active event does not hide the earlier event.
+    b.set_name("renamed") ;
+    EXPECT_TRUE(em.get_event("b") == NULL) ;
+    EXPECT_EQ(em.get_event("renamed"), &a) ;
+    a.set_name("a") ;
+    EXPECT_EQ(em.get_event("a"), &a) ;
+    EXPECT_EQ(em.get_event("renamed"), &b) ;
+
+    // Events that are not active are not found under either name.
+    idle.set_name("still_idle") ;
+    EXPECT_TRUE(em.get_event("idle") == NULL) ;
+    EXPECT_TRUE(em.get_event("still_idle") == NULL) ;
+
+    em.remove_event(&a) ;
+    em.remove_event(&b) ;
+    EXPECT_TRUE(em.get_event("a") == NULL) ;
+    EXPECT_TRUE(em.get_event("renamed") == NULL) ;
+}
+
+TEST_F(EventManagerTest, SkippedCyclesFireAtSameTimes) {
+    Trick::EventProcessor skip_ep ;
+    Trick::JobData skip_job ;
+    skip_ep.set_process_event_job(&skip_job) ;
+
+    // The fire time is between cycles so the first firing is on the next cycle boundary.
+    TestEvent every("every", 0.25) ;
+    TestEvent skipping("skipping", 0.25) ;
+    every.fire_tics = skipping.fire_tics = tics(10.1) ;
+    skipping.report_wake = true ;
+
+    ep.add_event(&every) ;
+    skip_ep.add_event(&skipping) ;
+    run(ep, process_event_job, tics(12.0)) ;
+    run(skip_ep, skip_job, tics(12.0)) ;
+
+    ASSERT_FALSE(every.fired.empty()) ;
+    EXPECT_EQ(every.fired.front(), tics(10.25)) ;
+    EXPECT_EQ(skipping.fired, every.fired) ;
+    // The skipped cycles are not processed.
+    EXPECT_EQ(skipping.processed, skipping.fired) ;
+    EXPECT_GT(every.processed.size(), every.fired.size()) ;
+}
+
+TEST_F(EventManagerTest, WokenEventFiresAtSameTimes) {
+    Trick::EventProcessor skip_ep ;
+    Trick::JobData skip_job ;
+    skip_ep.set_process_event_job(&skip_job) ;
+
+    TestEvent every("every", 0.5) ;
+    TestEvent skipping("skipping", 0.5) ;
+    every.fire_tics = skipping.fire_tics = tics(100.0) ;
+    skipping.report_wake = true ;
+
+    ep.add_event(&every) ;
+    skip_ep.add_event(&skipping) ;
+    run(ep, process_event_job, tics(2.0)) ;
+    run(skip_ep, skip_job, tics(2.0)) ;
+    EXPECT_TRUE(every.fired.empty()) ;
+    EXPECT_TRUE(skipping.fired.empty()) ;
+
+    // The condition changes so the events could fire sooner than their wake time.
+    every.fire_tics = skipping.fire_tics = tics(3.2) ;
+    skip_ep.wake_event(&skipping) ;
+
+    long long curr_tics = tics(2.0) ;
+    while ( curr_tics <= tics(5.0) ) {
+        ep.add_pending_events(curr_tics) ;
+        skip_ep.add_pending_events(curr_tics) ;
+        if ( process_event_job.next_tics == curr_tics ) {
+            ep.process_event(curr_tics) ;
+        }
+        if ( skip_job.next_tics == curr_tics ) {
+            skip_ep.process_event(curr_tics) ;
+        }
+        curr_tics += tics(0.1) ;
+    }
+    ASSERT_FALSE(every.fired.empty()) ;
+    EXPECT_EQ(every.fired.front(), tics(3.5)) ;
+    EXPECT_EQ(skipping.fired, every.fired) ;
+}
+
+TEST_F(EventManagerTest, RemovedEventsAreNotAddedOrWoken) {
+    // An event added and removed before the next top of frame is never processed.
+    TestEvent added("added", 0.5) ;
+    ep.add_event(&added) ;
+    ep.remove_event(&added) ;
+    ep.add_pending_events(0) ;
+    EXPECT_EQ(process_event_job.next_tics, TRICK_MAX_LONG_LONG) ;
+
+    // A woken event that is removed and freed is not touched at the next top of frame.
+    TestEvent * woken = new TestEvent("woken", 0.5) ;
+    woken->fire_tics = tics(100.0) ;
+    woken->report_wake = true ;
+    ep.add_event(woken) ;
+    ep.add_pending_events(0) ;
+    EXPECT_EQ(process_event_job.next_tics, tics(100.0)) ;
+    ep.wake_event(woken) ;
+    ep.remove_event(woken) ;
+    delete woken ;
+    ep.add_pending_events(tics(1.0)) ;
+    EXPECT_EQ(process_event_job.next_tics, TRICK_MAX_LONG_LONG) ;
+}
+
+}
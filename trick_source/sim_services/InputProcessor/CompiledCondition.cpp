@@ -0,0 +1,752 @@
+/*
+   PURPOSE: ( Native evaluation of simple event condition strings )
+   REFERENCE: ( Trick Simulation Environment )
+   ASSUMPTIONS AND LIMITATIONS: ( None )
+   CLASS: ( N/A )
+   LIBRARY DEPENDENCY: ( None )
+*/
+
+#include <string>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "trick/CompiledCondition.hh"
+#include "trick/reference.h"
+#include "trick/parameter_types.h"
+#include "trick/memorymanager_c_intf.h"
+#include "trick/exec_proto.h"
+
+/* ================================================================================
+                                Expression tree nodes
+   ================================================================================ */
+
+/*
+ Nodes evaluate in double precision. Python compares and adds integers exactly, so an
+ integer valued node keeps a bound on its magnitude, and the parser leaves any expression
+ that could reach 2**53, past which doubles skip integers, to Python.
+ */
+static const double max_exact_int = 9007199254740992.0 ;
+
+class Trick::CompiledCondition::Node {
+    public:
+        Node( bool in_is_bool, double in_int_bound ) : is_bool(in_is_bool), int_bound(in_int_bound) {}
+        virtual ~Node() {}
+        virtual double eval() = 0 ;
+        /** If the node is false whenever sim time is less than some time, set bound to that time. */
+        virtual bool time_bound( double & ) { return false ; }
+        virtual bool is_sim_time() { return false ; }
+        virtual bool is_constant( double & ) { return false ; }
+        /** True if the node always produces a Python bool. */
+        bool is_bool ;
+        /** Bound on the magnitude of an integer valued node, or -1 for a float valued node. */
+        double int_bound ;
+} ;
+
+typedef Trick::CompiledCondition::Node Node ;
+
+namespace {
+
+/* Thrown when a variable is referenced through a NULL pointer. */
+struct NullReference {} ;
+
+class ConstantNode : public Node {
+    public:
+        ConstantNode( double in_value, bool in_is_bool, bool in_is_int ) :
+         Node(in_is_bool, in_is_int ? fabs(in_value) : -1.0), value(in_value) {}
+        virtual double eval() { return value ; }
+        virtual bool is_constant( double & out_value ) { out_value = value ; return true ; }
+    private:
+        double value ;
+} ;
+
+class SimTimeNode : public Node {
+    public:
+        SimTimeNode() : Node(false, -1.0) {}
+        virtual double eval() { return exec_get_sim_time() ; }
+        virtual bool is_sim_time() { return true ; }
+} ;
+
+/*
+ A variable resolved when the condition is compiled. Deleting or resizing a named allocation
+ changes the memory manager's reference generation, and the variable is then resolved again
+ by name, as Python would, before it is read. A variable that no longer exists, or that now
+ has a different type, raises a NullReference like a NULL pointer does.
+ */
+class VariableNode : public Node {
+    public:
+        VariableNode( REF2 * in_ref ) : Node(in_ref->attr->type == TRICK_BOOLEAN, bound(in_ref->attr)),
+         ref(in_ref), name(in_ref->reference), type(in_ref->attr->type), size(in_ref->attr->size),
+         num_index(in_ref->num_index), generation(TMM_ref_cache_generation()) {}
+
+        virtual ~VariableNode() {
+            free_ref(ref) ;
+        }
+
+        virtual double eval() {
+            if ( ref == NULL || generation != TMM_ref_cache_generation() ) {
+                resolve() ;
+            }
+            void * address = ref->pointer_present ? follow_address_path(ref) : ref->address ;
+            if ( address == NULL ) {
+                throw NullReference() ;
+            }
+            switch ( type ) {
+                case TRICK_SHORT:              return *(short *)address ;
+                case TRICK_UNSIGNED_SHORT:     return *(unsigned short *)address ;
+                case TRICK_INTEGER:            return *(int *)address ;
+                case TRICK_UNSIGNED_INTEGER:   return *(unsigned int *)address ;
+                case TRICK_LONG:               return *(long *)address ;
+                case TRICK_UNSIGNED_LONG:      return *(unsigned long *)address ;
+                case TRICK_LONG_LONG:          return *(long long *)address ;
+                case TRICK_UNSIGNED_LONG_LONG: return *(unsigned long long *)address ;
+                case TRICK_FLOAT:              return *(float *)address ;
+                case TRICK_DOUBLE:             return *(double *)address ;
+                case TRICK_BOOLEAN:            return *(bool *)address ;
+                case TRICK_ENUMERATED:
+                    switch ( size ) {
+                        case 1: return *(signed char *)address ;
+                        case 2: return *(short *)address ;
+                        default: return *(int *)address ;
+                    }
+                default:                       return 0.0 ;
+            }
+        }
+
+        static void free_ref( REF2 * in_ref ) {
+            if ( in_ref != NULL ) {
+                ref_free(in_ref) ;
+                if ( in_ref->ref_attr ) {
+                    free(in_ref->ref_attr) ;
+                }
+                free(in_ref) ;
+            }
+        }
+
+        /* 64 bit integers cannot all be held in a double, so they are left to Python. */
+        static bool is_supported( REF2 * in_ref ) {
+            if ( in_ref->attr == NULL || in_ref->num_index != in_ref->attr->num_index ) {
+                return false ;
+            }
+            switch ( in_ref->attr->type ) {
+                case TRICK_SHORT:
+                case TRICK_UNSIGNED_SHORT:
+                case TRICK_INTEGER:
+                case TRICK_UNSIGNED_INTEGER:
+                case TRICK_FLOAT:
+                case TRICK_DOUBLE:
+                case TRICK_BOOLEAN:
+                    return true ;
+                case TRICK_LONG:
+                case TRICK_UNSIGNED_LONG:
+                    return ( sizeof(long) == 4 ) ;
+                case TRICK_ENUMERATED:
+                    return ( in_ref->attr->size == 1 || in_ref->attr->size == 2 || in_ref->attr->size == 4 ) ;
+                default:
+                    return false ;
+            }
+        }
+
+        static double bound( ATTRIBUTES * attr ) {
+            switch ( attr->type ) {
+                case TRICK_FLOAT:
+                case TRICK_DOUBLE:
+                    return -1.0 ;
+                case TRICK_BOOLEAN:
+                    return 1.0 ;
+                default:
+                    return ldexp( 1.0, 8 * attr->size ) ;
+            }
+        }
+
+    private:
+        /* Resolve the name again. Leaves ref NULL and throws if it no longer names the same type. */
+        void resolve() {
+            generation = TMM_ref_cache_generation() ;
+            free_ref(ref) ;
+            ref = NULL ;
+            std::string top_name = name.substr(0, name.find_first_of(".[")) ;
+            if ( TMM_var_exists(top_name.c_str()) ) {
+                ref = ref_attributes(name.c_str()) ;
+            }
+            if ( ref != NULL && ( ref->attr == NULL || ref->attr->type != type || ref->attr->size != size ||
+             ref->num_index != num_index ) ) {
+                free_ref(ref) ;
+                ref = NULL ;
+            }
+            if ( ref == NULL ) {
+                throw NullReference() ;
+            }
+        }
+
+        REF2 * ref ;
+        std::string name ;
+        int type ;
+        int size ;
+        int num_index ;
+        unsigned int generation ;
+} ;
+
+class NegateNode : public Node {
+    public:
+        NegateNode( Node * in_operand ) : Node(false, in_operand->int_bound), operand(in_operand) {}
+        virtual ~NegateNode() { delete operand ; }
+        virtual double eval() { return -operand->eval() ; }
+    private:
+        Node * operand ;
+} ;
+
+class NotNode : public Node {
+    public:
+        NotNode( Node * in_operand ) : Node(true, 1.0), operand(in_operand) {}
+        virtual ~NotNode() { delete operand ; }
+        virtual double eval() { return operand->eval() == 0.0 ; }
+    private:
+        Node * operand ;
+} ;
+
+class ArithmeticNode : public Node {
+    public:
+        ArithmeticNode( char in_op, Node * in_left, Node * in_right ) :
+         Node(false, bound(in_op, in_left, in_right)), op(in_op), left(in_left), right(in_right) {}
+        virtual ~ArithmeticNode() { delete left ; delete right ; }
+        virtual double eval() {
+            switch ( op ) {
+                case '+': return left->eval() + right->eval() ;
+                case '-': return left->eval() - right->eval() ;
+                default:  return left->eval() * right->eval() ;
+            }
+        }
+        /* An integer result is only produced from integer operands. */
+        static double bound( char in_op, Node * in_left, Node * in_right ) {
+            if ( in_left->int_bound < 0.0 || in_right->int_bound < 0.0 ) {
+                return -1.0 ;
+            }
+            return ( in_op == '*' ) ? in_left->int_bound * in_right->int_bound : in_left->int_bound + in_right->int_bound ;
+        }
+    private:
+        char op ;
+        Node * left ;
+        Node * right ;
+} ;
+
+/* "and" and "or" return one of their operands, as in Python. */
+class LogicalNode : public Node {
+    public:
+        LogicalNode( bool in_is_and, Node * in_left, Node * in_right ) :
+         Node(in_left->is_bool && in_right->is_bool, ( in_left->int_bound < 0.0 || in_right->int_bound < 0.0 ) ?
+          -1.0 : fmax(in_left->int_bound, in_right->int_bound)), is_and(in_is_and), left(in_left), right(in_right) {}
+        virtual ~LogicalNode() { delete left ; delete right ; }
+        virtual double eval() {
+            double value = left->eval() ;
+            if ( (value != 0.0) == is_and ) {
+                value = right->eval() ;
+            }
+            return value ;
+        }
+        /* "a and b" is false until both could be true, "a or b" until either could be. */
+        virtual bool time_bound( double & bound ) {
+            double left_bound , right_bound ;
+            bool has_left = left->time_bound(left_bound) ;
+            bool has_right = right->time_bound(right_bound) ;
+            if ( is_and ) {
+                if ( has_left && has_right ) {
+                    bound = left_bound > right_bound ? left_bound : right_bound ;
+                } else if ( has_left || has_right ) {
+                    bound = has_left ? left_bound : right_bound ;
+                }
+                return ( has_left || has_right ) ;
+            }
+            if ( has_left && has_right ) {
+                bound = left_bound < right_bound ? left_bound : right_bound ;
+                return true ;
+            }
+            return false ;
+        }
+    private:
+        bool is_and ;
+        Node * left ;
+        Node * right ;
+} ;
+
+enum CompareOp { CMP_LT, CMP_LE, CMP_GT, CMP_GE, CMP_EQ, CMP_NE } ;
+
+/* a < b <= c is evaluated as a < b and b <= c, with b evaluated once. */
+class CompareNode : public Node {
+    public:
+        CompareNode( Node * first ) : Node(true, 1.0) { operands.push_back(first) ; }
+        virtual ~CompareNode() {
+            for ( size_t ii = 0 ; ii < operands.size() ; ii++ ) {
+                delete operands[ii] ;
+            }
+        }
+        void add( CompareOp op, Node * operand ) {
+            ops.push_back(op) ;
+            operands.push_back(operand) ;
+        }
+        virtual double eval() {
+            double left = operands[0]->eval() ;
+            for ( size_t ii = 0 ; ii < ops.size() ; ii++ ) {
+                double right = operands[ii + 1]->eval() ;
+                bool result ;
+                switch ( ops[ii] ) {
+                    case CMP_LT: result = left <  right ; break ;
+                    case CMP_LE: result = left <= right ; break ;
+                    case CMP_GT: result = left >  right ; break ;
+                    case CMP_GE: result = left >= right ; break ;
+                    case CMP_EQ: result = left == right ; break ;
+                    default:     result = left != right ; break ;
+                }
+                if ( ! result ) {
+                    return 0.0 ;
+                }
+                left = right ;
+            }
+            return 1.0 ;
+        }
+        /* Every link of the chain must hold, so the latest lower bound on sim time applies. */
+        virtual bool time_bound( double & bound ) {
+            bool found = false ;
+            for ( size_t ii = 0 ; ii < ops.size() ; ii++ ) {
+                double value ;
+                bool lower_bound = false ;
+                if ( operands[ii]->is_sim_time() && operands[ii + 1]->is_constant(value) ) {
+                    // time > c, time >= c, time == c
+                    lower_bound = ( ops[ii] == CMP_GT || ops[ii] == CMP_GE || ops[ii] == CMP_EQ ) ;
+                } else if ( operands[ii]->is_constant(value) && operands[ii + 1]->is_sim_time() ) {
+                    // c < time, c <= time, c == time
+                    lower_bound = ( ops[ii] == CMP_LT || ops[ii] == CMP_LE || ops[ii] == CMP_EQ ) ;
+                }
+                if ( lower_bound && ( ! found || value > bound )) {
+                    bound = value ;
+                    found = true ;
+                }
+            }
+            return found ;
+        }
+    private:
+        std::vector<CompareOp> ops ;
+        std::vector<Node *> operands ;
+} ;
+
+/* ================================================================================
+                                      Parser
+   ================================================================================ */
+
+enum TokenType { TOK_END, TOK_NUMBER, TOK_NAME, TOK_CALL, TOK_LPAREN, TOK_RPAREN,
+                 TOK_PLUS, TOK_MINUS, TOK_STAR, TOK_COMPARE,
+                 TOK_AND, TOK_OR, TOK_NOT, TOK_TRUE, TOK_FALSE, TOK_ERROR } ;
+
+/*
+ Recursive descent parser for the compiled subset of Python expressions. Any
+ construct outside the subset sets the error flag, and the caller falls back to
+ Python. Precedence follows the Python grammar:
+    or_test    : and_test ( "or" and_test )*
+    and_test   : not_test ( "and" not_test )*
+    not_test   : "not" not_test | comparison
+    comparison : arith ( comp_op arith )*
+    arith      : term ( ( "+" | "-" ) term )*
+    term       : factor ( "*" factor )*
+    factor     : ( "+" | "-" ) factor | atom
+    atom       : NUMBER | True | False | NAME | trick.exec_get_sim_time() | "(" or_test ")"
+ */
+class ConditionParser {
+
+    public:
+
+        ConditionParser( const std::string & in_str ) : str(in_str), pos(0), error(false) {
+            next() ;
+        }
+
+        Node * parse() {
+            Node * root = or_test() ;
+            if ( root != NULL && ( error || type != TOK_END )) {
+                delete root ;
+                root = NULL ;
+            }
+            return root ;
+        }
+
+    private:
+
+        const std::string & str ;
+        size_t pos ;
+        bool error ;
+
+        TokenType type ;        // current token
+        double number ;         // value of a TOK_NUMBER
+        bool number_is_int ;    // true if a TOK_NUMBER is an integer literal
+        std::string name ;      // canonical reference of a TOK_NAME or TOK_CALL
+        CompareOp compare_op ;  // operator of a TOK_COMPARE
+
+        void skip_space() {
+            while ( pos < str.size() && isspace((unsigned char)str[pos]) ) {
+                pos++ ;
+            }
+        }
+
+        static bool is_name_start( char c ) {
+            return ( isalpha((unsigned char)c) || c == '_' ) ;
+        }
+
+        static bool is_name_char( char c ) {
+            return ( isalnum((unsigned char)c) || c == '_' ) ;
+        }
+
+        void lex_number() {
+            const char * start = str.c_str() + pos ;
+            char * end ;
+            // Leave hex, octal, binary and complex literals and digit separators to Python.
+            if ( start[0] == '0' && isalpha((unsigned char)start[1]) && tolower(start[1]) != 'e' ) {
+                type = TOK_ERROR ;
+                return ;
+            }
+            number = strtod( start, &end ) ;
+            number_is_int = ( strcspn( start, ".eE" ) >= (size_t)(end - start) ) ;
+            pos += end - start ;
+            if ( end == start || is_name_char(*end) || *end == '.' ) {
+                type = TOK_ERROR ;
+            } else {
+                type = TOK_NUMBER ;
+            }
+        }
+
+        /* NAME ( "." NAME | "[" integer "]" )*, rebuilt without whitespace. */
+        void lex_name() {
+            bool plain = true ;
+            name.clear() ;
+            while ( true ) {
+                size_t start = pos ;
+                while ( pos < str.size() && is_name_char(str[pos]) ) {
+                    pos++ ;
+                }
+                name += str.substr(start, pos - start) ;
+                skip_space() ;
+                while ( pos < str.size() && str[pos] == '[' ) {
+                    plain = false ;
+                    pos++ ;
+                    skip_space() ;
+                    start = pos ;
+                    while ( pos < str.size() && isdigit((unsigned char)str[pos]) ) {
+                        pos++ ;
+                    }
+                    if ( pos == start ) {
+                        type = TOK_ERROR ;
+                        return ;
+                    }
+                    name += "[" + str.substr(start, pos - start) + "]" ;
+                    skip_space() ;
+                    if ( pos >= str.size() || str[pos] != ']' ) {
+                        type = TOK_ERROR ;
+                        return ;
+                    }
+                    pos++ ;
+                    skip_space() ;
+                }
+                if ( pos < str.size() && str[pos] == '.' ) {
+                    plain = false ;
+                    pos++ ;
+                    skip_space() ;
+                    if ( pos >= str.size() || ! is_name_start(str[pos]) ) {
+                        type = TOK_ERROR ;
+                        return ;
+                    }
+                    name += "." ;
+                } else {
+                    break ;
+                }
+            }
+
+            if ( plain && name == "and" ) {
+                type = TOK_AND ;
+            } else if ( plain && name == "or" ) {
+                type = TOK_OR ;
+            } else if ( plain && name == "not" ) {
+                type = TOK_NOT ;
+            } else if ( plain && name == "True" ) {
+                type = TOK_TRUE ;
+            } else if ( plain && name == "False" ) {
+                type = TOK_FALSE ;
+            } else if ( pos < str.size() && str[pos] == '(' ) {
+                // The only call compiled is trick.exec_get_sim_time()
+                pos++ ;
+                skip_space() ;
+                if ( name == "trick.exec_get_sim_time" && pos < str.size() && str[pos] == ')' ) {
+                    pos++ ;
+                    type = TOK_CALL ;
+                } else {
+                    type = TOK_ERROR ;
+                }
+            } else {
+                type = TOK_NAME ;
+            }
+        }
+
+        void next() {
+            skip_space() ;
+            if ( pos >= str.size() ) {
+                type = TOK_END ;
+                return ;
+            }
+            char c = str[pos] ;
+            char c1 = ( pos + 1 < str.size() ) ? str[pos + 1] : '\0' ;
+            if ( isdigit((unsigned char)c) || ( c == '.' && isdigit((unsigned char)c1) )) {
+                lex_number() ;
+            } else if ( is_name_start(c) ) {
+                lex_name() ;
+            } else {
+                pos++ ;
+                switch ( c ) {
+                    case '(': type = TOK_LPAREN ; break ;
+                    case ')': type = TOK_RPAREN ; break ;
+                    case '+': type = TOK_PLUS ; break ;
+                    case '-': type = TOK_MINUS ; break ;
+                    case '*': type = ( c1 == '*' ) ? TOK_ERROR : TOK_STAR ; break ;
+                    case '<':
+                        type = TOK_COMPARE ;
+                        compare_op = ( c1 == '=' ) ? CMP_LE : CMP_LT ;
+                        break ;
+                    case '>':
+                        type = TOK_COMPARE ;
+                        compare_op = ( c1 == '=' ) ? CMP_GE : CMP_GT ;
+                        break ;
+                    case '=':
+                    case '!':
+                        type = ( c1 == '=' ) ? TOK_COMPARE : TOK_ERROR ;
+                        compare_op = ( c == '=' ) ? CMP_EQ : CMP_NE ;
+                        break ;
+                    default:
+                        type = TOK_ERROR ;
+                        break ;
+                }
+                if ( type == TOK_COMPARE && c1 == '=' ) {
+                    pos++ ;
+                }
+            }
+            if ( type == TOK_ERROR ) {
+                error = true ;
+            }
+        }
+
+        /* Integers that a double may not hold exactly are left to Python. */
+        Node * exact( Node * node ) {
+            if ( node->int_bound >= max_exact_int ) {
+                delete node ;
+                error = true ;
+                return NULL ;
+            }
+            return node ;
+        }
+
+        Node * or_test() {
+            Node * left = and_test() ;
+            while ( left != NULL && type == TOK_OR ) {
+                next() ;
+                Node * right = and_test() ;
+                if ( right == NULL ) {
+                    delete left ;
+                    return NULL ;
+                }
+                left = new LogicalNode( false, left, right ) ;
+            }
+            return left ;
+        }
+
+        Node * and_test() {
+            Node * left = not_test() ;
+            while ( left != NULL && type == TOK_AND ) {
+                next() ;
+                Node * right = not_test() ;
+                if ( right == NULL ) {
+                    delete left ;
+                    return NULL ;
+                }
+                left = new LogicalNode( true, left, right ) ;
+            }
+            return left ;
+        }
+
+        Node * not_test() {
+            if ( type == TOK_NOT ) {
+                next() ;
+                Node * operand = not_test() ;
+                return operand ? new NotNode(operand) : NULL ;
+            }
+            return comparison() ;
+        }
+
+        Node * comparison() {
+            Node * left = arith() ;
+            if ( left == NULL || type != TOK_COMPARE ) {
+                return left ;
+            }
+            CompareNode * compare = new CompareNode(left) ;
+            while ( type == TOK_COMPARE ) {
+                CompareOp op = compare_op ;
+                next() ;
+                Node * right = arith() ;
+                if ( right == NULL ) {
+                    delete compare ;
+                    return NULL ;
+                }
+                compare->add( op, right ) ;
+            }
+            return compare ;
+        }
+
+        Node * arith() {
+            Node * left = term() ;
+            while ( left != NULL && ( type == TOK_PLUS || type == TOK_MINUS )) {
+                char op = ( type == TOK_PLUS ) ? '+' : '-' ;
+                next() ;
+                Node * right = term() ;
+                if ( right == NULL ) {
+                    delete left ;
+                    return NULL ;
+                }
+                left = exact( new ArithmeticNode( op, left, right )) ;
+            }
+            return left ;
+        }
+
+        Node * term() {
+            Node * left = factor() ;
+            while ( left != NULL && type == TOK_STAR ) {
+                next() ;
+                Node * right = factor() ;
+                if ( right == NULL ) {
+                    delete left ;
+                    return NULL ;
+                }
+                left = exact( new ArithmeticNode( '*', left, right )) ;
+            }
+            return left ;
+        }
+
+        Node * factor() {
+            if ( type == TOK_PLUS ) {
+                next() ;
+                Node * operand = factor() ;
+                // Unary plus turns a bool into an int.
+                return operand ? new ArithmeticNode( '+', new ConstantNode(0.0, false, true), operand ) : NULL ;
+            }
+            if ( type == TOK_MINUS ) {
+                next() ;
+                Node * operand = factor() ;
+                double value ;
+                if ( operand != NULL && ! operand->is_bool && operand->is_constant(value) ) {
+                    bool is_int = ( operand->int_bound >= 0.0 ) ;
+                    delete operand ;
+                    return new ConstantNode( -value, false, is_int ) ;
+                }
+                return operand ? new NegateNode(operand) : NULL ;
+            }
+            return atom() ;
+        }
+
+        Node * atom() {
+            Node * node = NULL ;
+            switch ( type ) {
+                case TOK_NUMBER:
+                    node = exact( new ConstantNode( number, false, number_is_int )) ;
+                    next() ;
+                    break ;
+                case TOK_TRUE:
+                case TOK_FALSE:
+                    node = new ConstantNode( type == TOK_TRUE ? 1.0 : 0.0, true, true ) ;
+                    next() ;
+                    break ;
+                case TOK_CALL:
+                    node = new SimTimeNode() ;
+                    next() ;
+                    break ;
+                case TOK_NAME:
+                    node = variable() ;
+                    if ( node != NULL ) {
+                        next() ;
+                    }
+                    break ;
+                case TOK_LPAREN:
+                    next() ;
+                    node = or_test() ;
+                    if ( node != NULL ) {
+                        if ( type == TOK_RPAREN ) {
+                            next() ;
+                        } else {
+                            delete node ;
+                            node = NULL ;
+                        }
+                    }
+                    break ;
+                default:
+                    break ;
+            }
+            return node ;
+        }
+
+        Node * variable() {
+            // Python names that are not Trick variables are left to Python. Checking the
+            // top level name first keeps ref_attributes from reporting missing variables.
+            std::string top_name = name.substr(0, name.find_first_of(".[")) ;
+            if ( ! TMM_var_exists(top_name.c_str()) ) {
+                return NULL ;
+            }
+            REF2 * ref = ref_attributes(name.c_str()) ;
+            if ( ref == NULL ) {
+                return NULL ;
+            }
+            if ( ! VariableNode::is_supported(ref) ) {
+                VariableNode::free_ref(ref) ;
+                return NULL ;
+            }
+            return new VariableNode(ref) ;
+        }
+} ;
+
+}
+
+/* ================================================================================
+                                  CompiledCondition
+   ================================================================================ */
+
+Trick::CompiledCondition::CompiledCondition( Node * in_root ) : root(in_root) {}
+
+Trick::CompiledCondition::~CompiledCondition() {
+    delete root ;
+}
+
+Trick::CompiledCondition * Trick::CompiledCondition::compile( const std::string & str ) {
+
+    ConditionParser parser(str) ;
+    Node * root = parser.parse() ;
+
+    /* IPPython::parse_condition stores the Python result in an int, so only expressions
+       that produce a bool are certain to have the same truth value here. */
+    if ( root == NULL ) {
+        return NULL ;
+    }
+    if ( ! root->is_bool ) {
+        delete root ;
+        return NULL ;
+    }
+    return new CompiledCondition(root) ;
+}
+
+/**
+ @par Detailed Design:
+ A reference through a NULL pointer raises an error in Python, which leaves the condition
+ false. A compiled condition is likewise false, however the rest of it would evaluate.
+ */
+bool Trick::CompiledCondition::evaluate() {
+    try {
+        return ( root->eval() != 0.0 ) ;
+    } catch ( NullReference & ) {
+        return false ;
+    }
+}
+
+bool Trick::CompiledCondition::get_time_bound( double & time ) {
+    return root->time_bound(time) ;
+}
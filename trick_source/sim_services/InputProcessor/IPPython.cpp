@@ -178,7 +178,8 @@ int Trick::IPPython::parse_condition(std::string in_string, int & cond_return_va
 
     pthread_mutex_lock(&ip_mutex);
     in_string =  std::string("trick_ip.ip.return_val = ") + in_string + "\n" ;
-    // Running the simple string will set return_val.
+    // Running the simple string will set return_val, unless it raises an error.
+    return_val = 0 ;
     PyRun_SimpleString(in_string.c_str()) ;
     cond_return_val = return_val ;
     pthread_mutex_unlock(&ip_mutex);
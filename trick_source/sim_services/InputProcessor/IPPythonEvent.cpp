@@ -11,15 +11,18 @@
 #include <string>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "trick/IPPythonEvent.hh"
 #include "trick/IPPython.hh"
+#include "trick/CompiledCondition.hh"
 #include "trick/MemoryManager.hh"
 #include "trick/exec_proto.h"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
 #include "trick/memorymanager_c_intf.h"
 #include "trick/exec_proto.hh"
+#include "trick/EventManager_c_intf.hh"
 
 /* Global singleton pointer to the memory manager */
 //TODO Use external MM interface
@@ -38,6 +41,11 @@ Trick::condition_t::condition_t() {
     fired_time = -1.0 ;
     ref = NULL ;
     job = NULL ;
+    compiled = NULL ;
+}
+
+Trick::condition_t::~condition_t() {
+    delete compiled ;
 }
 
 Trick::action_t::action_t() {
@@ -125,6 +133,7 @@ void Trick::IPPythonEvent::manual_on() {
     manual_fired = true ;
     hold = true ;
     fired = false ;
+    event_manager_wake_event(this) ;
 }
 
 //Command to manually fire the event once NOW (enter manual mode, bypasses normal condition processing).
@@ -134,6 +143,7 @@ void Trick::IPPythonEvent::manual_fire() {
     hold = false ;
     fired = false ;
     process_user_event(exec_get_time_tics()) ;
+    event_manager_wake_event(this) ;
 }
 
 //Command to manually set the event as not fired (enter manual mode, bypasses normal condition processing).
@@ -142,6 +152,7 @@ void Trick::IPPythonEvent::manual_off() {
     manual_fired = false ;
     hold = false ;
     fired = false ;
+    event_manager_wake_event(this) ;
 }
 
 //Command to return to normal event processing (needed to end manual mode after any manual commands).
@@ -149,6 +160,7 @@ void Trick::IPPythonEvent::manual_done() {
     manual = false ;
     manual_fired = false ;
     hold = false ;
+    event_manager_wake_event(this) ;
 }
 
 void Trick::IPPythonEvent::add() {
@@ -179,6 +191,10 @@ void Trick::IPPythonEvent::restart() {
         if (condition_list[jj]->cond_type==2) { // condition job
             condition_list[jj]->job = exec_get_job(condition_list[jj]->str.c_str(),1);
         }
+        if (condition_list[jj]->cond_type==0) { // condition string
+            delete condition_list[jj]->compiled ;
+            condition_list[jj]->compiled = Trick::CompiledCondition::compile(condition_list[jj]->str) ;
+        }
     }
     for (jj=0; jj<action_count; jj++) {
         if (action_list[jj]->act_type!=0) { // action job
@@ -256,6 +272,14 @@ int Trick::IPPythonEvent::condition(int num, std::string str, std::string commen
             condition_list[num]->cond_type = 2;
         } else condition_list[num]->cond_type = 0;
         condition_list[num]->str = str;
+        /** @li Compile a condition string into native form if it only uses simple comparisons of variables
+                and constants, so it can be evaluated without python. */
+        delete condition_list[num]->compiled ;
+        condition_list[num]->compiled = NULL ;
+        if (condition_list[num]->cond_type == 0) {
+            condition_list[num]->compiled = Trick::CompiledCondition::compile(str) ;
+        }
+        event_manager_wake_event(this) ;
         // comment is for display in mtv, if not supplied create a comment containing up to 50 characters of cond string
         if (comment.empty()) {
             condition_list[num]->comment = str.substr(0,50);
@@ -275,6 +299,7 @@ int Trick::IPPythonEvent::condition_hold_on(int num) {
 
     if ((num >=0) && (num < condition_count)) {
         condition_list[num]->hold = true ;
+        event_manager_wake_event(this) ;
     } else {
         message_publish(MSG_WARNING, "Event condition hold not set. Condition number %d is invalid.\n", num) ;
     }
@@ -286,6 +311,7 @@ int Trick::IPPythonEvent::condition_hold_off(int num) {
 
     if ((num >=0) && (num < condition_count)) {
         condition_list[num]->hold = false ;
+        event_manager_wake_event(this) ;
     } else {
         message_publish(MSG_WARNING, "Event condition hold not set. Condition number %d is invalid.\n", num) ;
     }
@@ -297,6 +323,7 @@ int Trick::IPPythonEvent::condition_enable(int num) {
 
     if ((num >=0) && (num < condition_count)) {
         condition_list[num]->enabled = true ;
+        event_manager_wake_event(this) ;
     } else {
         message_publish(MSG_WARNING, "Event condition not enabled. Condition number %d is invalid.\n", num) ;
     }
@@ -308,6 +335,7 @@ int Trick::IPPythonEvent::condition_disable(int num) {
 
     if ((num >=0) && (num < condition_count)) {
         condition_list[num]->enabled = false ;
+        event_manager_wake_event(this) ;
     } else {
         message_publish(MSG_WARNING, "Event condition not disabled. Condition number %d is invalid.\n", num) ;
     }
@@ -358,6 +386,17 @@ std::string Trick::IPPythonEvent::condition_string(int num) {
     return "" ;
 }
 
+//Accessor function to test if the condition string, indicated by num, is evaluated without python.
+bool Trick::IPPythonEvent::condition_compiled(int num) {
+
+    if ((num >=0) && (num < condition_count)) {
+        return (condition_list[num]->compiled != NULL) ;
+    } else {
+        message_publish(MSG_WARNING, "Event condition compiled state not returned. Condition number %d is invalid.\n", num) ;
+    }
+    return(false);
+}
+
 //Command to create a new action using a model job (or reset an existing action job), num is index starting at 0.
 int Trick::IPPythonEvent::action_job(int num, std::string jobname, std::string comment) {
     /** @par Detailed Design: */
@@ -504,6 +543,43 @@ double Trick::IPPythonEvent::action_ran_time(int num) {
     return(0.0) ;
 }
 
+long long Trick::IPPythonEvent::get_wake_tics() {
+
+    int ii ;
+    double bound ;
+    double wake_time = 0.0 ;
+    bool found = false ;
+
+    /** @par Detailed Design: */
+    /** @li Manual mode and read events are always processed. */
+    if ( manual || ! is_user_event ) {
+        return 0 ;
+    }
+    /** @li Every enabled condition must be a compiled condition with a lower bound on sim time, and
+            must not be holding a fired state.  The event cannot fire before the earliest bound. */
+    for (ii=0; ii<condition_count; ii++) {
+        if (! condition_list[ii]->enabled ) {
+            continue ;
+        }
+        if ( condition_list[ii]->hold && condition_list[ii]->fired ) {
+            return 0 ;
+        }
+        if ( condition_list[ii]->compiled == NULL || ! condition_list[ii]->compiled->get_time_bound(bound) ) {
+            return 0 ;
+        }
+        if ( ! found || bound < wake_time ) {
+            wake_time = bound ;
+        }
+        found = true ;
+    }
+    /** @li Round down to tics so the event is never processed later than it would have fired. */
+    wake_time *= exec_get_time_tic_value() ;
+    if ( ! found || wake_time <= 0.0 || wake_time > 1.0e18 ) {
+        return 0 ;
+    }
+    return (long long)floor(wake_time) ;
+}
+
 int Trick::IPPythonEvent::process( long long curr_time ) {
 
     if ( active || manual_fired ) {
@@ -569,6 +645,9 @@ bool Trick::IPPythonEvent::process_user_event( long long curr_time ) {
                     condition_list[ii]->job->disabled = false;
                     return_val = condition_list[ii]->job->call();
                     condition_list[ii]->job->disabled = save_disabled_state;
+                } else if (condition_list[ii]->compiled != NULL) {
+                // if the string was compiled, evaluate it natively
+                    return_val = condition_list[ii]->compiled->evaluate() ;
                 } else {
                 // otherwise use python to evaluate string
                     std::string full_in_string ;
@@ -0,0 +1,203 @@
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "trick/CompiledCondition.hh"
+#include "trick/Executive.hh"
+#include "trick/MemoryManager.hh"
+#include "CompiledCondition_test.hh"
+
+/*
+ The expected values are what Python gives for the same condition strings, which is
+ what IPPythonEvent would otherwise evaluate.
+ */
+
+class CompiledConditionTest : public ::testing::Test {
+
+    protected:
+        Trick::Executive exec ;
+        Trick::MemoryManager mm ;
+        CondTest obj ;
+
+        CompiledConditionTest() {
+            memset(&obj, 0, sizeof(obj)) ;
+            obj.i = 3 ;
+            obj.u = 4000000000u ;
+            obj.s = -2 ;
+            obj.b = true ;
+            obj.e = COND_TWO ;
+            obj.f = 0.5 ;
+            obj.d[1] = 1.5 ;
+            obj.d[2] = -2.0 ;
+            obj.d[3] = 7.0 ;
+            obj.ll = 9007199254740993LL ;
+            obj.ull = 18446744073709551615ULL ;
+            obj.l = 5 ;
+            mm.declare_extern_var(&obj, TRICK_STRUCTURED, "CondTest", 0, "obj", 0, NULL) ;
+        }
+
+        /* 1 or 0 for a compiled condition, -1 if it is left to Python. */
+        int eval( const char * str ) {
+            Trick::CompiledCondition * cond = Trick::CompiledCondition::compile(str) ;
+            if ( cond == NULL ) {
+                return -1 ;
+            }
+            int ret = cond->evaluate() ;
+            delete cond ;
+            return ret ;
+        }
+} ;
+
+TEST_F(CompiledConditionTest, Precedence) {
+    EXPECT_EQ(eval("obj.i + 2 * 3 == 9"), 1) ;
+    EXPECT_EQ(eval("(obj.i + 2) * 3 == 15"), 1) ;
+    EXPECT_EQ(eval("obj.i - 3 - 1 == -1"), 1) ;
+    EXPECT_EQ(eval("-obj.i * 2 == -6"), 1) ;
+    EXPECT_EQ(eval("- -obj.i == 3"), 1) ;
+    EXPECT_EQ(eval("not obj.i == 3"), 0) ;
+    EXPECT_EQ(eval("not obj.i == 4 and obj.b"), 1) ;
+    EXPECT_EQ(eval("obj.i == 3 or obj.i == 1 and False"), 1) ;
+    EXPECT_EQ(eval("(obj.i == 3 or obj.i == 1) and False"), 0) ;
+    EXPECT_EQ(eval("not not obj.b"), 1) ;
+    // Comparisons chain instead of comparing a bool.
+    EXPECT_EQ(eval("1 < obj.i < 5"), 1) ;
+    EXPECT_EQ(eval("1 < obj.i < 2"), 0) ;
+    EXPECT_EQ(eval("obj.i > 2 == True"), 0) ;
+    EXPECT_EQ(eval("(obj.i > 2) == True"), 1) ;
+    EXPECT_EQ(eval("obj.d [ 3 ] * 2 == 14.0"), 1) ;
+    EXPECT_EQ(eval("1e1 > 9.5"), 1) ;
+}
+
+TEST_F(CompiledConditionTest, BooleansAndEnums) {
+    EXPECT_EQ(eval("obj.b"), 1) ;
+    EXPECT_EQ(eval("obj.b_false"), 0) ;
+    EXPECT_EQ(eval("not obj.b"), 0) ;
+    EXPECT_EQ(eval("obj.b and obj.b_false"), 0) ;
+    EXPECT_EQ(eval("obj.b_false or obj.b"), 1) ;
+    EXPECT_EQ(eval("obj.b == 1"), 1) ;
+    EXPECT_EQ(eval("obj.b + obj.b == 2"), 1) ;
+    EXPECT_EQ(eval("obj.e == 2"), 1) ;
+    EXPECT_EQ(eval("obj.e > 1 and obj.b"), 1) ;
+    EXPECT_EQ(eval("obj.u > 3000000000"), 1) ;
+    EXPECT_EQ(eval("obj.s < 0"), 1) ;
+    EXPECT_EQ(eval("obj.f == 0.5"), 1) ;
+    // Python returns an operand of "and" or "or", which may not be a bool.
+    EXPECT_EQ(eval("obj.e"), -1) ;
+    EXPECT_EQ(eval("obj.b and obj.i"), -1) ;
+}
+
+TEST_F(CompiledConditionTest, NullPointer) {
+    // A pointer that is NULL when the condition is compiled leaves it to Python.
+    EXPECT_EQ(eval("obj.p[1] == 0"), -1) ;
+
+    // Python raises an error for a reference through a NULL pointer, so the condition is false
+    // however the rest of it would evaluate.
+    obj.p = obj.d ;
+    Trick::CompiledCondition * cond = Trick::CompiledCondition::compile("obj.p[1] == 1.5") ;
+    Trick::CompiledCondition * or_cond = Trick::CompiledCondition::compile("obj.p[1] == 0 or True") ;
+    Trick::CompiledCondition * not_cond = Trick::CompiledCondition::compile("not obj.p[1] == 0") ;
+    ASSERT_TRUE(cond != NULL) ;
+    ASSERT_TRUE(or_cond != NULL) ;
+    ASSERT_TRUE(not_cond != NULL) ;
+    EXPECT_TRUE(cond->evaluate()) ;
+    EXPECT_TRUE(or_cond->evaluate()) ;
+    EXPECT_TRUE(not_cond->evaluate()) ;
+    obj.p = NULL ;
+    EXPECT_FALSE(cond->evaluate()) ;
+    EXPECT_FALSE(or_cond->evaluate()) ;
+    EXPECT_FALSE(not_cond->evaluate()) ;
+    obj.p = obj.d ;
+    EXPECT_TRUE(cond->evaluate()) ;
+    delete cond ;
+    delete or_cond ;
+    delete not_cond ;
+}
+
+TEST_F(CompiledConditionTest, ExactIntegers) {
+    // Doubles cannot hold every 64 bit integer, so these are left to Python.
+    EXPECT_EQ(eval("obj.ll == 9007199254740993"), -1) ;
+    EXPECT_EQ(eval("obj.ull > 0"), -1) ;
+    EXPECT_EQ(eval("obj.i == 9007199254740993"), -1) ;
+    EXPECT_EQ(eval("obj.i < 9007199254740992"), -1) ;
+    EXPECT_EQ(eval("obj.u * obj.u > 0"), -1) ;
+    EXPECT_EQ(eval("obj.l == 5"), sizeof(long) == 4 ? 1 : -1) ;
+    // Within 2**53, integers and floats compare exactly.
+    EXPECT_EQ(eval("obj.i < 9007199254740991"), 1) ;
+    EXPECT_EQ(eval("obj.s * obj.i < 0"), 1) ;
+    EXPECT_EQ(eval("obj.u == 4000000000.0"), 1) ;
+    EXPECT_EQ(eval("obj.i * 1e300 > 1e300"), 1) ;
+}
+
+TEST_F(CompiledConditionTest, LeftToPython) {
+    EXPECT_EQ(eval("obj.i == 'a'"), -1) ;
+    EXPECT_EQ(eval("obj.i == \"3\""), -1) ;
+    EXPECT_EQ(eval("str(obj.i) == '3'"), -1) ;
+    EXPECT_EQ(eval("len(\"abc\") == 3"), -1) ;
+    EXPECT_EQ(eval("obj.i / 2 > 1"), -1) ;
+    EXPECT_EQ(eval("obj.i ** 2 > 1"), -1) ;
+    EXPECT_EQ(eval("obj.i is 3"), -1) ;
+    EXPECT_EQ(eval("obj.i == 0x3"), -1) ;
+    EXPECT_EQ(eval("obj.i = 3"), -1) ;
+    EXPECT_EQ(eval("obj.i == 3 and"), -1) ;
+    EXPECT_EQ(eval("(obj.i == 3"), -1) ;
+    EXPECT_EQ(eval("python_name > 3"), -1) ;
+    EXPECT_EQ(eval("obj.d > 1"), -1) ;
+    EXPECT_EQ(eval("obj.d[obj.i] > 1"), -1) ;
+    EXPECT_EQ(eval("trick.exec_get_freeze_time() > 1"), -1) ;
+    EXPECT_EQ(eval("obj.i + 1"), -1) ;
+}
+
+TEST_F(CompiledConditionTest, SimTime) {
+    double bound ;
+    EXPECT_EQ(eval("trick.exec_get_sim_time() >= 0.0"), 1) ;
+    EXPECT_EQ(eval("trick.exec_get_sim_time() > 0.0"), 0) ;
+
+    Trick::CompiledCondition * cond = Trick::CompiledCondition::compile("obj.b and 100.0 <= trick.exec_get_sim_time()") ;
+    ASSERT_TRUE(cond != NULL) ;
+    EXPECT_TRUE(cond->get_time_bound(bound)) ;
+    EXPECT_EQ(bound, 100.0) ;
+    delete cond ;
+
+    cond = Trick::CompiledCondition::compile("obj.b or trick.exec_get_sim_time() > 100.0") ;
+    ASSERT_TRUE(cond != NULL) ;
+    EXPECT_FALSE(cond->get_time_bound(bound)) ;
+    delete cond ;
+}
+
+TEST_F(CompiledConditionTest, DeletedAndRedeclaredVariables) {
+    int cdims[1] = { 3 } ;
+    double * dbl_p = (double *)mm.declare_var(TRICK_DOUBLE, "", 0, "cond_dbl", 1, cdims) ;
+    ASSERT_TRUE(dbl_p != NULL) ;
+    dbl_p[1] = 2.0 ;
+
+    Trick::CompiledCondition * cond = Trick::CompiledCondition::compile("cond_dbl[1] > 1.0") ;
+    ASSERT_TRUE(cond != NULL) ;
+    EXPECT_TRUE(cond->evaluate()) ;
+
+    // A deleted variable cannot be read, so the condition is false.
+    mm.delete_var("cond_dbl") ;
+    EXPECT_FALSE(cond->evaluate()) ;
+
+    // A new allocation with the same name is found again.
+    dbl_p = (double *)mm.declare_var(TRICK_DOUBLE, "", 0, "cond_dbl", 1, cdims) ;
+    ASSERT_TRUE(dbl_p != NULL) ;
+    EXPECT_FALSE(cond->evaluate()) ;
+    dbl_p[1] = 3.0 ;
+    EXPECT_TRUE(cond->evaluate()) ;
+
+    // Resizing moves the allocation.
+    dbl_p = (double *)mm.resize_array("cond_dbl", 100) ;
+    ASSERT_TRUE(dbl_p != NULL) ;
+    EXPECT_TRUE(cond->evaluate()) ;
+    dbl_p[1] = 0.0 ;
+    EXPECT_FALSE(cond->evaluate()) ;
+
+    // A variable declared again with another type is not read as the old type.
+    mm.delete_var("cond_dbl") ;
+    int * int_p = (int *)mm.declare_var(TRICK_INTEGER, "", 0, "cond_dbl", 1, cdims) ;
+    ASSERT_TRUE(int_p != NULL) ;
+    int_p[1] = 5 ;
+    EXPECT_FALSE(cond->evaluate()) ;
+    delete cond ;
+}
@@ -0,0 +1,30 @@
+/*
+PURPOSE: (Testing)
+*/
+
+#ifndef COMPILEDCONDITION_TEST_HH
+#define COMPILEDCONDITION_TEST_HH
+
+typedef enum {
+    COND_ZERO,
+    COND_ONE,
+    COND_TWO
+} COND_ENUM ;
+
+class CondTest {
+    public:
+        int i ;
+        unsigned int u ;
+        short s ;
+        bool b ;
+        bool b_false ;
+        COND_ENUM e ;
+        float f ;
+        double d[4] ;
+        double * p ;
+        long long ll ;
+        unsigned long long ull ;
+        long l ;
+} ;
+
+#endif
@@ -0,0 +1,276 @@
+// Vectorize the block loops, and never contract a multiply and an add into a fused multiply-add, so the
+// states are bit for bit those of the per-body integrators.
+#if (defined __GNUC__) && !(defined __clang__)
+#pragma GCC optimize ("tree-vectorize", "fp-contract=off")
+#elif (defined __clang__)
+#pragma clang fp contract(off)
+#endif
+
+#include "trick/BatchIntegrator.hh"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+/* The block is stepped with the inline integ_utils loops, compiled in this file, so that every build vectorizes
+   them. The vectorized steps of the er7_utils library are not used because that library is linked only when
+   er7_utils is in use. */
+#define ER7_UTILS_NO_VECTOR_STEPS
+#include "er7_utils/integration/core/include/integ_utils.hh"
+
+/* Compile the stage function for each instruction set and select one when the program is loaded. */
+#if (defined __GNUC__) && !(defined __clang__) && (__GNUC__ >= 6) && \
+    (defined __x86_64__) && (defined __linux__)
+#define BATCH_INTEGRATOR_SIMD_CLONES __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#define BATCH_INTEGRATOR_SIMD_CLONES
+#endif
+
+namespace {
+    const int max_stages = 4;
+    const int abm_order = 4;
+
+    const double rk2_weights[2] = { 1.0/2.0, 1.0/2.0 };
+    const double rk4_weights[4] = { 1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0 };
+
+    /* Adams-Bashforth predictor and Adams-Moulton corrector weights,
+       oldest derivative first and the current derivative last. */
+    const double ab4_weights[4] = { -9.0/24.0, 37.0/24.0, -59.0/24.0, 55.0/24.0 };
+    const double am4_weights[4] = { 1.0/24.0, -5.0/24.0, 19.0/24.0, 9.0/24.0 };
+}
+
+/**
+ */
+Trick::BatchIntegrator::BatchIntegrator() :
+    alg(Runge_Kutta_4), capacity(0), num_stages(0), num_hist(0), deriv_hist(NULL) {}
+
+/**
+ */
+Trick::BatchIntegrator::BatchIntegrator( Integrator_type Alg, double Dt) :
+    alg(Alg), capacity(0), num_stages(0), num_hist(0), deriv_hist(NULL) {
+
+    switch (alg) {
+        case Euler:
+            num_stages = 1;
+            break;
+        case Runge_Kutta_2:
+            num_stages = 2;
+            break;
+        case Runge_Kutta_4:
+        case ABM_Method:
+            num_stages = max_stages;
+            break;
+        default:
+            message_publish(MSG_ERROR, "BatchIntegrator ERROR: unsupported integration technique %d,"
+             " using Runge_Kutta_4.\n", (int)alg);
+            alg = Runge_Kutta_4;
+            num_stages = max_stages;
+            break;
+    }
+
+    dt = Dt;
+    deriv = INTEG_ALLOC( double*, num_stages);
+    state_ws = INTEG_ALLOC( double*, 1);
+    if (alg == ABM_Method) {
+        deriv_hist = INTEG_ALLOC( double*, abm_order);
+    }
+}
+
+/**
+ */
+Trick::BatchIntegrator::~BatchIntegrator() {
+
+    int i;
+
+    if (state) INTEG_FREE(state);
+    if (deriv) {
+        for (i = 0; i < num_stages; i++) {
+            if (deriv[i]) INTEG_FREE(deriv[i]);
+        }
+        INTEG_FREE(deriv);
+    }
+    if (state_ws) {
+        if (state_ws[0]) INTEG_FREE(state_ws[0]);
+        INTEG_FREE(state_ws);
+    }
+    if (deriv_hist) {
+        for (i = 0; i < abm_order; i++) {
+            if (deriv_hist[i]) INTEG_FREE(deriv_hist[i]);
+        }
+        INTEG_FREE(deriv_hist);
+    }
+}
+
+/**
+ */
+void Trick::BatchIntegrator::initialize( int State_size, double Dt) {
+    dt = Dt;
+    add_states(State_size);
+}
+
+/**
+ Grow the block, doubling its size so adding many bodies one at a time is cheap.
+ */
+int Trick::BatchIntegrator::add_states( int num) {
+
+    int offset = num_state;
+
+    if (num_state + num > capacity) {
+        int new_capacity = (capacity > 0) ? capacity : 64;
+        while (new_capacity < num_state + num) {
+            new_capacity *= 2;
+        }
+        allocate(new_capacity);
+    }
+    num_state += num;
+    return offset;
+}
+
+/**
+ Reallocate every state sized array, keeping the states already added.
+ */
+void Trick::BatchIntegrator::allocate( int new_capacity) {
+
+    int i;
+    double * new_array;
+
+    new_array = INTEG_ALLOC( double, new_capacity);
+    if (state) {
+        er7_utils::integ_utils::copy_array(state, num_state, new_array);
+        INTEG_FREE(state);
+    }
+    state = new_array;
+
+    for (i = 0; i < num_stages; i++) {
+        new_array = INTEG_ALLOC( double, new_capacity);
+        if (deriv[i]) {
+            er7_utils::integ_utils::copy_array(deriv[i], num_state, new_array);
+            INTEG_FREE(deriv[i]);
+        }
+        deriv[i] = new_array;
+    }
+
+    new_array = INTEG_ALLOC( double, new_capacity);
+    if (state_ws[0]) {
+        er7_utils::integ_utils::copy_array(state_ws[0], num_state, new_array);
+        INTEG_FREE(state_ws[0]);
+    }
+    state_ws[0] = new_array;
+
+    if (deriv_hist) {
+        for (i = 0; i < abm_order; i++) {
+            new_array = INTEG_ALLOC( double, new_capacity);
+            if (deriv_hist[i]) {
+                er7_utils::integ_utils::copy_array(deriv_hist[i], num_state, new_array);
+                INTEG_FREE(deriv_hist[i]);
+            }
+            deriv_hist[i] = new_array;
+        }
+    }
+
+    capacity = new_capacity;
+}
+
+/**
+ */
+void Trick::BatchIntegrator::reset() {
+    num_hist = 0;
+    intermediate_step = 0;
+}
+
+/**
+ Each case advances every state in the block by one stage. The state at the
+ start of the step is kept in state_0 and the stage result is written back
+ to state, where the next derivatives are evaluated.
+ @return the next intermediate step
+ */
+namespace {
+BATCH_INTEGRATOR_SIMD_CLONES
+int integrate_stage( Integrator_type alg, bool use_rk4, int intermediate_step, double dt, int num_state,
+ double * state, double * state_0, double ** deriv, double ** deriv_hist, int & num_hist ) {
+
+    using namespace er7_utils::integ_utils;
+
+    if (alg == Euler) {
+        inplace_euler_step(deriv[0], dt, num_state, state);
+        intermediate_step = 0;
+
+    } else if (alg == Runge_Kutta_2) {
+        switch (intermediate_step) {
+            case 0:
+                inplace_euler_step_save_state(deriv[0], dt, num_state, state_0, state);
+                intermediate_step = 1;
+                break;
+            case 1:
+                weighted_step<2>(state_0, deriv, rk2_weights, dt, num_state, state);
+                intermediate_step = 0;
+                break;
+        }
+
+    } else if (use_rk4) {
+        switch (intermediate_step) {
+            case 0:
+                /* ABM primes its derivative history with the derivatives at the start of each RK4 step. */
+                if (alg == ABM_Method) {
+                    copy_array(deriv[0], num_state, deriv_hist[num_hist]);
+                }
+                inplace_euler_step_save_state(deriv[0], dt / 2.0, num_state, state_0, state);
+                intermediate_step = 1;
+                break;
+            case 1:
+                euler_step(state_0, deriv[1], dt / 2.0, num_state, state);
+                intermediate_step = 2;
+                break;
+            case 2:
+                euler_step(state_0, deriv[2], dt, num_state, state);
+                intermediate_step = 3;
+                break;
+            case 3:
+                weighted_step<4>(state_0, deriv, rk4_weights, dt, num_state, state);
+                if (alg == ABM_Method) {
+                    num_hist++;
+                }
+                intermediate_step = 0;
+                break;
+        }
+
+    } else {
+        double * oldest;
+        switch (intermediate_step) {
+            case 0:
+                /* Predict, saving the current derivatives as the newest history entry. */
+                copy_array(state, num_state, state_0);
+                weighted_step_save_deriv<4>(state_0, deriv[0], ab4_weights, dt, num_state, deriv_hist, state);
+                oldest = deriv_hist[0];
+                deriv_hist[0] = deriv_hist[1];
+                deriv_hist[1] = deriv_hist[2];
+                deriv_hist[2] = deriv_hist[3];
+                deriv_hist[3] = oldest;
+                intermediate_step = 1;
+                break;
+            case 1:
+                /* Correct with the derivatives at the predicted state. */
+                weighted_step<4>(state_0, deriv[1], deriv_hist, am4_weights, dt, num_state, state);
+                intermediate_step = 0;
+                break;
+        }
+    }
+    return intermediate_step;
+}
+}
+
+/**
+ */
+int Trick::BatchIntegrator::integrate() {
+
+    bool use_rk4 = (alg == Runge_Kutta_4) || (alg == ABM_Method && num_hist < abm_order - 1);
+
+    if (intermediate_step == 0) {
+        time_0 = time;
+    }
+
+    intermediate_step = integrate_stage(alg, use_rk4, intermediate_step, dt, num_state, state, state_ws[0],
+     deriv, deriv_hist, num_hist);
+
+    if (intermediate_step == 0) {
+        time = time_0 + dt;
+    }
+    return intermediate_step;
+}
@@ -0,0 +1,347 @@
+
+
+// Local includes
+#include "trick/IntegJobThreads.hh"
+#include "trick/IntegLoopScheduler.hh"
+
+// Trick includes
+#include "trick/JobData.hh"
+
+// System includes
+#include <sstream>
+#include <unistd.h>
+
+
+/**
+ Constructor.
+ @param in_scheduler The scheduler whose jobs are called.
+ */
+Trick::IntegJobThreads::IntegJobThreads (
+    Trick::IntegLoopScheduler * in_scheduler)
+:
+    scheduler (in_scheduler),
+    num_threads (1),
+    partitions (1),
+    assignments (),
+    workers (),
+    workers_pid (0),
+    generation (0),
+    num_running (0),
+    shutdown (false),
+    phase (DerivPhase),
+    t_start (0.0),
+    dt (0.0),
+    ex_pass (0)
+{
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&start_cv, NULL);
+    pthread_cond_init(&done_cv, NULL);
+}
+
+/**
+ Destructor.
+ */
+Trick::IntegJobThreads::~IntegJobThreads ()
+{
+    stop_workers();
+    pthread_cond_destroy(&done_cv);
+    pthread_cond_destroy(&start_cv);
+    pthread_mutex_destroy(&mutex);
+}
+
+/**
+ Set the number of threads. Worker threads are started when jobs are next
+ called, so a process forked after this call starts its own workers.
+ @param num Number of threads, including the calling thread.
+ */
+void Trick::IntegJobThreads::set_num_threads (unsigned int num)
+{
+    if (num < 1) {
+        num = 1;
+    }
+    if (num == num_threads) {
+        return;
+    }
+
+    stop_workers();
+    num_threads = num;
+    partitions.assign(num_threads, Partition());
+    clear_assignments();
+}
+
+/**
+ Start the worker threads if this process does not have them.
+ */
+void Trick::IntegJobThreads::start_workers ()
+{
+    pid_t pid = getpid();
+
+    if (workers_pid != pid) {
+        forget_forked_workers();
+    }
+    if (! workers.empty()) {
+        return;
+    }
+
+    shutdown = false;
+    workers_pid = pid;
+    for (unsigned int ii = 1; ii < num_threads; ++ii) {
+        Worker * worker = new Worker(this, ii, generation);
+        std::ostringstream oss;
+        oss << "integ_worker_" << ii;
+        worker->set_name(oss.str());
+        worker->create_thread();
+        workers.push_back(worker);
+    }
+}
+
+/**
+ A child of fork() has none of its parent's threads. Drop the parent's
+ workers without joining them, and reset the synchronization state that
+ they may have been using when the process forked.
+ */
+void Trick::IntegJobThreads::forget_forked_workers ()
+{
+    if (workers.empty()) {
+        return;
+    }
+    for (unsigned int ii = 0; ii < workers.size(); ++ii) {
+        delete workers[ii];
+    }
+    workers.clear();
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&start_cv, NULL);
+    pthread_cond_init(&done_cv, NULL);
+    num_running = 0;
+}
+
+/**
+ Forget which thread each sim object was assigned to.
+ */
+void Trick::IntegJobThreads::clear_assignments ()
+{
+    assignments.clear();
+    for (unsigned int ii = 0; ii < partitions.size(); ++ii) {
+        partitions[ii].load = 0;
+    }
+}
+
+/**
+ Split the enabled jobs among the threads by sim object.
+ A sim object seen for the first time goes to the thread with the fewest jobs.
+ */
+void Trick::IntegJobThreads::distribute (
+    Trick::ScheduledJobQueue & deriv_queue,
+    Trick::ScheduledJobQueue & integ_queue)
+{
+    for (unsigned int ii = 0; ii < partitions.size(); ++ii) {
+        partitions[ii].deriv_jobs.clear();
+        partitions[ii].integ_jobs.clear();
+        partitions[ii].integ_order.clear();
+    }
+
+    Trick::ScheduledJobQueue * queues[2] = { &deriv_queue, &integ_queue };
+    for (unsigned int qq = 0; qq < 2; ++qq) {
+        Trick::JobData * curr_job;
+        unsigned int order = 0;
+        queues[qq]->reset_curr_index();
+        while ((curr_job = queues[qq]->get_next_job()) != NULL) {
+            unsigned int thread_index;
+            std::map<Trick::SimObject*, unsigned int>::iterator it =
+                assignments.find(curr_job->parent_object);
+            if (it != assignments.end()) {
+                thread_index = it->second;
+            } else {
+                thread_index = 0;
+                for (unsigned int ii = 1; ii < partitions.size(); ++ii) {
+                    if (partitions[ii].load < partitions[thread_index].load) {
+                        thread_index = ii;
+                    }
+                }
+                assignments[curr_job->parent_object] = thread_index;
+            }
+            Partition & part = partitions[thread_index];
+            part.load++;
+            if (qq == 0) {
+                part.deriv_jobs.push_back(curr_job);
+            } else {
+                part.integ_jobs.push_back(curr_job);
+                part.integ_order.push_back(order++);
+            }
+        }
+    }
+}
+
+/**
+ Call the distributed derivative jobs on all threads.
+ */
+void Trick::IntegJobThreads::call_deriv_jobs ()
+{
+    run_phase(DerivPhase);
+}
+
+/**
+ Call the distributed integration jobs on all threads.
+ The resulting pass number is that of the last job in queue order, which is
+ what the serial loop would see.
+ */
+int Trick::IntegJobThreads::call_integ_jobs (
+    double in_t_start, double in_dt, int in_ex_pass, int & ipass)
+{
+    t_start = in_t_start;
+    dt = in_dt;
+    ex_pass = in_ex_pass;
+
+    run_phase(IntegPhase);
+
+    int status = 0;
+    int last_order = -1;
+    ipass = 0;
+    for (unsigned int ii = 0; ii < partitions.size(); ++ii) {
+        const Partition & part = partitions[ii];
+        if (part.status != 0) {
+            status = part.status;
+        }
+        if (part.last_order > last_order) {
+            last_order = part.last_order;
+            ipass = part.ipass;
+        }
+    }
+    return status;
+}
+
+/**
+ Hand a phase to the workers, call the first partition on this thread, and
+ wait for the workers to finish.
+ */
+void Trick::IntegJobThreads::run_phase (Phase in_phase)
+{
+    phase = in_phase;
+
+    if (num_threads > 1) {
+        start_workers();
+    }
+
+    if (! workers.empty()) {
+        pthread_mutex_lock(&mutex);
+        num_running = workers.size();
+        ++generation;
+        pthread_cond_broadcast(&start_cv);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    call_partition(0);
+
+    if (! workers.empty()) {
+        pthread_mutex_lock(&mutex);
+        while (num_running != 0) {
+            pthread_cond_wait(&done_cv, &mutex);
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+/**
+ Call the jobs of one partition for the current phase.
+ @param index Partition index.
+ */
+void Trick::IntegJobThreads::call_partition (unsigned int index)
+{
+    Partition & part = partitions[index];
+
+    if (phase == DerivPhase) {
+        for (unsigned int ii = 0; ii < part.deriv_jobs.size(); ++ii) {
+            part.deriv_jobs[ii]->call();
+        }
+    } else {
+        part.status = 0;
+        part.ipass = 0;
+        part.last_order = -1;
+        for (unsigned int ii = 0; ii < part.integ_jobs.size(); ++ii) {
+            if (scheduler->call_integ_job(
+                    part.integ_jobs[ii], t_start, dt, ex_pass, part.ipass) != 0) {
+                part.status = 1;
+                break;
+            }
+            part.last_order = part.integ_order[ii];
+        }
+    }
+}
+
+/**
+ Body of a worker thread: wait for a phase, call the partition, report back.
+ @param index Partition index of this worker.
+ @param seen  Generation of the last phase this worker has handled.
+ */
+void Trick::IntegJobThreads::worker_loop (
+    unsigned int index, unsigned long long seen)
+{
+    pthread_mutex_lock(&mutex);
+    while (true) {
+        while (! shutdown && generation == seen) {
+            pthread_cond_wait(&start_cv, &mutex);
+        }
+        if (shutdown) {
+            break;
+        }
+        seen = generation;
+        pthread_mutex_unlock(&mutex);
+
+        call_partition(index);
+
+        pthread_mutex_lock(&mutex);
+        if (--num_running == 0) {
+            pthread_cond_signal(&done_cv);
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+/**
+ Stop and join the worker threads.
+ */
+void Trick::IntegJobThreads::stop_workers ()
+{
+    if (workers.empty()) {
+        return;
+    }
+
+    if (workers_pid != getpid()) {
+        forget_forked_workers();
+        return;
+    }
+
+    pthread_mutex_lock(&mutex);
+    shutdown = true;
+    pthread_cond_broadcast(&start_cv);
+    pthread_mutex_unlock(&mutex);
+
+    for (unsigned int ii = 0; ii < workers.size(); ++ii) {
+        pthread_join(workers[ii]->get_pthread_id(), NULL);
+        delete workers[ii];
+    }
+    workers.clear();
+}
+
+/**
+ Worker constructor.
+ */
+Trick::IntegJobThreads::Worker::Worker (
+    IntegJobThreads * in_owner, unsigned int in_index,
+    unsigned long long in_generation)
+:
+    Trick::ThreadBase (),
+    owner (in_owner),
+    index (in_index),
+    generation (in_generation)
+{
+}
+
+/**
+ Worker thread body.
+ */
+void * Trick::IntegJobThreads::Worker::thread_body ()
+{
+    owner->worker_loop(index, generation);
+    return NULL;
+}
@@ -5,6 +5,7 @@
 
 #include "trick/IntegLoopManager.hh"
 #include "trick/IntegJobClassId.hh"
+#include "trick/IntegJobThreads.hh"
 
 // Trick includes
 #include "trick/exec_proto.h"
@@ -15,6 +16,7 @@
 // System includes
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <cstdarg>
 #include <math.h>
 
@@ -44,9 +46,9 @@ namespace {
 Trick::IntegrationManager Trick::IntegLoopScheduler::manager;
 
 /**
- The Integrator currently being processed.
+ The Integrator currently being processed by this thread.
  */
-Trick::Integrator* trick_curr_integ = NULL;
+__thread Trick::Integrator* trick_curr_integ = NULL;
 
 /**
  Non-default constructor.
@@ -67,6 +69,21 @@ Trick::IntegLoopScheduler::IntegLoopScheduler(
     nominal_cycle (in_cycle),
     next_cycle (in_cycle),
     parent_sim_object (in_parent_so),
+    num_threads (1),
+    job_threads (NULL),
+    dense_events (false),
+    adaptive_step (false),
+    adaptive_abs_tol (1.0e-8),
+    adaptive_rel_tol (1.0e-8),
+    min_substep (0.0),
+    substep (0.0),
+    accepted_substeps (0),
+    rejected_substeps (0),
+    rate_outputs (),
+    rate_times (),
+    rate_values (),
+    rate_history_span (0.0),
+    rate_inputs (),
     pre_integ_jobs (),
     deriv_jobs (),
     integ_jobs (),
@@ -92,6 +109,21 @@ Trick::IntegLoopScheduler::IntegLoopScheduler()
     nominal_cycle (),
     next_cycle (),
     parent_sim_object (NULL),
+    num_threads (1),
+    job_threads (NULL),
+    dense_events (false),
+    adaptive_step (false),
+    adaptive_abs_tol (1.0e-8),
+    adaptive_rel_tol (1.0e-8),
+    min_substep (0.0),
+    substep (0.0),
+    accepted_substeps (0),
+    rejected_substeps (0),
+    rate_outputs (),
+    rate_times (),
+    rate_values (),
+    rate_history_span (0.0),
+    rate_inputs (),
     pre_integ_jobs (),
     deriv_jobs (),
     integ_jobs (),
@@ -101,6 +133,14 @@ Trick::IntegLoopScheduler::IntegLoopScheduler()
     complete_construction();
 }
 
+/**
+ Destructor. Stops the worker threads, if any.
+ */
+Trick::IntegLoopScheduler::~IntegLoopScheduler()
+{
+    delete job_threads;
+}
+
 /**
  Complete the construction of an integration loop.
  All constructors but the copy constructor call this method.
@@ -175,6 +215,10 @@ int Trick::IntegLoopScheduler::add_integ_jobs_from_sim_object (
         }
     }
 
+    if (job_threads != NULL) {
+        job_threads->clear_assignments();
+    }
+
     return 0;
 
 }
@@ -256,6 +300,8 @@ int Trick::IntegLoopScheduler::remove_sim_object(Trick::SimObject & sim_obj)
 void Trick::IntegLoopScheduler::restart_checkpoint()
 {
     manager.clear_sim_object_info();
+    rate_times.clear();
+    rate_values.clear();
 }
 
 /**
@@ -297,6 +343,29 @@ void Trick::IntegLoopScheduler::rebuild_jobs ()
                 job_class_name, job_class_id, sim_object, queue);
         }
     }
+
+    // Reassign sim objects to threads. num_threads may have been restored
+    // from a checkpoint, so bring the worker threads in line with it too.
+    if ((num_threads > 1) || (job_threads != NULL)) {
+        set_num_threads (num_threads);
+        job_threads->clear_assignments();
+    }
+}
+
+/**
+ Set the number of threads used to call the derivative and integration jobs.
+ @param num Number of threads, including the thread that calls integ_loop.
+ */
+int Trick::IntegLoopScheduler::set_num_threads (unsigned int num)
+{
+    num_threads = (num < 1) ? 1 : num;
+    if ((job_threads == NULL) && (num_threads > 1)) {
+        job_threads = new Trick::IntegJobThreads (this);
+    }
+    if (job_threads != NULL) {
+        job_threads->set_num_threads (num_threads);
+    }
+    return 0;
 }
 
 /**
@@ -335,33 +404,57 @@ int Trick::IntegLoopScheduler::integrate()
     double t_start = t_end - next_cycle; // This is the time of the current state vector.
     int status;
 
+    // Start the history read by slower loops with the states at the start.
+    if (rate_times.empty()) {
+        record_rate_outputs (t_start);
+    }
+    save_rate_inputs ();
+
     // Call all of the jobs in the pre-integration job queue.
     call_jobs (pre_integ_jobs);
 
-    // Integrate sim objects to the current time.
-    status = integrate_dt (t_start, next_cycle);
-    if (status != 0) {
-        return status;
-    }
+    // Capture the steps for adaptive stepping, or for dense output if events
+    // are located on it. Both need derivatives at the start of each step.
+    bool adaptive = adaptive_step && have_error_estimates ();
+    bool dense = (adaptive || (dense_events && (! dynamic_event_jobs.empty()))) &&
+                 get_first_step_deriv_from_integrator() &&
+                 set_dense_mode (Dense_Capture);
 
-    // Process dynamic events, if any.
-    if (! dynamic_event_jobs.empty()) {
+    if (adaptive && dense) {
+        // Integrate sim objects to the current time in substeps.
+        status = integrate_adaptive (t_start, t_end);
 
-        status = process_dynamic_events (t_start, t_end);
+    } else {
+        // Integrate sim objects to the current time.
+        status = integrate_dt (t_start, next_cycle);
 
-        if (status != 0) {
-            return status;
+        // Process dynamic events, if any.
+        if ((status == 0) && (! dynamic_event_jobs.empty())) {
+            status = process_dynamic_events (t_start, t_end);
         }
     }
 
+    if (dense) {
+        set_dense_mode (Dense_Off);
+    }
+    if (status != 0) {
+        restore_rate_inputs ();
+        return status;
+    }
+
     // Call the jobs in the derivative job queue one more time if indicated.
     if (get_last_step_deriv()) {
+         set_rate_inputs (t_end);
          call_jobs (deriv_jobs);
     }
+    restore_rate_inputs ();
 
     // Call all of the jobs in the post-integration job queue.
     call_jobs (post_integ_jobs);
 
+    // Record the states read by slower loops.
+    record_rate_outputs (t_end);
+
     // We should now be back in sync with the nominal cycle rate.
     next_cycle = nominal_cycle;
 
@@ -435,82 +528,129 @@ bool Trick::IntegLoopScheduler::get_last_step_deriv()
     return false;
 }
 
+/**
+ Call one integration job for one intermediate pass.
+ This is called concurrently for jobs of different sim objects when the loop
+ uses more than one thread; trick_curr_integ is thread local for that reason.
+ */
+int Trick::IntegLoopScheduler::call_integ_job (
+    Trick::JobData * curr_job, double t_start, double dt, int ex_pass, int & ipass)
+{
+    void* sup_class_data = curr_job->sup_class_data;
+    // Jobs without supplemental data use the default integrator.
+    if (sup_class_data == NULL) {
+        trick_curr_integ = integ_ptr;
+    }
+    // Non-null supplemental data:
+    // Resolve as a pointer-to-a-pointer to a Trick::Integrator.
+    else {
+        trick_curr_integ =
+            *(static_cast<Trick::Integrator**>(sup_class_data));
+    }
+
+
+    if (trick_curr_integ == NULL) {
+        message_publish (
+            MSG_ERROR,
+            "Integ Scheduler ERROR: "
+            "Integrate job has no associated Integrator.\n");
+        return 1;
+    }
+
+    if (ex_pass == 1) {
+        trick_curr_integ->time = t_start;
+        trick_curr_integ->dt   = dt;
+    }
+
+    if (verbosity || trick_curr_integ->verbosity) {
+        message_publish (MSG_DEBUG, "Job: %s, time: %f, dt: %f\n",
+                         curr_job->name.c_str(), t_start, dt);
+    }
+
+    ipass = curr_job->call();
+
+    // Trick integrators are expected to advance from step one to step
+    // two, etc., and then back to zero to indicate completion.
+    // All integrators are expected to march to the same beat.
+    // FIXME, future: This restricts Trick to using only rather
+    // simple integration techniques.
+    if ((ipass != 0) && (ipass != ex_pass)) {
+        message_publish (
+            MSG_ERROR,
+            "Integ Scheduler ERROR: Integrators not in sync.\n");
+        return 1;
+    }
+
+    return 0;
+}
+
 /**
  Integrate over the specified time interval.
+ With more than one thread, each pass calls the derivative jobs of all sim
+ objects in parallel, waits for them, and then does the same with the
+ integration jobs.
  */
 int Trick::IntegLoopScheduler::integrate_dt ( double t_start, double dt) {
 
     int ipass = 0;
     int ex_pass = 0;
+    double deriv_time = t_start;
     bool need_derivs = get_first_step_deriv_from_integrator();
+    bool parallel = (job_threads != NULL) && (job_threads->get_num_threads() > 1);
+
+    if (parallel) {
+        job_threads->distribute (deriv_jobs, integ_jobs);
+    }
 
     do {
         ex_pass ++;
         // Call all of the jobs in the derivative job queue if needed.
         if (need_derivs) {
-             call_jobs (deriv_jobs);
+            set_rate_inputs (deriv_time);
+            if (parallel) {
+                job_threads->call_deriv_jobs();
+            } else {
+                call_jobs (deriv_jobs);
+            }
         }
         need_derivs = true;
 
         // Call all of the jobs in the integration job queue.
-        Trick::JobData * curr_job;
-        integ_jobs.reset_curr_index();
-        while ((curr_job = integ_jobs.get_next_job()) != NULL) {
-
-
-            void* sup_class_data = curr_job->sup_class_data;
-            // Jobs without supplemental data use the default integrator.
-            if (sup_class_data == NULL) {
-                trick_curr_integ = integ_ptr;
-            }
-            // Non-null supplemental data:
-            // Resolve as a pointer-to-a-pointer to a Trick::Integrator.
-            else {
-                trick_curr_integ =
-                    *(static_cast<Trick::Integrator**>(sup_class_data));
-            }
-
-
-            if (trick_curr_integ == NULL) {
-                message_publish (
-                    MSG_ERROR,
-                    "Integ Scheduler ERROR: "
-                    "Integrate job has no associated Integrator.\n");
+        if (parallel) {
+            if (job_threads->call_integ_jobs (t_start, dt, ex_pass, ipass) != 0) {
                 return 1;
             }
-
-            if (ex_pass == 1) {
-                trick_curr_integ->time = t_start;
-                trick_curr_integ->dt   = dt;
-            }
-
-            if (verbosity || trick_curr_integ->verbosity) {
-                message_publish (MSG_DEBUG, "Job: %s, time: %f, dt: %f\n",
-                                 curr_job->name.c_str(), t_start, dt);
+        } else {
+            Trick::JobData * curr_job;
+            integ_jobs.reset_curr_index();
+            while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+                if (call_integ_job (curr_job, t_start, dt, ex_pass, ipass) != 0) {
+                    return 1;
+                }
             }
+        }
 
-            ipass = curr_job->call();
-
-            // Trick integrators are expected to advance from step one to step
-            // two, etc., and then back to zero to indicate completion.
-            // All integrators are expected to march to the same beat.
-            // FIXME, future: This restricts Trick to using only rather
-            // simple integration techniques.
-            if ((ipass != 0) && (ipass != ex_pass)) {
-                message_publish (
-                    MSG_ERROR,
-                    "Integ Scheduler ERROR: Integrators not in sync.\n");
-                return 1;
-            }
+        // Rate inputs are interpolated at the time of the next pass.
+        if (! rate_inputs.empty()) {
+            deriv_time = get_deriv_time (t_start + dt);
         }
     } while (ipass);
 
     return 0;
 }
 
+/**
+ Process dynamic events.
+ When the step was captured for dense output, the search for an event sets the
+ states to the interpolant at each estimate of the event time. Once an event
+ has fired the interpolant no longer describes the trajectory, so later events
+ in the same interval are found by integrating to each estimate.
+ */
 int Trick::IntegLoopScheduler::process_dynamic_events ( double t_start, double t_end, unsigned int depth) {
 
     bool fired = false;
+    bool dense = dense_events && dense_step_captured (t_start, false);
+    bool end_derivs = false;
     double t_to = t_end;
     double t_from = t_start;
     Trick::JobData * curr_job;
@@ -520,8 +660,20 @@ int Trick::IntegLoopScheduler::process_dynamic_events ( double t_start, double t
         double tgo = curr_job->call_double();
        if (tgo < 0.0) {   // If there is a root in this interval ...
             fired = true;
+            // The interpolant also needs the derivatives at the end of the step,
+            // where the states still are.
+            if (dense && ! end_derivs) {
+                set_rate_inputs (t_end);
+                call_jobs (deriv_jobs);
+                if (call_dense_pass (Dense_End_Deriv, t_end) != 0) { return 1; }
+                end_derivs = true;
+                dense = dense_step_captured (t_start, true);
+            }
             while (tgo != 0.0) {
-                if (tgo > 0.0) {
+                if (dense) {
+                    t_to = std::min (std::max (t_to + tgo, t_start), t_end);
+                    if (call_dense_pass (Dense_Evaluate, t_to) != 0) { return 1; }
+                } else if (tgo > 0.0) {
                     t_from = t_to;
                     t_to = t_to + tgo;
                     int status = integrate_dt( t_from, (t_to-t_from));
@@ -540,6 +692,7 @@ int Trick::IntegLoopScheduler::process_dynamic_events ( double t_start, double t
                 }
                 tgo = curr_job->call_double();
             }
+            dense = false;
         }
     }
     /*
@@ -554,13 +707,374 @@ int Trick::IntegLoopScheduler::process_dynamic_events ( double t_start, double t
         */
         int status = integrate_dt( t_from, (t_to-t_from));
         if (status != 0) { return status; }
-        status = process_dynamic_events(t_from, t_to, depth+1);
-        if (status != 0) { return status; }
+        return process_dynamic_events(t_from, t_to, depth+1);
     } else {
         return 0;
     }
 }
 
+/**
+ Collect the integrators used by the enabled integration jobs.
+ */
+void Trick::IntegLoopScheduler::get_integrators (IntegratorVector & integrators)
+{
+    Trick::JobData * curr_job;
+
+    integrators.clear();
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        Trick::Integrator * integ = integ_ptr;
+        if (curr_job->sup_class_data != NULL) {
+            integ = *(static_cast<Trick::Integrator**>(curr_job->sup_class_data));
+        }
+        if ((integ != NULL) &&
+            (std::find (integrators.begin(), integrators.end(), integ) == integrators.end())) {
+            integrators.push_back (integ);
+        }
+    }
+}
+
+/**
+ Set the dense output mode of every integrator of the loop.
+ */
+bool Trick::IntegLoopScheduler::set_dense_mode (Dense_Output_Mode mode, double time)
+{
+    IntegratorVector integrators;
+    get_integrators (integrators);
+
+    if (mode != Dense_Off) {
+        for (unsigned int ii = 0; ii < integrators.size(); ii++) {
+            if (! integrators[ii]->has_dense_output()) {
+                if (verbosity) {
+                    message_publish (MSG_DEBUG, "Integ Scheduler: an integrator has no dense output,"
+                                     " dynamic events are located by integration.\n");
+                }
+                return false;
+            }
+        }
+    }
+    for (unsigned int ii = 0; ii < integrators.size(); ii++) {
+        integrators[ii]->dense_time = time;
+        integrators[ii]->set_dense_mode (mode);
+    }
+    return true;
+}
+
+/**
+ A step is captured when every integrator saw it start at t_start and
+ complete, through the C interface integrate functions.
+ */
+bool Trick::IntegLoopScheduler::dense_step_captured (double t_start, bool end_derivs)
+{
+    IntegratorVector integrators;
+    get_integrators (integrators);
+
+    if (integrators.empty()) {
+        return false;
+    }
+    for (unsigned int ii = 0; ii < integrators.size(); ii++) {
+        Trick::Integrator * integ = integrators[ii];
+        if ((integ->dense_mode != Dense_Capture) || ! integ->dense_captured ||
+            (integ->dense_t0 != t_start) || (end_derivs && ! integ->dense_valid)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Adaptive stepping needs an error estimate from every integrator. Without one
+ the loop warns once and goes back to stepping at the integration cycle.
+ */
+bool Trick::IntegLoopScheduler::have_error_estimates ()
+{
+    IntegratorVector integrators;
+    get_integrators (integrators);
+
+    for (unsigned int ii = 0; ii < integrators.size(); ii++) {
+        if (! integrators[ii]->has_dense_output() || ! integrators[ii]->has_error_estimate()) {
+            message_publish (MSG_WARNING, "Integ Scheduler: an integrator has no error estimate,"
+                             " adaptive stepping is disabled.\n");
+            adaptive_step = false;
+            return false;
+        }
+    }
+    return ! integrators.empty();
+}
+
+/**
+ Integrate the cycle in substeps sized by the standard step size controller,
+ h_new = 0.9 * h * err^(-1/(p+1)), with the change limited to a factor of five
+ either way, where p is the order of the lower order solution of the embedded
+ pair. A rejected substep is undone by restoring the captured start state.
+ */
+int Trick::IntegLoopScheduler::integrate_adaptive (double t_start, double t_end)
+{
+    IntegratorVector integrators;
+    double cycle = t_end - t_start;
+    double h_min = (min_substep > 0.0) ? min_substep : cycle * 1.0e-6;
+    double h = (substep > 0.0) ? std::min (substep, cycle) : cycle;
+    double t = t_start;
+    int order = 0;
+    int status;
+
+    get_integrators (integrators);
+    for (unsigned int ii = 0; ii < integrators.size(); ii++) {
+        int integ_order;
+        integrators[ii]->get_error_weights (integ_order);
+        order = (ii == 0) ? integ_order : std::min (order, integ_order);
+    }
+
+    while (t < t_end) {
+        // Shorten the substep to end on the cycle boundary.
+        double remaining = t_end - t;
+        bool last = (h >= remaining - 0.5 * h_min);
+        double h_try = last ? remaining : h;
+
+        status = integrate_dt (t, h_try);
+        if (status != 0) {
+            return status;
+        }
+
+        double err = 0.0;
+        for (unsigned int ii = 0; ii < integrators.size(); ii++) {
+            err = std::max (err, integrators[ii]->get_error_norm (adaptive_abs_tol, adaptive_rel_tol));
+        }
+        double factor = (err > 0.0) ? 0.9 * pow (err, -1.0 / (order + 1)) : 5.0;
+        factor = std::min (std::max (factor, 0.2), 5.0);
+
+        if ((err <= 1.0) || (h_try <= h_min)) {
+            accepted_substeps++;
+            if (! dynamic_event_jobs.empty()) {
+                status = process_dynamic_events (t, t + h_try);
+                if (status != 0) {
+                    return status;
+                }
+            }
+            t = last ? t_end : t + h_try;
+            // A substep shortened to meet the boundary does not limit the next one.
+            h = last ? std::max (h, h_try * factor) : h_try * factor;
+        } else {
+            rejected_substeps++;
+            if (call_dense_pass (Dense_Restore, t) != 0) {
+                return 1;
+            }
+            h = h_try * factor;
+        }
+        h = std::min (std::max (h, h_min), cycle);
+    }
+
+    substep = h;
+    return 0;
+}
+
+/**
+ Add a variable read from another loop. The source loop keeps enough history
+ to cover two cycles of its slowest reader.
+ */
+int Trick::IntegLoopScheduler::add_rate_input (
+    double * var, Trick::IntegLoopScheduler & source)
+{
+    if (&source == this) {
+        message_publish (
+            MSG_ERROR,
+            "Integ Scheduler ERROR: "
+            "A loop cannot read its own states as rate inputs.\n");
+        return 1;
+    }
+    for (RateInputVector::iterator it = rate_inputs.begin();
+         it != rate_inputs.end();
+         ++it) {
+        if (it->var == var) {
+            message_publish (
+                MSG_ERROR,
+                "Integ Scheduler ERROR: "
+                "Variable is already a rate input of this loop.\n");
+            return 1;
+        }
+    }
+
+    RateInput input;
+    input.var = var;
+    input.source = &source;
+    input.index = source.add_rate_output (var);
+    input.saved = *var;
+    rate_inputs.push_back (input);
+
+    source.rate_history_span = std::max (source.rate_history_span, 2.0 * nominal_cycle);
+    return 0;
+}
+
+/**
+ Remove a variable read from another loop. The source loop keeps recording it.
+ */
+int Trick::IntegLoopScheduler::remove_rate_input (double * var)
+{
+    for (RateInputVector::iterator it = rate_inputs.begin();
+         it != rate_inputs.end();
+         ++it) {
+        if (it->var == var) {
+            rate_inputs.erase (it);
+            return 0;
+        }
+    }
+    message_publish (
+        MSG_ERROR,
+        "Integ Scheduler ERROR: Variable is not a rate input of this loop.\n");
+    return 1;
+}
+
+/**
+ Find or add a variable that other loops read. The rows of the history change
+ size when a variable is added, so the history starts over.
+ */
+unsigned int Trick::IntegLoopScheduler::add_rate_output (double * var)
+{
+    std::vector<double *>::iterator found =
+        std::find (rate_outputs.begin(), rate_outputs.end(), var);
+    if (found != rate_outputs.end()) {
+        return found - rate_outputs.begin();
+    }
+    rate_outputs.push_back (var);
+    rate_times.clear();
+    rate_values.clear();
+    return rate_outputs.size() - 1;
+}
+
+/**
+ Append the rate outputs to the history. A time at or before the latest
+ record, as after a checkpoint restart, replaces the records from that time on.
+ Records older than the readers need are dropped, keeping enough before the
+ span for the interpolant.
+ */
+void Trick::IntegLoopScheduler::record_rate_outputs (double time)
+{
+    size_t stride = rate_outputs.size();
+    if (stride == 0) {
+        return;
+    }
+
+    while ((! rate_times.empty()) && (rate_times.back() >= time)) {
+        rate_times.pop_back();
+        rate_values.erase (rate_values.end() - stride, rate_values.end());
+    }
+
+    rate_times.push_back (time);
+    for (size_t ii = 0; ii < stride; ii++) {
+        rate_values.push_back (*rate_outputs[ii]);
+    }
+
+    while ((rate_times.size() > 4) && (rate_times[2] < time - rate_history_span)) {
+        rate_times.pop_front();
+        rate_values.erase (rate_values.begin(), rate_values.begin() + stride);
+    }
+}
+
+/**
+ Evaluate the Lagrange polynomial through up to four records around the
+ requested time, two on either side where the history allows. Past either end
+ of the history this extrapolates from the nearest four records.
+ */
+bool Trick::IntegLoopScheduler::get_rate_output (
+    unsigned int index, double time, double & value)
+{
+    size_t num_times = rate_times.size();
+    if (num_times == 0) {
+        return false;
+    }
+
+    size_t stride = rate_outputs.size();
+    size_t num_points = std::min (num_times, (size_t)4);
+    size_t upper = std::upper_bound (rate_times.begin(), rate_times.end(), time) -
+                   rate_times.begin();
+    size_t first = std::min ((upper > 2) ? upper - 2 : 0, num_times - num_points);
+
+    double sum = 0.0;
+    for (size_t ii = first; ii < first + num_points; ii++) {
+        double weight = 1.0;
+        for (size_t jj = first; jj < first + num_points; jj++) {
+            if (jj != ii) {
+                weight *= (time - rate_times[jj]) / (rate_times[ii] - rate_times[jj]);
+            }
+        }
+        sum += weight * rate_values[ii * stride + index];
+    }
+    value = sum;
+    return true;
+}
+
+/**
+ Set each rate input to its source's history at the given time. Inputs whose
+ source has recorded nothing yet keep their value.
+ */
+void Trick::IntegLoopScheduler::set_rate_inputs (double time)
+{
+    for (RateInputVector::iterator it = rate_inputs.begin();
+         it != rate_inputs.end();
+         ++it) {
+        it->source->get_rate_output (it->index, time, *(it->var));
+    }
+}
+
+/**
+ Save the values of the rate inputs before a cycle.
+ */
+void Trick::IntegLoopScheduler::save_rate_inputs ()
+{
+    for (RateInputVector::iterator it = rate_inputs.begin();
+         it != rate_inputs.end();
+         ++it) {
+        it->saved = *(it->var);
+    }
+}
+
+/**
+ Give the rate inputs back their values from before the cycle, which belong
+ to the source loops.
+ */
+void Trick::IntegLoopScheduler::restore_rate_inputs ()
+{
+    for (RateInputVector::iterator it = rate_inputs.begin();
+         it != rate_inputs.end();
+         ++it) {
+        *(it->var) = it->saved;
+    }
+}
+
+/**
+ Get the time of the next derivative pass from the first integrator.
+ */
+double Trick::IntegLoopScheduler::get_deriv_time (double t_default)
+{
+    IntegratorVector integrators;
+    get_integrators (integrators);
+    return integrators.empty() ? t_default : integrators[0]->time;
+}
+
+/**
+ Call the integration jobs once in a dense output mode. The jobs load and
+ unload their states as usual; the integrators either record the derivatives
+ or replace the states with the interpolant. Integrator time and time step are
+ left alone, so ex_pass is zero.
+ */
+int Trick::IntegLoopScheduler::call_dense_pass (Dense_Output_Mode mode, double time)
+{
+    Trick::JobData * curr_job;
+    int ipass = 0;
+    int status = 0;
+
+    set_dense_mode (mode, time);
+    integ_jobs.reset_curr_index();
+    while ((curr_job = integ_jobs.get_next_job()) != NULL) {
+        if (call_integ_job (curr_job, time, 0.0, 0, ipass) != 0) {
+            status = 1;
+            break;
+        }
+    }
+    set_dense_mode (Dense_Capture);
+    return status;
+}
+
 /**
  Utility function to get an integrator.
  @param alg The integration algorithm to use.
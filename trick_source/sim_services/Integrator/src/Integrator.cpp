@@ -1,8 +1,10 @@
 #include "trick/Integrator.hh"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
+#include <algorithm>
 #include <cstdarg>
 #include <iostream>
+#include <math.h>
 
 /**
  */
@@ -25,6 +27,28 @@ Trick::Integrator::Integrator() {
    time = 0.0;
    time_0 = 0.0;
    verbosity = 0 ;
+   dense_mode = Dense_Off;
+   dense_time = 0.0;
+   dense_t0 = 0.0;
+   dense_t1 = 0.0;
+   dense_captured = false;
+   dense_valid = false;
+   dense_y0 = NULL;
+   dense_f0 = NULL;
+   dense_y1 = NULL;
+   dense_f1 = NULL;
+   dense_err = NULL;
+   dense_size = 0;
+}
+
+/**
+ */
+Trick::Integrator::~Integrator() {
+   delete [] dense_y0;
+   delete [] dense_f0;
+   delete [] dense_y1;
+   delete [] dense_f1;
+   delete [] dense_err;
 }
 
 /**
@@ -228,3 +252,275 @@ void Trick::Integrator::set_last_step_deriv(bool last_step) {
 void Trick::Integrator::set_verbosity(int level) {
     verbosity = level;
 }
+
+bool Trick::Integrator::has_dense_output() {
+    return (!use_deriv2 && (num_state > 0));
+}
+
+/**
+ Set what the C interface integrate functions do. The captured step survives
+ mode changes so that it can be evaluated between capture passes.
+ */
+void Trick::Integrator::set_dense_mode(Dense_Output_Mode mode) {
+
+    if ((mode != Dense_Off) && (dense_size != num_state)) {
+        delete [] dense_y0;
+        delete [] dense_f0;
+        delete [] dense_y1;
+        delete [] dense_f1;
+        delete [] dense_err;
+        dense_y0 = new double[num_state];
+        dense_f0 = new double[num_state];
+        dense_y1 = new double[num_state];
+        dense_f1 = new double[num_state];
+        dense_err = new double[num_state];
+        dense_size = num_state;
+        dense_captured = false;
+        dense_valid = false;
+    }
+    dense_mode = mode;
+}
+
+void Trick::Integrator::dense_capture_start(double const * y, double const * f) {
+    for (int ii = 0; ii < num_state; ++ii) {
+        dense_y0[ii] = y[ii];
+        dense_f0[ii] = f[ii];
+    }
+    dense_t0 = time;
+    dense_captured = false;
+    dense_valid = false;
+    for (int ii = 0; ii < num_state; ++ii) {
+        dense_err[ii] = 0.0;
+    }
+}
+
+/**
+ Add the derivatives of the current intermediate step to the error estimate.
+ f2, if not NULL, holds the second half of the derivatives.
+ */
+void Trick::Integrator::dense_capture_stage(double const * f, double const * f2) {
+
+    int order;
+    const double * weights = get_error_weights(order);
+
+    if ((weights == NULL) || (weights[intermediate_step] == 0.0)) {
+        return;
+    }
+    double weight = weights[intermediate_step];
+    if (f2 == NULL) {
+        for (int ii = 0; ii < num_state; ++ii) {
+            dense_err[ii] += weight * f[ii];
+        }
+    } else {
+        int half_size = num_state / 2;
+        for (int ii = 0; ii < half_size; ++ii) {
+            dense_err[ii] += weight * f[ii];
+            dense_err[ii+half_size] += weight * f2[ii];
+        }
+    }
+}
+
+void Trick::Integrator::dense_capture_end(double const * y) {
+    for (int ii = 0; ii < num_state; ++ii) {
+        dense_y1[ii] = y[ii];
+    }
+    dense_t1 = dense_t0 + dt;
+    dense_captured = true;
+}
+
+const double * Trick::Integrator::get_error_weights(int & order) {
+    order = 0;
+    return NULL;
+}
+
+bool Trick::Integrator::has_error_estimate() {
+    int order;
+    return (get_error_weights(order) != NULL);
+}
+
+double Trick::Integrator::get_error_norm(double abs_tol, double rel_tol) {
+
+    double norm = 0.0;
+    double h = dense_t1 - dense_t0;
+
+    if (! dense_captured || ! has_error_estimate()) {
+        return 0.0;
+    }
+    for (int ii = 0; ii < num_state; ++ii) {
+        double scale = abs_tol + rel_tol * std::max(fabs(dense_y0[ii]), fabs(dense_y1[ii]));
+        double ratio = fabs(dense_err[ii] * h);
+        if (scale > 0.0) {
+            ratio /= scale;
+        }
+        norm = std::max(norm, ratio);
+    }
+    return norm;
+}
+
+/**
+ Cubic Hermite interpolation between the captured end points.
+ */
+void Trick::Integrator::dense_output(double t, double * y) {
+
+    double h = dense_t1 - dense_t0;
+    double theta = (h != 0.0) ? (t - dense_t0) / h : 1.0;
+    double theta2 = theta * theta;
+    double theta3 = theta2 * theta;
+    double h00 = 2.0 * theta3 - 3.0 * theta2 + 1.0;
+    double h10 = (theta3 - 2.0 * theta2 + theta) * h;
+    double h01 = 3.0 * theta2 - 2.0 * theta3;
+    double h11 = (theta3 - theta2) * h;
+
+    for (int ii = 0; ii < num_state; ++ii) {
+        y[ii] = h00 * dense_y0[ii] + h10 * dense_f0[ii] + h01 * dense_y1[ii] + h11 * dense_f1[ii];
+    }
+}
+
+/**
+ The integrate() call of the C interface while dense_mode is not Dense_Off.
+ The state and derivatives have been loaded by load_state and load_deriv, and
+ state_ws[intermediate_step] is what unload_state copies back out.
+ */
+int Trick::Integrator::dense_integrate() {
+
+    int ipass;
+
+    switch (dense_mode) {
+        case Dense_Capture:
+            if (intermediate_step == 0) {
+                dense_capture_start(state, deriv[0]);
+            }
+            dense_capture_stage(deriv[intermediate_step], NULL);
+            ipass = integrate();
+            if (ipass == 0) {
+                dense_capture_end(state_ws[0]);
+            }
+            return ipass;
+
+        case Dense_End_Deriv:
+            for (int ii = 0; ii < num_state; ++ii) {
+                dense_f1[ii] = deriv[0][ii];
+                state_ws[0][ii] = state[ii];
+            }
+            dense_valid = dense_captured;
+            return 0;
+
+        case Dense_Evaluate:
+            dense_output(dense_time, state_ws[0]);
+            time = dense_time;
+            return 0;
+
+        case Dense_Restore:
+            for (int ii = 0; ii < num_state; ++ii) {
+                state_ws[0][ii] = dense_y0[ii];
+            }
+            time = dense_t0;
+            return 0;
+
+        default:
+            return integrate();
+    }
+}
+
+int Trick::Integrator::dense_integrate_1st_order_ode (
+    double const* derivs_in, double* state_in_out) {
+
+    int ipass;
+
+    switch (dense_mode) {
+        case Dense_Capture:
+            if (intermediate_step == 0) {
+                dense_capture_start(state_in_out, derivs_in);
+            }
+            dense_capture_stage(derivs_in, NULL);
+            ipass = integrate_1st_order_ode(derivs_in, state_in_out);
+            if (ipass == 0) {
+                dense_capture_end(state_in_out);
+            }
+            return ipass;
+
+        case Dense_End_Deriv:
+            for (int ii = 0; ii < num_state; ++ii) {
+                dense_f1[ii] = derivs_in[ii];
+            }
+            dense_valid = dense_captured;
+            return 0;
+
+        case Dense_Evaluate:
+            dense_output(dense_time, state_in_out);
+            time = dense_time;
+            return 0;
+
+        case Dense_Restore:
+            for (int ii = 0; ii < num_state; ++ii) {
+                state_in_out[ii] = dense_y0[ii];
+            }
+            time = dense_t0;
+            return 0;
+
+        default:
+            return integrate_1st_order_ode(derivs_in, state_in_out);
+    }
+}
+
+/**
+ Second order problems are handled as the first order problem whose state is
+ the positions followed by the velocities.
+ */
+int Trick::Integrator::dense_integrate_2nd_order_ode (
+    double const* accel, double* velocity, double* position) {
+
+    int half_size = num_state / 2;
+    int ipass;
+
+    switch (dense_mode) {
+        case Dense_Capture:
+            if (intermediate_step == 0) {
+                for (int ii = 0; ii < half_size; ++ii) {
+                    dense_y0[ii] = position[ii];
+                    dense_y0[ii+half_size] = velocity[ii];
+                    dense_f0[ii] = velocity[ii];
+                    dense_f0[ii+half_size] = accel[ii];
+                }
+                dense_capture_start(dense_y0, dense_f0);
+            }
+            dense_capture_stage(velocity, accel);
+            ipass = integrate_2nd_order_ode(accel, velocity, position);
+            if (ipass == 0) {
+                for (int ii = 0; ii < half_size; ++ii) {
+                    dense_y1[ii] = position[ii];
+                    dense_y1[ii+half_size] = velocity[ii];
+                }
+                dense_capture_end(dense_y1);
+            }
+            return ipass;
+
+        case Dense_End_Deriv:
+            for (int ii = 0; ii < half_size; ++ii) {
+                dense_f1[ii] = velocity[ii];
+                dense_f1[ii+half_size] = accel[ii];
+            }
+            dense_valid = dense_captured;
+            return 0;
+
+        case Dense_Evaluate:
+            dense_output(dense_time, state);
+            for (int ii = 0; ii < half_size; ++ii) {
+                position[ii] = state[ii];
+                velocity[ii] = state[ii+half_size];
+            }
+            time = dense_time;
+            return 0;
+
+        case Dense_Restore:
+            for (int ii = 0; ii < half_size; ++ii) {
+                position[ii] = dense_y0[ii];
+                velocity[ii] = dense_y0[ii+half_size];
+            }
+            time = dense_t0;
+            return 0;
+
+        default:
+            return integrate_2nd_order_ode(accel, velocity, position);
+    }
+}
@@ -7,17 +7,26 @@
 #include <iostream>
 
 /* GLOBAL Integrator. */
-extern Trick::Integrator* trick_curr_integ ;
+extern __thread Trick::Integrator* trick_curr_integ ;
 
 extern "C" int integrate() {
+    if (trick_curr_integ->dense_mode != Dense_Off) {
+        return (trick_curr_integ->dense_integrate());
+    }
     return (trick_curr_integ->integrate());
 }
 
 extern "C" int integrate_1st_order_ode(const double* deriv, double* state) {
+    if (trick_curr_integ->dense_mode != Dense_Off) {
+        return (trick_curr_integ->dense_integrate_1st_order_ode(deriv, state));
+    }
     return (trick_curr_integ->integrate_1st_order_ode(deriv, state));
 }
 
 extern "C" int integrate_2nd_order_ode(const double* acc, double* vel, double * pos) {
+    if (trick_curr_integ->dense_mode != Dense_Off) {
+        return (trick_curr_integ->dense_integrate_2nd_order_ode(acc, vel, pos));
+    }
     return (trick_curr_integ->integrate_2nd_order_ode(acc, vel, pos));
 }
 
@@ -0,0 +1,129 @@
+/*
+ Compare the rate of integrating many six state bodies with one integrator per body
+ and with all of the bodies in one BatchIntegrator.
+ This is a benchmark, not a unit test. Build and run it with "make benchmark".
+
+ usage: BatchIntegrator_benchmark [num_bodies [num_steps]]
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <iostream>
+#include <vector>
+#include "trick/MemoryManager.hh"
+#include "trick/Integrator.hh"
+#include "trick/BatchIntegrator.hh"
+
+static double elapsed_seconds( struct timeval & start ) {
+    struct timeval stop ;
+    gettimeofday(&stop, NULL) ;
+    return (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) * 1.0e-6 ;
+}
+
+static void oscillator_deriv( const double * state, double * deriv ) {
+    for ( int ii = 0 ; ii < 3 ; ii++ ) {
+        deriv[ii]   = state[3+ii] ;
+        deriv[3+ii] = -state[ii] ;
+    }
+}
+
+/*
+ Integrate each body with an integrator of its own, loaded and unloaded through the
+ state_in / deriv_in / state_out interface as a derivative and integration job pair would.
+ Returns bodies-steps per second and sets final to the first state of the first body.
+ */
+static double per_body_rate( Integrator_type alg, int num_bodies, int num_steps, double dt, double & final ) {
+    std::vector<Trick::Integrator*> integrators ;
+    std::vector<double> states(num_bodies * 6, 0.0) ;
+    std::vector<double> derivs(num_bodies * 6, 0.0) ;
+    for ( int ii = 0 ; ii < num_bodies ; ii++ ) {
+        integrators.push_back(Trick::getIntegrator(alg, 6, dt)) ;
+        states[ii*6] = states[ii*6+1] = states[ii*6+2] = 1.0 ;
+    }
+
+    struct timeval start ;
+    gettimeofday(&start, NULL) ;
+    for ( int step = 0 ; step < num_steps ; step++ ) {
+        for ( int ii = 0 ; ii < num_bodies ; ii++ ) {
+            double * s = &states[ii*6] ;
+            double * d = &derivs[ii*6] ;
+            Trick::Integrator * integ = integrators[ii] ;
+            do {
+                oscillator_deriv(s, d) ;
+                integ->state_in(&s[0], &s[1], &s[2], &s[3], &s[4], &s[5], NULL) ;
+                integ->deriv_in(&d[0], &d[1], &d[2], &d[3], &d[4], &d[5], NULL) ;
+                integ->integrate() ;
+                integ->state_out(&s[0], &s[1], &s[2], &s[3], &s[4], &s[5], NULL) ;
+            } while ( integ->intermediate_step ) ;
+        }
+    }
+    double rate = (double)num_bodies * num_steps / elapsed_seconds(start) ;
+
+    final = states[0] ;
+    for ( int ii = 0 ; ii < num_bodies ; ii++ ) {
+        delete integrators[ii] ;
+    }
+    return rate ;
+}
+
+/*
+ Integrate all of the bodies as one block in a BatchIntegrator.
+ Returns bodies-steps per second and sets final to the first state of the first body.
+ */
+static double batch_rate( Integrator_type alg, int num_bodies, int num_steps, double dt, double & final ) {
+    Trick::BatchIntegrator batch(alg, dt) ;
+    std::vector<int> offsets ;
+    for ( int ii = 0 ; ii < num_bodies ; ii++ ) {
+        offsets.push_back(batch.add_states(6)) ;
+    }
+    for ( int ii = 0 ; ii < num_bodies ; ii++ ) {
+        double * s = batch.get_state(offsets[ii]) ;
+        s[0] = s[1] = s[2] = 1.0 ;
+    }
+
+    struct timeval start ;
+    gettimeofday(&start, NULL) ;
+    for ( int step = 0 ; step < num_steps ; step++ ) {
+        do {
+            for ( int ii = 0 ; ii < num_bodies ; ii++ ) {
+                oscillator_deriv(batch.get_state(offsets[ii]), batch.get_deriv(offsets[ii])) ;
+            }
+        } while ( batch.integrate() ) ;
+    }
+    double rate = (double)num_bodies * num_steps / elapsed_seconds(start) ;
+
+    final = batch.get_state(offsets[0])[0] ;
+    return rate ;
+}
+
+int main( int argc, char * argv[] ) {
+
+    int num_bodies = (argc > 1) ? atoi(argv[1]) : 2000 ;
+    int num_steps = (argc > 2) ? atoi(argv[2]) : 1000 ;
+    const double dt = 0.01 ;
+    const Integrator_type algs[] = { Runge_Kutta_4, ABM_Method } ;
+    const char * names[] = { "RK4", "ABM4" } ;
+
+    // The integrators are allocated through the memory manager.
+    Trick::MemoryManager * memmgr = new Trick::MemoryManager ;
+
+    std::cout << num_bodies << " six state bodies, " << num_steps << " steps" << std::endl ;
+    for ( int ii = 0 ; ii < 2 ; ii++ ) {
+        double per_body_final , batch_final ;
+        double single = per_body_rate( algs[ii], num_bodies, num_steps, dt, per_body_final ) ;
+        double batch = batch_rate( algs[ii], num_bodies, num_steps, dt, batch_final ) ;
+
+        std::cout << names[ii] << " : one integrator per body " << single
+                  << ", BatchIntegrator " << batch << " bodies-steps/sec ("
+                  << batch / single << "x)" << std::endl ;
+        // Both must integrate the same motion for the rates to be comparable.
+        if ( fabs(per_body_final - batch_final) > 1.0e-9 ) {
+            std::cout << names[ii] << " : final states differ, " << per_body_final
+                      << " and " << batch_final << std::endl ;
+        }
+    }
+
+    delete memmgr ;
+    return 0 ;
+}
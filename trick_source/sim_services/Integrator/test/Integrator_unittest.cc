@@ -11,9 +11,23 @@
 #include "trick/exec_proto.h"
 #include "trick/exec_proto.hh"
 #include "trick/SimObject.hh"
+#include "trick/BatchIntegrator.hh"
+#include "trick/integrator_c_intf.h"
+#include "trick/regula_falsi.h"
+#include "er7_utils/integration/core/include/integ_simd.hh"
+#include "er7_utils/interface/include/alloc.hh"
+#include "er7_utils/integration/core/include/integration_controls.hh"
+#include "er7_utils/integration/rk4/include/rk4_integrator_constructor.hh"
+#include "er7_utils/integration/rk4/include/rk4_first_order_ode_integrator.hh"
+#include "er7_utils/integration/rk4/include/rk4_second_order_ode_integrator.hh"
 //#include "trick/RequirementScribe.hh"
 #include <math.h>
+#include <climits>
 #include <iostream>
+#include <sstream>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #define PI 3.141592653589793
 #define RAD_PER_DEG (2.0*PI/180.0)
@@ -544,3 +558,713 @@ TEST_F(IntegratorTest, Ball_UserDefined) {
 
     EXPECT_EQ(integrator->get_Integrator_type(), 10);
 }
+
+/* x'' = -x on each of three axes; the state is the position followed by the velocity. */
+static void oscillator_deriv(const double * state, double * deriv) {
+    for (int ii = 0; ii < 3; ii++) {
+        deriv[ii]   = state[3+ii];
+        deriv[3+ii] = -state[ii];
+    }
+}
+
+static double batch_oscillator_error(Integrator_type alg, int num_steps, double dt) {
+    const int num_bodies = 5;
+    Trick::BatchIntegrator batch(alg, dt);
+    std::vector<int> offsets;
+
+    for (int ii = 0; ii < num_bodies; ii++) {
+        offsets.push_back(batch.add_states(6));
+    }
+    for (int ii = 0; ii < num_bodies; ii++) {
+        double * state = batch.get_state(offsets[ii]);
+        for (int jj = 0; jj < 3; jj++) {
+            state[jj] = 1.0 + ii;
+            state[3+jj] = 0.0;
+        }
+    }
+
+    for (int step = 0; step < num_steps; step++) {
+        do {
+            for (int ii = 0; ii < num_bodies; ii++) {
+                oscillator_deriv(batch.get_state(offsets[ii]), batch.get_deriv(offsets[ii]));
+            }
+        } while (batch.integrate());
+    }
+    EXPECT_NEAR(batch.time, num_steps * dt, 1.0e-12);
+
+    double err = 0.0;
+    for (int ii = 0; ii < num_bodies; ii++) {
+        double * state = batch.get_state(offsets[ii]);
+        err = fmax(err, fabs(state[0] / (1.0 + ii) - cos(num_steps * dt)));
+    }
+    return err;
+}
+
+TEST_F(IntegratorTest, Batch_Integrator) {
+
+    EXPECT_LT(batch_oscillator_error(Euler, 1000, 0.001), 1.0e-3);
+    EXPECT_LT(batch_oscillator_error(Runge_Kutta_2, 1000, 0.001), 1.0e-6);
+    EXPECT_LT(batch_oscillator_error(Runge_Kutta_4, 100, 0.01), 1.0e-9);
+
+    // ABM is fourth order once primed: halving the step cuts the error by about 16.
+    double abm_err = batch_oscillator_error(ABM_Method, 100, 0.01);
+    double abm_err_half = batch_oscillator_error(ABM_Method, 200, 0.005);
+    EXPECT_LT(abm_err, 1.0e-8);
+    EXPECT_GT(abm_err / abm_err_half, 10.0);
+}
+
+/* Integrate num_bodies oscillators with different initial states and frequencies in one
+   BatchIntegrator per group of bodies_per_batch bodies. Returns the final states. */
+static std::vector<double> batch_run(Integrator_type alg, int num_bodies, int bodies_per_batch,
+                                     int num_steps, double dt) {
+    std::vector<Trick::BatchIntegrator *> batches;
+    std::vector<double *> states;
+    std::vector<int> offsets;
+    std::vector<double> result;
+
+    for (int ii = 0; ii < num_bodies; ii++) {
+        if (ii % bodies_per_batch == 0) {
+            batches.push_back(new Trick::BatchIntegrator(alg, dt));
+        }
+        offsets.push_back(batches.back()->add_states(6));
+    }
+    for (int ii = 0; ii < num_bodies; ii++) {
+        double * state = batches[ii / bodies_per_batch]->get_state(offsets[ii]);
+        for (int jj = 0; jj < 3; jj++) {
+            state[jj] = 1.0 + 0.1 * ii + jj;
+            state[3+jj] = 0.01 * ii;
+        }
+    }
+
+    for (int step = 0; step < num_steps; step++) {
+        for (size_t bb = 0; bb < batches.size(); bb++) {
+            do {
+                for (int ii = bb * bodies_per_batch; ii < num_bodies && ii < (int)(bb + 1) * bodies_per_batch; ii++) {
+                    double * state = batches[bb]->get_state(offsets[ii]);
+                    double * deriv = batches[bb]->get_deriv(offsets[ii]);
+                    double omega2 = 1.0 + 0.01 * ii;
+                    for (int jj = 0; jj < 3; jj++) {
+                        deriv[jj] = state[3+jj];
+                        deriv[3+jj] = -omega2 * state[jj];
+                    }
+                }
+            } while (batches[bb]->integrate());
+        }
+    }
+
+    for (int ii = 0; ii < num_bodies; ii++) {
+        double * state = batches[ii / bodies_per_batch]->get_state(offsets[ii]);
+        result.insert(result.end(), state, state + 6);
+    }
+    for (size_t bb = 0; bb < batches.size(); bb++) {
+        delete batches[bb];
+    }
+    return result;
+}
+
+TEST_F(IntegratorTest, Batch_Integrator_per_body) {
+
+    // Integrating the bodies as one block must match integrating each body on its own bit for bit.
+    // The block is long enough for the vectorized loops; a single body is not.
+    const Integrator_type algs[] = { Euler, Runge_Kutta_2, Runge_Kutta_4, ABM_Method };
+    const char * names[] = { "Euler", "RK2", "RK4", "ABM" };
+    const int num_bodies = 37;
+    const int num_steps = 50;
+
+    for (int aa = 0; aa < 4; aa++) {
+        std::vector<double> block = batch_run(algs[aa], num_bodies, num_bodies, num_steps, 0.01);
+        std::vector<double> per_body = batch_run(algs[aa], num_bodies, 1, num_steps, 0.01);
+        ASSERT_EQ(block.size(), per_body.size());
+        for (size_t ii = 0; ii < block.size(); ii++) {
+            EXPECT_EQ(per_body[ii], block[ii]) << names[aa] << " state " << ii;
+        }
+    }
+}
+
+/* Integrate a set of undamped oscillators with num_state states using the
+   given vector step threshold. Returns the final states. */
+static std::vector<double> vector_step_run(Integrator_type alg, int num_state, int num_steps, int min_size) {
+    const double dt = 0.01;
+    std::vector<double> state(num_state), deriv(num_state);
+    int saved_min_size = er7_utils::integ_simd::min_size;
+
+    er7_utils::integ_simd::min_size = min_size;
+    Trick::Integrator * integ = Trick::getIntegrator(alg, num_state, dt);
+    for (int ii = 0; ii < num_state; ii++) {
+        state[ii] = (ii % 2) ? 0.0 : 1.0 + 0.01 * ii;
+    }
+    for (int step = 0; step < num_steps; step++) {
+        do {
+            for (int ii = 0; ii + 1 < num_state; ii += 2) {
+                double omega = 1.0 + 0.001 * ii;
+                deriv[ii] = state[ii+1];
+                deriv[ii+1] = -omega * omega * state[ii];
+            }
+            if (num_state % 2) {
+                deriv[num_state-1] = -state[num_state-1];
+            }
+        } while (integ->integrate_1st_order_ode(&deriv[0], &state[0]));
+    }
+    delete integ;
+    er7_utils::integ_simd::min_size = saved_min_size;
+    return state;
+}
+
+TEST_F(IntegratorTest, Vector_Steps) {
+
+    // The vectorized steps must match the scalar loops bit for bit.
+    const Integrator_type algs[] = { Runge_Kutta_4, Runge_Kutta_Fehlberg_78, ABM_Method };
+    const char * names[] = { "RK4", "RKF78", "ABM4" };
+    // Shorter and longer than a vector, and longer than one 256 state block of the long weighted sums.
+    const int sizes[] = { 6, 13, 601 };
+    const int num_steps = 100;
+
+    for (int aa = 0; aa < 3; aa++) {
+        for (int ss = 0; ss < 3; ss++) {
+            std::vector<double> scalar = vector_step_run(algs[aa], sizes[ss], num_steps, INT_MAX);
+            std::vector<double> vector = vector_step_run(algs[aa], sizes[ss], num_steps, 1);
+            EXPECT_NE(scalar[0], 1.0) << names[aa] << " size " << sizes[ss];
+            for (int ii = 0; ii < sizes[ss]; ii++) {
+                EXPECT_EQ(scalar[ii], vector[ii]) << names[aa] << " size " << sizes[ss] << " state " << ii;
+            }
+        }
+    }
+}
+
+/* Integrate a set of undamped oscillators through the given first order ODE
+   integrator. Returns the final states. */
+static std::vector<double> fixed_size_run(er7_utils::FirstOrderODEIntegrator & integ, int num_state,
+                                          int num_steps) {
+    const double dt = 0.01;
+    std::vector<double> state(num_state), deriv(num_state);
+
+    for (int ii = 0; ii < num_state; ii++) {
+        state[ii] = (ii % 2) ? 0.0 : 1.0 + 0.01 * ii;
+    }
+    for (int step = 0; step < num_steps; step++) {
+        for (unsigned int stage = 1; stage <= 4; stage++) {
+            for (int ii = 0; ii + 1 < num_state; ii += 2) {
+                double omega = 1.0 + 0.001 * ii;
+                deriv[ii] = state[ii+1];
+                deriv[ii+1] = -omega * omega * state[ii];
+            }
+            if (num_state % 2) {
+                deriv[num_state-1] = -0.1 * state[num_state-1];
+            }
+            integ.integrate(dt, stage, &deriv[0], &state[0]);
+        }
+    }
+    return state;
+}
+
+TEST_F(IntegratorTest, Fixed_Size_Steps) {
+
+    // The fixed-size RK4 integrators must match the general ones bit for bit.
+    er7_utils::RK4IntegratorConstructor constructor;
+    er7_utils::IntegrationControls * controls = constructor.create_integration_controls();
+    const int sizes[] = { 3, 4, 6, 7, 13 };
+    const int num_steps = 100;
+
+    for (int ss = 0; ss < 5; ss++) {
+        er7_utils::FirstOrderODEIntegrator * fixed =
+            constructor.create_first_order_ode_integrator(sizes[ss], *controls);
+        er7_utils::RK4FirstOrderODEIntegrator general(sizes[ss], *controls);
+        EXPECT_TRUE(dynamic_cast<er7_utils::RK4FirstOrderODEIntegrator *>(fixed) == NULL);
+
+        std::vector<double> fixed_state = fixed_size_run(*fixed, sizes[ss], num_steps);
+        std::vector<double> general_state = fixed_size_run(general, sizes[ss], num_steps);
+        EXPECT_NE(general_state[0], 1.0) << "size " << sizes[ss];
+        for (int ii = 0; ii < sizes[ss]; ii++) {
+            EXPECT_EQ(general_state[ii], fixed_state[ii]) << "size " << sizes[ss] << " state " << ii;
+        }
+        er7_utils::alloc::delete_object(fixed);
+    }
+
+    // Simple second order ODE, three dimensional.
+    er7_utils::SecondOrderODEIntegrator * fixed =
+        constructor.create_second_order_ode_integrator(3, *controls);
+    er7_utils::RK4SimpleSecondOrderODEIntegrator general(3, *controls);
+    EXPECT_TRUE(dynamic_cast<er7_utils::RK4SimpleSecondOrderODEIntegrator *>(fixed) == NULL);
+    double pos[2][3] = {{1.0, 2.0, 3.0}, {1.0, 2.0, 3.0}};
+    double vel[2][3] = {{0.0, 0.1, 0.2}, {0.0, 0.1, 0.2}};
+    double acc[3];
+    er7_utils::SecondOrderODEIntegrator * integs[2] = { fixed, &general };
+    for (int kk = 0; kk < 2; kk++) {
+        for (int step = 0; step < num_steps; step++) {
+            for (unsigned int stage = 1; stage <= 4; stage++) {
+                for (int ii = 0; ii < 3; ii++) {
+                    acc[ii] = -(1.0 + 0.1 * ii) * pos[kk][ii];
+                }
+                integs[kk]->integrate(0.01, stage, acc, vel[kk], pos[kk]);
+            }
+        }
+    }
+    for (int ii = 0; ii < 3; ii++) {
+        EXPECT_EQ(pos[1][ii], pos[0][ii]);
+        EXPECT_EQ(vel[1][ii], vel[0][ii]);
+    }
+    er7_utils::alloc::delete_object(fixed);
+    er7_utils::alloc::delete_object(controls);
+}
+
+class ballSimObject : public Trick::SimObject {
+    public:
+
+    BALL ball;
+    Trick::Integrator * integ;
+
+    ballSimObject(double speed) {
+        ball.pos[0] = 0.0;
+        ball.pos[1] = 0.0;
+        ball.vel[0] = speed;
+        ball.vel[1] = 0.5 * speed;
+        ball.acc[0] = 0.0;
+        ball.acc[1] = 0.0;
+        integ = Trick::getIntegrator( Runge_Kutta_4, 4, 0.01);
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", &integ, 1, "integration", "TRK") ;
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        int ipass = 0;
+        if (curr_job->id == 0) {
+            ball.acc[0] = -9.81 - 0.1 * ball.vel[0];
+            ball.acc[1] = -0.1 * ball.vel[1];
+        } else {
+            load_state( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+            load_deriv( &ball.vel[0], &ball.vel[1], &ball.acc[0], &ball.acc[1], NULL);
+            ipass = integrate();
+            unload_state( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+        }
+        return ipass;
+    }
+
+    virtual double call_function_double(Trick::JobData*) {
+        return 0.0;
+    }
+};
+
+TEST_F(IntegratorLoopTest, Parallel_Integration) {
+
+    const int num_balls = 6;
+    Trick::IntegLoopScheduler serial_loop(0.01, &uno);
+    Trick::IntegLoopScheduler parallel_loop(0.01, &uno);
+    ballSimObject * serial_balls[num_balls];
+    ballSimObject * parallel_balls[num_balls];
+
+    for (int ii = 0; ii < num_balls; ii++) {
+        std::ostringstream oss;
+        oss << "ball_" << ii;
+        serial_balls[ii] = new ballSimObject(10.0 + ii);
+        exec_add_sim_object(serial_balls[ii], (oss.str() + "_serial").c_str());
+        serial_loop.add_integ_jobs_from_sim_object(serial_balls[ii]);
+        parallel_balls[ii] = new ballSimObject(10.0 + ii);
+        exec_add_sim_object(parallel_balls[ii], (oss.str() + "_parallel").c_str());
+        parallel_loop.add_integ_jobs_from_sim_object(parallel_balls[ii]);
+    }
+
+    EXPECT_EQ(parallel_loop.get_num_threads(), 1u);
+    parallel_loop.set_num_threads(3);
+    EXPECT_EQ(parallel_loop.get_num_threads(), 3u);
+
+    // The threaded loop must give bit for bit the same answer as the serial one.
+    for (int step = 0; step < 100; step++) {
+        ASSERT_EQ(serial_loop.integrate_dt(step * 0.01, 0.01), 0);
+        ASSERT_EQ(parallel_loop.integrate_dt(step * 0.01, 0.01), 0);
+    }
+    for (int ii = 0; ii < num_balls; ii++) {
+        EXPECT_NE(serial_balls[ii]->ball.pos[0], 0.0);
+        EXPECT_EQ(serial_balls[ii]->ball.pos[0], parallel_balls[ii]->ball.pos[0]);
+        EXPECT_EQ(serial_balls[ii]->ball.pos[1], parallel_balls[ii]->ball.pos[1]);
+        EXPECT_EQ(serial_balls[ii]->ball.vel[0], parallel_balls[ii]->ball.vel[0]);
+        EXPECT_EQ(serial_balls[ii]->ball.vel[1], parallel_balls[ii]->ball.vel[1]);
+    }
+
+    // Back to serial.
+    parallel_loop.set_num_threads(1);
+    ASSERT_EQ(parallel_loop.integrate_dt(1.0, 0.01), 0);
+}
+
+/* Integrate both loops in a forked child and report whether the states match.
+   A child that hangs waiting for threads it did not inherit is killed by the alarm. */
+static bool integrate_in_child(Trick::IntegLoopScheduler & serial_loop, Trick::IntegLoopScheduler & parallel_loop,
+ ballSimObject ** serial_balls, ballSimObject ** parallel_balls, int num_balls, int first_step) {
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        alarm(10);
+        for (int step = first_step; step < first_step + 50; step++) {
+            if (serial_loop.integrate_dt(step * 0.01, 0.01) != 0 or
+                parallel_loop.integrate_dt(step * 0.01, 0.01) != 0) {
+                _exit(2);
+            }
+        }
+        for (int ii = 0; ii < num_balls; ii++) {
+            if (serial_balls[ii]->ball.pos[0] != parallel_balls[ii]->ball.pos[0] or
+                serial_balls[ii]->ball.pos[1] != parallel_balls[ii]->ball.pos[1] or
+                serial_balls[ii]->ball.vel[0] != parallel_balls[ii]->ball.vel[0] or
+                serial_balls[ii]->ball.vel[1] != parallel_balls[ii]->ball.vel[1]) {
+                _exit(1);
+            }
+        }
+        _exit(0);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    return (WIFEXITED(status) and WEXITSTATUS(status) == 0);
+}
+
+TEST_F(IntegratorLoopTest, Parallel_Integration_After_Fork) {
+
+    const int num_balls = 4;
+    Trick::IntegLoopScheduler serial_loop(0.01, &uno);
+    Trick::IntegLoopScheduler parallel_loop(0.01, &uno);
+    ballSimObject * serial_balls[num_balls];
+    ballSimObject * parallel_balls[num_balls];
+
+    for (int ii = 0; ii < num_balls; ii++) {
+        std::ostringstream oss;
+        oss << "fork_ball_" << ii;
+        serial_balls[ii] = new ballSimObject(10.0 + ii);
+        exec_add_sim_object(serial_balls[ii], (oss.str() + "_serial").c_str());
+        serial_loop.add_integ_jobs_from_sim_object(serial_balls[ii]);
+        parallel_balls[ii] = new ballSimObject(10.0 + ii);
+        exec_add_sim_object(parallel_balls[ii], (oss.str() + "_parallel").c_str());
+        parallel_loop.add_integ_jobs_from_sim_object(parallel_balls[ii]);
+    }
+    parallel_loop.set_num_threads(3);
+
+    // Forked before the parent has integrated, as a Monte Carlo slave is.
+    EXPECT_TRUE(integrate_in_child(serial_loop, parallel_loop, serial_balls, parallel_balls, num_balls, 0));
+
+    // Forked after the parent's worker threads have run.
+    for (int step = 0; step < 20; step++) {
+        ASSERT_EQ(serial_loop.integrate_dt(step * 0.01, 0.01), 0);
+        ASSERT_EQ(parallel_loop.integrate_dt(step * 0.01, 0.01), 0);
+    }
+    EXPECT_TRUE(integrate_in_child(serial_loop, parallel_loop, serial_balls, parallel_balls, num_balls, 20));
+
+    // The parent's workers are unaffected by the children.
+    for (int step = 20; step < 40; step++) {
+        ASSERT_EQ(serial_loop.integrate_dt(step * 0.01, 0.01), 0);
+        ASSERT_EQ(parallel_loop.integrate_dt(step * 0.01, 0.01), 0);
+    }
+    for (int ii = 0; ii < num_balls; ii++) {
+        EXPECT_EQ(serial_balls[ii]->ball.pos[0], parallel_balls[ii]->ball.pos[0]);
+        EXPECT_EQ(serial_balls[ii]->ball.vel[1], parallel_balls[ii]->ball.vel[1]);
+    }
+}
+
+class bouncingBallSimObject : public Trick::SimObject {
+    public:
+
+    BALL ball;
+    Trick::Integrator * integ;
+    REGULA_FALSI floor;
+    int num_bounces;
+    int num_derivs;
+
+    bouncingBallSimObject() : num_bounces(0), num_derivs(0) {
+        ball.pos[0] = 10.0;
+        ball.pos[1] = 0.0;
+        ball.vel[0] = 0.0;
+        ball.vel[1] = 1.0;
+        ball.acc[0] = 0.0;
+        ball.acc[1] = 0.0;
+        floor.lower_set = 0;
+        floor.upper_set = 0;
+        floor.iterations = 0;
+        floor.fires = 0;
+        floor.delta_time = BIG_TGO;
+        floor.last_tgo = BIG_TGO;
+        floor.error_tol = 1.0e-12;
+        floor.mode = Decreasing;
+        integ = Trick::getIntegrator( Runge_Kutta_4, 4, 0.01);
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", &integ, 1, "integration", "TRK") ;
+        add_job(0, 2, "dynamic_event", NULL, 1, "dynamic_event", "TRK") ;
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        int ipass = 0;
+        if (curr_job->id == 0) {
+            num_derivs++;
+            ball.acc[0] = -9.81 - 0.1 * ball.vel[0];
+            ball.acc[1] = -0.1 * ball.vel[1];
+        } else {
+            load_state( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+            load_deriv( &ball.vel[0], &ball.vel[1], &ball.acc[0], &ball.acc[1], NULL);
+            ipass = integrate();
+            unload_state( &ball.pos[0], &ball.pos[1], &ball.vel[0], &ball.vel[1], NULL);
+        }
+        return ipass;
+    }
+
+    virtual double call_function_double(Trick::JobData*) {
+        floor.error = ball.pos[0];
+        double tgo = regula_falsi( get_integ_time(), &floor);
+        if (tgo == 0.0) {
+            reset_regula_falsi( get_integ_time(), &floor);
+            ball.vel[0] = -ball.vel[0];
+            num_bounces++;
+        }
+        return tgo;
+    }
+};
+
+TEST_F(IntegratorLoopTest, Dense_Events) {
+
+    Trick::IntegLoopScheduler search_loop(0.01, &uno);
+    Trick::IntegLoopScheduler dense_loop(0.01, &uno);
+    bouncingBallSimObject search_ball;
+    bouncingBallSimObject dense_ball;
+
+    exec_add_sim_object(&search_ball, "search_ball");
+    search_loop.add_integ_jobs_from_sim_object(&search_ball);
+    exec_add_sim_object(&dense_ball, "dense_ball");
+    dense_loop.add_integ_jobs_from_sim_object(&dense_ball);
+
+    EXPECT_FALSE(dense_loop.get_dense_events());
+    dense_loop.set_dense_events(true);
+    EXPECT_TRUE(dense_loop.get_dense_events());
+
+    // Step the loops as integrate() does.
+    for (int step = 0; step < 600; step++) {
+        double t = step * 0.01;
+        ASSERT_EQ(search_loop.integrate_dt(t, 0.01), 0);
+        ASSERT_EQ(search_loop.process_dynamic_events(t, t + 0.01), 0);
+        ASSERT_TRUE(dense_loop.set_dense_mode(Dense_Capture));
+        ASSERT_EQ(dense_loop.integrate_dt(t, 0.01), 0);
+        ASSERT_EQ(dense_loop.process_dynamic_events(t, t + 0.01), 0);
+        dense_loop.set_dense_mode(Dense_Off);
+    }
+
+    // The interpolant locates the bounces as well as integrating to them does,
+    // without calling the derivative job at each estimate.
+    EXPECT_EQ(search_ball.num_bounces, 2);
+    EXPECT_EQ(dense_ball.num_bounces, search_ball.num_bounces);
+    EXPECT_NEAR(dense_ball.ball.pos[0], search_ball.ball.pos[0], 1.0e-6);
+    EXPECT_NEAR(dense_ball.ball.vel[0], search_ball.ball.vel[0], 1.0e-6);
+    EXPECT_NEAR(dense_ball.ball.pos[1], search_ball.ball.pos[1], 1.0e-9);
+    EXPECT_LT(dense_ball.num_derivs, search_ball.num_derivs);
+}
+
+class orbitSimObject : public Trick::SimObject {
+    public:
+
+    double pos[2];
+    double vel[2];
+    double acc[2];
+    Trick::Integrator * integ;
+    int num_derivs;
+
+    orbitSimObject(Integrator_type alg, double dt) : num_derivs(0) {
+        // An orbit of eccentricity 0.7, which returns to periapsis after 2 pi.
+        pos[0] = 0.3;
+        pos[1] = 0.0;
+        vel[0] = 0.0;
+        vel[1] = sqrt(1.7 / 0.3);
+        acc[0] = 0.0;
+        acc[1] = 0.0;
+        integ = Trick::getIntegrator( alg, 4, dt);
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", &integ, 1, "integration", "TRK") ;
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        int ipass = 0;
+        if (curr_job->id == 0) {
+            double r = sqrt(pos[0] * pos[0] + pos[1] * pos[1]);
+            num_derivs++;
+            acc[0] = -pos[0] / (r * r * r);
+            acc[1] = -pos[1] / (r * r * r);
+        } else {
+            load_state( &pos[0], &pos[1], &vel[0], &vel[1], NULL);
+            load_deriv( &vel[0], &vel[1], &acc[0], &acc[1], NULL);
+            ipass = integrate();
+            unload_state( &pos[0], &pos[1], &vel[0], &vel[1], NULL);
+        }
+        return ipass;
+    }
+
+    virtual double call_function_double(Trick::JobData*) {
+        return 0.0;
+    }
+};
+
+TEST_F(IntegratorLoopTest, Adaptive_Step) {
+
+    const double period = 2.0 * PI;
+    const int num_fixed = 6000;
+    const int num_cycles = 64;
+    Trick::IntegLoopScheduler fixed_loop(period / num_fixed, &uno);
+    Trick::IntegLoopScheduler adaptive_loop(period / num_cycles, &uno);
+    orbitSimObject fixed_orbit(Runge_Kutta_Fehlberg_45, period / num_fixed);
+    orbitSimObject adaptive_orbit(Runge_Kutta_Fehlberg_45, period / num_cycles);
+
+    exec_add_sim_object(&fixed_orbit, "fixed_orbit");
+    fixed_loop.add_integ_jobs_from_sim_object(&fixed_orbit);
+    exec_add_sim_object(&adaptive_orbit, "adaptive_orbit");
+    adaptive_loop.add_integ_jobs_from_sim_object(&adaptive_orbit);
+
+    EXPECT_FALSE(adaptive_loop.get_adaptive_step());
+    adaptive_loop.set_adaptive_step(true);
+    adaptive_loop.set_adaptive_tolerance(1.0e-10, 1.0e-10);
+    EXPECT_TRUE(adaptive_loop.get_adaptive_step());
+
+    for (int step = 0; step < num_fixed; step++) {
+        ASSERT_EQ(fixed_loop.integrate_dt(step * period / num_fixed, period / num_fixed), 0);
+    }
+
+    // Step the adaptive loop as integrate() does.
+    for (int step = 0; step < num_cycles; step++) {
+        ASSERT_TRUE(adaptive_loop.have_error_estimates());
+        ASSERT_TRUE(adaptive_loop.set_dense_mode(Dense_Capture));
+        ASSERT_EQ(adaptive_loop.integrate_adaptive(step * period / num_cycles,
+                                                   (step + 1) * period / num_cycles), 0);
+        adaptive_loop.set_dense_mode(Dense_Off);
+    }
+
+    // Back at periapsis, with far fewer derivative calls than the fixed step.
+    EXPECT_NEAR(fixed_orbit.pos[0], 0.3, 1.0e-9);
+    EXPECT_NEAR(adaptive_orbit.pos[0], 0.3, 1.0e-6);
+    EXPECT_NEAR(adaptive_orbit.pos[1], 0.0, 1.0e-6);
+    EXPECT_GT(adaptive_loop.get_accepted_substeps(), (unsigned int)num_cycles);
+    EXPECT_GT(adaptive_loop.get_substep(), 0.0);
+    EXPECT_LT(adaptive_orbit.num_derivs * 10, fixed_orbit.num_derivs);
+
+    // Without an error estimate the loop goes back to fixed steps.
+    Trick::IntegLoopScheduler rk4_loop(0.01, &uno);
+    orbitSimObject rk4_orbit(Runge_Kutta_4, 0.01);
+    exec_add_sim_object(&rk4_orbit, "rk4_orbit");
+    rk4_loop.add_integ_jobs_from_sim_object(&rk4_orbit);
+    rk4_loop.set_adaptive_step(true);
+    EXPECT_FALSE(rk4_loop.have_error_estimates());
+    EXPECT_FALSE(rk4_loop.get_adaptive_step());
+}
+
+// x''' = 6 from rest, so x = t^3, which RK4 integrates exactly.
+class cubicSimObject : public Trick::SimObject {
+    public:
+
+    double state[3];
+    double deriv[3];
+    Trick::Integrator * integ;
+
+    cubicSimObject(double dt) {
+        for (int ii = 0; ii < 3; ii++) {
+            state[ii] = 0.0;
+            deriv[ii] = 0.0;
+        }
+        integ = Trick::getIntegrator( Runge_Kutta_4, 3, dt);
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", &integ, 1, "integration", "TRK") ;
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        int ipass = 0;
+        if (curr_job->id == 0) {
+            deriv[0] = state[1];
+            deriv[1] = state[2];
+            deriv[2] = 6.0;
+        } else {
+            load_state( &state[0], &state[1], &state[2], NULL);
+            load_deriv( &deriv[0], &deriv[1], &deriv[2], NULL);
+            ipass = integrate();
+            unload_state( &state[0], &state[1], &state[2], NULL);
+        }
+        return ipass;
+    }
+
+    virtual double call_function_double(Trick::JobData*) {
+        return 0.0;
+    }
+};
+
+// y' = x, where x is read from another object.
+class quadratureSimObject : public Trick::SimObject {
+    public:
+
+    double y;
+    double dy;
+    double * x;
+    Trick::Integrator * integ;
+
+    quadratureSimObject(double * in_x, double dt) : y(0.0), dy(0.0), x(in_x) {
+        integ = Trick::getIntegrator( Runge_Kutta_4, 1, dt);
+        add_job(0, 0, "derivative", NULL, 1, "derivative", "TRK") ;
+        add_job(0, 1, "integration", &integ, 1, "integration", "TRK") ;
+    }
+
+    virtual int call_function(Trick::JobData* curr_job) {
+        int ipass = 0;
+        if (curr_job->id == 0) {
+            dy = *x;
+        } else {
+            load_state( &y, NULL);
+            load_deriv( &dy, NULL);
+            ipass = integrate();
+            unload_state( &y, NULL);
+        }
+        return ipass;
+    }
+
+    virtual double call_function_double(Trick::JobData*) {
+        return 0.0;
+    }
+};
+
+TEST_F(IntegratorLoopTest, Rate_Inputs) {
+
+    const double fast_cycle = 0.01;
+    const double slow_cycle = 0.1;
+    const int num_frames = 100;
+    Trick::IntegLoopScheduler fast_loop(fast_cycle, &uno);
+    Trick::IntegLoopScheduler slow_loop(slow_cycle, &uno);
+    Trick::IntegLoopScheduler early_loop(slow_cycle, &uno);
+    Trick::IntegLoopScheduler held_loop(slow_cycle, &uno);
+    cubicSimObject cubic(fast_cycle);
+    quadratureSimObject slow(&cubic.state[0], slow_cycle);
+    quadratureSimObject early(&cubic.state[0], slow_cycle);
+    quadratureSimObject held(&cubic.state[0], slow_cycle);
+
+    exec_add_sim_object(&cubic, "cubic");
+    fast_loop.add_integ_jobs_from_sim_object(&cubic);
+    exec_add_sim_object(&slow, "slow");
+    slow_loop.add_integ_jobs_from_sim_object(&slow);
+    exec_add_sim_object(&early, "early");
+    early_loop.add_integ_jobs_from_sim_object(&early);
+    exec_add_sim_object(&held, "held");
+    held_loop.add_integ_jobs_from_sim_object(&held);
+
+    EXPECT_EQ(slow_loop.add_rate_input(&cubic.state[0], fast_loop), 0);
+    EXPECT_NE(slow_loop.add_rate_input(&cubic.state[0], fast_loop), 0);
+    EXPECT_NE(fast_loop.add_rate_input(&cubic.state[1], fast_loop), 0);
+    EXPECT_EQ(early_loop.add_rate_input(&cubic.state[0], fast_loop), 0);
+    EXPECT_EQ(fast_loop.rate_outputs.size(), 1u);
+
+    // The early loop runs before the fast loop in each frame, so it
+    // extrapolates the last fast cycle; the held loop sees x at the start of
+    // each of its cycles.
+    for (int frame = 1; frame <= num_frames; frame++) {
+        exec_set_time(frame * fast_cycle);
+        if (frame % 10 == 0) {
+            ASSERT_EQ(early_loop.integrate(), 0);
+            ASSERT_EQ(held_loop.integrate(), 0);
+        }
+        ASSERT_EQ(fast_loop.integrate(), 0);
+        if (frame % 10 == 0) {
+            ASSERT_EQ(slow_loop.integrate(), 0);
+        }
+        EXPECT_NEAR(cubic.state[0], pow(frame * fast_cycle, 3), 1.0e-12);
+    }
+
+    // y = t^4 / 4 from the cubic interpolant of the fast history.
+    EXPECT_NEAR(slow.y, 0.25, 1.0e-12);
+    EXPECT_NEAR(early.y, 0.25, 1.0e-12);
+    EXPECT_GT(fabs(held.y - 0.25), 1.0e-3);
+    EXPECT_LT(fast_loop.rate_times.size(), 30u);
+
+    EXPECT_EQ(slow_loop.remove_rate_input(&cubic.state[0]), 0);
+    EXPECT_NE(slow_loop.remove_rate_input(&cubic.state[0]), 0);
+}
@@ -0,0 +1,96 @@
+/*
+ Compare the rate of the er7_utils RK4, RKF78 and ABM4 steps on the inline scalar loops
+ and on the vectorized integ_simd functions, for state sizes from a point mass to a
+ large flexible body.
+ This is a benchmark, not a unit test. Build and run it with "make benchmark".
+
+ usage: Vector_Steps_benchmark [states_steps]
+ */
+
+#include <climits>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <iostream>
+#include <vector>
+#include "trick/MemoryManager.hh"
+#include "trick/Integrator.hh"
+#include "er7_utils/integration/core/include/integ_simd.hh"
+
+static double elapsed_seconds( struct timeval & start ) {
+    struct timeval stop ;
+    gettimeofday(&stop, NULL) ;
+    return (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) * 1.0e-6 ;
+}
+
+/*
+ Integrate a set of undamped oscillators with num_state states using the given vector
+ step threshold. Returns states-steps per second and sets final to the first state.
+ */
+static double vector_step_rate( Integrator_type alg, int num_state, int num_steps, int min_size, double & final ) {
+    const double dt = 0.01 ;
+    std::vector<double> state(num_state), deriv(num_state) ;
+    int saved_min_size = er7_utils::integ_simd::min_size ;
+
+    er7_utils::integ_simd::min_size = min_size ;
+    Trick::Integrator * integ = Trick::getIntegrator(alg, num_state, dt) ;
+    for ( int ii = 0 ; ii < num_state ; ii++ ) {
+        state[ii] = (ii % 2) ? 0.0 : 1.0 + 0.01 * ii ;
+    }
+
+    struct timeval start ;
+    gettimeofday(&start, NULL) ;
+    for ( int step = 0 ; step < num_steps ; step++ ) {
+        do {
+            for ( int ii = 0 ; ii + 1 < num_state ; ii += 2 ) {
+                double omega = 1.0 + 0.001 * ii ;
+                deriv[ii] = state[ii+1] ;
+                deriv[ii+1] = -omega * omega * state[ii] ;
+            }
+            if ( num_state % 2 ) {
+                deriv[num_state-1] = -state[num_state-1] ;
+            }
+        } while ( integ->integrate_1st_order_ode(&deriv[0], &state[0]) ) ;
+    }
+    double rate = (double)num_state * num_steps / elapsed_seconds(start) ;
+
+    final = state[0] ;
+    delete integ ;
+    er7_utils::integ_simd::min_size = saved_min_size ;
+    return rate ;
+}
+
+int main( int argc, char * argv[] ) {
+
+    // Each run integrates about this many states-steps, so every size takes about as long.
+    double states_steps = (argc > 1) ? atof(argv[1]) : 3.0e6 ;
+    const Integrator_type algs[] = { Runge_Kutta_4, Runge_Kutta_Fehlberg_78, ABM_Method } ;
+    const char * names[] = { "RK4", "RKF78", "ABM4" } ;
+    // A point mass, a rigid body with a quaternion, a few bodies, and flexible bodies with many modes.
+    const int sizes[] = { 6, 13, 60, 600, 6000 } ;
+
+    // The integrators are allocated through the memory manager.
+    Trick::MemoryManager * memmgr = new Trick::MemoryManager ;
+
+    std::cout << "vector steps are used by default from " << er7_utils::integ_simd::min_size
+              << " states" << std::endl ;
+    for ( int aa = 0 ; aa < 3 ; aa++ ) {
+        for ( int ss = 0 ; ss < 5 ; ss++ ) {
+            int num_steps = (int)(states_steps / sizes[ss]) + 1 ;
+            double scalar_final , vector_final ;
+            double scalar_rate = vector_step_rate( algs[aa], sizes[ss], num_steps, INT_MAX, scalar_final ) ;
+            double vector_rate = vector_step_rate( algs[aa], sizes[ss], num_steps, 1, vector_final ) ;
+
+            std::cout << names[aa] << " size " << sizes[ss] << " : scalar " << scalar_rate
+                      << ", vector " << vector_rate << " states-steps/sec ("
+                      << vector_rate / scalar_rate << "x)" << std::endl ;
+            // The vector steps are bit for bit the scalar steps.
+            if ( scalar_final != vector_final ) {
+                std::cout << names[aa] << " size " << sizes[ss] << " : final states differ, "
+                          << scalar_final << " and " << vector_final << std::endl ;
+            }
+        }
+    }
+
+    delete memmgr ;
+    return 0 ;
+}
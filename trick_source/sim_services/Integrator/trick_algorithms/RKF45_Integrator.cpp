@@ -171,6 +171,18 @@ int Trick::RKF45_Integrator::integrate() {
 
 }
 
+/**
+ Weights of the stage derivatives in the difference between the fifth and
+ fourth order solutions.
+ */
+const double * Trick::RKF45_Integrator::get_error_weights(int & order) {
+
+    static const double e_45[] = { 1.0 / 360.0, 0.0, -128.0 / 4275.0, -2197.0 / 75240.0, 1.0 / 50.0, 2.0 / 55.0 };
+
+    order = 4;
+    return e_45;
+}
+
 void Trick::RKF45_Integrator::set_first_step_deriv(bool first_step) {
     if ( !first_step ) {
         message_publish(MSG_WARNING, "5th Order Runge Kutta Fehlberg should always have first_step_deriv = 1\n");
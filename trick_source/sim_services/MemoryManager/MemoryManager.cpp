@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include "trick/MemoryManager.hh"
 #include "trick/ClassicCheckPointAgent.hh"
+#include "trick/MemoryPool.hh"
 // Global pointer to the (singleton) MemoryManager for the C language interface.
 Trick::MemoryManager * trick_MM = NULL;
 
@@ -30,6 +31,12 @@ Trick::MemoryManager::MemoryManager()
     // start counter at 0.  This forces extern vars to appear in front of actual allocations in checkpoint.
     extern_alloc_info_map_counter = 0 ;
     pthread_mutex_init(&mm_mutex, NULL);
+    ref_cache_enabled = true ;
+    ref_cache_max_size = 4096 ;
+    ref_cache_generation = 0 ;
+    pool_allocation = false ;
+    alloc_info_pool = new MemoryPool( sizeof(ALLOC_INFO), 1024 ) ;
+    create_data_pools() ;
 
     defaultCheckPointAgent = new ClassicCheckPointAgent( this);
     defaultCheckPointAgent->set_reduced_checkpoint( reduced_checkpoint);
@@ -80,6 +87,8 @@ Trick::MemoryManager::~MemoryManager() {
 
     delete defaultCheckPointAgent ;
 
+    invalidate_ref_cache() ;
+
     for ( ait = alloc_info_map.begin() ; ait != alloc_info_map.end() ; ait++ ) {
         ALLOC_INFO * ai_ptr = (*ait).second ;
         if (ai_ptr->stcl == TRICK_LOCAL) {
@@ -88,12 +97,19 @@ Trick::MemoryManager::~MemoryManager() {
             } else if ( ai_ptr->alloc_type == TRICK_ALLOC_NEW ) {
                 io_src_delete_class( ai_ptr );
             }
+            // TRICK_ALLOC_POOL memory is released with the data_pools below.
         }
         free(ai_ptr->name);
         free(ai_ptr->user_type_name);
-        free(ai_ptr) ;
+        free_alloc_info(ai_ptr) ;
     }
     alloc_info_map.clear() ;
+
+    for ( std::vector<MemoryPool*>::iterator pit = data_pools.begin() ; pit != data_pools.end() ; ++pit ) {
+        delete *pit ;
+    }
+    data_pools.clear() ;
+    delete alloc_info_pool ;
 }
 
 #include <sstream>
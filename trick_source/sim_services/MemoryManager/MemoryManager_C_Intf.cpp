@@ -264,6 +264,18 @@ extern "C" void TMM_hexfloat_checkpoint(int yesno) {
     }
 }
 
+/**
+ @relates Trick::MemoryManager
+ This is the C Language version of Trick::MemoryManager::set_pool_allocation( yesno).
+ */
+extern "C" void TMM_pool_allocation(int yesno) {
+    if (trick_MM != NULL) {
+        trick_MM->set_pool_allocation( yesno!=0 );
+    } else {
+        Trick::MemoryManager::emitError("TMM_pool_allocation() called before MemoryManager instantiation.\n") ;
+    }
+}
+
 
 
 
@@ -471,6 +483,19 @@ extern "C" REF2* ref_attributes(const char* name) {
     }
 }
 
+/**
+ @relates Trick::MemoryManager
+ This is the C Language version of Trick::MemoryManager::get_ref_cache_generation().
+ */
+extern "C" unsigned int TMM_ref_cache_generation(void) {
+    if (trick_MM != NULL) {
+        return( trick_MM->get_ref_cache_generation());
+    } else {
+        Trick::MemoryManager::emitError("TMM_ref_cache_generation() called before MemoryManager instantiation. Returning 0.\n") ;
+        return (0);
+    }
+}
+
 /**
  @relates Trick::MemoryManager
  This is the C Language version of Trick::MemoryManager::ref_assignment( REF2*, V_TREE*).
@@ -47,6 +47,7 @@ void* Trick::MemoryManager::declare_var( TRICK_TYPE type,
     int n_elems;
     Language language;
     void* address;
+    TRICK_ALLOC_TYPE alloc_type = TRICK_ALLOC_MALLOC;
     ATTRIBUTES* sub_attr;
     ALLOC_INFO *new_alloc;
     VARIABLE_MAP::iterator variable_pos;
@@ -140,7 +141,10 @@ void* Trick::MemoryManager::declare_var( TRICK_TYPE type,
         }
         language = Language_CPP;
     } else {
-        if ( (address = calloc( (size_t)n_elems, (size_t)size ) ) == NULL) {
+        /** @li If pool allocation is enabled, small C allocations come from the size-class pools. */
+        if ( pool_allocation && (address = pool_allocate( (size_t)n_elems * size )) != NULL ) {
+            alloc_type = TRICK_ALLOC_POOL;
+        } else if ( (address = calloc( (size_t)n_elems, (size_t)size ) ) == NULL) {
             emitError("Out of memory.") ;
             return ((void*)NULL);
         }
@@ -148,12 +152,13 @@ void* Trick::MemoryManager::declare_var( TRICK_TYPE type,
     }
 
     /** @li Allocate and populate an ALLOC_INFO record for the allocation. */
-    if ((new_alloc = (ALLOC_INFO*)calloc(1, sizeof(ALLOC_INFO))) != NULL) {
+    if ((new_alloc = new_alloc_info()) != NULL) {
 
         new_alloc->start = address;
         new_alloc->end = ( (char*)new_alloc->start) + (n_elems * size) - 1;
         new_alloc->name = allocation_name;
         new_alloc->stcl = TRICK_LOCAL;
+        new_alloc->alloc_type = alloc_type;
         new_alloc->size = size;
         new_alloc->language = language;
         new_alloc->type = type;
@@ -337,7 +342,7 @@ void* Trick::MemoryManager::declare_operatornew_var( std::string user_type_name,
     aligned = alloc_size % element_size ;
 
     /** @li Allocate and populate an ALLOC_INFO record for the allocation. */
-    if ((new_alloc = (ALLOC_INFO*)calloc(1, sizeof(ALLOC_INFO))) != NULL) {
+    if ((new_alloc = new_alloc_info()) != NULL) {
 
         new_alloc->start = (char *)address + aligned ;
         new_alloc->end = ( (char*)new_alloc->start) + alloc_size - 1 - aligned ;
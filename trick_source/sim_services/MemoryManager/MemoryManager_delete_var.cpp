@@ -29,6 +29,10 @@ int Trick::MemoryManager::delete_var(void* address ) {
         // BEGIN PROTECTION of the alloc_info_map.
         pthread_mutex_lock(&mm_mutex);
         alloc_info_map.erase( address);
+        if ( alloc_info->name ) {
+            // Cached references into this allocation are no longer valid.
+            invalidate_ref_cache() ;
+        }
         // END PROTECTION of the alloc_info_map.
         pthread_mutex_unlock(&mm_mutex);
 
@@ -50,6 +54,9 @@ int Trick::MemoryManager::delete_var(void* address ) {
                 free( address);
             } else if ( alloc_info->alloc_type == TRICK_ALLOC_NEW ) {
                 io_src_delete_class( alloc_info );
+            } else if ( alloc_info->alloc_type == TRICK_ALLOC_POOL ) {
+                deleted_addr_list.push_back(address);
+                pool_deallocate( address, (char *)alloc_info->end - (char *)alloc_info->start + 1 );
             }
         }
 
@@ -70,7 +77,7 @@ int Trick::MemoryManager::delete_var(void* address ) {
         }
 
         // Delete the alloc_info record.
-        free(alloc_info);
+        free_alloc_info(alloc_info);
 
     } else {
 
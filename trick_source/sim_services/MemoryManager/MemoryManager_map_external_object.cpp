@@ -84,7 +84,7 @@ void* Trick::MemoryManager::
     /** @li Allocate and populate an ALLOC_INFO record for the external allocation
         (the thingy pointed to by @b address).
      */
-    if ((new_alloc = (ALLOC_INFO*)calloc(1, sizeof(ALLOC_INFO))) != NULL) {
+    if ((new_alloc = new_alloc_info()) != NULL) {
 
         new_alloc->start = (void *) address;
         new_alloc->end = ((char*)new_alloc->start) + (n_elems * size) - 1;
@@ -0,0 +1,67 @@
+#include <stdlib.h>
+#include <string.h>
+#include "trick/MemoryManager.hh"
+#include "trick/MemoryPool.hh"
+
+/*
+ Block sizes of the data pools. Allocations larger than the last size class
+ are always made with calloc.
+ */
+static const size_t pool_size_classes[] = { 16, 32, 64, 128, 256, 512 } ;
+static const size_t pool_slab_bytes = 64 * 1024 ;
+
+// MEMBER FUNCTION
+void Trick::MemoryManager::create_data_pools() {
+
+    /* Pools obtain no memory until their first allocation, so creating them all up front costs little.
+       The list is never changed afterwards, so it may be searched without mm_mutex. */
+    for ( size_t ii = 0 ; ii < sizeof(pool_size_classes)/sizeof(size_t) ; ii++ ) {
+        data_pools.push_back( new MemoryPool( pool_size_classes[ii], pool_slab_bytes / pool_size_classes[ii] )) ;
+    }
+}
+
+// MEMBER FUNCTION
+void Trick::MemoryManager::set_pool_allocation(bool flag) {
+
+    pthread_mutex_lock(&mm_mutex);
+    pool_allocation = flag;
+    pthread_mutex_unlock(&mm_mutex);
+}
+
+// MEMBER FUNCTION
+ALLOC_INFO * Trick::MemoryManager::new_alloc_info() {
+    return (ALLOC_INFO *)alloc_info_pool->allocate() ;
+}
+
+// MEMBER FUNCTION
+void Trick::MemoryManager::free_alloc_info( ALLOC_INFO * alloc_info ) {
+    alloc_info_pool->deallocate( alloc_info ) ;
+}
+
+// MEMBER FUNCTION
+void * Trick::MemoryManager::pool_allocate( size_t num_bytes ) {
+
+    std::vector<MemoryPool*>::iterator it ;
+
+    /* data_pools is fixed at construction, so it may be searched without mm_mutex.
+       Each pool serializes its own free list. */
+    for ( it = data_pools.begin() ; it != data_pools.end() ; ++it ) {
+        if ( num_bytes <= (*it)->get_block_size() ) {
+            return (*it)->allocate() ;
+        }
+    }
+    return NULL ;
+}
+
+// MEMBER FUNCTION
+void Trick::MemoryManager::pool_deallocate( void * address, size_t num_bytes ) {
+
+    std::vector<MemoryPool*>::iterator it ;
+
+    for ( it = data_pools.begin() ; it != data_pools.end() ; ++it ) {
+        if ( num_bytes <= (*it)->get_block_size() ) {
+            (*it)->deallocate( address ) ;
+            return ;
+        }
+    }
+}
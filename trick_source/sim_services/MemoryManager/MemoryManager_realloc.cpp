@@ -161,10 +161,18 @@ void* Trick::MemoryManager::resize_array( void *address, int n_cdims, int *cdims
                 n_cdims);
 
     /** @li Delete the previous memory allocation. */
-    free( address);
+    if ( alloc_info->alloc_type == TRICK_ALLOC_POOL ) {
+        pool_deallocate( address, (char *)alloc_info->end - (char *)alloc_info->start + 1 );
+        alloc_info->alloc_type = TRICK_ALLOC_MALLOC;
+    } else {
+        free( address);
+    }
 
     // Remove the old <address, ALLOC_INFO*> key-value pair from the alloc_info_map.
     alloc_info_map.erase( address);
+    if ( alloc_info->name ) {
+        invalidate_ref_cache() ;
+    }
 
     /** @li Update the ALLOC_INFO record with new start and end addresses, with
             new extents and with the new number of elements.*/
@@ -1,4 +1,5 @@
 #include "trick/MemoryManager.hh"
+#include "trick/UnitsConversion.hh"
 #include "trick/bitfield_proto.h"
 #include "trick/vval.h"
 #include "trick/wcs_ext.h"
@@ -7,7 +8,7 @@
 #include <udunits2.h>
 #include <string.h>
 
-int Trick::MemoryManager::assign_recursive(void* base_addr, ATTRIBUTES* attr, int curr_dim, int offset, V_TREE* v_tree, cv_converter* cf) {
+int Trick::MemoryManager::assign_recursive(void* base_addr, ATTRIBUTES* attr, int curr_dim, int offset, V_TREE* v_tree, const Trick::UnitsConversion * cf) {
 
    char* assign_addr;
    int remaining_dimensions = attr->num_index - curr_dim;
@@ -72,7 +73,7 @@ int Trick::MemoryManager::assign_recursive(void* base_addr, ATTRIBUTES* attr, in
                    if (cf == NULL) {
                        *(int *)assign_addr = input_value;
                    } else {
-                       *(int *)assign_addr = (int)cv_convert_double(cf, (double)input_value) ;
+                       *(int *)assign_addr = (int)cf->convert((double)input_value) ;
                    }
                } else {
                    *(int *)assign_addr = 0;
@@ -140,7 +141,7 @@ int Trick::MemoryManager::assign_recursive(void* base_addr, ATTRIBUTES* attr, in
                    if (cf == NULL) {
                        *(long *)assign_addr = input_value;
                    } else {
-                       *(long *)assign_addr = (long)cv_convert_double(cf, (double)input_value) ;
+                       *(long *)assign_addr = (long)cf->convert((double)input_value) ;
                    }
                } else {
                    *(long *)assign_addr = 0;
@@ -159,7 +160,7 @@ int Trick::MemoryManager::assign_recursive(void* base_addr, ATTRIBUTES* attr, in
                    if (cf == NULL) {  // There is no units conversion.
                        *(float *)assign_addr = input_value;
                    } else { // There is units conversion.
-                       *(float *)assign_addr = (float)cv_convert_double(cf, (double)input_value) ;
+                       *(float *)assign_addr = (float)cf->convert((double)input_value) ;
                    }
                } else {
                    *(float *)assign_addr = 0;
@@ -178,7 +179,7 @@ int Trick::MemoryManager::assign_recursive(void* base_addr, ATTRIBUTES* attr, in
                    if (cf == NULL) {
                        *(double *)assign_addr = input_value;
                    } else {
-                       *(double *)assign_addr = cv_convert_double(cf, input_value) ;
+                       *(double *)assign_addr = cf->convert(input_value) ;
                    }
                } else {
                    *(double *)assign_addr = 0;
@@ -417,30 +418,24 @@ ut_system * Trick::MemoryManager::get_unit_system() {
 int Trick::MemoryManager::ref_assignment( REF2* R, V_TREE* V) {
 
     int ret = 0;
-    cv_converter * cf = NULL ;
+    Trick::UnitsConversion conversion ;
+    Trick::UnitsConversion * cf = NULL ;
 
-    // Create a units conversion function if necessary.
+    // Look up the units conversion if necessary.
     if (R->units) {
-        ut_unit * from = ut_parse(get_unit_system(), R->units, UT_ASCII) ;
-        ut_unit * to = ut_parse(get_unit_system(), R->attr->units, UT_ASCII) ;
-        if ( !from or !to ) {
+        if ( Trick::UnitsConversion::get(get_unit_system(), R->units, R->attr->units, conversion) != 0 ) {
             std::stringstream message;
             message << "Can't convert \"" << R->units << "\" to \"" << R->attr->units << "\".";
             emitError(message.str());
             return TRICK_UNITS_CONVERSION_ERROR ;
         }
-        cf = ut_get_converter(from,to) ;
-        if ( !cf ) {
-            std::stringstream message;
-            message << "Can't convert \"" << R->units << "\" to \"" << R->attr->units << "\".";
-            emitError(message.str());
-            return TRICK_UNITS_CONVERSION_ERROR ;
+        if ( ! conversion.is_trivial() ) {
+            cf = &conversion ;
         }
     }
 
     // R->num_index is badly named. It is really the current dimension
     ret = assign_recursive( R->address, R->attr, R->num_index, 0, V, cf);
-    if ( cf ) cv_free(cf) ;
 
     return ( ret);
 
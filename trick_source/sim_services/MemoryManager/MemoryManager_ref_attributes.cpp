@@ -2,24 +2,263 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <ctype.h>
 #include <sstream>
 #include "trick/MemoryManager.hh"
 #include "trick/RefParseContext.hh"
+#include "trick/memorymanager_c_intf.h"
 
 extern int REF_debug;
 
+/*
+ Deep copy a REF2 so the copy may be handed to a caller that will free() it.
+ */
+static REF2 * copy_ref( REF2 * src ) {
+
+    REF2 * dest = (REF2 *)malloc( sizeof(REF2)) ;
+    memcpy( dest, src, sizeof(REF2)) ;
+    dest->reference = src->reference ? strdup(src->reference) : NULL ;
+
+    if ( src->ref_attr ) {
+        dest->ref_attr = (ATTRIBUTES *)calloc( 1, sizeof(ATTRIBUTES)) ;
+        memcpy( dest->ref_attr, src->ref_attr, sizeof(ATTRIBUTES)) ;
+        if ( src->attr == src->ref_attr ) {
+            dest->attr = dest->ref_attr ;
+        }
+    }
+
+    if ( src->address_path ) {
+        DLLPOS pos = DLL_GetHeadPosition(src->address_path) ;
+        dest->address_path = DLL_Create() ;
+        while ( pos != NULL ) {
+            ADDRESS_NODE * address_node = new ADDRESS_NODE ;
+            *address_node = *(ADDRESS_NODE *)DLL_GetNext(&pos, src->address_path) ;
+            DLL_AddTail(address_node , dest->address_path) ;
+        }
+    }
+    return dest ;
+}
+
+/*
+ Free everything a REF2 owns, including the REF2 itself.
+ */
+static void delete_ref( REF2 * ref ) {
+    if ( ref ) {
+        ref_free(ref) ;
+        if ( ref->ref_attr ) {
+            free(ref->ref_attr) ;
+        }
+        free(ref) ;
+    }
+}
+
+/*
+ A reference may be cached if its address cannot change without the named
+ allocation changing, i.e. no pointer is followed along the address path.
+ */
+static bool is_fixed_address( REF2 * ref ) {
+    if ( ref->pointer_present || ref->address_path == NULL ) {
+        return false ;
+    }
+    DLLPOS pos = DLL_GetHeadPosition(ref->address_path) ;
+    while ( pos != NULL ) {
+        ADDRESS_NODE * address_node = (ADDRESS_NODE *)DLL_GetNext(&pos, ref->address_path) ;
+        if ( address_node->operator_ != AO_ADDRESS ) {
+            return false ;
+        }
+    }
+    return true ;
+}
+
+static inline bool is_name_start( char c ) {
+    return ( isalpha((unsigned char)c) || c == '_' ) ;
+}
+
+static inline bool is_name_char( char c ) {
+    return ( isalnum((unsigned char)c) || c == '_' || c == ':' ) ;
+}
+
+/*
+ Returns true if name is made only of NAME ( '.' NAME | '[' decimal ']' )* tokens,
+ the subset of the reference grammar handled by ref_attributes_fast.
+ */
+static bool is_plain_reference( const char * name ) {
+
+    const char * cp = name ;
+
+    if ( ! is_name_start(*cp) ) {
+        return false ;
+    }
+    while ( *cp != '\0' ) {
+        if ( is_name_start(*cp) ) {
+            cp++ ;
+            while ( is_name_char(*cp) ) {
+                cp++ ;
+            }
+        } else {
+            return false ;
+        }
+        while ( *cp == '[' ) {
+            cp++ ;
+            if ( !isdigit((unsigned char)*cp) || ( cp[0] == '0' && ( cp[1] == 'x' || cp[1] == 'X' ))) {
+                return false ;
+            }
+            while ( isdigit((unsigned char)*cp) ) {
+                cp++ ;
+            }
+            if ( *cp++ != ']' ) {
+                return false ;
+            }
+        }
+        if ( *cp == '.' ) {
+            cp++ ;
+        } else if ( *cp != '\0' ) {
+            return false ;
+        }
+    }
+    return ( cp[-1] != '.' ) ;
+}
+
+/*
+ Hand written equivalent of the reference parser for plain dotted/indexed names.
+ The same ref_var, ref_dim and ref_name calls are made in the same order as the
+ grammar actions in ref_parser.y so results and error messages are identical.
+ */
+REF2 * Trick::MemoryManager::ref_attributes_fast( const char* name, bool & handled ) {
+
+    REF2 R ;
+    int ret = MM_OK ;
+    const char * cp = name ;
+    const char * token ;
+    std::string reference ;
+
+    if ( ! is_plain_reference(name) ) {
+        handled = false ;
+        return NULL ;
+    }
+    handled = true ;
+
+    memset(&R, 0, sizeof(REF2)) ;
+    R.ref_type = REF_ADDRESS ;
+    R.create_add_path = 1 ;
+    R.address_path = DLL_Create() ;
+
+    while ( ret == MM_OK && *cp != '\0' ) {
+
+        token = cp ;
+        while ( is_name_char(*cp) ) {
+            cp++ ;
+        }
+        std::string elem_name(token, cp - token) ;
+
+        if ( token == name ) {
+            // NAME
+            if ((ret = ref_var( &R, (char *)elem_name.c_str())) != MM_OK) {
+                break ;
+            }
+            reference = elem_name ;
+            R.reference = (char *)reference.c_str() ;
+        } else {
+            // param '.' NAME
+            if (R.num_index != R.attr->num_index) {
+                std::stringstream message;
+                message << "Dimension mismatch.";
+                emitError(message.str());
+                ret = MM_PARAMETER_ARRAY_DIM ;
+                break ;
+            }
+            R.num_index = 0;
+            if ((ret = ref_name( &R, (char *)elem_name.c_str())) != MM_OK) {
+                break ;
+            }
+            reference += "." + elem_name ;
+            R.reference = (char *)reference.c_str() ;
+        }
+        R.num_index_left = R.attr->num_index;
+
+        // param '[' I_CON ']'
+        while ( *cp == '[' ) {
+            V_DATA v_data ;
+            v_data.type = TRICK_INTEGER ;
+            v_data.value.i = atoi(cp + 1) ;
+            cp = strchr(cp, ']') + 1 ;
+            if ((ret = ref_dim( &R, &v_data)) != MM_OK) {
+                break ;
+            }
+        }
+
+        if ( *cp == '.' ) {
+            cp++ ;
+        }
+    }
+
+    R.reference = NULL ;
+    if ( ret != MM_OK ) {
+        ref_free(&R) ;
+        if ( R.ref_attr ) {
+            free(R.ref_attr) ;
+        }
+        return NULL ;
+    }
+
+    REF2 * result = (REF2*)malloc( sizeof(REF2));
+    memcpy( result, &R, sizeof(REF2));
+    result->reference = strdup(name) ;
+    return result ;
+}
+
 REF2 *Trick::MemoryManager::ref_attributes(const char* name) {
 
     std::stringstream reference_sstream;
     REF2 * result = NULL;
     RefParseContext* context = NULL;
+    REF_CACHE_MAP::iterator cit ;
+    unsigned int generation ;
+    bool handled ;
 
     /** @par Design Details: */
+
+    /** @li Return a copy of the cached reference if this name has already been resolved. */
+    pthread_mutex_lock(&mm_mutex);
+    if ( ref_cache_enabled ) {
+        cit = ref_cache.find(name) ;
+        if ( cit != ref_cache.end() ) {
+            result = copy_ref(cit->second) ;
+            pthread_mutex_unlock(&mm_mutex);
+            return result ;
+        }
+    }
+    generation = ref_cache_generation ;
+    pthread_mutex_unlock(&mm_mutex);
+
+    /** @li Resolve plain dotted/indexed names directly. Cache the result if its
+            address does not depend on any pointer values. */
+    result = ref_attributes_fast( name, handled ) ;
+    if ( handled ) {
+        if ( result != NULL && is_fixed_address(result) ) {
+            pthread_mutex_lock(&mm_mutex);
+            if ( ref_cache_enabled && generation == ref_cache_generation ) {
+                cit = ref_cache.find(name) ;
+                if ( cit == ref_cache.end() ) {
+                    /* Keep the cache bounded when many distinct references are resolved. */
+                    if ( ref_cache.size() >= ref_cache_max_size ) {
+                        clear_ref_cache() ;
+                    }
+                    if ( ref_cache_max_size > 0 ) {
+                        ref_cache[name] = copy_ref(result) ;
+                    }
+                }
+            }
+            pthread_mutex_unlock(&mm_mutex);
+        }
+        return result ;
+    }
+
     reference_sstream << name;
 
     REF_debug = 0;
 
-    /** @li Create a parse context. */
+    /** @li Otherwise create a parse context. */
     context = new RefParseContext(this, &reference_sstream);
 
     /** @li Call REF_parse to parse the variable reference. */
@@ -41,3 +280,33 @@ REF2 *Trick::MemoryManager::ref_attributes(const char* name) {
     return ( result);
 }
 
+void Trick::MemoryManager::set_ref_cache_enabled( bool on ) {
+    pthread_mutex_lock(&mm_mutex);
+    ref_cache_enabled = on ;
+    if ( ! on ) {
+        invalidate_ref_cache() ;
+    }
+    pthread_mutex_unlock(&mm_mutex);
+}
+
+void Trick::MemoryManager::set_ref_cache_max_size( size_t num ) {
+    pthread_mutex_lock(&mm_mutex);
+    ref_cache_max_size = num ;
+    if ( ref_cache.size() > ref_cache_max_size ) {
+        clear_ref_cache() ;
+    }
+    pthread_mutex_unlock(&mm_mutex);
+}
+
+void Trick::MemoryManager::invalidate_ref_cache() {
+    clear_ref_cache() ;
+    ref_cache_generation++ ;
+}
+
+void Trick::MemoryManager::clear_ref_cache() {
+    REF_CACHE_MAP::iterator cit ;
+    for ( cit = ref_cache.begin() ; cit != ref_cache.end() ; ++cit ) {
+        delete_ref(cit->second) ;
+    }
+    ref_cache.clear() ;
+}
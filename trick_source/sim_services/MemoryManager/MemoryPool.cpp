@@ -0,0 +1,73 @@
+#include <stdlib.h>
+#include <string.h>
+#include "trick/MemoryPool.hh"
+
+Trick::MemoryPool::MemoryPool( size_t in_block_size, size_t in_blocks_per_slab ) {
+
+    // Keep every block 16 byte aligned, and big enough to hold the free list link.
+    block_size = (in_block_size + 15) & ~(size_t)15 ;
+    if ( block_size < sizeof(FreeBlock) ) {
+        block_size = 16 ;
+    }
+    blocks_per_slab = in_blocks_per_slab > 0 ? in_blocks_per_slab : 1 ;
+    free_list = NULL ;
+    num_in_use = 0 ;
+    pthread_mutex_init(&pool_mutex, NULL);
+}
+
+Trick::MemoryPool::~MemoryPool() {
+    std::vector<char *>::iterator it ;
+    for ( it = slabs.begin() ; it != slabs.end() ; ++it ) {
+        free(*it) ;
+    }
+    slabs.clear() ;
+    pthread_mutex_destroy(&pool_mutex);
+}
+
+int Trick::MemoryPool::add_slab() {
+
+    char * slab = (char *)malloc( block_size * blocks_per_slab ) ;
+    if ( slab == NULL ) {
+        return -1 ;
+    }
+    slabs.push_back(slab) ;
+
+    // Thread the new blocks onto the free list, lowest address first.
+    for ( size_t ii = blocks_per_slab ; ii > 0 ; ii-- ) {
+        FreeBlock * block = (FreeBlock *)(slab + (ii - 1) * block_size) ;
+        block->next = free_list ;
+        free_list = block ;
+    }
+    return 0 ;
+}
+
+void * Trick::MemoryPool::allocate() {
+
+    FreeBlock * block ;
+
+    pthread_mutex_lock(&pool_mutex);
+    if ( free_list == NULL && add_slab() != 0 ) {
+        pthread_mutex_unlock(&pool_mutex);
+        return NULL ;
+    }
+    block = free_list ;
+    free_list = block->next ;
+    num_in_use++ ;
+    pthread_mutex_unlock(&pool_mutex);
+
+    memset( block, 0, block_size ) ;
+    return block ;
+}
+
+void Trick::MemoryPool::deallocate( void * address ) {
+
+    if ( address == NULL ) {
+        return ;
+    }
+    FreeBlock * block = (FreeBlock *)address ;
+    pthread_mutex_lock(&pool_mutex);
+    block->next = free_list ;
+    free_list = block ;
+    num_in_use-- ;
+    pthread_mutex_unlock(&pool_mutex);
+}
@@ -0,0 +1,101 @@
+#include <float.h>
+#include <math.h>
+#include <map>
+#include <utility>
+#include <pthread.h>
+#include <udunits2.h>
+#include "trick/UnitsConversion.hh"
+
+typedef std::map< std::pair< std::string, std::string >, Trick::UnitsConversion > UNITS_CONVERSION_MAP ;
+
+/* Process wide cache of conversions. Entries are never removed, so converters kept
+   for non-affine conversions live as long as the process. */
+static UNITS_CONVERSION_MAP conversion_cache ;
+static pthread_mutex_t conversion_cache_mutex = PTHREAD_MUTEX_INITIALIZER ;
+
+Trick::UnitsConversion::UnitsConversion() : scale(1.0), offset(0.0), converter(NULL) {}
+
+int Trick::UnitsConversion::get( ut_system * u_system, const std::string & from, const std::string & to,
+ UnitsConversion & conversion ) {
+
+    std::pair< std::string, std::string > key(from, to) ;
+    UNITS_CONVERSION_MAP::iterator it ;
+
+    pthread_mutex_lock(&conversion_cache_mutex) ;
+    it = conversion_cache.find(key) ;
+    if ( it != conversion_cache.end() ) {
+        conversion = it->second ;
+        pthread_mutex_unlock(&conversion_cache_mutex) ;
+        return 0 ;
+    }
+    pthread_mutex_unlock(&conversion_cache_mutex) ;
+
+    ut_unit * from_unit = ut_parse(u_system, from.c_str(), UT_ASCII) ;
+    if ( !from_unit ) {
+        return -1 ;
+    }
+    ut_unit * to_unit = ut_parse(u_system, to.c_str(), UT_ASCII) ;
+    if ( !to_unit ) {
+        ut_free(from_unit) ;
+        return -2 ;
+    }
+    cv_converter * cv = ut_get_converter(from_unit, to_unit) ;
+    ut_free(from_unit) ;
+    ut_free(to_unit) ;
+    if ( !cv ) {
+        return -3 ;
+    }
+
+    /* Sample the converter to find the scale and offset, then check that the conversion
+       really is affine at more points. A point may differ from udunits only by the rounding
+       of the multiply and add, a few ulps of the larger term. Anything else, including the
+       rounding of a composed udunits converter beyond that, keeps the udunits converter. */
+    UnitsConversion result ;
+    double y0 = cv_convert_double(cv, 0.0) ;
+    result.offset = y0 ;
+    if ( y0 == 0.0 ) {
+        result.scale = cv_convert_double(cv, 1.0) ;
+    } else {
+        // a wide sample keeps the rounding of the offset out of the scale
+        result.scale = (cv_convert_double(cv, 1024.0) - y0) / 1024.0 ;
+    }
+    const double probes[] = { -1000.0 , 0.5 , 1.0 , 37.25 , 12345.678 , 1.0e6 } ;
+    for ( size_t ii = 0 ; ii < sizeof(probes)/sizeof(double) ; ii++ ) {
+        double expected = cv_convert_double(cv, probes[ii]) ;
+        double actual = probes[ii] * result.scale + result.offset ;
+        double tolerance = 8.0 * DBL_EPSILON * fmax(fabs(probes[ii] * result.scale), fabs(result.offset)) ;
+        if ( !( fabs(actual - expected) <= tolerance )) {
+            result.scale = 1.0 ;
+            result.offset = 0.0 ;
+            result.converter = cv ;
+            break ;
+        }
+    }
+
+    pthread_mutex_lock(&conversion_cache_mutex) ;
+    std::pair< UNITS_CONVERSION_MAP::iterator, bool > inserted = conversion_cache.insert(std::make_pair(key, result)) ;
+    conversion = inserted.first->second ;
+    pthread_mutex_unlock(&conversion_cache_mutex) ;
+
+    /* Free the converter unless the cache kept it. */
+    if ( result.converter != cv || ! inserted.second ) {
+        cv_free(cv) ;
+    }
+    return 0 ;
+}
+
+void Trick::UnitsConversion::convert( double * values, size_t num ) const {
+    if ( converter != NULL ) {
+        cv_convert_doubles(converter, values, num, values) ;
+    } else if ( ! is_trivial() ) {
+        const double s = scale ;
+        const double o = offset ;
+        for ( size_t ii = 0 ; ii < num ; ii++ ) {
+            values[ii] = values[ii] * s + o ;
+        }
+    }
+}
+
+double Trick::UnitsConversion::convert_nonaffine( double value ) const {
+    return cv_convert_double(converter, value) ;
+}
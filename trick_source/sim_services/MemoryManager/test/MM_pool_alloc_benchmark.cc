@@ -0,0 +1,66 @@
+/*
+ Compare the rate of declare_var/delete_var pairs with and without pool allocation.
+ This is a benchmark, not a unit test. Build and run it with "make benchmark".
+
+ usage: MM_pool_alloc_benchmark [num_cycles [batch_size]]
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <iostream>
+#include <vector>
+#include "trick/MemoryManager.hh"
+
+static double elapsed_seconds( struct timeval & start ) {
+    struct timeval stop ;
+    gettimeofday(&stop, NULL) ;
+    return (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) * 1.0e-6 ;
+}
+
+/*
+ Declare and delete num_cycles batches of anonymous double arrays of max_length or fewer elements,
+ returning allocations per second.
+ */
+static double alloc_rate( Trick::MemoryManager * memmgr, int num_cycles, int batch_size, int max_length ) {
+    std::vector<void*> addrs(batch_size) ;
+    struct timeval start ;
+    gettimeofday(&start, NULL) ;
+    for ( int ii = 0 ; ii < num_cycles ; ii++ ) {
+        for ( int jj = 0 ; jj < batch_size ; jj++ ) {
+            int cdims[1] = { 1 + (jj % max_length) } ;
+            addrs[jj] = memmgr->declare_var( TRICK_DOUBLE, "", 0, "", 1, cdims) ;
+        }
+        // Delete in a different order than declared, as a sim tearing down objects would.
+        for ( int jj = 0 ; jj < batch_size ; jj += 2 ) {
+            memmgr->delete_var( addrs[jj] ) ;
+        }
+        for ( int jj = 1 ; jj < batch_size ; jj += 2 ) {
+            memmgr->delete_var( addrs[jj] ) ;
+        }
+    }
+    return (double)num_cycles * batch_size / elapsed_seconds(start) ;
+}
+
+int main( int argc, char * argv[] ) {
+
+    int num_cycles = (argc > 1) ? atoi(argv[1]) : 200 ;
+    int batch_size = (argc > 2) ? atoi(argv[2]) : 1000 ;
+    const int max_lengths[] = { 1, 8, 64 } ;
+
+    std::cout << num_cycles << " cycles of " << batch_size << " declare_var/delete_var pairs" << std::endl ;
+    for ( int ii = 0 ; ii < 3 ; ii++ ) {
+        Trick::MemoryManager * calloc_mm = new Trick::MemoryManager ;
+        double calloc_rate = alloc_rate( calloc_mm, num_cycles, batch_size, max_lengths[ii] ) ;
+        delete calloc_mm ;
+
+        Trick::MemoryManager * pool_mm = new Trick::MemoryManager ;
+        pool_mm->set_pool_allocation(true) ;
+        double pool_rate = alloc_rate( pool_mm, num_cycles, batch_size, max_lengths[ii] ) ;
+        delete pool_mm ;
+
+        std::cout << "up to " << max_lengths[ii] << " doubles : calloc " << calloc_rate
+                  << ", pooled " << pool_rate << " allocations/sec ("
+                  << pool_rate / calloc_rate << "x)" << std::endl ;
+    }
+    return 0 ;
+}
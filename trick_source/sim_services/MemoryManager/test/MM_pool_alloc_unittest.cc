@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "trick/MemoryManager.hh"
+#include "trick/reference.h"
+#include "MM_test.hh"
+
+/*
+ Test Fixture.
+ */
+class MM_pool_alloc_unittest : public ::testing::Test {
+    protected:
+    Trick::MemoryManager *memmgr;
+    MM_pool_alloc_unittest() { memmgr = new Trick::MemoryManager; }
+    ~MM_pool_alloc_unittest() { delete memmgr;   }
+    void SetUp() {}
+    void TearDown() {}
+};
+
+/* ================================================================================
+                                      Test Cases
+   ================================================================================
+*/
+
+TEST_F(MM_pool_alloc_unittest, pooled_var) {
+
+    memmgr->set_pool_allocation(true) ;
+
+    double *dbl_p = (double*)memmgr->declare_var("double dbl_array[4]");
+    ASSERT_TRUE(dbl_p != NULL);
+
+    // Pooled memory is zeroed and tracked like any other local allocation.
+    for ( int ii = 0 ; ii < 4 ; ii++ ) {
+        EXPECT_EQ(0.0, dbl_p[ii]);
+    }
+    ALLOC_INFO * alloc_info = memmgr->get_alloc_info_of(&dbl_p[2]) ;
+    ASSERT_TRUE(alloc_info != NULL);
+    EXPECT_EQ(TRICK_ALLOC_POOL, alloc_info->alloc_type);
+    EXPECT_EQ(dbl_p, alloc_info->start);
+    EXPECT_EQ(4, alloc_info->num);
+    EXPECT_EQ(1, memmgr->var_exists("dbl_array"));
+
+    // A freed block is handed out again.
+    memmgr->delete_var("dbl_array");
+    EXPECT_EQ(0, memmgr->var_exists("dbl_array"));
+    double *dbl_p2 = (double*)memmgr->declare_var("double dbl_array2[4]");
+    EXPECT_EQ(dbl_p, dbl_p2);
+    EXPECT_EQ(0.0, dbl_p2[0]);
+
+    // Allocations larger than the largest size class still use calloc.
+    double *big_p = (double*)memmgr->declare_var("double big_array[1000]");
+    ASSERT_TRUE(big_p != NULL);
+    EXPECT_EQ(TRICK_ALLOC_MALLOC, memmgr->get_alloc_info_at(big_p)->alloc_type);
+
+    // Resizing moves a pooled array to calloc'ed memory and keeps the contents.
+    dbl_p2[3] = 3.0 ;
+    dbl_p2 = (double*)memmgr->resize_array(dbl_p2, 200);
+    ASSERT_TRUE(dbl_p2 != NULL);
+    EXPECT_EQ(3.0, dbl_p2[3]);
+    EXPECT_EQ(TRICK_ALLOC_MALLOC, memmgr->get_alloc_info_at(dbl_p2)->alloc_type);
+}
+
+TEST_F(MM_pool_alloc_unittest, pooled_vars_do_not_overlap) {
+
+    const int num_vars = 2000 ;
+    std::vector< std::pair<char*, char*> > ranges ;
+
+    memmgr->set_pool_allocation(true) ;
+
+    // Every size class, and enough allocations to need several slabs of each.
+    for ( int ii = 0 ; ii < num_vars ; ii++ ) {
+        int cdims[1] = { 1 + (ii % 64) } ;
+        char * addr = (char*)memmgr->declare_var( TRICK_DOUBLE, "", 0, "", 1, cdims) ;
+        ASSERT_TRUE(addr != NULL);
+        EXPECT_EQ(TRICK_ALLOC_POOL, memmgr->get_alloc_info_at(addr)->alloc_type);
+        // Fill the allocation so that an overlapping neighbor would be caught below.
+        for ( int jj = 0 ; jj < cdims[0] ; jj++ ) {
+            ((double*)addr)[jj] = ii ;
+        }
+        ranges.push_back( std::make_pair( addr, addr + cdims[0] * sizeof(double))) ;
+    }
+
+    std::sort( ranges.begin(), ranges.end()) ;
+    for ( int ii = 1 ; ii < num_vars ; ii++ ) {
+        EXPECT_LE(ranges[ii-1].second, ranges[ii].first);
+    }
+    for ( int ii = 0 ; ii < num_vars ; ii++ ) {
+        double * dbl_p = (double*)ranges[ii].first ;
+        ALLOC_INFO * alloc_info = memmgr->get_alloc_info_at(dbl_p) ;
+        ASSERT_TRUE(alloc_info != NULL);
+        EXPECT_EQ(ranges[ii].second - 1, (char*)alloc_info->end);
+        for ( double * dp = dbl_p ; dp < (double*)ranges[ii].second ; dp++ ) {
+            EXPECT_EQ(dbl_p[0], *dp);
+        }
+    }
+    for ( int ii = 0 ; ii < num_vars ; ii++ ) {
+        EXPECT_EQ(0, memmgr->delete_var((void*)ranges[ii].first));
+    }
+}
+
+TEST_F(MM_pool_alloc_unittest, deleted_blocks_are_reused) {
+
+    const int num_vars = 100 ;
+    std::vector<void*> first ;
+    std::vector<void*> second ;
+
+    memmgr->set_pool_allocation(true) ;
+
+    for ( int ii = 0 ; ii < num_vars ; ii++ ) {
+        int cdims[1] = { 3 } ;
+        first.push_back( memmgr->declare_var( TRICK_INTEGER, "", 0, "", 1, cdims)) ;
+        ((int*)first.back())[1] = ii ;
+    }
+    for ( int ii = 0 ; ii < num_vars ; ii++ ) {
+        memmgr->delete_var( first[ii] ) ;
+    }
+    for ( int ii = 0 ; ii < num_vars ; ii++ ) {
+        int cdims[1] = { 3 } ;
+        second.push_back( memmgr->declare_var( TRICK_INTEGER, "", 0, "", 1, cdims)) ;
+        // Reused blocks are zeroed again.
+        EXPECT_EQ(0, ((int*)second.back())[1]);
+    }
+
+    // The same blocks are handed out again, in some order.
+    std::sort( first.begin(), first.end()) ;
+    std::sort( second.begin(), second.end()) ;
+    EXPECT_TRUE( first == second );
+}
+
+TEST_F(MM_pool_alloc_unittest, ref_attributes_of_pooled_var) {
+
+    REF2 *ref;
+
+    memmgr->set_pool_allocation(true) ;
+
+    double *dbl_p = (double*)memmgr->declare_var("double pooled_dbl[8]");
+    int *int_p = (int*)memmgr->declare_var("int pooled_int");
+    ASSERT_TRUE(dbl_p != NULL);
+    ASSERT_TRUE(int_p != NULL);
+    EXPECT_EQ(TRICK_ALLOC_POOL, memmgr->get_alloc_info_at(dbl_p)->alloc_type);
+    EXPECT_EQ(TRICK_ALLOC_POOL, memmgr->get_alloc_info_at(int_p)->alloc_type);
+
+    ref = memmgr->ref_attributes("pooled_dbl[5]");
+    ASSERT_TRUE(ref != NULL);
+    EXPECT_EQ(&dbl_p[5], ref->address);
+    ASSERT_TRUE(ref->attr != NULL);
+    EXPECT_EQ(TRICK_DOUBLE, ref->attr->type);
+    free( ref);
+
+    ref = memmgr->ref_attributes("pooled_int");
+    ASSERT_TRUE(ref != NULL);
+    EXPECT_EQ(int_p, ref->address);
+    ASSERT_TRUE(ref->attr != NULL);
+    EXPECT_EQ(TRICK_INTEGER, ref->attr->type);
+    free( ref);
+
+    // A name and address found in a recycled block refer to the new variable.
+    memmgr->delete_var("pooled_int");
+    EXPECT_TRUE(memmgr->ref_attributes("pooled_int") == NULL);
+    int *int_p2 = (int*)memmgr->declare_var("int pooled_int2");
+    EXPECT_EQ(int_p, int_p2);
+    EXPECT_EQ(std::string("pooled_int2"), memmgr->ref_name_from_address(int_p2));
+    ref = memmgr->ref_attributes("pooled_int2");
+    ASSERT_TRUE(ref != NULL);
+    EXPECT_EQ(int_p2, ref->address);
+    free( ref);
+}
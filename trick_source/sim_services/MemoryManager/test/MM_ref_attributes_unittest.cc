@@ -1,4 +1,5 @@
 
+#define private public
 #include <gtest/gtest.h>
 #include "MM_test.hh"
 #include "MM_user_defined_types.hh"
@@ -168,3 +169,70 @@ TEST_F(MM_ref_attributes, FailureCases) {
         ASSERT_TRUE(ref == NULL);
 
 }
+
+TEST_F(MM_ref_attributes, CachedReferences) {
+        REF2 *ref;
+
+        double* dbl_p = (double*)memmgr->declare_var("double dbl_array[3]");
+        ASSERT_TRUE(dbl_p != NULL);
+
+        // The first lookup resolves and caches the reference, the second is served from the cache.
+        ref = memmgr->ref_attributes("dbl_array[2]");
+        ASSERT_TRUE(ref != NULL);
+        EXPECT_EQ( &dbl_p[2], ref->address);
+        free( ref);
+
+        ref = memmgr->ref_attributes("dbl_array[2]");
+        ASSERT_TRUE(ref != NULL);
+        EXPECT_EQ( &dbl_p[2], ref->address);
+        EXPECT_STREQ( "dbl_array[2]", ref->reference);
+        free( ref);
+
+        // Resizing the allocation moves it, so the cached reference must be dropped.
+        dbl_p = (double*)memmgr->resize_array("dbl_array", 5);
+        ASSERT_TRUE(dbl_p != NULL);
+        ref = memmgr->ref_attributes("dbl_array[2]");
+        ASSERT_TRUE(ref != NULL);
+        EXPECT_EQ( &dbl_p[2], ref->address);
+        free( ref);
+
+        // Deleting the allocation must also drop the cached reference.
+        memmgr->delete_var("dbl_array");
+        ref = memmgr->ref_attributes("dbl_array[2]");
+        ASSERT_TRUE(ref == NULL);
+}
+
+TEST_F(MM_ref_attributes, CacheIsBounded) {
+        REF2 *ref;
+        char name[32];
+
+        double* dbl_p = (double*)memmgr->declare_var("double dbl_array[100]");
+        ASSERT_TRUE(dbl_p != NULL);
+
+        // Every distinct reference is cached until the limit, then the cache starts over.
+        memmgr->set_ref_cache_max_size(10);
+        for ( int ii = 0 ; ii < 100 ; ii++ ) {
+            snprintf(name, sizeof(name), "dbl_array[%d]", ii);
+            ref = memmgr->ref_attributes(name);
+            ASSERT_TRUE(ref != NULL);
+            EXPECT_EQ( &dbl_p[ii], ref->address);
+            free( ref);
+            EXPECT_LE( memmgr->ref_cache.size(), 10u);
+        }
+        EXPECT_GT( memmgr->ref_cache.size(), 0u);
+
+        // Entries still in the cache give the same answers.
+        ref = memmgr->ref_attributes("dbl_array[99]");
+        ASSERT_TRUE(ref != NULL);
+        EXPECT_EQ( &dbl_p[99], ref->address);
+        free( ref);
+
+        // Shrinking the limit below the number of entries empties the cache.
+        memmgr->set_ref_cache_max_size(0);
+        EXPECT_EQ( memmgr->ref_cache.size(), 0u);
+        ref = memmgr->ref_attributes("dbl_array[3]");
+        ASSERT_TRUE(ref != NULL);
+        EXPECT_EQ( &dbl_p[3], ref->address);
+        free( ref);
+        EXPECT_EQ( memmgr->ref_cache.size(), 0u);
+}
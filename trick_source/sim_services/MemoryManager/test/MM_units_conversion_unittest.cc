@@ -0,0 +1,124 @@
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <string.h>
+#include <udunits2.h>
+#include "trick/UnitsConversion.hh"
+
+/*
+ Test Fixture.
+ */
+class MM_units_conversion_unittest : public ::testing::Test {
+    protected:
+    static ut_system * u_system ;
+    static void SetUpTestCase() {
+        ut_set_error_message_handler(ut_ignore) ;
+        u_system = ut_read_xml( NULL ) ;
+    }
+    static void TearDownTestCase() {
+        ut_free_system(u_system) ;
+    }
+};
+
+ut_system * MM_units_conversion_unittest::u_system = NULL ;
+
+/* ================================================================================
+                                      Test Cases
+   ================================================================================
+*/
+
+TEST_F(MM_units_conversion_unittest, linear) {
+
+    Trick::UnitsConversion conversion ;
+    ASSERT_TRUE(u_system != NULL);
+    EXPECT_TRUE(conversion.is_trivial());
+
+    ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, "ft", "m", conversion));
+    EXPECT_TRUE(conversion.is_affine());
+    EXPECT_FALSE(conversion.is_trivial());
+    EXPECT_DOUBLE_EQ(0.3048, conversion.get_scale());
+    EXPECT_EQ(0.0, conversion.get_offset());
+    EXPECT_DOUBLE_EQ(3.048, conversion.convert(10.0));
+
+    // The second lookup comes from the cache and gives the same conversion.
+    Trick::UnitsConversion cached ;
+    ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, "ft", "m", cached));
+    EXPECT_EQ(conversion.get_scale(), cached.get_scale());
+
+    ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, "m", "m", conversion));
+    EXPECT_TRUE(conversion.is_trivial());
+}
+
+TEST_F(MM_units_conversion_unittest, affine) {
+
+    Trick::UnitsConversion conversion ;
+    ASSERT_TRUE(u_system != NULL);
+    ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, "degC", "K", conversion));
+    EXPECT_TRUE(conversion.is_affine());
+    EXPECT_DOUBLE_EQ(1.0, conversion.get_scale());
+    EXPECT_DOUBLE_EQ(273.15, conversion.get_offset());
+
+    double values[5] = { -273.15, 0.0, 25.0, 100.0, 1000.0 } ;
+    conversion.convert(values, 5) ;
+    EXPECT_NEAR(0.0, values[0], 1.0e-12);
+    EXPECT_DOUBLE_EQ(273.15, values[1]);
+    EXPECT_DOUBLE_EQ(298.15, values[2]);
+    EXPECT_DOUBLE_EQ(373.15, values[3]);
+    EXPECT_DOUBLE_EQ(1273.15, values[4]);
+}
+
+TEST_F(MM_units_conversion_unittest, temperature_offsets) {
+
+    const char * units[][2] = {
+     { "degC", "degF" } , { "degF", "degC" } , { "degF", "K" } , { "K", "degF" } ,
+     { "degC", "degR" } , { "degR", "degC" } , { "K", "degC" } , { "degC", "K" } } ;
+    const double values[] = { -459.67, -273.15, -40.0, -1.0, 0.0, 0.1, 1.0, 32.0, 37.0, 98.6,
+     100.0, 451.0, 1.0e4, 1.0e9 } ;
+
+    ASSERT_TRUE(u_system != NULL);
+    for ( size_t ii = 0 ; ii < sizeof(units)/sizeof(units[0]) ; ii++ ) {
+        Trick::UnitsConversion conversion ;
+        ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, units[ii][0], units[ii][1], conversion));
+        EXPECT_TRUE(conversion.is_affine()) << units[ii][0] << " to " << units[ii][1];
+        EXPECT_NE(0.0, conversion.get_offset()) << units[ii][0] << " to " << units[ii][1];
+
+        ut_unit * from = ut_parse(u_system, units[ii][0], UT_ASCII) ;
+        ut_unit * to = ut_parse(u_system, units[ii][1], UT_ASCII) ;
+        cv_converter * cv = ut_get_converter(from, to) ;
+        ASSERT_TRUE(cv != NULL);
+
+        // The scale and offset give the udunits values, and the array and scalar paths agree.
+        double converted[sizeof(values)/sizeof(double)] ;
+        memcpy(converted, values, sizeof(values)) ;
+        conversion.convert(converted, sizeof(values)/sizeof(double)) ;
+        for ( size_t jj = 0 ; jj < sizeof(values)/sizeof(double) ; jj++ ) {
+            double expected = cv_convert_double(cv, values[jj]) ;
+            EXPECT_NEAR(expected, conversion.convert(values[jj]), 1.0e-12 * fmax(1.0, fabs(expected)))
+             << values[jj] << " " << units[ii][0] << " to " << units[ii][1];
+            EXPECT_EQ(conversion.convert(values[jj]), converted[jj]);
+        }
+        cv_free(cv) ;
+        ut_free(from) ;
+        ut_free(to) ;
+    }
+
+    // Known values, so that an offset applied before rather than after the scale is caught.
+    Trick::UnitsConversion c_to_f ;
+    ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, "degC", "degF", c_to_f));
+    EXPECT_DOUBLE_EQ(32.0, c_to_f.convert(0.0));
+    EXPECT_DOUBLE_EQ(212.0, c_to_f.convert(100.0));
+    EXPECT_DOUBLE_EQ(-40.0, c_to_f.convert(-40.0));
+    Trick::UnitsConversion f_to_k ;
+    ASSERT_EQ(0, Trick::UnitsConversion::get(u_system, "degF", "K", f_to_k));
+    EXPECT_NEAR(0.0, f_to_k.convert(-459.67), 1.0e-12);
+    EXPECT_NEAR(273.15, f_to_k.convert(32.0), 1.0e-12);
+}
+
+TEST_F(MM_units_conversion_unittest, errors) {
+
+    Trick::UnitsConversion conversion ;
+    ASSERT_TRUE(u_system != NULL);
+    EXPECT_EQ(-1, Trick::UnitsConversion::get(u_system, "not_a_unit", "m", conversion));
+    EXPECT_EQ(-2, Trick::UnitsConversion::get(u_system, "m", "not_a_unit", conversion));
+    EXPECT_EQ(-3, Trick::UnitsConversion::get(u_system, "m", "s", conversion));
+}
@@ -41,6 +41,21 @@ int Trick::MessageFile::init() {
     return(0) ;
 }
 
+/**
+@details
+-# If the file is open
+   -# Close it, leaving the file in the previous output directory as it is
+   -# Call init to open a new file in the current output directory
+*/
+int Trick::MessageFile::reopen() {
+
+    if ( out_stream.is_open() ) {
+        out_stream.close() ;
+        init() ;
+    }
+    return(0) ;
+}
+
 /**
 @details
 -# If enabled and level < 100
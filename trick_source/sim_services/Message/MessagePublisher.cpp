@@ -75,6 +75,18 @@ int Trick::MessagePublisher::publish(int level , std::string message) {
 
 }
 
+int Trick::MessagePublisher::reopen() {
+
+    /** @par Design Details: */
+    std::list<Trick::MessageSubscriber *>::iterator p ;
+
+    /** @li Call reopen of every subscriber. */
+    for ( p = subscribers.begin() ; p != subscribers.end() ; p++ ) {
+        (*p)->reopen() ;
+    }
+    return(0) ;
+}
+
 Trick::MessageSubscriber * Trick::MessagePublisher::getSubscriber( std::string sub_name ) {
     std::list<Trick::MessageSubscriber *>::iterator lit ;
     for ( lit = subscribers.begin() ; lit != subscribers.end() ; lit++ ) {
@@ -108,3 +108,15 @@ extern "C" int vsend_hs(FILE * fp __attribute__ ((unused)), const char * format_
     return (0);
 }
 
+
+/**
+ @relates Trick::MessagePublisher
+ @copydoc Trick::MessagePublisher::reopen
+ */
+extern "C" int message_reopen(void) {
+
+    if (the_message_publisher != NULL) {
+        the_message_publisher->reopen() ;
+    }
+    return (0);
+}
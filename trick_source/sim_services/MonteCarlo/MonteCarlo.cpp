@@ -10,11 +10,16 @@ Trick::MonteCarlo::MonteCarlo() :
     custom_slave_dispatch(false),
     timeout(120),
     max_tries(2),
+    max_pending_runs(2),
+    branch_time(0),
     verbosity(MC_INFORMATIONAL),
     num_runs(0),
     actual_num_runs(0),
     num_results(0),
     slave_id(0),
+    post_run_data_read(0),
+    branch_job(NULL),
+    sample_job(NULL),
     except_return(0)
 {
     the_mc = this;
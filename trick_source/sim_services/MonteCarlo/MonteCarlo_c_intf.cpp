@@ -91,6 +91,32 @@ extern "C" unsigned int mc_get_max_tries(void) {
     return 0 ;
 }
 
+extern "C" void mc_set_max_pending_runs(unsigned int max_pending_runs) {
+    if ( the_mc != NULL ) {
+        the_mc->set_max_pending_runs(max_pending_runs);
+    }
+}
+
+extern "C" unsigned int mc_get_max_pending_runs(void) {
+    if ( the_mc != NULL ) {
+        return the_mc->get_max_pending_runs();
+    }
+    return 0 ;
+}
+
+extern "C" void mc_set_branch_time(double branch_time) {
+    if ( the_mc != NULL ) {
+        the_mc->set_branch_time(branch_time);
+    }
+}
+
+extern "C" double mc_get_branch_time(void) {
+    if ( the_mc != NULL ) {
+        return the_mc->get_branch_time();
+    }
+    return 0.0 ;
+}
+
 extern "C" void mc_set_user_cmd_string(const char *user_cmd_string) {
     if ( the_mc != NULL ) {
         the_mc->set_user_cmd_string(std::string(user_cmd_string ? user_cmd_string : ""));
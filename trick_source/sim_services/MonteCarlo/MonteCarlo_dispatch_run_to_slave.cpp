@@ -8,57 +8,90 @@
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
 
+/**
+ * @par Detailed Design:
+ * Runs are written to the slave's persistent connection, where they queue until the slave is ready for them, so a
+ * slave with a run pending starts it as soon as it finishes the one before.
+ */
 void Trick::MonteCarlo::dispatch_run_to_slave(MonteRun *run, MonteSlave *slave) {
     if (slave && run) {
         current_run = run->id;
         if (prepare_run(run) == -1) {
             return;
         }
-        slave->state = MonteSlave::MC_RUNNING;
-        connection_device.hostname = (char*)slave->machine_name.c_str();
-        connection_device.port = slave->port;
-        if (tc_connect(&connection_device) == TC_SUCCESS) {
-            std::stringstream buffer_stream;
-            buffer_stream << slave_output_directory << "/RUN_" << std::setw(5) << std::setfill('0') << run->id;
-            std::string buffer = "";
-            for (std::vector<std::string>::size_type j = 0; j < run->variables.size(); ++j) {
+        std::stringstream buffer_stream;
+        buffer_stream << slave_output_directory << "/RUN_" << std::setw(5) << std::setfill('0') << run->id;
+        std::string output_dir = buffer_stream.str();
+
+        /**
+         * <ul><li> Send each value that is a plain number as the variable's index, the value's type, and its bits,
+         * so that the slave can assign it directly. Any other assignment is sent as input processor text.
+         */
+        std::string values;
+        std::string buffer = "";
+        int num_values = 0;
+        for (std::vector<std::string>::size_type j = 0; j < run->variables.size(); ++j) {
+            int type;
+            unsigned long long bits;
+            if (j < run->values.size() && run->variables[j] == assignment_text(*variables[j], run->values[j]) &&
+              parse_number(run->values[j], type, bits)) {
+                int record[4];
+                record[0] = htonl(j);
+                record[1] = htonl(type);
+                record[2] = htonl((unsigned int)(bits >> 32));
+                record[3] = htonl((unsigned int)bits);
+                values.append((char *)record, sizeof(record));
+                ++num_values;
+            } else {
                 buffer += run->variables[j] + "\n";
             }
-            buffer += std::string("trick.set_output_dir(\"") + buffer_stream.str() + std::string("\")\n");
-            buffer_stream.str("");
-            buffer_stream << run->id ;
-            buffer += std::string("trick.mc_set_current_run(") + buffer_stream.str() + std::string(")\n");
+        }
 
-            if (verbosity >= MC_INFORMATIONAL) {
-                message_publish(MSG_INFO, "Monte [Master] Dispatching run %d to %s:%d.\n",
-		     run->id, slave->machine_name.c_str(), slave->id) ;
-            }
+        if (verbosity >= MC_INFORMATIONAL) {
+            message_publish(MSG_INFO, "Monte [Master] Dispatching run %d to %s:%d.\n",
+                 run->id, slave->machine_name.c_str(), slave->id) ;
+        }
+
+        /** <li> Write the command, the run's id, its values, its output directory and its text in one piece. */
+        int header[5];
+        header[0] = htonl(MonteSlave::MC_PROCESS_RUN);
+        header[1] = htonl(run->id);
+        header[2] = htonl(num_values);
+        header[3] = htonl(output_dir.length());
+        header[4] = htonl(buffer.length());
+        std::string message((char *)header, sizeof(header));
+        message += values;
+        message += output_dir;
+        message += buffer;
 
-            int command = htonl(MonteSlave::MC_PROCESS_RUN);
-            tc_write(&connection_device, (char *)&command, (int)sizeof(command));
-            int num_bytes = htonl(buffer.length());
-            tc_write(&connection_device, (char*)&num_bytes, (int)sizeof(num_bytes));
-            tc_write(&connection_device, (char*)buffer.c_str(), (int)buffer.length());
+        slave->pending_runs.push_back(run);
+        if (tc_write(&slave->connection, (char *)message.data(), (int)message.length()) != (int)message.length()) {
+            /** <li> If the connection has been lost, the run is queued again with any others pending on the slave. */
+            set_disconnected_state(*slave);
+            return;
+        }
 
-            if (verbosity >= MC_ALL) {
-                message_publish(MSG_INFO, "Parameterization of run %d :\n%s\n", run->id, buffer.c_str()) ;
+        if (verbosity >= MC_ALL) {
+            std::string parameterization = "";
+            for (std::vector<std::string>::size_type j = 0; j < run->variables.size(); ++j) {
+                parameterization += run->variables[j] + "\n";
             }
+            message_publish(MSG_INFO, "Parameterization of run %d :\n%s\n", run->id, parameterization.c_str()) ;
+        }
 
-            tc_disconnect(&connection_device);
+        ++slave->num_dispatches;
+        ++run->num_tries;
 
-            ++slave->num_dispatches;
+        /**
+         * <li> If the slave was idle, the run starts now. Otherwise it starts when the slave returns the results of
+         * the runs ahead of it. </ul>
+         */
+        if (slave->pending_runs.size() == 1) {
             slave->current_run = run;
-
             struct timeval time_val;
             gettimeofday(&time_val, NULL);
             run->start_time = time_val.tv_sec + (double)time_val.tv_usec / 1000000;
-            ++run->num_tries;
-        } else {
-            slave->state = Trick::MonteSlave::MC_DISCONNECTED;
-            if (verbosity >= MC_ERROR) {
-                message_publish(MSG_ERROR, "Monte [Master] Failed to connect to %s:%d to dispatch run.\n",
-                                slave->machine_name.c_str(), slave->id) ;
-            }
         }
+        slave->state = MonteSlave::MC_RUNNING;
     }
 }
@@ -1,7 +1,11 @@
 
+#include <math.h>
 #include <sys/resource.h>
 
 #include "trick/MonteCarlo.hh"
+#include "trick/TrickConstant.hh"
+#include "trick/data_record_proto.h"
+#include "trick/exec_proto.h"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
 
@@ -17,8 +21,78 @@ int Trick::MonteCarlo::execute_monte() {
             master();
         } else {
             slave_init();
+            /** A slave that branches connects to the master from the #branch job once it reaches #branch_time. */
+            if (branch_time > 0) {
+                return(0);
+            }
+            slave_connect();
             execute_as_slave();
         }
     }
     return(0);
 }
+
+/**
+ * @par Detailed Design:
+ * Every run that a slave forks at #branch_time shares the simulation up to that time, which the slave ran only once,
+ * rather than running it again itself.
+ */
+int Trick::MonteCarlo::branch() {
+
+    /** <ul><li> Unless this is a slave that branches, this job is not called again. */
+    if (!enabled || !is_slave() || branch_time <= 0) {
+        branch_job->next_tics = TRICK_MAX_LONG_LONG;
+        return(0);
+    }
+
+    /** <li> Until #branch_time, wait for it. */
+    long long branch_tics = (long long)round(branch_time * exec_get_time_tic_value());
+    if (exec_get_time_tics() < branch_tics) {
+        branch_job->next_tics = branch_tics;
+        return(0);
+    }
+    branch_job->next_tics = TRICK_MAX_LONG_LONG;
+
+    /**
+     * <li> Only the calling thread is part of a forked process. A simulation with child threads cannot continue in
+     * one, and data recording must stop its writer thread and write out its groups first. Integration loops that
+     * call their jobs on several threads start new worker threads in each run's process, so they need no check.
+     */
+    if (exec_get_num_threads() > 1) {
+        if (verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Runs cannot branch from a simulation with child threads.\nTerminating.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        exit(-1);
+    }
+    if (dr_prepare_fork() != 0) {
+        if (verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Runs cannot branch while recording data in a format that cannot be forked.\nTerminating.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        exit(-1);
+    }
+
+    /**
+     * <li> Resolve the variables and results again. Those resolved by #slave_init refer to the allocations as they
+     * were at initialization, which the simulation may have since deleted, resized or repointed.
+     */
+    resolve_variable_references();
+    resolve_results();
+
+    /**
+     * <li> Connect to the master only now, so that no run is dispatched while the slave is simulating up to
+     * #branch_time, where it would count towards the run's #timeout.
+     */
+    slave_connect();
+
+    /**
+     * <li> Process runs. This returns only in a run's child process, which starts data recording and the message
+     * files again in the run's output directory and continues the simulation from #branch_time. Files written once
+     * at initialization, such as S_job_execution and S_run_summary, stay in the slave's output directory. </ul>
+     */
+    execute_as_slave();
+    dr_reopen();
+    message_reopen();
+    return(0);
+}
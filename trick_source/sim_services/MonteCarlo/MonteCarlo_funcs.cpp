@@ -1,4 +1,10 @@
 
+#include <algorithm>
+#include <ctype.h>
+#include <errno.h>
+#include <set>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 
 #include "trick/MonteCarlo.hh"
@@ -8,6 +14,7 @@
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
 #include "trick/exec_proto.h"
+#include "trick/parameter_types.h"
 
 extern Trick::Executive * the_exec ;
 
@@ -73,6 +80,30 @@ unsigned int Trick::MonteCarlo::get_max_tries() {
     return max_tries;
 }
 
+void Trick::MonteCarlo::set_max_pending_runs(unsigned int in_max_pending_runs) {
+    this->max_pending_runs = in_max_pending_runs > 0 ? in_max_pending_runs : 1;
+}
+
+unsigned int Trick::MonteCarlo::get_max_pending_runs() {
+    return max_pending_runs;
+}
+
+void Trick::MonteCarlo::set_branch_time(double in_branch_time) {
+    this->branch_time = in_branch_time > 0 ? in_branch_time : 0;
+}
+
+double Trick::MonteCarlo::get_branch_time() {
+    return branch_time;
+}
+
+void Trick::MonteCarlo::set_branch_job(Trick::JobData * in_branch_job) {
+    this->branch_job = in_branch_job;
+}
+
+void Trick::MonteCarlo::set_sample_job(Trick::JobData * in_sample_job) {
+    this->sample_job = in_sample_job;
+}
+
 void Trick::MonteCarlo::set_user_cmd_string(std::string in_user_cmd_string) {
     this->user_cmd_string = in_user_cmd_string;
 }
@@ -196,6 +227,21 @@ const std::vector<Trick::MonteVar*>& Trick::MonteCarlo::get_variables() {
     return variables;
 }
 
+void Trick::MonteCarlo::add_result(Trick::MonteResult *result) {
+    for (std::vector<Trick::MonteResult *>::const_iterator i = results.begin(); i != results.end(); ++i) {
+        if ( (*i)->name.compare(result->name) == 0 ) {
+            message_publish(MSG_WARNING, "Monte WARNING: Cannot add new MonteResult \"%s\", result of that name already exists.\n",
+                    result->name.c_str() );
+            return;
+        }
+    }
+    results.push_back(result);
+}
+
+const std::vector<Trick::MonteResult*>& Trick::MonteCarlo::get_results() {
+    return results;
+}
+
 void Trick::MonteCarlo::add_slave(std::string in_machine_name) {
     add_slave(new MonteSlave(in_machine_name));
 }
@@ -292,26 +338,28 @@ int Trick::MonteCarlo::process_sim_args() {
 
 /** @par Detailed Design: */
 int Trick::MonteCarlo::shutdown() {
-    /** <ul><li> If this is a slave, run the shutdown jobs. */
+    /**
+     * <ul><li> If this is a slave, run the post run jobs, sample the final values of the #results, and return the
+     * exit status, with anything the jobs wrote and the values of the results, over the connection to the master.
+     * The connection is shared with the slave, which processes its next run over it, so it is left open.
+     */
     if (enabled && is_slave()) {
-        connection_device.port = master_port;
-        if (tc_connect(&connection_device) == TC_SUCCESS) {
-            int exit_status = the_exec->get_except_return() ? MonteRun::MC_RUN_FAILED : MonteRun::MC_RUN_COMPLETE;
-            if (verbosity >= MC_ALL) {
-                message_publish(MSG_INFO, "Monte [%s:%d] Sending run exit status to master: %d\n",
-                                machine_name.c_str(), slave_id, exit_status) ;
+        MonteRun::ExitStatus exit_status = the_exec->get_except_return() ? MonteRun::MC_RUN_FAILED : MonteRun::MC_RUN_COMPLETE;
+        run_queue(&slave_post_queue, "in slave_post queue");
+        for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+            if (results[i]->interval == 0 && results[i]->ref2 != NULL) {
+                results[i]->sample();
             }
-            int id = htonl(slave_id);
-            tc_write(&connection_device, (char*)&id, (int)sizeof(id));
-            exit_status = htonl(exit_status);
-            tc_write(&connection_device, (char*)&exit_status, (int)sizeof(exit_status));
-            run_queue(&slave_post_queue, "in slave_post queue");
-            tc_disconnect(&connection_device);
-        } else {
+        }
+        if (verbosity >= MC_ALL) {
+            message_publish(MSG_INFO, "Monte [%s:%d] Sending run exit status to master: %d\n",
+                            machine_name.c_str(), slave_id, exit_status) ;
+        }
+        if (slave_send_result(current_run, exit_status) != 0) {
             if (verbosity >= MC_ERROR)
                 message_publish(
                   MSG_ERROR,
-                  "Monte [%s:%d] Failed to connect to master.\n",
+                  "Monte [%s:%d] Failed to return results to master.\n",
                   machine_name.c_str(), slave_id);
         }
     }
@@ -378,8 +426,11 @@ void Trick::MonteCarlo::check_timeouts() {
                     message_publish(MSG_ERROR, "Monte [Master] %s:%d has not responded for run %d.\n",
                                     slaves[i]->machine_name.c_str(), slaves[i]->id, slaves[i]->current_run->id) ;
                 }
+                dequeue_run(slaves[i]->current_run);
                 handle_retry(*slaves[i], MonteRun::MC_RUN_TIMED_OUT);
             }
+            /** <li> The runs queued behind it may never be reached, so queue them for other slaves. */
+            requeue_pending_runs(*slaves[i]);
             /** </ul><li> Update the slave's state. */
             slaves[i]->state = slaves[i]->state == MonteSlave::MC_RUNNING ?
                MonteSlave::MC_UNRESPONSIVE_RUNNING : MonteSlave::MC_UNRESPONSIVE_STOPPING;
@@ -388,12 +439,15 @@ void Trick::MonteCarlo::check_timeouts() {
 }
 
 Trick::MonteSlave * Trick::MonteCarlo::get_ready_slave() {
+    MonteSlave *ready_slave = NULL;
     for (std::vector<Trick::MonteSlave>::size_type i = 0; i < slaves.size(); ++i) {
-        if (slaves[i]->state == Trick::MonteSlave::MC_READY) {
-            return slaves[i];
+        if ((slaves[i]->state == Trick::MonteSlave::MC_READY || slaves[i]->state == Trick::MonteSlave::MC_RUNNING) &&
+          slaves[i]->pending_runs.size() < max_pending_runs &&
+          (!ready_slave || slaves[i]->pending_runs.size() < ready_slave->pending_runs.size())) {
+            ready_slave = slaves[i];
         }
     }
-    return NULL;
+    return ready_slave;
 }
 
 Trick::MonteSlave* Trick::MonteCarlo::get_slave(unsigned int id) {
@@ -450,6 +504,7 @@ int  Trick::MonteCarlo::prepare_run(MonteRun *curr_run) {
                 set_num_runs(curr_run->id);
                 return -1;
             }
+            curr_run->values.push_back(variables[i]->value);
         }
         /** <li> Create the data file </ul>*/
         fprintf(run_data_file, "%05u\t", curr_run->id);
@@ -466,6 +521,86 @@ int  Trick::MonteCarlo::prepare_run(MonteRun *curr_run) {
     return 0;
 }
 
+std::string Trick::MonteCarlo::assignment_text(const MonteVar &variable, const std::string &value) {
+    if (variable.unit.empty()) {
+        return variable.name + std::string(" = ") + value;
+    }
+    return variable.name + std::string(" = trick.attach_units(\"") + variable.unit + std::string("\", ") + value +
+           std::string(")");
+}
+
+/**
+ * @par Detailed Design:
+ * Accepts an optional sign followed by the digits of an integer, or of a decimal floating point number with an
+ * optional exponent, with optional surrounding white space. Anything else, including integers with leading zeros and
+ * numbers out of range, is left to the input processor so that it reports the same errors it always has.
+ */
+bool Trick::MonteCarlo::parse_number(const std::string &value, int &type, unsigned long long &bits) {
+    std::string::size_type first = value.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return false;
+    }
+    std::string::size_type last = value.find_last_not_of(" \t");
+    std::string number = value.substr(first, last - first + 1);
+
+    const char *cp = number.c_str();
+    if (*cp == '+' || *cp == '-') {
+        ++cp;
+    }
+    const char *digits = cp;
+    while (isdigit((unsigned char)*cp)) {
+        ++cp;
+    }
+    int num_digits = cp - digits;
+    if (*cp == '\0') {
+        if (num_digits == 0 || (digits[0] == '0' && strspn(digits, "0") != (size_t)num_digits)) {
+            return false;
+        }
+        errno = 0;
+        long long integer = strtoll(number.c_str(), NULL, 10);
+        if (errno != 0) {
+            return false;
+        }
+        type = TRICK_LONG_LONG;
+        bits = (unsigned long long)integer;
+        return true;
+    }
+    if (*cp == '.') {
+        ++cp;
+        const char *fraction = cp;
+        while (isdigit((unsigned char)*cp)) {
+            ++cp;
+        }
+        num_digits += cp - fraction;
+    }
+    if (num_digits == 0) {
+        return false;
+    }
+    if (*cp == 'e' || *cp == 'E') {
+        ++cp;
+        if (*cp == '+' || *cp == '-') {
+            ++cp;
+        }
+        if (!isdigit((unsigned char)*cp)) {
+            return false;
+        }
+        while (isdigit((unsigned char)*cp)) {
+            ++cp;
+        }
+    }
+    if (*cp != '\0') {
+        return false;
+    }
+    errno = 0;
+    double real = strtod(number.c_str(), NULL);
+    if (errno != 0) {
+        return false;
+    }
+    type = TRICK_DOUBLE;
+    memcpy(&bits, &real, sizeof(bits));
+    return true;
+}
+
 void Trick::MonteCarlo::dequeue_run(MonteRun *curr_run) {
     for (std::deque<MonteRun *>::size_type i = 0; i < runs.size(); ++i) {
         if (curr_run == runs[i]) {
@@ -474,6 +609,10 @@ void Trick::MonteCarlo::dequeue_run(MonteRun *curr_run) {
     }
 }
 
+bool Trick::MonteCarlo::is_queued(MonteRun *curr_run) {
+    return std::find(runs.begin(), runs.end(), curr_run) != runs.end();
+}
+
 /**
  * @par Detailed Design:
  * Since the Variable Server is unable to access elements within the standard template objects, the data contained in
@@ -503,12 +642,20 @@ void Trick::MonteCarlo::update_actual_num_runs() {
             ++actual_num_runs;
         }
     }
-    /** <li> Add one for every currently dispatched run. */
+    /**
+     * <li> Add one for every unresolved run dispatched to a slave that is not also on the queue. A run requeued after
+     * a timeout may be pending on more than one slave, so each is counted once.
+     */
+    std::set<MonteRun *> dispatched_runs;
     for (std::vector<MonteSlave *>::size_type i = 0; i < slaves.size(); ++i) {
-        if (slaves[i]->state == MonteSlave::MC_RUNNING || slaves[i]->state == MonteSlave::MC_STOPPING) {
-            ++actual_num_runs;
+        for (std::deque<MonteRun *>::size_type j = 0; j < slaves[i]->pending_runs.size(); ++j) {
+            MonteRun *run = slaves[i]->pending_runs[j];
+            if (run->exit_status == MonteRun::MC_RUN_INCOMPLETE && !is_queued(run)) {
+                dispatched_runs.insert(run);
+            }
         }
     }
+    actual_num_runs += dispatched_runs.size();
 }
 
 bool Trick::MonteCarlo::equals_ignore_case(std::string string1, std::string string2) {
@@ -621,10 +768,40 @@ int Trick::MonteCarlo::write_s_job_execution(FILE *fp) {
     return 0;
 }
 
+/**
+ * @par Detailed Design:
+ * The data is held until the post run jobs finish, then returned with the run's exit status.
+ */
 int Trick::MonteCarlo::write(char* data, int size) {
-    return tc_write(&connection_device, data, size);
+    if (is_master()) {
+        if (verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [Master] Only a slave's post run jobs may write data to the master.\n") ;
+        }
+        return -1;
+    }
+    if (size <= 0) {
+        return 0;
+    }
+    post_run_data.append(data, size);
+    return size;
 }
 
+/**
+ * @par Detailed Design:
+ * Reads from the data returned with the run's exit status, at most as much as remains.
+ */
 int Trick::MonteCarlo::read(char* data, int size) {
-    return tc_read(&connection_device, data, size);
+    if (is_slave()) {
+        if (verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Only the master's post run jobs may read data from a slave.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        return -1;
+    }
+    if (size <= 0) {
+        return 0;
+    }
+    std::string::size_type num_bytes = post_run_data.copy(data, size, post_run_data_read);
+    post_run_data_read += num_bytes;
+    return (int)num_bytes;
 }
@@ -31,8 +31,15 @@ int Trick::MonteCarlo::master() {
             /** <li> Check to see if any dispatched units have timed out. */
             check_timeouts();
 
-            /** <li> Dispatch the next run to a ready slave. </ul> */
-            dispatch_run_to_slave(get_next_dispatch(), get_ready_slave());
+            /**
+             * <li> Dispatch runs to ready slaves until every slave has #max_pending_runs or there are no more
+             * runs. </ul>
+             */
+            MonteSlave *slave;
+            MonteRun *run;
+            while ((slave = get_ready_slave()) && (run = get_next_dispatch())) {
+                dispatch_run_to_slave(run, slave);
+            }
         }
     } catch (Trick::ExecutiveException & ex ) {
 
@@ -95,3 +95,19 @@ void Trick::MonteCarlo::write_to_run_files(std::string file_name)
         fprintf(run_header_file, "trick_mc.mc.add_variable(var%zu)\n", i);
     }
 }
+
+void Trick::MonteCarlo::write_results() {
+    if (results.empty()) {
+        return;
+    }
+    FILE *file_ptr;
+    if (open_file(run_directory + std::string("/monte_results"), &file_ptr) == -1) {
+        return;
+    }
+    fprintf(file_ptr, "# Statistics of the results of %zu completed runs\n\n",
+            num_results - failed_runs.size() - error_runs.size());
+    for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+        results[i]->write(file_ptr);
+    }
+    fclose(file_ptr);
+}
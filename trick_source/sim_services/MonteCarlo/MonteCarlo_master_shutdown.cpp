@@ -37,6 +37,9 @@ void Trick::MonteCarlo::master_shutdown() {
     print_statistics(&stdout) ;
     fclose(file_ptr) ;
 
+    /** <li> Write the statistics of the results. */
+    write_results() ;
+
     if ( !except_return and failed_runs.size() > 0 ) {
         except_return = -2 ;
     }
@@ -52,11 +55,9 @@ void Trick::MonteCarlo::shutdown_slaves() {
 
     for (std::vector<MonteSlave *>::size_type i = 0; i < slaves.size() ; ++i) {
         slaves[i]->state = MonteSlave::MC_FINISHED;
-        connection_device.hostname = (char*)slaves[i]->machine_name.c_str();
-        connection_device.port = slaves[i]->port;
-        if (tc_connect(&connection_device) == TC_SUCCESS) {
+        if (slaves[i]->connection.socket != TRICKCOMM_INVALID_SOCKET) {
             int command = htonl(MonteSlave::MC_SHUTDOWN);
-            tc_write(&connection_device, (char*)&command, sizeof(command));
+            tc_write(&slaves[i]->connection, (char*)&command, sizeof(command));
         }
     }
 }
@@ -1,3 +1,8 @@
+
+#include <string.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
 #include "trick/MonteCarlo.hh"
 #include "trick/message_proto.h"
 #include "trick/message_type.h"
@@ -5,10 +10,31 @@
 
 /**
  * @par Detailed Design:
- * This function performs a non-blocking accept on the listening socket.
+ * This function waits briefly for a newly started slave to connect or for a slave to return results over its
+ * connection, so that the master does not spin while the slaves work.
  */
 void Trick::MonteCarlo::receive_results() {
 
+    /** <ul><li> Wait on the listening socket and every slave's connection. */
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(listen_device.socket, &read_fds);
+    int max_fd = listen_device.socket;
+    for (std::vector<MonteSlave *>::size_type i = 0; i < slaves.size(); ++i) {
+        if (slaves[i]->connection.socket != TRICKCOMM_INVALID_SOCKET) {
+            FD_SET(slaves[i]->connection.socket, &read_fds);
+            if (slaves[i]->connection.socket > max_fd) {
+                max_fd = slaves[i]->connection.socket;
+            }
+        }
+    }
+    struct timeval wait_time;
+    wait_time.tv_sec = 0;
+    wait_time.tv_usec = 100000;
+    if (select(max_fd + 1, &read_fds, NULL, NULL, &wait_time) <= 0) {
+        return;
+    }
+
     /** <li> While there are pending connections: */
     while (tc_accept(&listen_device, &connection_device) == TC_SUCCESS) {
 
@@ -23,19 +49,29 @@ void Trick::MonteCarlo::receive_results() {
               "Monte [Master] Slave returned an invalid id (%d)\n",
               id) ;
             tc_disconnect(&connection_device);
-            return;
+            continue;
+        }
+        if (slave->state != MonteSlave::MC_INITIALIZING) {
+            message_publish(
+              MSG_ERROR,
+              "Monte [Master] %s:%d connected again after initialization. Ignoring.\n",
+              slave->machine_name.c_str(), slave->id) ;
+            tc_disconnect(&connection_device);
+            continue;
         }
 
         /**
-         * <li> If the slave is in the MC_INITIALIZING state, it is sending us the
-         * machine name and port over which it is listening for new runs.
+         * <li> The slave is sending us the machine name on which it is running. Its connection is kept for
+         * dispatching runs. </ul>
          */
-        if (slave->state == MonteSlave::MC_INITIALIZING) {
-            handle_initialization(*slave);
-        }
-        /** <li> Otherwise, it's sending us run data. */
-        else {
-            handle_run_data(*slave);
+        handle_initialization(*slave);
+    }
+
+    /** <li> Receive results from every slave whose connection has them. </ul> */
+    for (std::vector<MonteSlave *>::size_type i = 0; i < slaves.size(); ++i) {
+        if (slaves[i]->connection.socket != TRICKCOMM_INVALID_SOCKET &&
+          FD_ISSET(slaves[i]->connection.socket, &read_fds)) {
+            handle_run_data(*slaves[i]);
         }
     }
 }
@@ -63,25 +99,75 @@ void Trick::MonteCarlo::handle_initialization(Trick::MonteSlave& slave) {
         }
         slave.machine_name = std::string(name);
 
-        size = (int)sizeof(slave.port);
-        if (tc_read(&connection_device, (char*)&slave.port, size) != size) {
-            set_disconnected_state(slave) ;
-            return;
-        }
-        slave.port = ntohl(slave.port);
-
+        tc_dev_copy(&slave.connection, &connection_device);
+        connection_device.socket = TRICKCOMM_INVALID_SOCKET;
         slave.state = MonteSlave::MC_READY;
-        tc_disconnect(&connection_device);
 }
 
 void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
+    /**
+     * <ul><li> Read the run's id, its exit status, the data written by the slave's post run jobs, and the values of
+     * the #results.
+     */
+    int header[4];
+    if (tc_read(&slave.connection, (char*)header, (int)sizeof(header)) != (int)sizeof(header)) {
+        set_disconnected_state(slave);
+        return;
+    }
+    unsigned int run_id = ntohl(header[0]);
+    int exit_status = ntohl(header[1]);
+    int size = ntohl(header[2]);
+    int values_size = ntohl(header[3]);
+    post_run_data.resize(size > 0 ? size : 0);
+    post_run_data_read = 0;
+    if (size > 0 && tc_read(&slave.connection, &post_run_data[0], size) != size) {
+        set_disconnected_state(slave);
+        return;
+    }
+    std::string values(values_size > 0 ? values_size : 0, '\0');
+    if (values_size > 0 && tc_read(&slave.connection, &values[0], values_size) != values_size) {
+        set_disconnected_state(slave);
+        return;
+    }
+
+    /**
+     * <li> The slave processes its runs in the order they were dispatched. Any run ahead of this one returned no
+     * results, its child having exited without reporting, so it is retried as though it had timed out.
+     */
+    while (!slave.pending_runs.empty() && slave.pending_runs.front()->id != run_id) {
+        slave.current_run = slave.pending_runs.front();
+        slave.pending_runs.pop_front();
+        if (slave.current_run->exit_status == MonteRun::MC_RUN_INCOMPLETE) {
+            if (verbosity >= MC_ERROR) {
+                message_publish(MSG_ERROR, "Monte [Master] %s:%d returned no results for run %d.\n",
+                                slave.machine_name.c_str(), slave.id, slave.current_run->id) ;
+            }
+            dequeue_run(slave.current_run);
+            handle_retry(slave, MonteRun::MC_RUN_TIMED_OUT);
+        }
+        if (!slave.pending_runs.empty()) {
+            struct timeval time_val;
+            gettimeofday(&time_val, NULL);
+            slave.pending_runs.front()->start_time = time_val.tv_sec + (double)time_val.tv_usec / 1000000;
+        }
+    }
+    if (slave.pending_runs.empty()) {
+        if (verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [Master] %s:%d returned results for run %d, which it was not dispatched.\n",
+                            slave.machine_name.c_str(), slave.id, run_id) ;
+        }
+        set_disconnected_state(slave);
+        return;
+    }
+    slave.current_run = slave.pending_runs.front();
+
     if (verbosity >= MC_INFORMATIONAL) {
         message_publish(MSG_INFO, "Monte [Master] Receiving results for run %d from %s:%d.\n",
              slave.current_run->id, slave.machine_name.c_str(), slave.id) ;
     }
 
     /**
-     * <ul><li> Try to remove this run from the queue in case it was requeued by #check_timeouts.
+     * <li> Try to remove this run from the queue in case it was requeued by #check_timeouts.
      * This covers the case in which the master determines that a slave has timed out, requeues
      * the run, and then the slave reports results.
      */
@@ -93,10 +179,6 @@ void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
      * discard these results.
      */
     if (slave.current_run->exit_status != MonteRun::MC_RUN_INCOMPLETE) {
-        // TODO: If a slave times out or core dumps in it's monte_slave_post
-        // jobs, the master will receive a MC_RUN_COMPLETE status from the slave's
-        // child process and then an error status from the parent, rendering
-        // this message incorrect.
         if (verbosity >= MC_ALL) {
             message_publish(
               MSG_INFO,
@@ -105,18 +187,18 @@ void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
         }
     } else {
         /** <li> Otherwise, check the exit status: */
-        int exit_status;
-        int size = sizeof(exit_status);
-        if (tc_read(&connection_device, (char*)&exit_status, size) != size) {
-            set_disconnected_state(slave) ;
-            return;
-        }
-        exit_status = ntohl(exit_status);
-
         switch (exit_status) {
 
             case MonteRun::MC_RUN_COMPLETE:
             case MonteRun::MC_RUN_FAILED:
+                /** <ul><li> Only the results of runs that completed are reduced. </ul> */
+                if (exit_status == MonteRun::MC_RUN_COMPLETE && reduce_results(values) != 0 &&
+                  verbosity >= MC_ERROR) {
+                    message_publish(
+                      MSG_ERROR,
+                      "Monte [Master] %s:%d returned malformed results for run %d. Ignoring them.\n",
+                      slave.machine_name.c_str(), slave.id, slave.current_run->id) ;
+                }
                 resolve_run(slave, static_cast<MonteRun::ExitStatus>(exit_status));
                 run_queue(&master_post_queue, "in master_post queue") ;
                 break;
@@ -172,14 +254,23 @@ void Trick::MonteCarlo::handle_run_data(Trick::MonteSlave& slave) {
                 break;
         }
     }
-    
-    tc_disconnect(&connection_device);
+    slave.pending_runs.pop_front();
+    post_run_data.clear();
+    post_run_data_read = 0;
+
+    /** <li> The slave has gone on to its next run, if it has one. */
+    if (!slave.pending_runs.empty()) {
+        slave.current_run = slave.pending_runs.front();
+        struct timeval time_val;
+        gettimeofday(&time_val, NULL);
+        slave.current_run->start_time = time_val.tv_sec + (double)time_val.tv_usec / 1000000;
+    }
 
-    /** <li> Update the slave's state. */
+    /** <li> Update the slave's state. </ul> */
     if (slave.state == MonteSlave::MC_RUNNING || slave.state == MonteSlave::MC_UNRESPONSIVE_RUNNING) {
-        slave.state = MonteSlave::MC_READY;
+        slave.state = slave.pending_runs.empty() ? MonteSlave::MC_READY : MonteSlave::MC_RUNNING;
     } else if (slave.state == MonteSlave::MC_STOPPING || slave.state == MonteSlave::MC_UNRESPONSIVE_STOPPING) {
-        slave.state = MonteSlave::MC_STOPPED;
+        slave.state = slave.pending_runs.empty() ? MonteSlave::MC_STOPPED : MonteSlave::MC_STOPPING;
     }
 }
 
@@ -189,5 +280,65 @@ void Trick::MonteCarlo::set_disconnected_state(Trick::MonteSlave& slave) {
         message_publish(MSG_ERROR, "Monte [Master] Lost connection to %s:%d.\n",
                         slave.machine_name.c_str(), slave.id) ;
     }
-    tc_disconnect(&connection_device);
+    /** Close the slave's connection or, if it was lost while initializing, the one being accepted. */
+    if (slave.connection.socket != TRICKCOMM_INVALID_SOCKET) {
+        tc_disconnect(&slave.connection);
+    } else {
+        tc_disconnect(&connection_device);
+    }
+    requeue_pending_runs(slave);
+    slave.pending_runs.clear();
+}
+
+/**
+ * @par Detailed Design:
+ * Runs already on the queue, or already resolved by another slave, are left alone.
+ */
+void Trick::MonteCarlo::requeue_pending_runs(Trick::MonteSlave& slave) {
+    for (std::deque<MonteRun *>::size_type i = 0; i < slave.pending_runs.size(); ++i) {
+        MonteRun *run = slave.pending_runs[i];
+        if (run->exit_status == MonteRun::MC_RUN_INCOMPLETE && !is_queued(run)) {
+            if (verbosity >= MC_ERROR) {
+                message_publish(MSG_ERROR, "Monte [Master] Queueing run %d for dispatch to another slave.\n", run->id) ;
+            }
+            runs.push_back(run);
+        }
+    }
+}
+
+/**
+ * @par Detailed Design:
+ * The values of every result are decoded before any is added, so that malformed data adds none.
+ */
+int Trick::MonteCarlo::reduce_results(const std::string &data) {
+    std::vector< std::vector<double> > run_samples(results.size());
+    std::string::size_type offset = 0;
+    for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+        int count;
+        if (data.length() - offset < sizeof(count)) {
+            return -1;
+        }
+        memcpy(&count, data.data() + offset, sizeof(count));
+        offset += sizeof(count);
+        count = ntohl(count);
+        if (count < 0 || (data.length() - offset) / (2 * sizeof(int)) < (std::string::size_type)count) {
+            return -1;
+        }
+        run_samples[i].resize(count);
+        for (int j = 0; j < count; ++j) {
+            int words[2];
+            memcpy(words, data.data() + offset, sizeof(words));
+            offset += sizeof(words);
+            unsigned long long bits = ((unsigned long long)(unsigned int)ntohl(words[0]) << 32) |
+                                      (unsigned int)ntohl(words[1]);
+            memcpy(&run_samples[i][j], &bits, sizeof(bits));
+        }
+    }
+    if (offset != data.length()) {
+        return -1;
+    }
+    for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+        results[i]->add_run(run_samples[i]);
+    }
+    return 0;
 }
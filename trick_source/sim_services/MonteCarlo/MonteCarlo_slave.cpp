@@ -13,18 +13,14 @@ int Trick::MonteCarlo::execute_as_slave() {
             message_publish(MSG_INFO, "Monte [%s:%d] Waiting for new run.\n",
                             machine_name.c_str(), slave_id) ;
         }
-        /** <ul><li> On a blocking read, wait for a MonteSlave::Command from the master. */
-        if (tc_accept(&listen_device, &connection_device) != TC_SUCCESS) {
-            if (verbosity >= MC_ERROR) {
-                message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master. Shutting down.\n",
-                                machine_name.c_str(), slave_id) ;
-            }
-            slave_shutdown();
-        }
+        /**
+         * <ul><li> On a blocking read, wait for a MonteSlave::Command from the master. Runs the master has queued
+         * ahead are read as soon as the previous one finishes.
+         */
         int command;
         if (tc_read(&connection_device, (char *)&command, (int)sizeof(command)) != (int)sizeof(command)) {
             if (verbosity >= MC_ERROR) {
-                message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master while receiving instructions. Shutting down.\n",
+                message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master. Shutting down.\n",
                                 machine_name.c_str(), slave_id) ;
             }
             slave_shutdown();
@@ -1,5 +1,18 @@
 
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "trick/MonteCarlo.hh"
+#include "trick/TrickConstant.hh"
+#include "trick/UdUnits.hh"
+#include "trick/exec_proto.h"
+#include "trick/memorymanager_c_intf.h"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+#include "trick/parameter_types.h"
+#include "trick/tc_proto.h"
 
 /** @par Detailed Design: */
 void Trick::MonteCarlo::slave_shutdown() {
@@ -31,7 +44,220 @@ void Trick::MonteCarlo::slave_kill_run() {
     sigaction(SIGTERM, &restore, NULL);
 }
 
+/**
+ * @par Detailed Design:
+ * The result is framed as the run's id, its exit status, and the lengths of the post run data and the values of the
+ * #results, followed by the data and the values, and written in one piece. The values of each result are its number
+ * of samples followed by the bits of each, high word first.
+ */
+int Trick::MonteCarlo::slave_send_result(unsigned int run_id, MonteRun::ExitStatus exit_status) {
+    std::string values;
+    for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+        const std::vector<double> &samples = results[i]->samples;
+        int count = htonl(samples.size());
+        values.append((char *)&count, sizeof(count));
+        for (std::vector<double>::size_type j = 0; j < samples.size(); ++j) {
+            unsigned long long bits;
+            memcpy(&bits, &samples[j], sizeof(bits));
+            int words[2];
+            words[0] = htonl((unsigned int)(bits >> 32));
+            words[1] = htonl((unsigned int)bits);
+            values.append((char *)words, sizeof(words));
+        }
+    }
+
+    int header[4];
+    header[0] = htonl(run_id);
+    header[1] = htonl(exit_status);
+    header[2] = htonl(post_run_data.length());
+    header[3] = htonl(values.length());
+    std::string message((char *)header, sizeof(header));
+    message += post_run_data;
+    message += values;
+    post_run_data.clear();
+    if (tc_write(&connection_device, (char *)message.data(), (int)message.length()) != (int)message.length()) {
+        return -1;
+    }
+    return 0;
+}
+
+/** @par Detailed Design: */
+void Trick::MonteCarlo::resolve_variable_references() {
+    /** <ul><li> Free the references of any earlier resolution. */
+    for (std::vector<MonteVarReference>::size_type i = 0; i < variable_references.size(); ++i) {
+        if (variable_references[i].ref2 != NULL) {
+            ref_free(variable_references[i].ref2);
+            free(variable_references[i].ref2);
+        }
+    }
+    variable_references.clear();
+    variable_references.resize(variables.size());
+    for (std::vector<MonteVar *>::size_type i = 0; i < variables.size(); ++i) {
+        /** <li> Only variables that name a single integer, floating point or boolean value are resolved. */
+        REF2 *ref2 = ref_attributes(variables[i]->name.c_str());
+        if (ref2 == NULL) {
+            continue;
+        }
+        bool resolved = ref2->attr != NULL && ref2->num_index == ref2->attr->num_index;
+        if (resolved) {
+            switch (ref2->attr->type) {
+                case TRICK_SHORT:
+                case TRICK_UNSIGNED_SHORT:
+                case TRICK_INTEGER:
+                case TRICK_UNSIGNED_INTEGER:
+                case TRICK_LONG:
+                case TRICK_UNSIGNED_LONG:
+                case TRICK_LONG_LONG:
+                case TRICK_UNSIGNED_LONG_LONG:
+                case TRICK_FLOAT:
+                case TRICK_DOUBLE:
+                case TRICK_BOOLEAN:
+                    break;
+                default:
+                    resolved = false;
+                    break;
+            }
+        }
+        /** <li> Look up the conversion from the Monte Carlo variable's units, if it has any. </ul> */
+        if (resolved && !variables[i]->unit.empty()) {
+            resolved = ref2->attr->units != NULL &&
+              UnitsConversion::get(UdUnits::get_u_system(), variables[i]->unit, ref2->attr->units,
+                                   variable_references[i].conversion) == 0;
+        }
+        if (resolved) {
+            variable_references[i].ref2 = ref2;
+        } else {
+            ref_free(ref2);
+            free(ref2);
+        }
+    }
+}
+
+/**
+ * @par Detailed Design:
+ * Values are converted to the variable's type as the input processor converts them. Each value's assignment is also
+ * formed as the master would have sent it, for the run's monte_input file, with doubles given the fewest digits that
+ * read back exactly.
+ */
+int Trick::MonteCarlo::assign_variable(unsigned int index, int type, unsigned long long bits,
+  std::string &assignment) {
+    if (index >= variables.size()) {
+        return -1;
+    }
+
+    long long integer = (long long)bits;
+    double real;
+    char text[32];
+    if (type == TRICK_LONG_LONG) {
+        real = (double)integer;
+        snprintf(text, sizeof(text), "%lld", integer);
+    } else {
+        memcpy(&real, &bits, sizeof(real));
+        for (int precision = 15; precision <= 17; ++precision) {
+            snprintf(text, sizeof(text), "%.*g", precision, real);
+            if (strtod(text, NULL) == real) {
+                break;
+            }
+        }
+        if (strpbrk(text, ".e") == NULL) {
+            strcat(text, ".0");
+        }
+    }
+    assignment = assignment_text(*variables[index], text);
+
+    if (index >= variable_references.size() || variable_references[index].ref2 == NULL) {
+        return 1;
+    }
+
+    REF2 *ref2 = variable_references[index].ref2;
+    const UnitsConversion &conversion = variable_references[index].conversion;
+    bool is_integer = type == TRICK_LONG_LONG;
+    if (!conversion.is_trivial()) {
+        real = conversion.convert(real);
+        is_integer = false;
+    }
+    switch (ref2->attr->type) {
+        case TRICK_SHORT:
+            *(short *)ref2->address = is_integer ? (short)integer : (short)real;
+            break;
+        case TRICK_UNSIGNED_SHORT:
+            *(unsigned short *)ref2->address = is_integer ? (unsigned short)integer : (unsigned short)real;
+            break;
+        case TRICK_INTEGER:
+            *(int *)ref2->address = is_integer ? (int)integer : (int)real;
+            break;
+        case TRICK_UNSIGNED_INTEGER:
+            *(unsigned int *)ref2->address = is_integer ? (unsigned int)integer : (unsigned int)real;
+            break;
+        case TRICK_LONG:
+            *(long *)ref2->address = is_integer ? (long)integer : (long)real;
+            break;
+        case TRICK_UNSIGNED_LONG:
+            *(unsigned long *)ref2->address = is_integer ? (unsigned long)integer : (unsigned long)real;
+            break;
+        case TRICK_LONG_LONG:
+            *(long long *)ref2->address = is_integer ? integer : (long long)real;
+            break;
+        case TRICK_UNSIGNED_LONG_LONG:
+            *(unsigned long long *)ref2->address = is_integer ? (unsigned long long)integer : (unsigned long long)real;
+            break;
+        case TRICK_FLOAT:
+            *(float *)ref2->address = (float)real;
+            break;
+        case TRICK_DOUBLE:
+            *(double *)ref2->address = real;
+            break;
+        case TRICK_BOOLEAN:
+            *(bool *)ref2->address = is_integer ? integer != 0 : real != 0.0;
+            break;
+        default:
+            return 1;
+    }
+    return 0;
+}
+
 /** @par Detailed Design: */
 void Trick::MonteSlave::set_S_main_name(std::string name) {
     S_main_name = name;
 }
+
+/** @par Detailed Design: */
+void Trick::MonteCarlo::resolve_results() {
+    /** <ul><li> A result whose variable is not a single number is returned with no values. </ul> */
+    for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+        if (!results[i]->resolve() && verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Result %s is not a single number and will not be returned.\n",
+                            machine_name.c_str(), slave_id, results[i]->name.c_str()) ;
+        }
+    }
+}
+
+/**
+ * @par Detailed Design:
+ * Sample k of a result is taken at k times its interval. A slave that branches samples the results up to
+ * #branch_time once, and its runs inherit those samples.
+ */
+int Trick::MonteCarlo::sample_results() {
+
+    /** <ul><li> Unless this is a slave, this job is not called again. */
+    long long next_tics = TRICK_MAX_LONG_LONG;
+    if (enabled && is_slave()) {
+        /** <li> Sample each periodic result that is due, and schedule the next sample of any result. </ul> */
+        long long time_tics = exec_get_time_tics();
+        int tic_value = exec_get_time_tic_value();
+        for (std::vector<MonteResult *>::size_type i = 0; i < results.size(); ++i) {
+            MonteResult *result = results[i];
+            if (result->interval > 0 && result->ref2 != NULL) {
+                long long due_tics;
+                while ((due_tics = (long long)round(result->samples.size() * result->interval * tic_value)) <= time_tics) {
+                    result->sample();
+                }
+                if (due_tics < next_tics) {
+                    next_tics = due_tics;
+                }
+            }
+        }
+    }
+    sample_job->next_tics = next_tics;
+    return 0;
+}
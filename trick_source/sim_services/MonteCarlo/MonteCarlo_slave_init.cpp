@@ -26,13 +26,22 @@ int Trick::MonteCarlo::slave_init() {
     /** <li> Run the slave initialization jobs. */
     run_queue(&slave_init_queue, "in slave_init queue") ;
 
-    /** <li> Initialize the sockets. */
-    tc_error(&listen_device, 0);
-    tc_error(&connection_device, 0);
-    tc_init(&listen_device);
-    listen_device.disable_handshaking = TC_COMM_TRUE;
+    /** <li> Resolve the variables so that the values of each run can be assigned directly. */
+    resolve_variable_references();
+
+    /** <li> Resolve the results so that they can be sampled. </ul> */
+    resolve_results();
 
-    /** <li> Connect to the master and write the port over which we are listening for new runs. */
+    return 0;
+}
+
+/** @par Detailed Design: */
+int Trick::MonteCarlo::slave_connect() {
+    /**
+     * <ul><li> Connect to the master and write the name of our machine. The connection stays open: runs are
+     * dispatched and their results returned over it. </ul>
+     */
+    tc_error(&connection_device, 0);
     connection_device.port = master_port;
     if (tc_connect(&connection_device) != TC_SUCCESS) {
         if (verbosity >= MC_ERROR) {
@@ -56,9 +65,6 @@ int Trick::MonteCarlo::slave_init() {
     int num_bytes = htonl(strlen(hostname));
     tc_write(&connection_device, (char *)&num_bytes, (int)sizeof(num_bytes));
     tc_write(&connection_device, hostname, strlen(hostname));
-    int listen_port = htonl(listen_device.port);
-    tc_write(&connection_device, (char *)&listen_port, (int)sizeof(listen_port));
-    tc_disconnect(&connection_device);
 
     return 0;
 }
@@ -13,25 +13,39 @@
 
 /** @par Detailed Design: */
 int Trick::MonteCarlo::slave_process_run() {
-    int size;
-    /** <ul><li> Read the length of the incoming message. */
-    if (tc_read(&connection_device, (char *)&size, (int)sizeof(size)) != (int)sizeof(size) || (size = ntohl(size)) < 0) {
+    /**
+     * <ul><li> Read the id of the run, the number of values, and the lengths of the output directory and the input
+     * processor text.
+     */
+    int header[4];
+    if (tc_read(&connection_device, (char *)header, (int)sizeof(header)) != (int)sizeof(header)) {
         if (verbosity >= MC_ERROR) {
             message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master while receiving new run.\nShutting down.\n",
                             machine_name.c_str(), slave_id) ;
         }
         slave_shutdown();
     }
-    char *input = new char[size + 1];
-    /** <li> Read the incoming message. */
-    if (tc_read(&connection_device, input, size) != size) {
+    int num_values = ntohl(header[1]);
+    int dir_size = ntohl(header[2]);
+    int size = ntohl(header[3]);
+    if (num_values < 0 || dir_size < 0 || size < 0) {
+        if (verbosity >= MC_ERROR) {
+            message_publish(MSG_ERROR, "Monte [%s:%d] Received a malformed run from Master.\nShutting down.\n",
+                            machine_name.c_str(), slave_id) ;
+        }
+        slave_shutdown();
+    }
+    /** <li> Read the values, the output directory and the text. */
+    int value_size = num_values * 4 * (int)sizeof(int);
+    std::string input(value_size + dir_size + size, '\0');
+    if (!input.empty() && tc_read(&connection_device, &input[0], (int)input.length()) != (int)input.length()) {
         if (verbosity >= MC_ERROR) {
             message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master while receiving new run.\nShutting down.\n",
                             machine_name.c_str(), slave_id) ;
         }
         slave_shutdown();
     }
-    tc_disconnect(&connection_device);
+    current_run = ntohl(header[0]);
 
     /**
      * <li> fork() a child process to execute the simulation.
@@ -75,34 +89,55 @@ int Trick::MonteCarlo::slave_process_run() {
             message_publish(MSG_ERROR, "Monte [%s:%d] Run killed by signal %d: %s\n",
                             machine_name.c_str(), slave_id, signal, strsignal(signal)) ;
         }
-        connection_device.port = master_port;
-        if (tc_connect(&connection_device) != TC_SUCCESS) {
+        if (verbosity >= MC_ALL) {
+            message_publish(MSG_INFO, "Monte [%s:%d] Sending run exit status to master %d.\n",
+                            machine_name.c_str(), slave_id, exit_status) ;
+        }
+        /** <li> Write the child's exit status to the master. </ul> */
+        if (slave_send_result(current_run, exit_status) != 0) {
             if (verbosity >= MC_ERROR) {
                 message_publish(MSG_ERROR, "Monte [%s:%d] Lost connection to Master before results could be returned.\nShutting down.\n",
                                 machine_name.c_str(), slave_id) ;
             }
             slave_shutdown();
         }
-        if (verbosity >= MC_ALL) {
-            message_publish(MSG_INFO, "Monte [%s:%d] Sending run exit status to master %d.\n",
-                            machine_name.c_str(), slave_id, exit_status) ;
-        }
-        /** <li> Write the slaves id to the master. </ul> */
-        int id = htonl(slave_id);
-        tc_write(&connection_device, (char *)&id, (int)sizeof(id));
-        /** <li> Write the child's exit status to the master. </ul> */
-        return_value = htonl(exit_status);
-        tc_write(&connection_device, (char *)&return_value, (int)sizeof(return_value));
-        tc_disconnect(&connection_device);
         return 0;
     /** <li> Child process: */
     } else {
-        input[size] = '\0';
-        if ( ip_parse(input) != 0 ) {
+        /**
+         * <ul><li> Assign the values, keeping their assignments for the monte_input file. Values of variables that
+         * could not be resolved are assigned by the input processor along with the rest of the text.
+         */
+        std::string assignments = "";
+        std::string text = "";
+        const int *records = (const int *)input.data();
+        for (int i = 0; i < num_values; ++i) {
+            unsigned long long bits = ((unsigned long long)(unsigned int)ntohl(records[4 * i + 2]) << 32) |
+                                      (unsigned int)ntohl(records[4 * i + 3]);
+            std::string assignment;
+            int status = assign_variable(ntohl(records[4 * i]), ntohl(records[4 * i + 1]), bits, assignment);
+            if (status == -1) {
+                if (verbosity >= MC_ERROR) {
+                    message_publish(MSG_ERROR, "Monte [%s:%d] Received a value for variable %d, but only %d variables were added.\n",
+                                    machine_name.c_str(), slave_id, ntohl(records[4 * i]), (int)variables.size()) ;
+                }
+                exit(MonteRun::MC_PROBLEM_PARSING_INPUT);
+            }
+            if (status == 1) {
+                text += assignment + "\n";
+            }
+            assignments += assignment + "\n";
+        }
+        text += input.substr(value_size + dir_size);
+        assignments += input.substr(value_size + dir_size);
+        std::string run_output_dir = input.substr(value_size, dir_size);
+
+        if (!text.empty() && ip_parse(text.c_str()) != 0) {
             exit(MonteRun::MC_PROBLEM_PARSING_INPUT);
         }
+        set_output_dir(run_output_dir.c_str());
 
-        /** <ul><li> Create the run directory. */
+        /** <li> Create the run directory. */
         std::string output_dir = command_line_args_get_output_dir();
         if (access(output_dir.c_str(), F_OK) != 0) {
             if (mkdir(output_dir.c_str(), 0775) == -1) {
@@ -110,6 +145,10 @@ int Trick::MonteCarlo::slave_process_run() {
             }
         }
 
+        /**
+         * <li> Write the monte_input file, which runs this run stand alone. The values of a run that branched are
+         * assigned at #branch_time, as they were here.
+         */
         std::stringstream ss_monte_input;
         ss_monte_input << output_dir << "/monte_input";
         FILE *fp = fopen(ss_monte_input.str().c_str(), "w");
@@ -122,9 +161,14 @@ int Trick::MonteCarlo::slave_process_run() {
         fprintf(fp, "else:\n");
         fprintf(fp, "    execfile(\"%s\")\n\n", command_line_args_get_input_file());
         fprintf(fp, "trick.mc_set_enabled(0)\n");
-        fprintf(fp, "%s" , input);
+        if (branch_time > 0) {
+            fprintf(fp, "trick.add_read(%.15g, \"\"\"\n%s\"\"\")\n", branch_time, assignments.c_str());
+        } else {
+            fprintf(fp, "%s" , assignments.c_str());
+        }
+        fprintf(fp, "trick.set_output_dir(\"%s\")\n", run_output_dir.c_str());
+        fprintf(fp, "trick.mc_set_current_run(%d)\n", current_run);
         fclose(fp);
-        delete [] input;
 
         /** <li> redirect stdout and stderr to files in the run directory */
         std::stringstream ss_stdout;
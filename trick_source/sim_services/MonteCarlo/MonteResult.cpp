@@ -0,0 +1,296 @@
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#include "trick/MonteResult.hh"
+#include "trick/memorymanager_c_intf.h"
+#include "trick/message_proto.h"
+#include "trick/message_type.h"
+#include "trick/parameter_types.h"
+
+Trick::MonteQuantile::MonteQuantile(double in_probability) :
+    probability(in_probability),
+    count(0)
+{
+    for (int i = 0; i < 5; ++i) {
+        heights[i] = positions[i] = desired[i] = 0;
+    }
+}
+
+/**
+ * @par Detailed Design:
+ * The markers hold the least value, the greatest, the quantile, and the quantiles halfway between it and each
+ * extreme. Each is moved towards its desired position by a piecewise-parabolic estimate of its height.
+ */
+void Trick::MonteQuantile::add(double value) {
+
+    /** <ul><li> The first five values are kept in order. */
+    if (count < 5) {
+        int i = count++;
+        for (; i > 0 && heights[i - 1] > value; --i) {
+            heights[i] = heights[i - 1];
+        }
+        heights[i] = value;
+        if (count == 5) {
+            for (i = 0; i < 5; ++i) {
+                positions[i] = i;
+            }
+            desired[0] = 0;
+            desired[1] = 2 * probability;
+            desired[2] = 4 * probability;
+            desired[3] = 2 + 2 * probability;
+            desired[4] = 4;
+        }
+        return;
+    }
+    ++count;
+
+    /** <li> Find the cell the value falls in, extending the extremes if need be, and move the markers above it. */
+    int k;
+    if (value < heights[0]) {
+        heights[0] = value;
+        k = 0;
+    } else if (value >= heights[4]) {
+        heights[4] = value;
+        k = 3;
+    } else {
+        for (k = 0; value >= heights[k + 1]; ++k) {
+        }
+    }
+    for (int i = k + 1; i < 5; ++i) {
+        positions[i] += 1;
+    }
+    desired[1] += probability / 2;
+    desired[2] += probability;
+    desired[3] += (1 + probability) / 2;
+    desired[4] += 1;
+
+    /** <li> Move each middle marker that is a position or more from where it should be by one. </ul> */
+    for (int i = 1; i < 4; ++i) {
+        double d = desired[i] - positions[i];
+        if ((d >= 1 && positions[i + 1] - positions[i] > 1) || (d <= -1 && positions[i - 1] - positions[i] < -1)) {
+            int step = d > 0 ? 1 : -1;
+            double height = heights[i] + step / (positions[i + 1] - positions[i - 1]) *
+              ((positions[i] - positions[i - 1] + step) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i]) +
+               (positions[i + 1] - positions[i] - step) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+            if (heights[i - 1] < height && height < heights[i + 1]) {
+                heights[i] = height;
+            } else {
+                heights[i] += step * (heights[i + step] - heights[i]) / (positions[i + step] - positions[i]);
+            }
+            positions[i] += step;
+        }
+    }
+}
+
+double Trick::MonteQuantile::get_value() const {
+    if (count == 0) {
+        return 0;
+    }
+    if (count < 5) {
+        double index = probability * (count - 1);
+        int lower = (int)index;
+        if (lower + 1 >= (int)count) {
+            return heights[count - 1];
+        }
+        return heights[lower] + (index - lower) * (heights[lower + 1] - heights[lower]);
+    }
+    return heights[2];
+}
+
+Trick::MonteResultBin::MonteResultBin(const MonteResult &result) :
+    count(0),
+    mean(0),
+    m2(0),
+    min(0),
+    max(0)
+{
+    quantiles.push_back(MonteQuantile(0.05));
+    quantiles.push_back(MonteQuantile(0.5));
+    quantiles.push_back(MonteQuantile(0.95));
+    if (result.num_histogram_bins > 0) {
+        histogram.resize(result.num_histogram_bins + 2, 0);
+    }
+}
+
+void Trick::MonteResultBin::add(double value, const MonteResult &result) {
+    /** Welford's method keeps the mean and variance accurate without keeping the values. */
+    ++count;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    if (count == 1 || value < min) {
+        min = value;
+    }
+    if (count == 1 || value > max) {
+        max = value;
+    }
+    for (std::vector<MonteQuantile>::size_type i = 0; i < quantiles.size(); ++i) {
+        quantiles[i].add(value);
+    }
+    if (!histogram.empty()) {
+        unsigned int bin;
+        if (value < result.histogram_min) {
+            bin = 0;
+        } else if (value >= result.histogram_max) {
+            bin = result.num_histogram_bins + 1;
+        } else {
+            bin = 1 + (unsigned int)((value - result.histogram_min) / (result.histogram_max - result.histogram_min) *
+                                     result.num_histogram_bins);
+            bin = std::min(bin, result.num_histogram_bins);
+        }
+        ++histogram[bin];
+    }
+}
+
+double Trick::MonteResultBin::get_variance() const {
+    return count > 1 ? m2 / (count - 1) : 0;
+}
+
+Trick::MonteResult::MonteResult(std::string in_name, double in_interval) :
+    name(in_name),
+    interval(in_interval > 0 ? in_interval : 0),
+    histogram_min(0),
+    histogram_max(0),
+    num_histogram_bins(0),
+    ref2(NULL)
+{
+}
+
+Trick::MonteResult::~MonteResult() {
+    if (ref2) {
+        ref_free(ref2);
+        free(ref2);
+    }
+}
+
+void Trick::MonteResult::set_histogram(double in_min, double in_max, unsigned int in_num_bins) {
+    if (in_num_bins > 0 && !(in_max > in_min)) {
+        message_publish(MSG_ERROR, "Monte : The histogram of %s must have a maximum greater than its minimum.\n",
+                        name.c_str()) ;
+        return;
+    }
+    histogram_min = in_min;
+    histogram_max = in_max;
+    num_histogram_bins = in_num_bins;
+}
+
+/** @par Detailed Design: */
+bool Trick::MonteResult::resolve() {
+    /** <ul><li> Free the reference of any earlier resolution. */
+    if (ref2) {
+        ref_free(ref2);
+        free(ref2);
+    }
+    /** <li> Only a single integer, floating point or boolean value can be sampled. </ul> */
+    ref2 = ref_attributes(name.c_str());
+    if (ref2 == NULL) {
+        return false;
+    }
+    bool resolved = ref2->attr != NULL && ref2->num_index == ref2->attr->num_index;
+    if (resolved) {
+        switch (ref2->attr->type) {
+            case TRICK_SHORT:
+            case TRICK_UNSIGNED_SHORT:
+            case TRICK_INTEGER:
+            case TRICK_UNSIGNED_INTEGER:
+            case TRICK_LONG:
+            case TRICK_UNSIGNED_LONG:
+            case TRICK_LONG_LONG:
+            case TRICK_UNSIGNED_LONG_LONG:
+            case TRICK_FLOAT:
+            case TRICK_DOUBLE:
+            case TRICK_BOOLEAN:
+                break;
+            default:
+                resolved = false;
+                break;
+        }
+    }
+    if (!resolved) {
+        ref_free(ref2);
+        free(ref2);
+        ref2 = NULL;
+    }
+    return resolved;
+}
+
+void Trick::MonteResult::sample() {
+    if (ref2->pointer_present == 1) {
+        ref2->address = follow_address_path(ref2);
+    }
+    double value;
+    void *address = ref2->address;
+    switch (ref2->attr->type) {
+        case TRICK_SHORT:              value = *(short *)address; break;
+        case TRICK_UNSIGNED_SHORT:     value = *(unsigned short *)address; break;
+        case TRICK_INTEGER:            value = *(int *)address; break;
+        case TRICK_UNSIGNED_INTEGER:   value = *(unsigned int *)address; break;
+        case TRICK_LONG:               value = *(long *)address; break;
+        case TRICK_UNSIGNED_LONG:      value = *(unsigned long *)address; break;
+        case TRICK_LONG_LONG:          value = *(long long *)address; break;
+        case TRICK_UNSIGNED_LONG_LONG: value = *(unsigned long long *)address; break;
+        case TRICK_FLOAT:              value = *(float *)address; break;
+        case TRICK_BOOLEAN:            value = *(bool *)address; break;
+        default:                       value = *(double *)address; break;
+    }
+    samples.push_back(value);
+}
+
+/**
+ * @par Detailed Design:
+ * A value that is not a number is not counted, as it would make every statistic of its time not a number.
+ */
+void Trick::MonteResult::add_run(const std::vector<double> &run_samples) {
+    for (std::vector<double>::size_type i = 0; i < run_samples.size(); ++i) {
+        if (i == bins.size()) {
+            bins.push_back(MonteResultBin(*this));
+        }
+        if (run_samples[i] == run_samples[i]) {
+            bins[i].add(run_samples[i], *this);
+        }
+    }
+}
+
+/**
+ * @par Detailed Design:
+ * Each result is written as a comment naming it, followed by a line of statistics for each sample time, or a single
+ * line for its final value.
+ */
+void Trick::MonteResult::write(FILE *fp) {
+    std::string units = "--";
+    REF2 *units_ref = ref_attributes(name.c_str());
+    if (units_ref != NULL) {
+        if (units_ref->attr != NULL && units_ref->attr->units != NULL) {
+            units = units_ref->attr->units;
+        }
+        ref_free(units_ref);
+        free(units_ref);
+    }
+
+    fprintf(fp, "# %s {%s}", name.c_str(), units.c_str());
+    if (num_histogram_bins > 0) {
+        fprintf(fp, " histogram %.15g to %.15g in %u bins", histogram_min, histogram_max, num_histogram_bins);
+    }
+    fprintf(fp, "\n# time count mean std_dev min max p05 p50 p95%s\n",
+            num_histogram_bins > 0 ? " below bins... above" : "");
+
+    for (std::vector<MonteResultBin>::size_type i = 0; i < bins.size(); ++i) {
+        const MonteResultBin &bin = bins[i];
+        if (interval > 0) {
+            fprintf(fp, "%.15g", i * interval);
+        } else {
+            fprintf(fp, "final");
+        }
+        fprintf(fp, " %u %.15g %.15g %.15g %.15g", bin.count, bin.mean, sqrt(bin.get_variance()), bin.min, bin.max);
+        for (std::vector<MonteQuantile>::size_type j = 0; j < bin.quantiles.size(); ++j) {
+            fprintf(fp, " %.15g", bin.quantiles[j].get_value());
+        }
+        for (std::vector<unsigned int>::size_type j = 0; j < bin.histogram.size(); ++j) {
+            fprintf(fp, " %u", bin.histogram[j]);
+        }
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "\n");
+}
@@ -2,9 +2,11 @@
 #define protected public
 
 #include <iostream>
+#include <arpa/inet.h>
 #include <sys/types.h>
 #include <signal.h>
 #include <string>
+#include <string.h>
 #include <sstream>
 #include <cmath>
 
@@ -24,6 +26,8 @@
 #include "trick/MemoryManager.hh"
 #include "trick/memorymanager_c_intf.h"
 #include "trick/rand_generator.h"
+#include "trick/parameter_types.h"
+#include "trick/TrickConstant.hh"
 //#include "trick/RequirementScribe.hh"
 
 void sig_hand(int sig) ;
@@ -245,6 +249,8 @@ TEST_F(MonteCarloTest , TestDefaultValues) {
     EXPECT_EQ(exec.get_custom_slave_dispatch(), false) ;
     EXPECT_EQ(exec.get_timeout(), 120) ;
     EXPECT_EQ(exec.get_max_tries(), 2) ;
+    EXPECT_EQ(exec.get_max_pending_runs(), 2) ;
+    EXPECT_EQ(exec.get_branch_time(), 0) ;
     EXPECT_EQ(exec.get_verbosity(), exec.MC_INFORMATIONAL) ;
     EXPECT_EQ(exec.get_num_runs(), 0) ;
     EXPECT_EQ(exec.get_slave_id(), 0) ;
@@ -268,6 +274,14 @@ TEST_F(MonteCarloTest, TestSettingValues) {
     EXPECT_EQ(exec.get_timeout(), 60) ;
     exec.set_max_tries(4) ;
     EXPECT_EQ(exec.get_max_tries(), 4) ;
+    exec.set_max_pending_runs(3) ;
+    EXPECT_EQ(exec.get_max_pending_runs(), 3) ;
+    exec.set_max_pending_runs(0) ;
+    EXPECT_EQ(exec.get_max_pending_runs(), 1) ;
+    exec.set_branch_time(10800) ;
+    EXPECT_EQ(exec.get_branch_time(), 10800) ;
+    exec.set_branch_time(-1) ;
+    EXPECT_EQ(exec.get_branch_time(), 0) ;
     exec.set_verbosity(exec.MC_NONE) ;
     EXPECT_EQ(exec.get_verbosity(), exec.MC_NONE) ;
     exec.set_verbosity(exec.MC_ERROR) ;
@@ -318,6 +332,306 @@ TEST_F(MonteCarloTest, TestSlaves) {
     EXPECT_EQ(slave1.machine_name, "WonderWoman") ;
 }
 
+TEST_F(MonteCarloTest, TestPendingRuns) {
+
+    Trick::MonteSlave slave0("localhost") ;
+    Trick::MonteSlave slave1("WonderWoman") ;
+    exec.add_slave(&slave0) ;
+    exec.add_slave(&slave1) ;
+    exec.set_num_runs(4) ;
+    EXPECT_TRUE(exec.get_ready_slave() == NULL) ;
+
+    slave0.state = Trick::MonteSlave::MC_READY ;
+    slave1.state = Trick::MonteSlave::MC_RUNNING ;
+    slave1.pending_runs.push_back(exec.runs[0]) ;
+    EXPECT_EQ(exec.get_ready_slave(), &slave0) ;
+
+    slave0.state = Trick::MonteSlave::MC_RUNNING ;
+    slave0.pending_runs.push_back(exec.runs[1]) ;
+    slave0.pending_runs.push_back(exec.runs[2]) ;
+    EXPECT_EQ(exec.get_ready_slave(), &slave1) ;
+
+    slave1.pending_runs.push_back(exec.runs[3]) ;
+    EXPECT_TRUE(exec.get_ready_slave() == NULL) ;
+    exec.set_max_pending_runs(3) ;
+    EXPECT_EQ(exec.get_ready_slave(), &slave0) ;
+
+    slave0.state = Trick::MonteSlave::MC_STOPPING ;
+    EXPECT_EQ(exec.get_ready_slave(), &slave1) ;
+}
+
+TEST_F(MonteCarloTest, TestBranchJob) {
+
+    Trick::JobData branch_job ;
+    exec.set_branch_job(&branch_job) ;
+
+    // The master never branches, so the job is not called again.
+    exec.set_enabled(true) ;
+    exec.set_branch_time(10) ;
+    EXPECT_EQ(exec.branch(), 0) ;
+    EXPECT_EQ(branch_job.next_tics, TRICK_MAX_LONG_LONG) ;
+}
+
+TEST_F(MonteCarloTest, TestBranchJobSlave) {
+
+    Trick::JobData branch_job ;
+    exec.set_branch_job(&branch_job) ;
+    exec.set_enabled(true) ;
+    exec.set_branch_time(10) ;
+    exec.slave_id = 1 ;
+
+    // A slave waits for the branch time before it forks any runs.
+    exec_set_time_tics(0) ;
+    EXPECT_EQ(exec.branch(), 0) ;
+    EXPECT_EQ(branch_job.next_tics, 10 * exec_get_time_tic_value()) ;
+
+    // Only the calling thread would be in each forked run, so a sim with child threads terminates.
+    exec_set_time_tics(branch_job.next_tics) ;
+    executive.threads.push_back(new Trick::Threads(1, false)) ;
+    ASSERT_GT(exec_get_num_threads(), 1u) ;
+    EXPECT_EXIT(exec.branch(), ::testing::ExitedWithCode(255), "") ;
+    EXPECT_EQ(branch_job.next_tics, 10 * exec_get_time_tic_value()) ;
+    delete executive.threads.back() ;
+    executive.threads.pop_back() ;
+}
+
+TEST_F(MonteCarloTest, TestResultStatistics) {
+
+    Trick::MonteResult result("obj.x") ;
+    result.set_histogram(0, 10, 5) ;
+    Trick::MonteResultBin bin(result) ;
+    EXPECT_EQ(bin.histogram.size(), 7u) ;
+
+    double values[] = { 2, 4, 4, 4, 5, 5, 7, 9, -1, 10 } ;
+    for (int ii = 0 ; ii < 10 ; ii++) {
+        bin.add(values[ii], result) ;
+    }
+    EXPECT_EQ(bin.count, 10u) ;
+    EXPECT_DOUBLE_EQ(bin.mean, 4.9) ;
+    EXPECT_NEAR(bin.get_variance(), 92.9 / 9, 1e-12) ;
+    EXPECT_EQ(bin.min, -1) ;
+    EXPECT_EQ(bin.max, 10) ;
+    unsigned int expected[] = { 1, 0, 1, 5, 1, 1, 1 } ;
+    for (int ii = 0 ; ii < 7 ; ii++) {
+        EXPECT_EQ(bin.histogram[ii], expected[ii]) ;
+    }
+
+    // A histogram must have a positive width.
+    result.set_histogram(1, 1, 5) ;
+    EXPECT_EQ(result.num_histogram_bins, 5u) ;
+    EXPECT_EQ(result.histogram_max, 10) ;
+}
+
+TEST_F(MonteCarloTest, TestResultQuantile) {
+
+    Trick::MonteQuantile median(0.5) ;
+    EXPECT_EQ(median.get_value(), 0) ;
+
+    // Fewer than five values are interpolated exactly.
+    median.add(3) ;
+    median.add(1) ;
+    median.add(2) ;
+    median.add(4) ;
+    EXPECT_DOUBLE_EQ(median.get_value(), 2.5) ;
+
+    Trick::MonteQuantile p05(0.05), p50(0.5), p95(0.95) ;
+    for (int ii = 0 ; ii < 1000 ; ii++) {
+        double value = (ii * 7919) % 1000 ;
+        p05.add(value) ;
+        p50.add(value) ;
+        p95.add(value) ;
+    }
+    EXPECT_NEAR(p05.get_value(), 50, 10) ;
+    EXPECT_NEAR(p50.get_value(), 500, 10) ;
+    EXPECT_NEAR(p95.get_value(), 950, 10) ;
+}
+
+TEST_F(MonteCarloTest, TestAddResult) {
+
+    Trick::MonteResult result_1("obj.x", 0.5) ;
+    Trick::MonteResult result_2("obj.x") ;
+    Trick::MonteResult result_3("obj.y", -1) ;
+    exec.add_result(&result_1) ;
+    exec.add_result(&result_2) ;
+    exec.add_result(&result_3) ;
+    ASSERT_EQ(exec.get_results().size(), 2u) ;
+    EXPECT_EQ(exec.get_results()[0], &result_1) ;
+    EXPECT_EQ(exec.get_results()[1], &result_3) ;
+    EXPECT_EQ(result_3.interval, 0) ;
+}
+
+TEST_F(MonteCarloTest, TestReduceResults) {
+
+    Trick::MonteResult result_1("obj.x", 1.0) ;
+    Trick::MonteResult result_2("obj.y") ;
+    exec.add_result(&result_1) ;
+    exec.add_result(&result_2) ;
+
+    // Each result is sent as its number of samples followed by each sample's bits, high word first.
+    double samples[] = { 1.5, -2.25, NAN, 8 } ;
+    int counts[] = { 3, 1 } ;
+    std::string data ;
+    for (int ii = 0, jj = 0 ; ii < 2 ; ii++) {
+        int word = htonl(counts[ii]) ;
+        data.append((char *)&word, sizeof(word)) ;
+        for (int kk = 0 ; kk < counts[ii] ; kk++, jj++) {
+            unsigned long long bits ;
+            memcpy(&bits, &samples[jj], sizeof(bits)) ;
+            int words[2] = { (int)htonl((unsigned int)(bits >> 32)), (int)htonl((unsigned int)bits) } ;
+            data.append((char *)words, sizeof(words)) ;
+        }
+    }
+    EXPECT_EQ(exec.reduce_results(data), 0) ;
+    EXPECT_EQ(exec.reduce_results(data), 0) ;
+    ASSERT_EQ(result_1.bins.size(), 3u) ;
+    EXPECT_EQ(result_1.bins[0].count, 2u) ;
+    EXPECT_EQ(result_1.bins[0].mean, 1.5) ;
+    EXPECT_EQ(result_1.bins[1].mean, -2.25) ;
+    // Values that are not a number are not counted.
+    EXPECT_EQ(result_1.bins[2].count, 0u) ;
+    ASSERT_EQ(result_2.bins.size(), 1u) ;
+    EXPECT_EQ(result_2.bins[0].mean, 8) ;
+
+    // Malformed data is rejected without changing the statistics.
+    EXPECT_EQ(exec.reduce_results(data.substr(0, data.length() - 1)), -1) ;
+    EXPECT_EQ(exec.reduce_results(data + "x"), -1) ;
+    EXPECT_EQ(exec.reduce_results(""), -1) ;
+    EXPECT_EQ(result_1.bins[0].count, 2u) ;
+    EXPECT_EQ(result_2.bins[0].count, 2u) ;
+}
+
+TEST_F(MonteCarloTest, TestPostRunData) {
+
+    char data[8] ;
+    EXPECT_EQ(exec.write((char *)"abc", 3), -1) ;
+
+    exec.post_run_data = "abcde" ;
+    EXPECT_EQ(exec.read(data, 3), 3) ;
+    EXPECT_EQ(std::string(data, 3), "abc") ;
+    EXPECT_EQ(exec.read(data, 3), 2) ;
+    EXPECT_EQ(std::string(data, 2), "de") ;
+    EXPECT_EQ(exec.read(data, 3), 0) ;
+
+    exec.slave_id = 1 ;
+    EXPECT_EQ(exec.read(data, 3), -1) ;
+    exec.post_run_data.clear() ;
+    EXPECT_EQ(exec.write((char *)"abc", 3), 3) ;
+    EXPECT_EQ(exec.write((char *)"de", 2), 2) ;
+    EXPECT_EQ(exec.post_run_data, "abcde") ;
+    exec.slave_id = 0 ;
+}
+
+TEST_F(MonteCarloTest, TestParseNumber) {
+
+    int type ;
+    unsigned long long bits ;
+    double real ;
+
+    EXPECT_TRUE(exec.parse_number(" 42", type, bits)) ;
+    EXPECT_EQ(type, TRICK_LONG_LONG) ;
+    EXPECT_EQ((long long)bits, 42) ;
+    EXPECT_TRUE(exec.parse_number("-7", type, bits)) ;
+    EXPECT_EQ((long long)bits, -7) ;
+    EXPECT_TRUE(exec.parse_number("0", type, bits)) ;
+    EXPECT_EQ((long long)bits, 0) ;
+
+    EXPECT_TRUE(exec.parse_number("0.1", type, bits)) ;
+    EXPECT_EQ(type, TRICK_DOUBLE) ;
+    memcpy(&real, &bits, sizeof(real)) ;
+    EXPECT_EQ(real, 0.1) ;
+    EXPECT_TRUE(exec.parse_number("-2.5e-3", type, bits)) ;
+    memcpy(&real, &bits, sizeof(real)) ;
+    EXPECT_EQ(real, -2.5e-3) ;
+    EXPECT_TRUE(exec.parse_number("5.", type, bits)) ;
+    EXPECT_EQ(type, TRICK_DOUBLE) ;
+    EXPECT_TRUE(exec.parse_number(".5", type, bits)) ;
+    EXPECT_TRUE(exec.parse_number("1e5", type, bits)) ;
+    EXPECT_EQ(type, TRICK_DOUBLE) ;
+
+    EXPECT_FALSE(exec.parse_number("", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("007", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("0x10", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("1e", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("1e400", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("99999999999999999999", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("inf", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("'a'", type, bits)) ;
+    EXPECT_FALSE(exec.parse_number("[1, 2]", type, bits)) ;
+}
+
+TEST_F(MonteCarloTest, TestAssignVariable) {
+
+    double *real = (double *)TMM_declare_var_s("double mc_assign_double") ;
+    int *integer = (int *)TMM_declare_var_s("int mc_assign_int") ;
+    exec.add_variable(new Trick::MonteVarFixed("mc_assign_double", 0)) ;
+    exec.add_variable(new Trick::MonteVarFixed("mc_assign_int", 0)) ;
+    exec.add_variable(new Trick::MonteVarFixed("mc_assign_missing", 0)) ;
+    exec.resolve_variable_references() ;
+    ASSERT_EQ(exec.variable_references.size(), 3) ;
+    EXPECT_TRUE(exec.variable_references[0].ref2 != NULL) ;
+    EXPECT_TRUE(exec.variable_references[1].ref2 != NULL) ;
+    EXPECT_TRUE(exec.variable_references[2].ref2 == NULL) ;
+
+    double value = 0.1 ;
+    unsigned long long bits ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+    std::string assignment ;
+    EXPECT_EQ(exec.assign_variable(0, TRICK_DOUBLE, bits, assignment), 0) ;
+    EXPECT_EQ(*real, 0.1) ;
+    EXPECT_EQ(assignment, "mc_assign_double = 0.1") ;
+
+    value = 7.9 ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+    EXPECT_EQ(exec.assign_variable(1, TRICK_DOUBLE, bits, assignment), 0) ;
+    EXPECT_EQ(*integer, 7) ;
+    EXPECT_EQ(exec.assign_variable(1, TRICK_LONG_LONG, (unsigned long long)-3LL, assignment), 0) ;
+    EXPECT_EQ(*integer, -3) ;
+    EXPECT_EQ(assignment, "mc_assign_int = -3") ;
+
+    value = 3 ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+    EXPECT_EQ(exec.assign_variable(2, TRICK_DOUBLE, bits, assignment), 1) ;
+    EXPECT_EQ(assignment, "mc_assign_missing = 3.0") ;
+    EXPECT_EQ(exec.assign_variable(3, TRICK_DOUBLE, bits, assignment), -1) ;
+}
+
+TEST_F(MonteCarloTest, TestResolveVariablesAgain) {
+
+    // A slave that branches resolves its variables and results again, after the sim may have reallocated them.
+    double *before = (double *)TMM_declare_var_s("double mc_resolve_double") ;
+    Trick::MonteResult result("mc_resolve_double") ;
+    exec.add_variable(new Trick::MonteVarFixed("mc_resolve_double", 0)) ;
+    exec.add_result(&result) ;
+    exec.resolve_variable_references() ;
+    exec.resolve_results() ;
+    ASSERT_TRUE(exec.variable_references[0].ref2 != NULL) ;
+    EXPECT_EQ(exec.variable_references[0].ref2->address, before) ;
+
+    TMM_delete_var_a(before) ;
+    double *after = (double *)TMM_declare_var_s("double mc_resolve_double[2]") ;
+    exec.resolve_variable_references() ;
+    exec.resolve_results() ;
+    ASSERT_EQ(exec.variable_references.size(), 1) ;
+    EXPECT_TRUE(exec.variable_references[0].ref2 == NULL) ;
+    EXPECT_TRUE(result.ref2 == NULL) ;
+
+    TMM_delete_var_a(after) ;
+    after = (double *)TMM_declare_var_s("double mc_resolve_double") ;
+    exec.resolve_variable_references() ;
+    exec.resolve_results() ;
+    ASSERT_TRUE(exec.variable_references[0].ref2 != NULL) ;
+    EXPECT_EQ(exec.variable_references[0].ref2->address, after) ;
+    ASSERT_TRUE(result.ref2 != NULL) ;
+    EXPECT_EQ(result.ref2->address, after) ;
+
+    double value = 2.5 ;
+    unsigned long long bits ;
+    memcpy(&bits, &value, sizeof(bits)) ;
+    std::string assignment ;
+    EXPECT_EQ(exec.assign_variable(0, TRICK_DOUBLE, bits, assignment), 0) ;
+    EXPECT_EQ(*after, 2.5) ;
+}
+
 TEST_F(MonteCarloTest, MonteVarFile) {
     //req.add_requirement("3932595803");
 
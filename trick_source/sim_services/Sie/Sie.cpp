@@ -2,6 +2,7 @@
 #include <iostream>
 #include <algorithm>
 #include <fstream>
+#include <map>
 #include <string.h>
 #include <cstring>
 
@@ -17,6 +18,12 @@
 
 Trick::Sie * the_sie = NULL ;
 
+/* The memory manager's variable map is unordered. Copy it into a map sorted by name so the
+   S_sie files list the top level objects in the same order in every build and run. */
+static std::map<std::string, ALLOC_INFO *> sorted_variable_map() {
+    return std::map<std::string, ALLOC_INFO *>(trick_MM->variable_map_begin(), trick_MM->variable_map_end()) ;
+}
+
 Trick::Sie::Sie() {
     // Call the attribute_map function which will instantiate the singleton maps
     class_attr_map = Trick::AttributesMap::attributes_map() ;
@@ -50,10 +57,11 @@ int Trick::Sie::process_sim_args() {
 }
 
 void Trick::Sie::top_level_objects_print(std::ofstream & sie_out) {
-    Trick::VARIABLE_MAP_ITER vit ;
+    std::map<std::string, ALLOC_INFO *> variables = sorted_variable_map() ;
+    std::map<std::string, ALLOC_INFO *>::iterator vit ;
     int jj ;
 
-    for ( vit = trick_MM->variable_map_begin() ; vit != trick_MM->variable_map_end() ; vit++ ) {
+    for ( vit = variables.begin() ; vit != variables.end() ; vit++ ) {
         ALLOC_INFO * alloc_info = (*vit).second ;
 
         if ( alloc_info != NULL ) {
@@ -76,10 +84,11 @@ void Trick::Sie::top_level_objects_print(std::ofstream & sie_out) {
 }
 
 void Trick::Sie::runtime_objects_print(std::fstream & sie_out) {
-    Trick::VARIABLE_MAP_ITER vit ;
+    std::map<std::string, ALLOC_INFO *> variables = sorted_variable_map() ;
+    std::map<std::string, ALLOC_INFO *>::iterator vit ;
     int jj ;
 
-    for ( vit = trick_MM->variable_map_begin() ; vit != trick_MM->variable_map_end() ; vit++ ) {
+    for ( vit = variables.begin() ; vit != variables.end() ; vit++ ) {
         ALLOC_INFO * alloc_info = (*vit).second ;
 
         if ( alloc_info != NULL && alloc_info->alloced_in_memory_init == 0) {
@@ -102,10 +111,11 @@ void Trick::Sie::runtime_objects_print(std::fstream & sie_out) {
 }
 
 void Trick::Sie::top_level_objects_json(std::ofstream & sie_out) {
-    Trick::VARIABLE_MAP_ITER vit ;
+    std::map<std::string, ALLOC_INFO *> variables = sorted_variable_map() ;
+    std::map<std::string, ALLOC_INFO *>::iterator vit ;
     int jj ;
     sie_out << "  \"top_level_objects\": [\n";
-    for ( vit = trick_MM->variable_map_begin() ; vit != trick_MM->variable_map_end() ; vit++ ) {
+    for ( vit = variables.begin() ; vit != variables.end() ; vit++ ) {
         ALLOC_INFO * alloc_info = (*vit).second ;
 
         if ( alloc_info != NULL ) {
@@ -127,7 +137,7 @@ void Trick::Sie::top_level_objects_json(std::ofstream & sie_out) {
                     sie_out << '\n' ;
                 }
             sie_out << "    }" ;
-            if(std::next(vit, 1) != trick_MM->variable_map_end()) {
+            if(std::next(vit, 1) != variables.end()) {
                 sie_out << ',' ;
             }
             sie_out << '\n';
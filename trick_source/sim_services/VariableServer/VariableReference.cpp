@@ -1,7 +1,6 @@
 
 #include <stdlib.h>
 #include <iostream>
-#include <udunits2.h>
 #include "trick/VariableServer.hh"
 #include "trick/memorymanager_c_intf.h"
 #include "trick/wcs_ext.h"
@@ -14,8 +13,6 @@ Trick::VariableReference::VariableReference(REF2 * in_ref ) {
     int k ;
 
     // VariableReference copy setup: set address & size to copy into buffer
-    conversion_factor = cv_get_trivial() ;
-
     ref = in_ref ;
     address = ref->address ;
     size = ref->attr->size ;
@@ -176,33 +176,26 @@ int Trick::VariableServerThread::var_units(std::string var_name, std::string uni
                 publish(MSG_ERROR, oss.str());
             };
 
-            ut_unit * from = ut_parse(Trick::UdUnits::get_u_system(), variable->ref->attr->units, UT_ASCII) ;
-            if ( !from ) {
-                publishError(variable->ref->attr->units);
-                ut_free(from) ;
-                return -1 ;
+            Trick::UnitsConversion conversion_factor ;
+            switch ( Trick::UnitsConversion::get(Trick::UdUnits::get_u_system(), variable->ref->attr->units,
+             new_units, conversion_factor) ) {
+                case -1:
+                    publishError(variable->ref->attr->units);
+                    return -1 ;
+                case -2:
+                    publishError(new_units);
+                    return -1 ;
+                case -3: {
+                    std::ostringstream oss;
+                    oss << "[" << var_name << "] cannot convert units from [" << variable->ref->attr->units
+                        << "] to [" << new_units << "]";
+                    publish(MSG_ERROR, oss.str());
+                    return -1 ;
+                }
+                default:
+                    break ;
             }
 
-            ut_unit * to = ut_parse(Trick::UdUnits::get_u_system(), new_units.c_str(), UT_ASCII) ;
-            if ( !to ) {
-                publishError(new_units);
-                ut_free(from) ;
-                ut_free(to) ;
-                return -1 ;
-            }
-
-            cv_converter * conversion_factor = ut_get_converter(from, to) ;
-            ut_free(from) ;
-            ut_free(to) ;
-            if ( !conversion_factor ) {
-                std::ostringstream oss;
-                oss << "[" << var_name << "] cannot convert units from [" << variable->ref->attr->units
-                    << "] to [" << new_units << "]";
-                publish(MSG_ERROR, oss.str());
-                return -1 ;
-            }
-
-            cv_free(variable->conversion_factor);
             variable->conversion_factor = conversion_factor ;
             free(variable->ref->units);
             variable->ref->units = strdup(new_units.c_str());
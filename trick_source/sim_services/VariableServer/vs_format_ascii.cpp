@@ -8,7 +8,6 @@ PROGRAMMERS: (((Keith Vetter) (LinCom) (September 2001) (--)))
 #include <string.h>
 #include <ctype.h>
 #include <limits>
-#include <udunits2.h>
 
 #include "trick/parameter_types.h"
 #include "trick/attributes.h"
@@ -41,7 +40,7 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
 
         case TRICK_CHARACTER:
             if (ref->attr->num_index == ref->num_index) {
-                snprintf(value, value_size, "%s%d", value,(char)cv_convert_double(var->conversion_factor, *(char *)buf_ptr));
+                snprintf(value, value_size, "%s%d", value,(char)var->conversion_factor.convert(*(char *)buf_ptr));
             } else {
                 /* All but last dim specified, leaves a char array */
                 escape_str((char *) buf_ptr, value);
@@ -50,7 +49,7 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
             break;
         case TRICK_UNSIGNED_CHARACTER:
             if (ref->attr->num_index == ref->num_index) {
-                snprintf(value, value_size, "%s%u", value,(unsigned char)cv_convert_double(var->conversion_factor,*(unsigned char *)buf_ptr));
+                snprintf(value, value_size, "%s%u", value,(unsigned char)var->conversion_factor.convert(*(unsigned char *)buf_ptr));
             } else {
                 /* All but last dim specified, leaves a char array */
                 escape_str((char *) buf_ptr, value);
@@ -98,16 +97,16 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
 
 #if ( __linux | __sgi )
         case TRICK_BOOLEAN:
-            snprintf(value, value_size, "%s%d", value,(unsigned char)cv_convert_double(var->conversion_factor,*(unsigned char *)buf_ptr));
+            snprintf(value, value_size, "%s%d", value,(unsigned char)var->conversion_factor.convert(*(unsigned char *)buf_ptr));
             break;
 #endif
 
         case TRICK_SHORT:
-            snprintf(value, value_size, "%s%d", value, (short)cv_convert_double(var->conversion_factor,*(short *)buf_ptr));
+            snprintf(value, value_size, "%s%d", value, (short)var->conversion_factor.convert(*(short *)buf_ptr));
             break;
 
         case TRICK_UNSIGNED_SHORT:
-            snprintf(value, value_size, "%s%u", value,(unsigned short)cv_convert_double(var->conversion_factor,*(unsigned short *)buf_ptr));
+            snprintf(value, value_size, "%s%u", value,(unsigned short)var->conversion_factor.convert(*(unsigned short *)buf_ptr));
             break;
 
         case TRICK_INTEGER:
@@ -115,7 +114,7 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
 #if ( __sun | __APPLE__ )
         case TRICK_BOOLEAN:
 #endif
-            snprintf(value, value_size, "%s%d", value, (int)cv_convert_double(var->conversion_factor,*(int *)buf_ptr));
+            snprintf(value, value_size, "%s%d", value, (int)var->conversion_factor.convert(*(int *)buf_ptr));
             break;
 
         case TRICK_BITFIELD:
@@ -126,13 +125,13 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
             snprintf(value, value_size, "%u", GET_UNSIGNED_BITFIELD(buf_ptr, ref->attr->size, ref->attr->index[0].start, ref->attr->index[0].size));
             break;
         case TRICK_UNSIGNED_INTEGER:
-            snprintf(value, value_size, "%s%u", value, (unsigned int)cv_convert_double(var->conversion_factor,*(unsigned int *)buf_ptr));
+            snprintf(value, value_size, "%s%u", value, (unsigned int)var->conversion_factor.convert(*(unsigned int *)buf_ptr));
             break;
 
         case TRICK_LONG: {
             long l = *(long *)buf_ptr;
-            if (var->conversion_factor != cv_get_trivial()) {
-                l = (long)cv_convert_double(var->conversion_factor, l);
+            if (! var->conversion_factor.is_trivial()) {
+                l = (long)var->conversion_factor.convert(l);
             }
             snprintf(value, value_size, "%s%ld", value, l);
             break;
@@ -140,25 +139,25 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
 
         case TRICK_UNSIGNED_LONG: {
             unsigned long ul = *(unsigned long *)buf_ptr;
-            if (var->conversion_factor != cv_get_trivial()) {
-                ul = (unsigned long)cv_convert_double(var->conversion_factor, ul);
+            if (! var->conversion_factor.is_trivial()) {
+                ul = (unsigned long)var->conversion_factor.convert(ul);
             }
             snprintf(value, value_size, "%s%lu", value, ul);
             break;
         }
 
         case TRICK_FLOAT:
-            snprintf(value, value_size, "%s%.8g", value, cv_convert_float(var->conversion_factor,*(float *)buf_ptr));
+            snprintf(value, value_size, "%s%.8g", value, var->conversion_factor.convert_float(*(float *)buf_ptr));
             break;
 
         case TRICK_DOUBLE:
-            snprintf(value, value_size, "%s%.16g", value, cv_convert_double(var->conversion_factor,*(double *)buf_ptr));
+            snprintf(value, value_size, "%s%.16g", value, var->conversion_factor.convert(*(double *)buf_ptr));
             break;
 
         case TRICK_LONG_LONG: {
             long long ll = *(long long *)buf_ptr;
-            if (var->conversion_factor != cv_get_trivial()) {
-                ll = (long long)cv_convert_double(var->conversion_factor, ll);
+            if (! var->conversion_factor.is_trivial()) {
+                ll = (long long)var->conversion_factor.convert(ll);
             }
             snprintf(value, value_size, "%s%lld", value, ll);
             break;
@@ -166,8 +165,8 @@ int vs_format_ascii(Trick::VariableReference * var, char *value, size_t value_si
 
         case TRICK_UNSIGNED_LONG_LONG: {
             unsigned long long ull = *(unsigned long long *)buf_ptr;
-            if (var->conversion_factor != cv_get_trivial()) {
-                ull = (unsigned long long)cv_convert_double(var->conversion_factor, ull);
+            if (! var->conversion_factor.is_trivial()) {
+                ull = (unsigned long long)var->conversion_factor.convert(ull);
             }
             snprintf(value, value_size, "%s%llu", value, ull);
             break;
@@ -133,6 +133,7 @@
 #include "trick/message_proto.h"
 #include "trick/MonteCarlo.hh"
 #include "trick/montecarlo_c_intf.h"
+#include "trick/MonteResult.hh"
 #include "trick/MonteVarCalculated.hh"
 #include "trick/MonteVarFile.hh"
 #include "trick/MonteVarFixed.hh"
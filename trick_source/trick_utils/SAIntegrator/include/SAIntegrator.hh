@@ -264,5 +264,78 @@ namespace SA {
         friend std::ostream& operator<<(std::ostream& os, const ABM4Integrator& I);
     };
     std::ostream& operator<<(std::ostream& os, const ABM4Integrator& I);
+
+    // Derivatives of the members first .. first+count-1 of an ensemble. state and derivs
+    // hold count consecutive member state vectors.
+    typedef void (*EnsembleDerivsFunc)( double x, unsigned int first, unsigned int count,
+                                        double state[], double derivs[], void* udata);
+
+    typedef double (*EnsembleRootErrorFunc)( double x, unsigned int member, double state[],
+                                             RootFinder* root_finder, void* udata);
+
+    // Integrates an ensemble of independent copies of an N-state system in lockstep. The
+    // member states are one contiguous block, member after member, and each stage is computed
+    // for the whole block at once.
+    class EnsembleIntegrator : public Integrator {
+    protected:
+        unsigned int num_members;  // Number of ensemble members.
+        unsigned int state_size;   // Size of each member's state vector.
+        double*  block;            // The members' state vectors, num_members x state_size.
+        double*  inState;          // Ensemble state prior to integration step.
+        double*  outState;         // Ensemble state result of integration step.
+        unsigned int num_stages;   // Number of ensemble sized arrays in work.
+        double*  work;             // Stage derivatives and intermediate states.
+        EnsembleDerivsFunc derivs_func;
+        RootFinder* root_finders;  // One RootFinder per member, or NULL.
+        EnsembleRootErrorFunc root_error_func;
+        double last_h;
+        EnsembleIntegrator( unsigned int stages, double h, unsigned int M, unsigned int N,
+                            double* state_block, EnsembleDerivsFunc dfunc, void* udata);
+        double* stage( unsigned int k) { return work + k * num_members * state_size; }
+        void advanceIndyVar( double h);
+    public:
+        EnsembleIntegrator( double h, unsigned int M, unsigned int N, double* state_block,
+                            EnsembleDerivsFunc dfunc, void* udata);
+        EnsembleIntegrator(const EnsembleIntegrator& other);
+        EnsembleIntegrator& operator=( const EnsembleIntegrator& rhs);
+        virtual ~EnsembleIntegrator();
+        void load();                               // Overrides Integrator::load(), Final
+        void unload();                             // Overrides Integrator::unload(), Final
+        void step();                               // Overrides Integrator::step(), Final
+        double undo_integrate();                   // Overrides Integrator::undo_integrate(), Final
+        // Step members first .. first+count-1 from x to x+h, from inState to outState.
+        virtual void variable_step( double x, double h, unsigned int first, unsigned int count);
+        void add_Rootfinder( double tolerance, SlopeConstraint constraint, EnsembleRootErrorFunc rfunc);
+        double* member_state( unsigned int member);
+        unsigned int getNumMembers();
+        friend std::ostream& operator<<(std::ostream& os, const SA::EnsembleIntegrator& I);
+    private:
+        void find_roots( unsigned int member, double x, double h, unsigned int depth);
+    };
+    std::ostream& operator<<(std::ostream& os, const EnsembleIntegrator& I);
+
+    class EnsembleRK2Integrator : public EnsembleIntegrator {
+        public:
+        EnsembleRK2Integrator( double h, unsigned int M, unsigned int N, double* state_block,
+                               EnsembleDerivsFunc dfunc, void* udata);
+        EnsembleRK2Integrator(const EnsembleRK2Integrator& other);
+        EnsembleRK2Integrator& operator=( const EnsembleRK2Integrator& rhs);
+        ~EnsembleRK2Integrator();
+        void variable_step( double x, double h, unsigned int first, unsigned int count);
+        friend std::ostream& operator<<(std::ostream& os, const SA::EnsembleRK2Integrator& I);
+    };
+    std::ostream& operator<<(std::ostream& os, const EnsembleRK2Integrator& I);
+
+    class EnsembleRK4Integrator : public EnsembleIntegrator {
+        public:
+        EnsembleRK4Integrator( double h, unsigned int M, unsigned int N, double* state_block,
+                               EnsembleDerivsFunc dfunc, void* udata);
+        EnsembleRK4Integrator(const EnsembleRK4Integrator& other);
+        EnsembleRK4Integrator& operator=( const EnsembleRK4Integrator& rhs);
+        ~EnsembleRK4Integrator();
+        void variable_step( double x, double h, unsigned int first, unsigned int count);
+        friend std::ostream& operator<<(std::ostream& os, const SA::EnsembleRK4Integrator& I);
+    };
+    std::ostream& operator<<(std::ostream& os, const EnsembleRK4Integrator& I);
 }
 #endif /* SAINTEGRATOR_HH */
@@ -1307,3 +1307,297 @@ std::ostream& SA::operator<<(std::ostream& os, const ABM4Integrator& I) {
     stream_double_array(os, I.state_size, I.composite_deriv);
     return os;
 }
+// ------------------------------------------------------------
+// Class EnsembleIntegrator
+// ------------------------------------------------------------
+// Constructor for derived classes, which need more stage arrays.
+SA::EnsembleIntegrator::EnsembleIntegrator(
+    unsigned int stages, double h, unsigned int M, unsigned int N, double* state_block,
+    EnsembleDerivsFunc dfunc, void* udata)
+: Integrator(h, udata) {
+    num_members = M;
+    state_size = N;
+    block = state_block;
+    inState = new double[num_members * state_size];
+    outState = new double[num_members * state_size];
+    num_stages = stages;
+    work = new double[num_stages * num_members * state_size];
+    if (dfunc == NULL) throw std::invalid_argument("dfunc must be non-NULL.");
+    derivs_func = dfunc;
+    root_finders = (RootFinder*) NULL;
+    root_error_func = (EnsembleRootErrorFunc) NULL;
+    last_h = h;
+}
+// Constructor
+SA::EnsembleIntegrator::EnsembleIntegrator(
+    double h, unsigned int M, unsigned int N, double* state_block, EnsembleDerivsFunc dfunc, void* udata)
+: EnsembleIntegrator(1, h, M, N, state_block, dfunc, udata) {}
+// Copy Constructor
+SA::EnsembleIntegrator::EnsembleIntegrator(const EnsembleIntegrator& other)
+: Integrator(other) {
+    unsigned int size = other.num_members * other.state_size;
+    num_members = other.num_members;
+    state_size = other.state_size;
+    block = other.block;
+    inState = new double[size];
+    std::copy( other.inState, other.inState + size, inState);
+    outState = new double[size];
+    std::copy( other.outState, other.outState + size, outState);
+    num_stages = other.num_stages;
+    work = new double[num_stages * size];
+    derivs_func = other.derivs_func;
+    if (other.root_finders != NULL) {
+        root_finders = new RootFinder[num_members];
+        std::copy( other.root_finders, other.root_finders + num_members, root_finders);
+    } else {
+        root_finders = NULL;
+    }
+    root_error_func = other.root_error_func;
+    last_h = other.last_h;
+}
+// Assignment Operator
+SA::EnsembleIntegrator& SA::EnsembleIntegrator::operator=( const SA::EnsembleIntegrator& rhs) {
+    if (this != &rhs) {
+        unsigned int size = rhs.num_members * rhs.state_size;
+        // Call base assignment operator
+        Integrator::operator=(rhs);
+        // Duplicate rhs arrays
+        double* new_inState = new double[size];
+        std::copy( rhs.inState, rhs.inState + size, new_inState);
+        double* new_outState = new double[size];
+        std::copy( rhs.outState, rhs.outState + size, new_outState);
+        double* new_work = new double[rhs.num_stages * size];
+        RootFinder* new_root_finders = NULL;
+        if (rhs.root_finders != NULL) {
+            new_root_finders = new RootFinder[rhs.num_members];
+            std::copy( rhs.root_finders, rhs.root_finders + rhs.num_members, new_root_finders);
+        }
+        // Delete lhs arrays & replace with rhs arrays
+        delete[] inState;
+        inState = new_inState;
+        delete[] outState;
+        outState = new_outState;
+        delete[] work;
+        work = new_work;
+        delete[] root_finders;
+        root_finders = new_root_finders;
+        // Copy primitive members
+        num_members = rhs.num_members;
+        state_size = rhs.state_size;
+        block = rhs.block;
+        num_stages = rhs.num_stages;
+        derivs_func = rhs.derivs_func;
+        root_error_func = rhs.root_error_func;
+        last_h = rhs.last_h;
+    }
+    return *this;
+}
+// Destructor
+SA::EnsembleIntegrator::~EnsembleIntegrator() {
+    delete[] inState;
+    delete[] outState;
+    delete[] work;
+    delete[] root_finders;
+}
+void SA::EnsembleIntegrator::load() {
+    if (block != NULL) {
+        std::copy( block, block + num_members * state_size, inState);
+        Integrator::load();
+    } else {
+        std::cerr << "Error: SA::EnsembleIntegrator::load(). block is not set." << std::endl;
+    }
+}
+void SA::EnsembleIntegrator::unload() {
+    if (block != NULL) {
+        std::copy( outState, outState + num_members * state_size, block);
+    } else {
+        std::cerr << "Error: SA::EnsembleIntegrator::unload(). block is not set." << std::endl;
+    }
+}
+double SA::EnsembleIntegrator::undo_integrate() {
+    if (block != NULL) {
+        std::copy( inState, inState + num_members * state_size, block);
+        std::copy( inState, inState + num_members * state_size, outState);
+        Integrator::undo_integrate();
+        return (last_h);
+    } else {
+        std::cerr << "Error: SA::EnsembleIntegrator::undo_integrate(). block is not set." << std::endl;
+    }
+    return (0.0);
+}
+void SA::EnsembleIntegrator::advanceIndyVar(double h) {
+    last_h = h; X_out = X_in + h;
+}
+void SA::EnsembleIntegrator::variable_step( double x, double h, unsigned int first, unsigned int count) {
+    unsigned int offset = first * state_size;
+    unsigned int size = count * state_size;
+    double* y0 = inState + offset;
+    double* y1 = outState + offset;
+    double* derivs = stage(0) + offset;
+    (*derivs_func)( x, first, count, y0, derivs, user_data);
+    for (unsigned int i=0; i<size; i++) {
+        y1[i] = y0[i] + derivs[i] * h;
+    }
+}
+void SA::EnsembleIntegrator::add_Rootfinder( double tolerance, SlopeConstraint constraint, EnsembleRootErrorFunc rfunc) {
+    if (rfunc == NULL) {
+        throw std::invalid_argument("OOPS! EnsembleRootErrorFunc function-pointer is NULL.");
+    }
+    delete[] root_finders;
+    root_finders = new RootFinder[num_members];
+    for (unsigned int m=0; m<num_members; m++) {
+        root_finders[m].init(tolerance, constraint);
+    }
+    root_error_func = rfunc;
+}
+double* SA::EnsembleIntegrator::member_state( unsigned int member) {
+    return (block + member * state_size);
+}
+unsigned int SA::EnsembleIntegrator::getNumMembers() {
+    return num_members;
+}
+// Each member searches for its own root by re-stepping only its own states,
+// from x, the start of the step, then steps from the root to the end of the step.
+void SA::EnsembleIntegrator::find_roots( unsigned int member, double x, double h, unsigned int depth) {
+    double* member_in = inState + member * state_size;
+    double* member_out = outState + member * state_size;
+    RootFinder* root_finder = &root_finders[member];
+    double new_h = h;
+    double h_correction = (*root_error_func)( x + h, member, member_out, root_finder, user_data );
+    if (h_correction < 0.0) {
+        while (h_correction != 0.0) {
+            new_h = new_h + h_correction;
+            variable_step( x, new_h, member, 1);
+            h_correction = (*root_error_func)( x + new_h, member, member_out, root_finder, user_data );
+        }
+        std::copy( member_out, member_out + state_size, member_in);
+        variable_step( x + new_h, h - new_h, member, 1);
+        if (depth > 0) {
+            find_roots( member, x + new_h, h - new_h, depth-1);
+        }
+    }
+}
+void SA::EnsembleIntegrator::step() {
+    variable_step( X_in, default_h, 0, num_members);
+    advanceIndyVar( default_h);
+    if ((root_finders != NULL) && (root_error_func != NULL)) {
+        for (unsigned int m=0; m<num_members; m++) {
+            find_roots( m, X_in, default_h, 5);
+        }
+    }
+}
+// Insertion Operator
+std::ostream& SA::operator<<(std::ostream& os, const EnsembleIntegrator& I) {
+    os << (SA::Integrator)I;
+    os << "\n--- EnsembleIntegrator ---";
+    os << "\nnum_members: " << I.num_members;
+    os << "\nstate_size: " << I.state_size;
+    os << "\ninState   :";
+    stream_double_array(os, I.num_members * I.state_size, I.inState);
+    os << "\noutState  :";
+    stream_double_array(os, I.num_members * I.state_size, I.outState);
+    os << "\nblock     : " << (void*)I.block;
+    if (I.root_error_func == NULL) {
+        os << "\nroot_error_func: NULL.";
+    } else {
+        os << "\nroot_error_func: " << (void*)I.root_error_func;
+    }
+    return os;
+}
+// ------------------------------------------------------------
+// Class EnsembleRK2Integrator
+// ------------------------------------------------------------
+// Constructor
+SA::EnsembleRK2Integrator::EnsembleRK2Integrator(
+    double h, unsigned int M, unsigned int N, double* state_block, EnsembleDerivsFunc dfunc, void* udata)
+    : EnsembleIntegrator(3, h, M, N, state_block, dfunc, udata) {}
+// Copy Constructor
+SA::EnsembleRK2Integrator::EnsembleRK2Integrator(const EnsembleRK2Integrator& other)
+    : EnsembleIntegrator(other) {}
+// Assignment Operator
+SA::EnsembleRK2Integrator& SA::EnsembleRK2Integrator::operator=( const SA::EnsembleRK2Integrator& rhs) {
+    if (this != &rhs) {
+        EnsembleIntegrator::operator=(rhs);
+    }
+    return *this;
+}
+// Destructor
+SA::EnsembleRK2Integrator::~EnsembleRK2Integrator() {}
+
+void SA::EnsembleRK2Integrator::variable_step( double x, double h, unsigned int first, unsigned int count) {
+    unsigned int offset = first * state_size;
+    unsigned int size = count * state_size;
+    double* y0 = inState + offset;
+    double* y1 = outState + offset;
+    double* wstate = stage(0) + offset;
+    double* derivs0 = stage(1) + offset;
+    double* derivs1 = stage(2) + offset;
+    (*derivs_func)( x, first, count, y0, derivs0, user_data);
+    for (unsigned int i=0; i<size; i++) {
+        wstate[i] = y0[i] + 0.5 * h * derivs0[i];
+    }
+    (*derivs_func)( x + 0.5 * h, first, count, wstate, derivs1, user_data);
+    for (unsigned int i=0; i<size; i++) {
+        y1[i] = y0[i] + h * derivs1[i];
+    }
+}
+
+// Insertion Operator
+std::ostream& SA::operator<<(std::ostream& os, const EnsembleRK2Integrator& I) {
+    os << (SA::EnsembleIntegrator)I;
+    return os;
+}
+// ------------------------------------------------------------
+// Class EnsembleRK4Integrator
+// ------------------------------------------------------------
+// Constructor
+SA::EnsembleRK4Integrator::EnsembleRK4Integrator(
+    double h, unsigned int M, unsigned int N, double* state_block, EnsembleDerivsFunc dfunc, void* udata)
+    : EnsembleIntegrator(5, h, M, N, state_block, dfunc, udata) {}
+// Copy Constructor
+SA::EnsembleRK4Integrator::EnsembleRK4Integrator(const EnsembleRK4Integrator& other)
+    : EnsembleIntegrator(other) {}
+// Assignment Operator
+SA::EnsembleRK4Integrator& SA::EnsembleRK4Integrator::operator=( const SA::EnsembleRK4Integrator& rhs) {
+    if (this != &rhs) {
+        EnsembleIntegrator::operator=(rhs);
+    }
+    return *this;
+}
+// Destructor
+SA::EnsembleRK4Integrator::~EnsembleRK4Integrator() {}
+
+void SA::EnsembleRK4Integrator::variable_step( double x, double h, unsigned int first, unsigned int count) {
+    unsigned int offset = first * state_size;
+    unsigned int size = count * state_size;
+    double* y0 = inState + offset;
+    double* y1 = outState + offset;
+    double* wstate = stage(0) + offset;
+    double* derivs[4] = { stage(1) + offset, stage(2) + offset, stage(3) + offset, stage(4) + offset };
+
+    (*derivs_func)( x, first, count, y0, derivs[0], user_data);
+    for (unsigned int i=0; i<size; i++) {
+        wstate[i] = y0[i] + 0.5 * derivs[0][i] * h;
+    }
+    (*derivs_func)( x + 0.5 * h, first, count, wstate, derivs[1], user_data);
+    for (unsigned int i=0; i<size; i++) {
+        wstate[i] = y0[i] + 0.5 * derivs[1][i] * h;
+    }
+    (*derivs_func)( x + 0.5 * h, first, count, wstate, derivs[2], user_data);
+    for (unsigned int i=0; i<size; i++) {
+        wstate[i] = y0[i] + derivs[2][i] * h;
+    }
+    (*derivs_func)( x + h, first, count, wstate, derivs[3], user_data);
+    for (unsigned int i=0; i<size; i++) {
+        y1[i] = y0[i] + ((1/6.0)* derivs[0][i] +
+                         (1/3.0)* derivs[1][i] +
+                         (1/3.0)* derivs[2][i] +
+                         (1/6.0)* derivs[3][i]) * h;
+    }
+}
+
+// Insertion Operator
+std::ostream& SA::operator<<(std::ostream& os, const EnsembleRK4Integrator& I) {
+    os << (SA::EnsembleIntegrator)I;
+    return os;
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include "SAIntegrator.hh"
+#include <math.h>
+
+#define NUM_MEMBERS 8
+
+// Damped oscillators. Member m has stiffness k = 1.0 + m.
+void oscillator_deriv( double t __attribute__((unused)),
+                       double state[],
+                       double derivs[],
+                       void* udata) {
+    double k = *(double*)udata;
+    derivs[0] = state[1];
+    derivs[1] = -k * state[0] - 0.1 * state[1];
+}
+
+void ensemble_oscillator_derivs( double t __attribute__((unused)),
+                                 unsigned int first,
+                                 unsigned int count,
+                                 double state[],
+                                 double derivs[],
+                                 void* udata __attribute__((unused))) {
+    for (unsigned int i=0; i<count; i++) {
+        double k = 1.0 + (first + i);
+        derivs[2*i]   = state[2*i+1];
+        derivs[2*i+1] = -k * state[2*i] - 0.1 * state[2*i+1];
+    }
+}
+
+TEST(EnsembleIntegrator_unittest, RK4_matches_individual_integrators) {
+
+    double dt = 0.01;
+    double block[NUM_MEMBERS][2];
+    double single[NUM_MEMBERS][2];
+    double stiffness[NUM_MEMBERS];
+    double* single_p[NUM_MEMBERS][2];
+    SA::RK4Integrator* integ[NUM_MEMBERS];
+
+    for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+        block[m][0] = single[m][0] = 1.0 + 0.25 * m;
+        block[m][1] = single[m][1] = 0.0;
+        stiffness[m] = 1.0 + m;
+        single_p[m][0] = &single[m][0];
+        single_p[m][1] = &single[m][1];
+        integ[m] = new SA::RK4Integrator(dt, 2, single_p[m], single_p[m], oscillator_deriv, &stiffness[m]);
+    }
+    SA::EnsembleRK4Integrator ensemble(dt, NUM_MEMBERS, 2, &block[0][0], ensemble_oscillator_derivs, NULL);
+
+    for (unsigned int count=0; count<500; count++) {
+        ensemble.integrate();
+        for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+            integ[m]->integrate();
+        }
+    }
+    EXPECT_NEAR(ensemble.getIndyVar(), integ[0]->getIndyVar(), 0.00000000001);
+    for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+        EXPECT_EQ(block[m][0], single[m][0]);
+        EXPECT_EQ(block[m][1], single[m][1]);
+        EXPECT_EQ(ensemble.member_state(m), &block[m][0]);
+        delete integ[m];
+    }
+}
+
+// Bouncing balls, dropped from different heights. state = {position, velocity}
+void ball_deriv( double t __attribute__((unused)),
+                 double state[],
+                 double derivs[],
+                 void* udata __attribute__((unused))) {
+    derivs[0] = state[1];
+    derivs[1] = -9.81;
+}
+
+double ball_impact( double t, double state[], RootFinder* root_finder, void* udata __attribute__((unused))) {
+    double root_error = root_finder->find_roots(t, state[0]);
+    if (root_error == 0.0) {
+        root_finder->init();
+        state[1] = -0.9 * state[1];
+    }
+    return (root_error);
+}
+
+void ensemble_ball_derivs( double t __attribute__((unused)),
+                           unsigned int first __attribute__((unused)),
+                           unsigned int count,
+                           double state[],
+                           double derivs[],
+                           void* udata __attribute__((unused))) {
+    for (unsigned int i=0; i<count; i++) {
+        derivs[2*i]   = state[2*i+1];
+        derivs[2*i+1] = -9.81;
+    }
+}
+
+double ensemble_ball_impact( double t, unsigned int member __attribute__((unused)), double state[],
+                             RootFinder* root_finder, void* udata __attribute__((unused))) {
+    double root_error = root_finder->find_roots(t, state[0]);
+    if (root_error == 0.0) {
+        root_finder->init();
+        state[1] = -0.9 * state[1];
+    }
+    return (root_error);
+}
+
+TEST(EnsembleIntegrator_unittest, RK2_rootfinding_matches_individual_integrators) {
+
+    double dt = 0.01;
+    double block[NUM_MEMBERS][2];
+    double single[NUM_MEMBERS][2];
+    double* single_p[NUM_MEMBERS][2];
+    SA::RK2Integrator* integ[NUM_MEMBERS];
+
+    for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+        block[m][0] = single[m][0] = 5.0 + 1.5 * m;
+        block[m][1] = single[m][1] = 0.0;
+        single_p[m][0] = &single[m][0];
+        single_p[m][1] = &single[m][1];
+        integ[m] = new SA::RK2Integrator(dt, 2, single_p[m], single_p[m], ball_deriv, NULL);
+        integ[m]->add_Rootfinder(0.00000000001, Negative, ball_impact);
+    }
+    SA::EnsembleRK2Integrator ensemble(dt, NUM_MEMBERS, 2, &block[0][0], ensemble_ball_derivs, NULL);
+    ensemble.add_Rootfinder(0.00000000001, Negative, ensemble_ball_impact);
+
+    for (unsigned int count=0; count<1000; count++) {
+        ensemble.integrate();
+        for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+            integ[m]->integrate();
+        }
+    }
+    for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+        // Every ball has bounced, and none has fallen through the floor.
+        EXPECT_GT(block[m][0], -0.00000001);
+        EXPECT_EQ(block[m][0], single[m][0]);
+        EXPECT_EQ(block[m][1], single[m][1]);
+        delete integ[m];
+    }
+}
+
+TEST(EnsembleIntegrator_unittest, undo_integrate) {
+
+    double dt = 0.01;
+    double block[NUM_MEMBERS][2];
+    for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+        block[m][0] = 1.0 + m;
+        block[m][1] = 0.0;
+    }
+    SA::EnsembleRK4Integrator ensemble(dt, NUM_MEMBERS, 2, &block[0][0], ensemble_oscillator_derivs, NULL);
+    ensemble.integrate();
+    EXPECT_NE(block[3][0], 4.0);
+    EXPECT_EQ(ensemble.undo_integrate(), dt);
+    for (unsigned int m=0; m<NUM_MEMBERS; m++) {
+        EXPECT_EQ(block[m][0], 1.0 + m);
+        EXPECT_EQ(block[m][1], 0.0);
+    }
+    EXPECT_EQ(ensemble.getIndyVar(), 0.0);
+}
+
+TEST(EnsembleIntegrator_unittest, copy_constructor) {
+
+    double block[NUM_MEMBERS][2] = {{0.0}};
+    SA::EnsembleRK4Integrator* integ1 =
+        new SA::EnsembleRK4Integrator(0.01, NUM_MEMBERS, 2, &block[0][0], ensemble_oscillator_derivs, NULL);
+    SA::EnsembleRK4Integrator* integ2 = new SA::EnsembleRK4Integrator(*integ1);
+
+    std::stringstream ss1;
+    std::stringstream ss2;
+    ss1 << *integ1;
+    ss2 << *integ2;
+    EXPECT_EQ(ss1.str(), ss2.str());
+    delete integ1;
+    delete integ2;
+}